@@ -1,4 +1,8 @@
 {
+  "variables": {
+    # Build the native microbenchmarks: node-gyp rebuild -- -Dselection_hook_bench=1
+    "selection_hook_bench%": 0
+  },
   "targets": [
     {
       "target_name": "selection-hook",
@@ -55,20 +59,61 @@
         }],
         ['OS=="linux"', {
           "sources": [
-            "src/linux/selection_hook.cc",
+            "src/linux/selection_hook.cc"
+          ],
+          # Protocols, gesture engine and correlation live in the core library
+          "dependencies": [
+            "selection-hook-core"
+          ],
+          "cflags_cc": [
+            "-std=c++17",
+            "-fexceptions"
+          ]
+        }],
+        ['OS!="win" and OS!="mac" and OS!="linux"', {
+          "defines": [
+            "UNSUPPORTED_PLATFORM"
+          ]
+        }]
+      ]
+    }
+  ],
+  "conditions": [
+    ['OS=="linux"', {
+      "targets": [
+        {
+          # Node-independent Linux engine with a C API (src/linux/core/selection_hook_core.h)
+          "target_name": "selection-hook-core",
+          "type": "static_library",
+          "cflags!": [ "-fno-exceptions" ],
+          "cflags_cc!": [ "-fno-exceptions" ],
+          "sources": [
+            "src/linux/core/selection_core.cc",
+            "src/linux/core/selection_hook_core.cc",
             "src/linux/protocols/x11.cc",
             "src/linux/protocols/wayland.cc",
             "src/linux/protocols/wayland/ext-data-control-v1-protocol.c",
+            "src/linux/protocols/wayland/ext-foreign-toplevel-list-v1-protocol.c",
             "src/linux/protocols/wayland/wlr-data-control-unstable-v1-protocol.c",
+            "src/linux/protocols/wayland/wlr-foreign-toplevel-management-unstable-v1-protocol.c",
+            "src/linux/lib/atspi.cc",
+            "src/linux/lib/dbus_loader.cc",
+            "src/linux/lib/event_reactor.cc",
+            "src/linux/lib/input_devices.cc",
             "src/linux/lib/keyboard.cc",
-            "src/linux/lib/utils.cc"
+            "src/linux/lib/log_ring.cc",
+            "src/linux/lib/program_names.cc",
+            "src/linux/lib/read_latency.cc",
+            "src/linux/lib/selection_history.cc",
+            "src/linux/lib/session_state.cc",
+            "src/linux/lib/text_classifier.cc",
+            "src/linux/lib/utils.cc",
+            "src/linux/lib/xi2_scroll.cc",
+            "src/linux/lib/xrecord.cc"
           ],
-          "libraries": [
-            "-levdev",
-            "-lX11",
-            "-lXtst",
-            "-lXfixes",
-            "-lwayland-client"
+          "cflags": [
+            # Linked into the addon shared object
+            "-fPIC"
           ],
           "cflags_cc": [
             "-std=c++17",
@@ -76,14 +121,41 @@
           ],
           "include_dirs": [
             "/usr/include/libevdev-1.0"
+          ],
+          "link_settings": {
+            "libraries": [
+              "-levdev",
+              "-lX11",
+              "-lXtst",
+              "-lXfixes",
+              "-lXi",
+              "-lXss",
+              "-lwayland-client"
+            ]
+          }
+        }
+      ]
+    }],
+    ['OS=="linux" and selection_hook_bench==1', {
+      "targets": [
+        {
+          # Microbenchmarks of the per-event helpers (ns/op, allocs/op)
+          "target_name": "selection-hook-bench",
+          "type": "executable",
+          "cflags!": [ "-fno-exceptions" ],
+          "cflags_cc!": [ "-fno-exceptions" ],
+          "sources": [
+            "src/linux/bench/microbench.cc"
+          ],
+          "dependencies": [
+            "selection-hook-core"
+          ],
+          "cflags_cc": [
+            "-std=c++17",
+            "-fexceptions"
           ]
-        }],
-        ['OS!="win" and OS!="mac" and OS!="linux"', {
-          "defines": [
-            "UNSUPPORTED_PLATFORM"
-          ]
-        }]
+        }
       ]
-    }
+    }]
   ]
-} 
\ No newline at end of file
+}
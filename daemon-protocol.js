@@ -0,0 +1,344 @@
+/**
+ * Selection Hook Daemon Protocol
+ *
+ * Compact binary framing shared by the selection-hook daemon (daemon.js) and
+ * the SelectionHook.Client subscriber in index.js.
+ *
+ * Frame layout (little-endian):
+ *   u32 payloadLength | u8 frameType | payload[payloadLength]
+ *
+ * Events are encoded once by the daemon and the same buffer is written to
+ * every subscribed client. Only SUBSCRIBE (client -> daemon, rare) uses JSON.
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+const fs = require("fs");
+const os = require("os");
+const path = require("path");
+
+const PROTOCOL_VERSION = 1;
+
+const HEADER_SIZE = 5;
+/** Upper bound for a single frame; larger frames indicate a corrupt stream */
+const MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+const FrameType = {
+  // daemon -> client
+  HELLO: 0x01,
+  TEXT_SELECTION: 0x10,
+  MOUSE_EVENT: 0x11,
+  KEYBOARD_EVENT: 0x12,
+  STATUS: 0x13,
+  ERROR: 0x14,
+  // client -> daemon
+  SUBSCRIBE: 0x20,
+};
+
+// Action names are sent as indices into these tables
+const MOUSE_ACTIONS = ["mouse-move", "mouse-down", "mouse-up", "mouse-wheel"];
+const KEYBOARD_ACTIONS = ["key-down", "key-up"];
+
+/** Events a client can subscribe to */
+const SUBSCRIBABLE_EVENTS = ["text-selection", ...MOUSE_ACTIONS, ...KEYBOARD_ACTIONS];
+
+// text-selection points, encoded in this order as i32 x/y pairs
+const SELECTION_POINTS = ["startTop", "startBottom", "endTop", "endBottom", "mousePosStart", "mousePosEnd"];
+
+/**
+ * Default daemon socket path: $XDG_RUNTIME_DIR/selection-hook.sock (per-user,
+ * per-session), falling back to a private directory in the temp dir with the uid
+ * in its name (created with mode 0700 by the daemon, see ensurePrivateSocketDir()).
+ * On Windows a named pipe with the user name is used.
+ * @returns {string}
+ */
+function defaultSocketPath() {
+  if (process.platform === "win32") {
+    const user = os.userInfo().username.replace(/[^A-Za-z0-9_.-]/g, "_");
+    return `\\\\.\\pipe\\selection-hook-${user}`;
+  }
+
+  const runtimeDir = process.env.XDG_RUNTIME_DIR;
+  if (runtimeDir) {
+    return path.join(runtimeDir, "selection-hook.sock");
+  }
+
+  const uid = typeof process.getuid === "function" ? process.getuid() : 0;
+  return path.join(os.tmpdir(), `selection-hook-${uid}`, "daemon.sock");
+}
+
+/**
+ * Create the private directory of the temp-dir fallback socket (mode 0700), or check that
+ * an existing one is a real directory owned by this user that no one else can enter.
+ * Other socket locations are left as they are.
+ * @param {string} socketPath
+ */
+function ensurePrivateSocketDir(socketPath) {
+  if (process.platform === "win32" || typeof process.getuid !== "function") return;
+
+  const dir = path.dirname(socketPath);
+  if (dir !== path.join(os.tmpdir(), `selection-hook-${process.getuid()}`)) return;
+
+  try {
+    fs.mkdirSync(dir, { mode: 0o700 });
+  } catch (err) {
+    if (/** @type {NodeJS.ErrnoException} */ (err).code !== "EEXIST") throw err;
+  }
+
+  const stat = fs.lstatSync(dir);
+  if (!stat.isDirectory() || stat.uid !== process.getuid() || (stat.mode & 0o077) !== 0) {
+    throw new Error(`Socket directory ${dir} is not a private directory of this user`);
+  }
+}
+
+/**
+ * @param {number} type
+ * @param {Buffer} payload
+ * @returns {Buffer}
+ */
+function encodeFrame(type, payload) {
+  const frame = Buffer.allocUnsafe(HEADER_SIZE + payload.length);
+  frame.writeUInt32LE(payload.length, 0);
+  frame.writeUInt8(type, 4);
+  payload.copy(frame, HEADER_SIZE);
+  return frame;
+}
+
+/** @returns {Buffer} */
+function encodeHello() {
+  const payload = Buffer.alloc(2);
+  payload.writeUInt16LE(PROTOCOL_VERSION, 0);
+  return encodeFrame(FrameType.HELLO, payload);
+}
+
+/**
+ * @param {any} data - formatted text-selection data (see SelectionHook)
+ * @returns {Buffer}
+ */
+function encodeTextSelection(data) {
+  const programName = Buffer.from(data.programName || "", "utf8");
+  const text = Buffer.from(data.text || "", "utf8");
+
+  const fixedSize = 3 + SELECTION_POINTS.length * 8;
+  const payload = Buffer.allocUnsafe(fixedSize + 4 + programName.length + 4 + text.length);
+
+  let offset = 0;
+  offset = payload.writeUInt8(data.method || 0, offset);
+  offset = payload.writeUInt8(data.posLevel || 0, offset);
+  // bit0: isFullscreen present (macOS), bit1: isFullscreen
+  const flags = (data.isFullscreen !== undefined ? 1 : 0) | (data.isFullscreen ? 2 : 0);
+  offset = payload.writeUInt8(flags, offset);
+
+  for (const name of SELECTION_POINTS) {
+    const point = data[name] || {};
+    offset = payload.writeInt32LE(point.x | 0, offset);
+    offset = payload.writeInt32LE(point.y | 0, offset);
+  }
+
+  offset = payload.writeUInt32LE(programName.length, offset);
+  offset += programName.copy(payload, offset);
+  offset = payload.writeUInt32LE(text.length, offset);
+  text.copy(payload, offset);
+
+  return encodeFrame(FrameType.TEXT_SELECTION, payload);
+}
+
+/**
+ * A wheel delta, when present, is appended as an f64 (older decoders ignore it).
+ * @param {string} action
+ * @param {any} data - { x, y, button, flag?, delta? }
+ * @returns {Buffer}
+ */
+function encodeMouseEvent(action, data) {
+  const hasDelta = data.delta !== undefined;
+  const payload = Buffer.allocUnsafe(hasDelta ? 25 : 17);
+  let offset = payload.writeUInt8(MOUSE_ACTIONS.indexOf(action), 0);
+  offset = payload.writeInt32LE(data.x | 0, offset);
+  offset = payload.writeInt32LE(data.y | 0, offset);
+  offset = payload.writeInt32LE(data.button | 0, offset);
+  offset = payload.writeInt32LE(data.flag | 0, offset);
+  if (hasDelta) payload.writeDoubleLE(data.delta, offset);
+  return encodeFrame(FrameType.MOUSE_EVENT, payload);
+}
+
+/**
+ * @param {string} action
+ * @param {any} data - { uniKey, vkCode, sys, flags, scanCode? }
+ * @returns {Buffer}
+ */
+function encodeKeyboardEvent(action, data) {
+  const uniKey = Buffer.from(data.uniKey || "", "utf8");
+  const payload = Buffer.allocUnsafe(16 + uniKey.length);
+
+  let offset = payload.writeUInt8(KEYBOARD_ACTIONS.indexOf(action), 0);
+  // bit0: sys, bit1: scanCode present
+  offset = payload.writeUInt8((data.sys ? 1 : 0) | (data.scanCode !== undefined ? 2 : 0), offset);
+  offset = payload.writeInt32LE(data.vkCode | 0, offset);
+  offset = payload.writeInt32LE(data.scanCode | 0, offset);
+  offset = payload.writeInt32LE(data.flags | 0, offset);
+  offset = payload.writeUInt16LE(uniKey.length, offset);
+  uniKey.copy(payload, offset);
+
+  return encodeFrame(FrameType.KEYBOARD_EVENT, payload);
+}
+
+/**
+ * @param {number} type - FrameType.STATUS, FrameType.ERROR or FrameType.SUBSCRIBE
+ * @param {string} str
+ * @returns {Buffer}
+ */
+function encodeString(type, str) {
+  return encodeFrame(type, Buffer.from(str, "utf8"));
+}
+
+/**
+ * @param {{ events?: string[], programs?: string[], excludePrograms?: string[] }} filter
+ * @returns {Buffer}
+ */
+function encodeSubscribe(filter) {
+  return encodeString(FrameType.SUBSCRIBE, JSON.stringify(filter));
+}
+
+/**
+ * Decode an event frame payload into [eventName, data].
+ * @param {number} type
+ * @param {Buffer} payload
+ * @returns {[string, any] | null}
+ */
+function decodeEvent(type, payload) {
+  switch (type) {
+    case FrameType.TEXT_SELECTION: {
+      let offset = 0;
+      /** @type {any} */
+      const data = {};
+      const method = payload.readUInt8(offset++);
+      const posLevel = payload.readUInt8(offset++);
+      const flags = payload.readUInt8(offset++);
+
+      const points = {};
+      for (const name of SELECTION_POINTS) {
+        const x = payload.readInt32LE(offset);
+        const y = payload.readInt32LE(offset + 4);
+        offset += 8;
+        /** @type {any} */ (points)[name] = { x, y };
+      }
+
+      const programNameLength = payload.readUInt32LE(offset);
+      offset += 4;
+      const programName = payload.toString("utf8", offset, offset + programNameLength);
+      offset += programNameLength;
+      const textLength = payload.readUInt32LE(offset);
+      offset += 4;
+      const text = payload.toString("utf8", offset, offset + textLength);
+
+      // Same key order as SelectionHook's formatted selection data
+      data.text = text;
+      data.programName = programName;
+      Object.assign(data, points);
+      data.method = method;
+      data.posLevel = posLevel;
+      if (flags & 1) data.isFullscreen = (flags & 2) !== 0;
+
+      return ["text-selection", data];
+    }
+
+    case FrameType.MOUSE_EVENT: {
+      const action = MOUSE_ACTIONS[payload.readUInt8(0)];
+      if (!action) return null;
+
+      const x = payload.readInt32LE(1);
+      const y = payload.readInt32LE(5);
+      const button = payload.readInt32LE(9);
+      if (action === "mouse-wheel") {
+        const flag = payload.readInt32LE(13);
+        if (payload.length >= 25) {
+          return [action, { x, y, button, flag, delta: payload.readDoubleLE(17) }];
+        }
+        return [action, { x, y, button, flag }];
+      }
+      return [action, { x, y, button }];
+    }
+
+    case FrameType.KEYBOARD_EVENT: {
+      const action = KEYBOARD_ACTIONS[payload.readUInt8(0)];
+      if (!action) return null;
+
+      const bits = payload.readUInt8(1);
+      const vkCode = payload.readInt32LE(2);
+      const scanCode = payload.readInt32LE(6);
+      const flags = payload.readInt32LE(10);
+      const uniKeyLength = payload.readUInt16LE(14);
+      const uniKey = payload.toString("utf8", 16, 16 + uniKeyLength);
+
+      /** @type {any} */
+      const keyData = { uniKey, vkCode, sys: (bits & 1) !== 0, flags };
+      if (bits & 2) keyData.scanCode = scanCode;
+      return [action, keyData];
+    }
+
+    case FrameType.STATUS:
+      return ["status", payload.toString("utf8")];
+
+    case FrameType.ERROR:
+      return ["error", new Error(payload.toString("utf8"))];
+
+    default:
+      return null;
+  }
+}
+
+/**
+ * Incremental frame decoder for a byte stream.
+ */
+class FrameDecoder {
+  /** @type {Buffer} */
+  #buffer = Buffer.alloc(0);
+
+  /**
+   * Append a chunk and return all complete frames.
+   * Throws on an oversized frame (corrupt or hostile stream).
+   * @param {Buffer} chunk
+   * @returns {{ type: number, payload: Buffer }[]}
+   */
+  push(chunk) {
+    this.#buffer = this.#buffer.length ? Buffer.concat([this.#buffer, chunk]) : chunk;
+
+    const frames = [];
+    let offset = 0;
+    while (this.#buffer.length - offset >= HEADER_SIZE) {
+      const length = this.#buffer.readUInt32LE(offset);
+      if (length > MAX_FRAME_SIZE) {
+        throw new Error(`Frame too large: ${length} bytes`);
+      }
+      if (this.#buffer.length - offset < HEADER_SIZE + length) break;
+
+      const type = this.#buffer.readUInt8(offset + 4);
+      const payload = this.#buffer.subarray(offset + HEADER_SIZE, offset + HEADER_SIZE + length);
+      frames.push({ type, payload });
+      offset += HEADER_SIZE + length;
+    }
+
+    this.#buffer = offset ? this.#buffer.subarray(offset) : this.#buffer;
+    return frames;
+  }
+}
+
+module.exports = {
+  PROTOCOL_VERSION,
+  MAX_FRAME_SIZE,
+  FrameType,
+  MOUSE_ACTIONS,
+  KEYBOARD_ACTIONS,
+  SUBSCRIBABLE_EVENTS,
+  defaultSocketPath,
+  ensurePrivateSocketDir,
+  encodeHello,
+  encodeTextSelection,
+  encodeMouseEvent,
+  encodeKeyboardEvent,
+  encodeString,
+  encodeSubscribe,
+  decodeEvent,
+  FrameDecoder,
+};
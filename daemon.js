@@ -0,0 +1,349 @@
+#!/usr/bin/env node
+/**
+ * Selection Hook Daemon
+ *
+ * Runs a single SelectionHook per user session and publishes its events over a
+ * Unix domain socket (named pipe on Windows) using the compact binary framing in
+ * daemon-protocol.js. Apps subscribe through SelectionHook.Client with per-client
+ * event and program filters, so input sources (evdev fds, XRecord context,
+ * data-control binding, KWin script) and selection reads exist once per session
+ * instead of once per app.
+ *
+ * Usage:
+ *   selection-hook-daemon [--socket <path>] [--config <config.json>] [--debug]
+ *
+ * --config takes a JSON file with SelectionConfig options passed to start().
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+const EventEmitter = require("events");
+const fs = require("fs");
+const net = require("net");
+
+const SelectionHook = require("./index.js");
+const protocol = require("./daemon-protocol.js");
+
+const isWindows = process.platform === "win32";
+
+/** Per-client send buffer limit; event frames are dropped for a client above it */
+const MAX_CLIENT_BUFFER = 1024 * 1024;
+
+class SelectionHookDaemon extends EventEmitter {
+  #socketPath;
+  #config;
+  /** @type {SelectionHook | null} */
+  #hook = null;
+  /** @type {net.Server | null} */
+  #server = null;
+  /** @type {Set<any>} */
+  #clients = new Set();
+  #mouseMoveEnabled = false;
+
+  /**
+   * @param {{ socketPath?: string, config?: object }} [options]
+   */
+  constructor(options = {}) {
+    super();
+    this.#socketPath = options.socketPath || protocol.defaultSocketPath();
+    this.#config = options.config || null;
+  }
+
+  get socketPath() {
+    return this.#socketPath;
+  }
+
+  /**
+   * Start the hook and listen for clients
+   * @returns {Promise<void>}
+   */
+  async start() {
+    if (this.#server) return;
+
+    protocol.ensurePrivateSocketDir(this.#socketPath);
+    await this.#removeStaleSocket();
+
+    const hook = new SelectionHook();
+    this.#hook = hook;
+
+    hook.on("text-selection", (data) => this.#broadcast("text-selection", data));
+    for (const action of protocol.MOUSE_ACTIONS) {
+      hook.on(action, (data) => this.#broadcast(action, data));
+    }
+    for (const action of protocol.KEYBOARD_ACTIONS) {
+      hook.on(action, (data) => this.#broadcast(action, data));
+    }
+    hook.on("status", (status) => this.#broadcastAll(protocol.encodeString(protocol.FrameType.STATUS, status)));
+    hook.on("error", (err) => this.#broadcastAll(protocol.encodeString(protocol.FrameType.ERROR, err.message)));
+
+    // The stream carries keystrokes and selected text: owner-only access. The umask covers
+    // the socket from its creation on; the chmod only makes the intent explicit.
+    const server = net.createServer((socket) => this.#onConnection(socket));
+    const previousUmask = isWindows ? null : process.umask(0o077);
+    try {
+      await new Promise((resolve, reject) => {
+        server.once("error", reject);
+        server.listen(this.#socketPath, () => {
+          server.off("error", reject);
+          resolve(undefined);
+        });
+      });
+    } finally {
+      if (previousUmask !== null) process.umask(previousUmask);
+    }
+    this.#server = server;
+
+    if (!isWindows) {
+      fs.chmodSync(this.#socketPath, 0o600);
+    }
+
+    if (!hook.start(this.#config)) {
+      this.stop();
+      throw new Error("Failed to start selection hook");
+    }
+
+    // Mouse move events follow client subscriptions, whatever the config said
+    this.#mouseMoveEnabled = !!(/** @type {any} */ (this.#config)?.enableMouseMoveEvent);
+    this.#updateMouseMoveEvent();
+
+    this.emit("status", "started");
+  }
+
+  /**
+   * Stop the hook, disconnect all clients and remove the socket
+   */
+  stop() {
+    if (this.#hook) {
+      this.#hook.cleanup();
+      this.#hook = null;
+    }
+
+    for (const client of this.#clients) {
+      client.socket.destroy();
+    }
+    this.#clients.clear();
+    this.#mouseMoveEnabled = false;
+
+    if (this.#server) {
+      this.#server.close();
+      this.#server = null;
+
+      if (!isWindows) {
+        try {
+          fs.unlinkSync(this.#socketPath);
+        } catch {
+          // Already removed
+        }
+      }
+
+      this.emit("status", "stopped");
+    }
+  }
+
+  /**
+   * Remove a socket file left behind by a daemon that did not exit cleanly.
+   * Refuses to start if another daemon is still accepting connections.
+   */
+  async #removeStaleSocket() {
+    if (isWindows || !fs.existsSync(this.#socketPath)) return;
+
+    const alive = await new Promise((resolve) => {
+      const probe = net.connect(this.#socketPath);
+      probe.once("connect", () => {
+        probe.destroy();
+        resolve(true);
+      });
+      probe.once("error", () => resolve(false));
+    });
+
+    if (alive) {
+      throw new Error(`Another selection-hook daemon is listening on ${this.#socketPath}`);
+    }
+
+    fs.unlinkSync(this.#socketPath);
+  }
+
+  /**
+   * @param {net.Socket} socket
+   */
+  #onConnection(socket) {
+    const client = {
+      socket,
+      decoder: new protocol.FrameDecoder(),
+      /** @type {Set<string>} */
+      events: new Set(),
+      /** @type {string[]} */
+      programs: [],
+      /** @type {string[]} */
+      excludePrograms: [],
+    };
+    this.#clients.add(client);
+
+    socket.on("data", (chunk) => {
+      try {
+        for (const frame of client.decoder.push(chunk)) {
+          if (frame.type === protocol.FrameType.SUBSCRIBE) {
+            this.#subscribe(client, JSON.parse(frame.payload.toString("utf8")));
+          }
+        }
+      } catch (err) {
+        socket.destroy();
+      }
+    });
+
+    const onClose = () => {
+      if (this.#clients.delete(client)) {
+        this.#updateMouseMoveEvent();
+      }
+    };
+    socket.on("close", onClose);
+    socket.on("error", onClose);
+
+    socket.write(protocol.encodeHello());
+  }
+
+  /**
+   * Apply a client's SUBSCRIBE filter
+   * @param {any} client
+   * @param {any} filter - { events, programs, excludePrograms }
+   */
+  #subscribe(client, filter) {
+    const toList = (/** @type {any} */ list) =>
+      Array.isArray(list) ? list.filter((item) => typeof item === "string").map((item) => item.toLowerCase()) : [];
+
+    client.events = new Set(toList(filter.events).filter((event) => protocol.SUBSCRIBABLE_EVENTS.includes(event)));
+    client.programs = toList(filter.programs);
+    client.excludePrograms = toList(filter.excludePrograms);
+
+    this.#updateMouseMoveEvent();
+  }
+
+  /**
+   * Mouse move events are expensive: only enable them while a client wants them
+   */
+  #updateMouseMoveEvent() {
+    if (!this.#hook) return;
+
+    let wanted = false;
+    for (const client of this.#clients) {
+      if (client.events.has("mouse-move")) {
+        wanted = true;
+        break;
+      }
+    }
+
+    if (wanted === this.#mouseMoveEnabled) return;
+    this.#mouseMoveEnabled = wanted;
+    if (wanted) {
+      this.#hook.enableMouseMoveEvent();
+    } else {
+      this.#hook.disableMouseMoveEvent();
+    }
+  }
+
+  /**
+   * Program filters use the same case-insensitive substring match as the native filter lists
+   * @param {any} client
+   * @param {string} programName
+   */
+  #matchesProgram(client, programName) {
+    const name = (programName || "").toLowerCase();
+    if (client.programs.length && !client.programs.some((/** @type {string} */ item) => name.includes(item))) {
+      return false;
+    }
+    return !client.excludePrograms.some((/** @type {string} */ item) => name.includes(item));
+  }
+
+  /**
+   * Encode an event once and send it to every client subscribed to it
+   * @param {string} event
+   * @param {any} data
+   */
+  #broadcast(event, data) {
+    let frame = null;
+
+    for (const client of this.#clients) {
+      if (!client.events.has(event)) continue;
+      if (event === "text-selection" && !this.#matchesProgram(client, data.programName)) continue;
+
+      // Slow consumer: drop rather than buffer without bound
+      if (client.socket.writableLength > MAX_CLIENT_BUFFER) continue;
+
+      if (!frame) {
+        if (event === "text-selection") {
+          frame = protocol.encodeTextSelection(data);
+        } else if (protocol.MOUSE_ACTIONS.includes(event)) {
+          frame = protocol.encodeMouseEvent(event, data);
+        } else {
+          frame = protocol.encodeKeyboardEvent(event, data);
+        }
+      }
+
+      client.socket.write(frame);
+    }
+  }
+
+  /**
+   * @param {Buffer} frame
+   */
+  #broadcastAll(frame) {
+    for (const client of this.#clients) {
+      client.socket.write(frame);
+    }
+  }
+}
+
+/**
+ * Parse command line arguments for the daemon CLI
+ * @param {string[]} argv
+ */
+function parseArgs(argv) {
+  /** @type {{ socketPath?: string, config?: any }} */
+  const options = {};
+
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case "--socket":
+        options.socketPath = argv[++i];
+        break;
+      case "--config":
+        options.config = { ...JSON.parse(fs.readFileSync(argv[++i], "utf8")), ...options.config };
+        break;
+      case "--debug":
+        options.config = { ...options.config, debug: true };
+        break;
+      default:
+        throw new Error(`Unknown argument: ${argv[i]}`);
+    }
+  }
+
+  return options;
+}
+
+if (require.main === module) {
+  let daemon;
+  try {
+    daemon = new SelectionHookDaemon(parseArgs(process.argv.slice(2)));
+  } catch (err) {
+    console.error("[selection-hook-daemon]", /** @type {Error} */ (err).message);
+    process.exit(1);
+  }
+
+  const shutdown = () => {
+    daemon.stop();
+    process.exit(0);
+  };
+  process.on("SIGINT", shutdown);
+  process.on("SIGTERM", shutdown);
+
+  daemon.start().then(
+    () => console.log(`[selection-hook-daemon] listening on ${daemon.socketPath}`),
+    (err) => {
+      console.error("[selection-hook-daemon]", err.message);
+      process.exit(1);
+    }
+  );
+}
+
+module.exports = SelectionHookDaemon;
@@ -0,0 +1,164 @@
+/**
+ * Text Selection Hook - Event Delivery Benchmark (Linux)
+ *
+ * Measures the cost of delivering events from the native layer to JS listeners,
+ * without real input: synthetic events are injected at the protocol thread entry
+ * points and travel the real path (event queue, dispatch on the event loop, N-API
+ * result objects, the index.js event switch and #formatSelectionData).
+ *
+ * Reported per event type:
+ * - events/s: delivered events per second of wall time
+ * - main µs/event: event loop active time per delivered event (main thread CPU)
+ * - process µs/event: process CPU time (all threads, including the injector) per event
+ * - GC ms: total garbage collection pause time during the run
+ * - dropped: events dropped by the bounded native queue (dispatch fell behind)
+ *
+ * Requirements: a running X11 or Wayland session (the hook connects to the display).
+ *
+ * Usage:
+ *   node examples/bench-event-delivery.js [--count 100000] [--rate 0] [--types mouse-move,text-selection]
+ *
+ * --rate is in events per second; 0 injects as fast as possible.
+ */
+
+// ===========================
+// === Module Dependencies ===
+// ===========================
+const { performance, PerformanceObserver } = require("perf_hooks");
+
+// Event injection is test-only and must be enabled explicitly
+process.env.SELECTION_HOOK_TEST_INJECTION = "1";
+const SelectionHook = require("../index.js");
+
+// ===========================
+// === Configuration ========
+// ===========================
+
+// Injected type -> JS events it produces (mouse-click and keyboard inject down/up pairs)
+const EVENT_TYPES = {
+  "mouse-move": ["mouse-move"],
+  "mouse-wheel": ["mouse-wheel"],
+  "mouse-click": ["mouse-down", "mouse-up"],
+  keyboard: ["key-down", "key-up"],
+  "text-selection": ["text-selection"],
+};
+
+function parseArgs(argv) {
+  const options = { count: 100000, rate: 0, types: Object.keys(EVENT_TYPES) };
+
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case "--count":
+        options.count = parseInt(argv[++i], 10);
+        break;
+      case "--rate":
+        options.rate = parseInt(argv[++i], 10);
+        break;
+      case "--types":
+        options.types = argv[++i].split(",");
+        break;
+    }
+  }
+
+  return options;
+}
+
+const options = parseArgs(process.argv.slice(2));
+
+const WARMUP_COUNT = 1000;
+const DRAIN_QUIET_MS = 100; // no new events for this long after injection ends = drained
+
+// ===========================
+// === Helpers ===============
+// ===========================
+
+const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+let gcTimeMs = 0;
+const gcObserver = new PerformanceObserver((list) => {
+  for (const entry of list.getEntries()) gcTimeMs += entry.duration;
+});
+gcObserver.observe({ entryTypes: ["gc"] });
+
+// Inject count events and wait until they have all been delivered or dropped
+async function injectAndDrain(hook, type, count, counter) {
+  if (!hook._injectTestEvents(type, count, options.rate)) {
+    throw new Error(`Failed to inject ${type} events`);
+  }
+
+  let last = -1;
+  while (hook._isInjectingTestEvents() || counter.value !== last) {
+    last = counter.value;
+    await sleep(DRAIN_QUIET_MS);
+  }
+}
+
+// ===========================
+// === Benchmark =============
+// ===========================
+
+async function runType(type) {
+  const jsEvents = EVENT_TYPES[type];
+  if (!jsEvents) throw new Error(`Unknown event type: ${type}`);
+
+  const hook = new SelectionHook();
+  const counter = { value: 0 };
+  const onEvent = () => counter.value++;
+  for (const event of jsEvents) hook.on(event, onEvent);
+
+  if (!hook.start({ enableMouseMoveEvent: type === "mouse-move" })) {
+    throw new Error("Failed to start the hook");
+  }
+
+  await injectAndDrain(hook, type, WARMUP_COUNT, counter);
+  counter.value = 0;
+
+  const expected = options.count * jsEvents.length;
+  const gcBefore = gcTimeMs;
+  const eluBefore = performance.eventLoopUtilization();
+  const cpuBefore = process.cpuUsage();
+  const begin = performance.now();
+
+  await injectAndDrain(hook, type, options.count, counter);
+
+  // Exclude the final quiet period used to detect the end of delivery
+  const elapsedMs = performance.now() - begin - DRAIN_QUIET_MS;
+  const elu = performance.eventLoopUtilization(eluBefore);
+  const cpu = process.cpuUsage(cpuBefore);
+  const delivered = counter.value;
+
+  hook.stop();
+  hook.cleanup();
+
+  return {
+    type,
+    delivered,
+    dropped: expected - delivered,
+    "events/s": Math.round(delivered / (elapsedMs / 1000)),
+    "main µs/event": ((elu.active * 1000) / delivered).toFixed(2),
+    "process µs/event": ((cpu.user + cpu.system) / delivered).toFixed(2),
+    "GC ms": (gcTimeMs - gcBefore).toFixed(1),
+  };
+}
+
+async function main() {
+  if (process.platform !== "linux") {
+    console.error("This benchmark only runs on Linux");
+    process.exit(1);
+  }
+
+  console.log(`Events per type: ${options.count}, rate: ${options.rate || "unpaced"}`);
+
+  const results = [];
+  for (const type of options.types) {
+    results.push(await runType(type));
+  }
+
+  gcObserver.disconnect();
+  console.table(results);
+}
+
+main().catch((err) => {
+  console.error(err);
+  process.exit(1);
+});
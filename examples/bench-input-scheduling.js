@@ -0,0 +1,188 @@
+/**
+ * Text Selection Hook - Input Thread Scheduling Benchmark (Linux X11)
+ *
+ * Measures how often a synthetic double-click produces a text-selection event,
+ * and how quickly, while the CPU is saturated by busy-looping child processes.
+ * Three phases are run with the same gestures:
+ * - baseline: idle system, default scheduling
+ * - contention: all CPUs busy, default scheduling
+ * - contention + scheduling: all CPUs busy, linuxSetThreadScheduling() applied
+ *
+ * Requirements: X11 session and `xdotool`. Place the mouse pointer over a word
+ * in a text editor or terminal before the countdown ends, and keep it there.
+ *
+ * Usage:
+ *   node examples/bench-input-scheduling.js [--gestures 50] [--nice -10] [--realtime] [--cpus 0,1]
+ *
+ * Negative nice values and --realtime need CAP_SYS_NICE (or RLIMIT_NICE/RLIMIT_RTPRIO);
+ * without them the threads keep the default scheduling and the last phase matches the second.
+ */
+
+// ===========================
+// === Module Dependencies ===
+// ===========================
+const { spawn, execFileSync } = require("child_process");
+const os = require("os");
+const SelectionHook = require("../index.js");
+
+// ===========================
+// === Configuration ========
+// ===========================
+
+function parseArgs(argv) {
+  const options = { gestures: 50, nice: -10, realtime: false, cpus: undefined };
+
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case "--gestures":
+        options.gestures = parseInt(argv[++i], 10);
+        break;
+      case "--nice":
+        options.nice = parseInt(argv[++i], 10);
+        break;
+      case "--realtime":
+        options.realtime = true;
+        break;
+      case "--cpus":
+        options.cpus = argv[++i].split(",").map((cpu) => parseInt(cpu, 10));
+        break;
+    }
+  }
+
+  return options;
+}
+
+const options = parseArgs(process.argv.slice(2));
+
+const SELECTION_TIMEOUT_MS = 1000; // a gesture without text-selection within this time counts as missed
+const GESTURE_INTERVAL_MS = 600; // pause between gestures, longer than the double-click interval
+const HOGS_PER_CPU = 2;
+
+// ===========================
+// === Helpers ===============
+// ===========================
+
+const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+function percentile(values, p) {
+  if (values.length === 0) return NaN;
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.floor((p / 100) * sorted.length))];
+}
+
+function startCpuHogs() {
+  const hogs = [];
+  for (let i = 0; i < os.cpus().length * HOGS_PER_CPU; i++) {
+    hogs.push(spawn(process.execPath, ["-e", "for(;;){}"], { stdio: "ignore" }));
+  }
+  return hogs;
+}
+
+function stopCpuHogs(hogs) {
+  for (const hog of hogs) hog.kill("SIGKILL");
+}
+
+// Resolves with the latency in ms since begin, or null on timeout
+function waitForEvent(hook, event, begin, timeoutMs) {
+  return new Promise((resolve) => {
+    const timer = setTimeout(() => {
+      hook.off(event, onEvent);
+      resolve(null);
+    }, timeoutMs);
+
+    function onEvent() {
+      clearTimeout(timer);
+      hook.off(event, onEvent);
+      resolve(Number(process.hrtime.bigint() - begin) / 1e6);
+    }
+
+    hook.on(event, onEvent);
+  });
+}
+
+// ===========================
+// === Benchmark =============
+// ===========================
+
+async function runPhase(name, { contention, scheduling }) {
+  const hook = new SelectionHook();
+  const hogs = contention ? startCpuHogs() : [];
+
+  hook.linuxSetThreadScheduling(scheduling);
+  if (!hook.start()) {
+    stopCpuHogs(hogs);
+    throw new Error("Failed to start the hook");
+  }
+
+  // Let the hogs reach full load
+  await sleep(500);
+
+  let hits = 0;
+  const mouseUpLatencies = [];
+  const selectionLatencies = [];
+
+  for (let i = 0; i < options.gestures; i++) {
+    const begin = process.hrtime.bigint();
+    const pending = Promise.all([
+      waitForEvent(hook, "mouse-up", begin, SELECTION_TIMEOUT_MS),
+      waitForEvent(hook, "text-selection", begin, SELECTION_TIMEOUT_MS),
+    ]);
+
+    spawn("xdotool", ["click", "--repeat", "2", "--delay", "50", "1"], { stdio: "ignore" });
+    const [mouseUpLatency, selectionLatency] = await pending;
+
+    if (mouseUpLatency !== null) mouseUpLatencies.push(mouseUpLatency);
+    if (selectionLatency !== null) {
+      selectionLatencies.push(selectionLatency);
+      hits++;
+    }
+
+    await sleep(GESTURE_INTERVAL_MS);
+  }
+
+  hook.stop();
+  hook.cleanup();
+  stopCpuHogs(hogs);
+
+  return {
+    phase: name,
+    success: `${((hits / options.gestures) * 100).toFixed(1)}%`,
+    "mouse-up p50 (ms)": percentile(mouseUpLatencies, 50).toFixed(1),
+    "mouse-up p95 (ms)": percentile(mouseUpLatencies, 95).toFixed(1),
+    "selection p50 (ms)": percentile(selectionLatencies, 50).toFixed(1),
+    "selection p95 (ms)": percentile(selectionLatencies, 95).toFixed(1),
+  };
+}
+
+async function main() {
+  if (process.platform !== "linux") {
+    console.error("This benchmark only runs on Linux (X11)");
+    process.exit(1);
+  }
+
+  try {
+    execFileSync("xdotool", ["version"], { stdio: "ignore" });
+  } catch {
+    console.error("xdotool is required: install it with your package manager");
+    process.exit(1);
+  }
+
+  const scheduling = { nice: options.nice, realtime: options.realtime, cpus: options.cpus };
+
+  console.log(`Gestures per phase: ${options.gestures}, CPU hogs: ${os.cpus().length * HOGS_PER_CPU}`);
+  console.log(`Scheduling: ${JSON.stringify(scheduling)}`);
+  console.log("Place the mouse pointer over a word, starting in 5 seconds...");
+  await sleep(5000);
+
+  const results = [];
+  results.push(await runPhase("baseline", { contention: false, scheduling: null }));
+  results.push(await runPhase("contention", { contention: true, scheduling: null }));
+  results.push(await runPhase("contention + scheduling", { contention: true, scheduling }));
+
+  console.table(results);
+}
+
+main().catch((err) => {
+  console.error(err);
+  process.exit(1);
+});
@@ -0,0 +1,207 @@
+/**
+ * Text Selection Hook - X11 Clipboard Fallback Benchmark (Linux X11)
+ *
+ * Measures the latency of the clipboard fallback (enableClipboard()): saving the
+ * clipboard, the synthesized Ctrl+C, the wait for the XFixes CLIPBOARD owner change,
+ * reading the copied text and restoring the saved clipboard.
+ *
+ * A responder child process plays the app: it watches key presses with its own hook
+ * and, on Ctrl+C, takes CLIPBOARD ownership through xclip after a configurable delay.
+ * The fallback is triggered with getCurrentSelection() while PRIMARY has no owner, so
+ * no mouse gesture (and no 500ms PRIMARY confirmation window) is involved. Before
+ * every read the clipboard is set to a known text, and afterwards it is checked that
+ * this text was restored.
+ *
+ * Reported per responder delay:
+ * - success: reads that returned the copied text through the clipboard fallback
+ * - restored: reads after which the clipboard held the saved text again
+ * - p50/p95 (ms): getCurrentSelection() latency
+ * - overhead p50 (ms): latency above the responder delay
+ *
+ * Delays above the 300ms copy timeout are expected to fail.
+ *
+ * Requirements: xclip, xwininfo and xprop (x11-utils), and an X server the benchmark
+ * owns, e.g. Xvfb (the root window is set as _NET_ACTIVE_WINDOW):
+ *   xvfb-run -a node examples/bench-x11-clipboard-fallback.js
+ *
+ * Usage:
+ *   node examples/bench-x11-clipboard-fallback.js [--reads 50] [--delays 0,10,50,200]
+ */
+
+// ===========================
+// === Module Dependencies ===
+// ===========================
+const { spawn, execFile, execFileSync } = require("child_process");
+const SelectionHook = require("../index.js");
+
+// ===========================
+// === Configuration ========
+// ===========================
+
+function parseArgs(argv) {
+  const options = { reads: 50, delays: [0, 10, 50, 200], responder: null };
+
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case "--reads":
+        options.reads = parseInt(argv[++i], 10);
+        break;
+      case "--delays":
+        options.delays = argv[++i].split(",").map((delay) => parseInt(delay, 10));
+        break;
+      case "--responder":
+        options.responder = parseInt(argv[++i], 10);
+        break;
+    }
+  }
+
+  return options;
+}
+
+const options = parseArgs(process.argv.slice(2));
+
+const RESPONDER_READY_MS = 500; // time for the responder's hook to start
+const READ_INTERVAL_MS = 100; // pause between reads, lets xclip processes settle
+const CTRL_FLAG = 0x02;
+
+// ===========================
+// === Helpers ===============
+// ===========================
+
+const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+function percentile(values, p) {
+  if (values.length === 0) return NaN;
+  const sorted = [...values].sort((a, b) => a - b);
+  return sorted[Math.min(sorted.length - 1, Math.floor((p / 100) * sorted.length))];
+}
+
+// Take CLIPBOARD ownership with text; xclip stays in the background serving it
+function setClipboard(text) {
+  return new Promise((resolve, reject) => {
+    const xclip = spawn("xclip", ["-selection", "clipboard", "-i"], { stdio: ["pipe", "ignore", "ignore"] });
+    xclip.on("error", reject);
+    xclip.on("exit", resolve);
+    xclip.stdin.end(text);
+  });
+}
+
+// Asynchronous: the restored text is served by the hook while this waits
+function readClipboard() {
+  return new Promise((resolve) => {
+    execFile("xclip", ["-selection", "clipboard", "-o"], { timeout: 1000 }, (err, stdout) =>
+      resolve(err ? null : stdout),
+    );
+  });
+}
+
+function setActiveWindowToRoot() {
+  const info = execFileSync("xwininfo", ["-root"], { encoding: "utf8" });
+  const match = info.match(/Window id: (0x[0-9a-f]+)/i);
+  if (!match) throw new Error("Cannot read the root window id");
+  execFileSync("xprop", ["-root", "-f", "_NET_ACTIVE_WINDOW", "32x", "-set", "_NET_ACTIVE_WINDOW", match[1]]);
+}
+
+// ===========================
+// === Responder =============
+// ===========================
+
+// Child process: copy on every Ctrl+C after delayMs, like an app answering the shortcut
+function runResponder(delayMs) {
+  const hook = new SelectionHook();
+  let copies = 0;
+
+  hook.on("key-down", (event) => {
+    if (event.uniKey.toLowerCase() !== "c" || !(event.flags & CTRL_FLAG)) return;
+    const text = `copied-${++copies}`;
+    setTimeout(() => setClipboard(text), delayMs);
+  });
+
+  if (!hook.start({ enableMouseMoveEvent: false })) {
+    console.error("Responder: failed to start the hook");
+    process.exit(1);
+  }
+}
+
+// ===========================
+// === Benchmark =============
+// ===========================
+
+async function runDelay(delayMs) {
+  const responder = spawn(process.execPath, [__filename, "--responder", String(delayMs)], { stdio: "inherit" });
+  await sleep(RESPONDER_READY_MS);
+
+  const hook = new SelectionHook();
+  if (!hook.start({ enableClipboard: true })) {
+    responder.kill();
+    throw new Error("Failed to start the hook");
+  }
+
+  let hits = 0;
+  let restored = 0;
+  const latencies = [];
+
+  for (let i = 0; i < options.reads; i++) {
+    const saved = `saved-${i}`;
+    await setClipboard(saved);
+    await sleep(READ_INTERVAL_MS);
+
+    const begin = process.hrtime.bigint();
+    const data = hook.getCurrentSelection();
+    const latency = Number(process.hrtime.bigint() - begin) / 1e6;
+
+    if (data && data.method === SelectionHook.SelectionMethod.CLIPBOARD && data.text.startsWith("copied-")) {
+      hits++;
+      latencies.push(latency);
+    }
+    if ((await readClipboard()) === saved) restored++;
+  }
+
+  hook.stop();
+  hook.cleanup();
+  responder.kill();
+
+  const p50 = percentile(latencies, 50);
+  return {
+    "delay (ms)": delayMs,
+    success: `${((hits / options.reads) * 100).toFixed(1)}%`,
+    restored: `${((restored / options.reads) * 100).toFixed(1)}%`,
+    "p50 (ms)": p50.toFixed(1),
+    "p95 (ms)": percentile(latencies, 95).toFixed(1),
+    "overhead p50 (ms)": (p50 - delayMs).toFixed(1),
+  };
+}
+
+async function main() {
+  if (process.platform !== "linux" || !process.env.DISPLAY) {
+    console.error("This benchmark only runs on Linux X11, e.g. under xvfb-run");
+    process.exit(1);
+  }
+
+  try {
+    execFileSync("xclip", ["-version"], { stdio: "ignore" });
+    execFileSync("xprop", ["-version"], { stdio: "ignore" });
+  } catch {
+    console.error("xclip and x11-utils (xprop, xwininfo) are required: install them with your package manager");
+    process.exit(1);
+  }
+
+  setActiveWindowToRoot();
+  console.log(`Reads per delay: ${options.reads}, DISPLAY=${process.env.DISPLAY}`);
+
+  const results = [];
+  for (const delayMs of options.delays) {
+    results.push(await runDelay(delayMs));
+  }
+
+  console.table(results);
+}
+
+if (options.responder !== null) {
+  runResponder(options.responder);
+} else {
+  main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+  });
+}
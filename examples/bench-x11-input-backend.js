@@ -0,0 +1,168 @@
+/**
+ * Text Selection Hook - X11 Input Backend Benchmark (Linux X11)
+ *
+ * Compares the CPU cost of the X11 input backends (linuxSetX11InputBackend()):
+ * XRecord and XInput2 raw events. The same real input, synthesized by xdotool
+ * through XTest, is fed to each backend in turn:
+ * - mouse-move: pointer motion, one `mousemove` per event
+ * - keyboard: key presses and releases
+ * - mouse-click: middle button presses and releases (no selection is read on the root window)
+ *
+ * Reported per backend and input type:
+ * - injected: X input events generated by xdotool
+ * - delivered: JS events received (XInput2 delivers motion read at once as one mouse-move)
+ * - process µs/input: process CPU time (all threads) per injected input event
+ * - process µs/event: process CPU time per delivered JS event
+ *
+ * Requirements: xdotool, and an X server the benchmark owns, e.g. Xvfb:
+ *   xvfb-run -a node examples/bench-x11-input-backend.js
+ *
+ * Usage:
+ *   node examples/bench-x11-input-backend.js [--count 20000] [--types mouse-move,keyboard,mouse-click]
+ */
+
+// ===========================
+// === Module Dependencies ===
+// ===========================
+const { spawn, execFileSync } = require("child_process");
+const SelectionHook = require("../index.js");
+
+// ===========================
+// === Configuration ========
+// ===========================
+
+const BACKENDS = ["xrecord", "xinput2"];
+
+// Input type -> xdotool commands for event i, X input events per command, JS events listened to
+const INPUT_TYPES = {
+  "mouse-move": {
+    command: (i) => `mousemove ${100 + (i % 400)} ${100 + ((i >> 1) % 2)}`,
+    inputs: 1,
+    events: ["mouse-move"],
+  },
+  keyboard: { command: () => "key shift", inputs: 2, events: ["key-down", "key-up"] },
+  "mouse-click": { command: () => "click 2", inputs: 2, events: ["mouse-down", "mouse-up"] },
+};
+
+function parseArgs(argv) {
+  const options = { count: 20000, types: Object.keys(INPUT_TYPES) };
+
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case "--count":
+        options.count = parseInt(argv[++i], 10);
+        break;
+      case "--types":
+        options.types = argv[++i].split(",");
+        break;
+    }
+  }
+
+  return options;
+}
+
+const options = parseArgs(process.argv.slice(2));
+
+const WARMUP_COUNT = 500;
+const DRAIN_QUIET_MS = 200; // no new events for this long after xdotool exits = drained
+
+// ===========================
+// === Helpers ===============
+// ===========================
+
+const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+// Run count commands through one xdotool process, reading its script from stdin
+function runXdotool(type, count) {
+  return new Promise((resolve, reject) => {
+    const xdotool = spawn("xdotool", ["-"], { stdio: ["pipe", "ignore", "ignore"] });
+    xdotool.on("error", reject);
+    xdotool.on("exit", resolve);
+
+    const lines = [];
+    for (let i = 0; i < count; i++) lines.push(INPUT_TYPES[type].command(i));
+    xdotool.stdin.end(lines.join("\n") + "\n");
+  });
+}
+
+// Generate count inputs and wait until the hook has delivered all it will
+async function injectAndDrain(type, count, counter) {
+  await runXdotool(type, count);
+
+  let last = -1;
+  while (counter.value !== last) {
+    last = counter.value;
+    await sleep(DRAIN_QUIET_MS);
+  }
+}
+
+// ===========================
+// === Benchmark =============
+// ===========================
+
+async function runBackend(backend, type) {
+  const input = INPUT_TYPES[type];
+  if (!input) throw new Error(`Unknown input type: ${type}`);
+
+  const hook = new SelectionHook();
+  const counter = { value: 0 };
+  const onEvent = () => counter.value++;
+  for (const event of input.events) hook.on(event, onEvent);
+
+  if (!hook.start({ enableMouseMoveEvent: type === "mouse-move", linuxX11InputBackend: backend })) {
+    throw new Error("Failed to start the hook");
+  }
+
+  await injectAndDrain(type, WARMUP_COUNT, counter);
+  counter.value = 0;
+
+  const cpuBefore = process.cpuUsage();
+  await injectAndDrain(type, options.count, counter);
+  const cpu = process.cpuUsage(cpuBefore);
+  const delivered = counter.value;
+
+  hook.stop();
+  hook.cleanup();
+
+  const injected = options.count * input.inputs;
+  const cpuUs = cpu.user + cpu.system;
+
+  return {
+    backend,
+    type,
+    injected,
+    delivered,
+    "process µs/input": (cpuUs / injected).toFixed(2),
+    "process µs/event": delivered ? (cpuUs / delivered).toFixed(2) : "-",
+  };
+}
+
+async function main() {
+  if (process.platform !== "linux" || !process.env.DISPLAY) {
+    console.error("This benchmark only runs on Linux X11, e.g. under xvfb-run");
+    process.exit(1);
+  }
+
+  try {
+    execFileSync("xdotool", ["version"], { stdio: "ignore" });
+  } catch {
+    console.error("xdotool is required: install it with your package manager");
+    process.exit(1);
+  }
+
+  console.log(`Inputs per type: ${options.count}, DISPLAY=${process.env.DISPLAY}`);
+
+  const results = [];
+  for (const type of options.types) {
+    for (const backend of BACKENDS) {
+      results.push(await runBackend(backend, type));
+    }
+  }
+
+  console.table(results);
+}
+
+main().catch((err) => {
+  console.error(err);
+  process.exit(1);
+});
@@ -0,0 +1,308 @@
+/**
+ * Text Selection Hook - Soak Test (Linux)
+ *
+ * Runs the hook for a long time with synthetic input and repeated start/stop
+ * cycles, sampling the process RSS, open file descriptors, thread count and the
+ * native event counters (linuxGetStats()). Fails with exit code 1 when any of
+ * them grows beyond its threshold, so leaks in the native layer (event contexts,
+ * Wayland offers, DBus messages, X connections, threads) show up as numbers.
+ *
+ * Input sources:
+ * - Native event injection (always): mouse, keyboard and selection events fed
+ *   through the real delivery pipeline
+ * - xdotool (if installed): real pointer motion and clicks through XRecord
+ * - xclip (if installed): PRIMARY ownership changes through XFixes
+ *
+ * Usage:
+ *   npm run soak -- [--duration 3600] [--cycle 60] [--xvfb] [--csv soak.csv]
+ *
+ * Options:
+ *   --duration <s>        Total run time (default 3600)
+ *   --cycle <s>           Running time per start/stop cycle (default 60)
+ *   --inject-rate <n>     Injected events per second (default 200)
+ *   --xvfb                Start a private Xvfb server (:99) instead of using $DISPLAY
+ *   --rss-growth <MB>     Allowed RSS growth (default 20)
+ *   --fd-growth <n>       Allowed growth of open fds after stop() (default 0)
+ *   --thread-growth <n>   Allowed growth of threads after stop() (default 0)
+ *   --csv <path>          Write one sample per cycle as CSV
+ *
+ * Baselines are taken after two warm-up cycles. Run with --expose-gc (as the npm
+ * script does) so that RSS is sampled after a full GC.
+ */
+
+// ===========================
+// === Module Dependencies ===
+// ===========================
+const { spawn, spawnSync } = require("child_process");
+const fs = require("fs");
+
+// Event injection is test-only and must be enabled explicitly
+process.env.SELECTION_HOOK_TEST_INJECTION = "1";
+
+// ===========================
+// === Configuration ========
+// ===========================
+
+function parseArgs(argv) {
+  const options = {
+    duration: 3600,
+    cycle: 60,
+    injectRate: 200,
+    xvfb: false,
+    rssGrowthMB: 20,
+    fdGrowth: 0,
+    threadGrowth: 0,
+    csv: null,
+  };
+
+  for (let i = 0; i < argv.length; i++) {
+    switch (argv[i]) {
+      case "--duration":
+        options.duration = parseInt(argv[++i], 10);
+        break;
+      case "--cycle":
+        options.cycle = parseInt(argv[++i], 10);
+        break;
+      case "--inject-rate":
+        options.injectRate = parseInt(argv[++i], 10);
+        break;
+      case "--xvfb":
+        options.xvfb = true;
+        break;
+      case "--rss-growth":
+        options.rssGrowthMB = parseFloat(argv[++i]);
+        break;
+      case "--fd-growth":
+        options.fdGrowth = parseInt(argv[++i], 10);
+        break;
+      case "--thread-growth":
+        options.threadGrowth = parseInt(argv[++i], 10);
+        break;
+      case "--csv":
+        options.csv = argv[++i];
+        break;
+    }
+  }
+
+  return options;
+}
+
+const options = parseArgs(process.argv.slice(2));
+
+const WARMUP_CYCLES = 2;
+const STOPPED_PAUSE_MS = 2000; // time between stop() and the next start()
+const XVFB_DISPLAY = ":99";
+const INJECT_TYPES = ["mouse-move", "mouse-wheel", "mouse-click", "keyboard", "text-selection"];
+
+// ===========================
+// === Helpers ===============
+// ===========================
+
+const sleep = (ms) => new Promise((resolve) => setTimeout(resolve, ms));
+
+function hasCommand(command) {
+  return spawnSync("sh", ["-c", `command -v ${command}`], { stdio: "ignore" }).status === 0;
+}
+
+async function startXvfb() {
+  const xvfb = spawn("Xvfb", [XVFB_DISPLAY, "-screen", "0", "1280x800x24", "-nolisten", "tcp"], {
+    stdio: "ignore",
+  });
+  const socket = `/tmp/.X11-unix/X${XVFB_DISPLAY.slice(1)}`;
+
+  for (let i = 0; i < 50 && !fs.existsSync(socket); i++) {
+    await sleep(100);
+  }
+  if (!fs.existsSync(socket)) {
+    xvfb.kill();
+    throw new Error("Xvfb did not start");
+  }
+
+  process.env.DISPLAY = XVFB_DISPLAY;
+  delete process.env.WAYLAND_DISPLAY;
+  return xvfb;
+}
+
+// RSS (MB), open fds and threads of this process
+function sampleProcess() {
+  if (global.gc) global.gc();
+
+  const status = fs.readFileSync("/proc/self/status", "utf8");
+  const rssKB = parseInt(/VmRSS:\s+(\d+)/.exec(status)[1], 10);
+  const threads = parseInt(/Threads:\s+(\d+)/.exec(status)[1], 10);
+  const fds = fs.readdirSync("/proc/self/fd").length;
+
+  return { rssMB: rssKB / 1024, fds, threads };
+}
+
+function average(values) {
+  return values.reduce((sum, value) => sum + value, 0) / values.length;
+}
+
+// ===========================
+// === Synthetic Input =======
+// ===========================
+
+/**
+ * Drive all input sources while the hook is running; returns a stop function
+ */
+function startInput(hook) {
+  const timers = [];
+  let nextType = 0;
+
+  // Native injection, one event type per second in turn
+  timers.push(
+    setInterval(() => {
+      if (hook._isInjectingTestEvents()) return;
+      hook._injectTestEvents(INJECT_TYPES[nextType], options.injectRate, options.injectRate);
+      nextType = (nextType + 1) % INJECT_TYPES.length;
+    }, 1000)
+  );
+
+  if (hasCommand("xdotool")) {
+    timers.push(
+      setInterval(() => {
+        const x = 100 + Math.floor(Math.random() * 800);
+        const y = 100 + Math.floor(Math.random() * 500);
+        spawn("xdotool", ["mousemove", String(x), String(y), "click", "1"], { stdio: "ignore" });
+      }, 250)
+    );
+  }
+
+  if (hasCommand("xclip")) {
+    timers.push(
+      setInterval(() => {
+        const xclip = spawn("xclip", ["-selection", "primary", "-loops", "1"], {
+          stdio: ["pipe", "ignore", "ignore"],
+        });
+        xclip.stdin.end(`soak ${Date.now()}`);
+        setTimeout(() => xclip.kill(), 1000);
+      }, 2000)
+    );
+  }
+
+  return () => timers.forEach(clearInterval);
+}
+
+// ===========================
+// === Soak Test =============
+// ===========================
+
+async function main() {
+  if (process.platform !== "linux") {
+    console.error("The soak test only runs on Linux");
+    process.exit(1);
+  }
+
+  const xvfb = options.xvfb ? await startXvfb() : null;
+  const SelectionHook = require("../index.js");
+
+  const hook = new SelectionHook();
+  const delivered = { events: 0 };
+  for (const event of ["text-selection", "mouse-move", "mouse-down", "mouse-up", "mouse-wheel", "key-down", "key-up"]) {
+    hook.on(event, () => delivered.events++);
+  }
+
+  const csv = options.csv ? fs.createWriteStream(options.csv) : null;
+  csv?.write(
+    "cycle,elapsed_s,rss_mb,fds_running,threads_running,fds_stopped,threads_stopped," +
+      "delivered,dispatched,dropped,queue_high_water\n"
+  );
+
+  const runningSamples = [];
+  const stoppedSamples = [];
+  const failures = [];
+  const begin = Date.now();
+
+  for (let cycle = 0; (Date.now() - begin) / 1000 < options.duration; cycle++) {
+    if (!hook.start({ enableMouseMoveEvent: true })) {
+      failures.push(`start() failed in cycle ${cycle}`);
+      break;
+    }
+
+    const stopInput = startInput(hook);
+    await sleep(options.cycle * 1000);
+    stopInput();
+
+    // Let the last injection finish before sampling the running state
+    while (hook._isInjectingTestEvents()) await sleep(100);
+    await sleep(500);
+    const running = sampleProcess();
+
+    hook.stop();
+    await sleep(STOPPED_PAUSE_MS);
+    const stopped = sampleProcess();
+    const stats = hook.linuxGetStats();
+
+    if (stats.queueLength !== 0) {
+      failures.push(`cycle ${cycle}: ${stats.queueLength} events left in the queue after stop()`);
+    }
+
+    runningSamples.push(running);
+    stoppedSamples.push(stopped);
+
+    const elapsed = Math.round((Date.now() - begin) / 1000);
+    console.log(
+      `[cycle ${cycle}] ${elapsed}s rss=${running.rssMB.toFixed(1)}MB fds=${running.fds}/${stopped.fds} ` +
+        `threads=${running.threads}/${stopped.threads} delivered=${delivered.events} ` +
+        `dispatched=${stats.dispatchedEvents} dropped=${stats.droppedEvents} highWater=${stats.queueHighWater}`
+    );
+    csv?.write(
+      [
+        cycle,
+        elapsed,
+        running.rssMB.toFixed(1),
+        running.fds,
+        running.threads,
+        stopped.fds,
+        stopped.threads,
+        delivered.events,
+        stats.dispatchedEvents,
+        stats.droppedEvents,
+        stats.queueHighWater,
+      ].join(",") + "\n"
+    );
+  }
+
+  hook.cleanup();
+  csv?.end();
+  xvfb?.kill();
+
+  // Compare the first and last cycles after warm-up
+  if (runningSamples.length < WARMUP_CYCLES + 2) {
+    console.error(`Too few cycles for a verdict (${runningSamples.length}); increase --duration or lower --cycle`);
+    process.exit(1);
+  }
+
+  const span = Math.min(3, Math.floor((runningSamples.length - WARMUP_CYCLES) / 2));
+  const firstRss = average(runningSamples.slice(WARMUP_CYCLES, WARMUP_CYCLES + span).map((s) => s.rssMB));
+  const lastRss = average(runningSamples.slice(-span).map((s) => s.rssMB));
+  const baselineStopped = stoppedSamples[WARMUP_CYCLES];
+  const lastStopped = stoppedSamples[stoppedSamples.length - 1];
+
+  const rssGrowth = lastRss - firstRss;
+  const fdGrowth = lastStopped.fds - baselineStopped.fds;
+  const threadGrowth = lastStopped.threads - baselineStopped.threads;
+
+  if (rssGrowth > options.rssGrowthMB) failures.push(`RSS grew by ${rssGrowth.toFixed(1)} MB`);
+  if (fdGrowth > options.fdGrowth) failures.push(`open fds grew by ${fdGrowth} after stop()`);
+  if (threadGrowth > options.threadGrowth) failures.push(`threads grew by ${threadGrowth} after stop()`);
+
+  console.log(
+    `\nRSS ${firstRss.toFixed(1)} -> ${lastRss.toFixed(1)} MB, fds ${baselineStopped.fds} -> ${lastStopped.fds}, ` +
+      `threads ${baselineStopped.threads} -> ${lastStopped.threads}`
+  );
+
+  if (failures.length > 0) {
+    console.error("FAIL");
+    for (const failure of failures) console.error(`  - ${failure}`);
+    process.exit(1);
+  }
+
+  console.log("PASS");
+}
+
+main().catch((err) => {
+  console.error(err);
+  process.exit(1);
+});
@@ -50,6 +50,54 @@ export interface TextSelectionData {
   posLevel: (typeof SelectionHook.PositionLevel)[keyof typeof SelectionHook.PositionLevel];
   /** Whether the current app's front window is in fullscreen mode, macOS only */
   isFullscreen?: boolean;
+  /** Classification tags, Linux only and only when text classification is enabled */
+  tags?: TextTag[];
+  /** X11 display of the selection, only when the hook monitors explicit displays (Linux, see `linuxDisplays`) */
+  display?: string;
+}
+
+/**
+ * Tags set by Linux text classification: content tags, then script tags for
+ * each script with at least a quarter of the letters
+ */
+export type TextTag =
+  | "url"
+  | "email"
+  | "path"
+  | "number"
+  | "code"
+  | "multiline"
+  | "latin"
+  | "cyrillic"
+  | "greek"
+  | "arabic"
+  | "hebrew"
+  | "devanagari"
+  | "thai"
+  | "cjk"
+  | "hangul";
+
+/**
+ * Field names accepted by getSelectionSnapshot()
+ */
+export type SelectionSnapshotField = "text" | "programName" | "cursor" | "hasSelection" | "byteLength";
+
+/**
+ * Result of getSelectionSnapshot(); only the requested fields are present
+ */
+export interface SelectionSnapshot {
+  /** Selected text, or "" when there is no selection */
+  text?: string;
+  /** Program name of the active window, or "" when unknown */
+  programName?: string;
+  /** Current cursor position; -99999 (INVALID_COORDINATE) when unavailable */
+  cursor?: Point;
+  /** Whether a selection exists */
+  hasSelection?: boolean;
+  /** UTF-8 byte length of the selected text */
+  byteLength?: number;
+  /** X11 display read from, only when the hook monitors explicit displays (Linux, see `linuxDisplays`) */
+  display?: string;
 }
 
 /**
@@ -71,6 +119,30 @@ export interface MouseEventData {
    * Unknown = 99
    */
   button: number;
+  /** Source device id, XInput2 slave (Linux X11 with the "xinput2" input backend only) */
+  deviceId?: number;
+  /** X server time of the event in ms (Linux X11 with the "xinput2" input backend only) */
+  time?: number;
+  /** X11 display of the event, only when the hook monitors explicit displays (Linux, see `linuxDisplays`) */
+  display?: string;
+}
+
+/**
+ * Selection change event data structure (Linux only)
+ *
+ * Emitted on every selection owner change; the selected text is not read.
+ */
+export interface SelectionChangeEventData {
+  /** Time of the change, ms since the Unix epoch */
+  timestamp: number;
+  /** X11 window that owns the selection, 0 when unknown (always on Wayland) */
+  owner: number;
+  /** Program of the owner window, empty when unknown (always on Wayland) */
+  programName: string;
+  /** Whether a selection gesture (mouse button) was in progress: the selection may still grow */
+  isDragging: boolean;
+  /** X11 display of the event, only when the hook monitors explicit displays (Linux, see `linuxDisplays`) */
+  display?: string;
 }
 
 /**
@@ -95,6 +167,10 @@ export interface MouseWheelEventData {
    * -1: Down/Left
    */
   flag: number;
+  /** Wheel notches, signed like `flag`; fractional for smooth scrolling (Linux only) */
+  delta?: number;
+  /** X11 display of the event, only when the hook monitors explicit displays (Linux, see `linuxDisplays`) */
+  display?: string;
 }
 
 /**
@@ -126,6 +202,12 @@ export interface KeyboardEventData {
    * Linux: Modifier bitmask — 0x01 Shift, 0x02 Ctrl, 0x04 Alt, 0x08 Meta(Super)
    */
   flags: number;
+  /** Source device id, XInput2 slave (Linux X11 with the "xinput2" input backend only) */
+  deviceId?: number;
+  /** X server time of the event in ms (Linux X11 with the "xinput2" input backend only) */
+  time?: number;
+  /** X11 display of the event, only when the hook monitors explicit displays (Linux, see `linuxDisplays`) */
+  display?: string;
 }
 
 /**
@@ -135,11 +217,13 @@ export interface KeyboardEventData {
  * and its various features like mouse tracking and clipboard fallback.
  */
 export interface SelectionConfig {
-  /** Enable debug logging for warnings and errors */
+  /** Enable debug logging for warnings and errors; on Linux also emits "debug" events for native log entries */
   debug?: boolean;
   /** Enable high CPU usage mouse movement tracking */
   enableMouseMoveEvent?: boolean;
-  /** Enable clipboard fallback for text selection */
+  /** Linux only: emit "selection-change" events, see enableSelectionChangeEvent() */
+  enableSelectionChangeEvent?: boolean;
+  /** Enable clipboard fallback for text selection (default: true; false on Linux) */
   enableClipboard?: boolean;
   /** Enable passive mode where selection requires manual trigger */
   selectionPassiveMode?: boolean;
@@ -151,6 +235,114 @@ export interface SelectionConfig {
   clipboardFilterList?: string[];
   /** List of program names for global filter mode filtering */
   globalFilterList?: string[];
+  /** Linux X11 only: read selection change events on the Node event loop instead of a background thread */
+  linuxSelectionInLoop?: boolean;
+  /** Linux only: scheduling of the input monitoring threads, see linuxSetThreadScheduling() */
+  linuxThreadScheduling?: LinuxThreadScheduling | null;
+  /** Linux only: input devices to monitor, see linuxSetInputDeviceFilter() */
+  linuxInputDeviceFilter?: LinuxInputDeviceFilter | null;
+  /** Linux X11 only: source of input events (default "xrecord"), see linuxSetX11InputBackend() */
+  linuxX11InputBackend?: LinuxX11InputBackend;
+  /** Linux only: add classification tags to text-selection events, see linuxSetTextClassification() */
+  linuxTextClassification?: boolean;
+  /** Linux only: read selections through AT-SPI2 alongside PRIMARY, see linuxSetAtspi() */
+  linuxAtspi?: boolean;
+  /** Linux only: suspend while the session is locked or idle (default true), see linuxSetAutoSuspend() */
+  linuxAutoSuspend?: boolean;
+  /** Linux only: suspend while a fullscreen window is focused (default false), see linuxSetFullscreenSuspend() */
+  linuxFullscreenSuspend?: boolean;
+  /** Linux only: programs whose fullscreen windows keep the hook running, see linuxSetFullscreenSuspend() */
+  linuxFullscreenKeepRunningList?: string[];
+  /** Linux only: native history of emitted selections, see setSelectionHistory() */
+  selectionHistory?: SelectionHistoryOptions | null;
+}
+
+/**
+ * Options of the SelectionHook constructor
+ */
+export interface SelectionHookOptions {
+  /**
+   * Linux X11 only: displays to monitor at once instead of $DISPLAY, e.g. [":10", ":11"].
+   * Each display has its own gesture and selection state; events are tagged with `display`.
+   */
+  linuxDisplays?: string[];
+}
+
+/**
+ * Limits of the native selection history
+ */
+export interface SelectionHistoryOptions {
+  /** Maximum number of entries (default 100) */
+  maxEntries?: number;
+  /** Maximum bytes of stored text, program names included (default 1 MB) */
+  maxBytes?: number;
+}
+
+/**
+ * Entry of the native selection history
+ */
+export interface SelectionHistoryEntry {
+  /** Increases with every new entry */
+  id: number;
+  /** Selected text */
+  text: string;
+  /** Program name, empty when unknown */
+  programName: string;
+  /** When the selection was last emitted (ms since the epoch) */
+  timestamp: number;
+  /** When the selection was first emitted (ms since the epoch) */
+  firstTimestamp: number;
+  /** Number of consecutive emissions of the same selection */
+  count: number;
+  /** X11 display of the selection, only when the hook monitors explicit displays (Linux, see `linuxDisplays`) */
+  display?: string;
+}
+
+/**
+ * Source of input events on Linux X11, see linuxSetX11InputBackend()
+ */
+export type LinuxX11InputBackend = "xrecord" | "xinput2";
+
+/**
+ * Scheduling options for the Linux input monitoring threads
+ */
+export interface LinuxThreadScheduling {
+  /** Nice value of the input threads (-20..19); values below 0 need CAP_SYS_NICE or RLIMIT_NICE */
+  nice?: number;
+  /** Use SCHED_RR at minimum priority when permitted; falls back to `nice` otherwise */
+  realtime?: boolean;
+  /** CPU affinity of the input threads, e.g. [0, 1] */
+  cpus?: number[];
+}
+
+/**
+ * Input device rule for linuxSetInputDeviceFilter(); omitted fields match any device
+ */
+export interface LinuxInputDeviceRule {
+  /** Case-insensitive substring of the device name, e.g. "logitech" */
+  name?: string;
+  /** Bus type (BUS_* from linux/input.h), e.g. 0x03 for USB, 0x05 for Bluetooth, 0x06 for virtual */
+  bus?: number;
+  /** USB/Bluetooth vendor id */
+  vendor?: number;
+  /** USB/Bluetooth product id */
+  product?: number;
+  /** Device classes, any of which must be present */
+  classes?: ("mouse" | "keyboard" | "touchpad" | "tablet" | "gamepad")[];
+}
+
+/**
+ * Input devices to monitor on Linux
+ */
+export interface LinuxInputDeviceFilter {
+  /** When not empty, only devices matching one of these rules are monitored */
+  allow?: LinuxInputDeviceRule[];
+  /** Devices matching one of these rules are never monitored; wins over allow */
+  deny?: LinuxInputDeviceRule[];
+  /** Skip virtual (uinput) devices, e.g. remapping daemons, remote desktop or automation tools */
+  excludeVirtual?: boolean;
+  /** X11: drop events synthesized through XTest (xdotool, automation, remote desktop) */
+  excludeXTest?: boolean;
 }
 
 /**
@@ -167,6 +359,122 @@ export interface LinuxEnvInfo {
   isRoot: boolean;
 }
 
+/**
+ * Native event counters returned by linuxGetStats(), cumulative since construction
+ */
+export interface LinuxStats {
+  /** Successful start() calls */
+  starts: number;
+  /** Mouse events queued by the input thread */
+  mouseEvents: number;
+  /** Keyboard events queued by the input thread */
+  keyboardEvents: number;
+  /** Selection change events queued (not suppressed by a drag) */
+  selectionChanges: number;
+  /** Events dropped because the native queue was full */
+  droppedEvents: number;
+  /** Events handled on the Node event loop */
+  dispatchedEvents: number;
+  /** text-selection events delivered to JS */
+  selectionsEmitted: number;
+  /** Reads that started the second selection source (AT-SPI2 or PRIMARY) while the first was pending */
+  hedgedReads: number;
+  /** Hedged reads answered by the second source */
+  hedgeSecondaryWins: number;
+  /** Events currently waiting to be dispatched */
+  queueLength: number;
+  /** Largest queue length seen */
+  queueHighWater: number;
+}
+
+/**
+ * Native diagnostic log entry (Linux only), from linuxDrainLog() or the "debug" event
+ */
+export interface LinuxLogEntry {
+  /** Write order; a gap means older entries were overwritten before they were drained */
+  seq: number;
+  level: "error" | "warn" | "info" | "debug";
+  /** Monotonic clock (CLOCK_MONOTONIC) in ms, not the Unix epoch */
+  timestamp: number;
+  message: string;
+}
+
+/**
+ * Events that a SelectionHookClient can subscribe to
+ */
+export type DaemonEventName =
+  | "text-selection"
+  | "mouse-move"
+  | "mouse-down"
+  | "mouse-up"
+  | "mouse-wheel"
+  | "key-down"
+  | "key-up";
+
+/**
+ * Subscription filter for SelectionHookClient
+ */
+export interface DaemonSubscriptionFilter {
+  /** Events to receive (default: ["text-selection"]) */
+  events?: DaemonEventName[];
+  /** Only receive text-selection events from these programs (case-insensitive substring match) */
+  programs?: string[];
+  /** Never receive text-selection events from these programs (case-insensitive substring match) */
+  excludePrograms?: string[];
+}
+
+/**
+ * Options for SelectionHookClient.connect()
+ */
+export interface DaemonConnectOptions extends DaemonSubscriptionFilter {
+  /** Daemon socket path (default: $XDG_RUNTIME_DIR/selection-hook.sock) */
+  socketPath?: string;
+  /** Log errors and debug messages to the console (default: false) */
+  debug?: boolean;
+}
+
+/**
+ * SelectionHookClient - Subscriber for the selection-hook daemon
+ *
+ * Receives the same events as SelectionHook, with the same data shapes, from a
+ * daemon (`selection-hook-daemon`) shared by all apps in the session.
+ */
+declare class SelectionHookClient extends EventEmitter {
+  /**
+   * Connect to the daemon and subscribe
+   *
+   * @param options Socket path and subscription filter
+   * @returns Resolves true once subscribed, false on failure
+   */
+  connect(options?: DaemonConnectOptions): Promise<boolean>;
+
+  /**
+   * Replace the subscription filter of a connected client
+   *
+   * @param filter New subscription filter (omitted fields keep their current value)
+   * @returns Success status
+   */
+  subscribe(filter: DaemonSubscriptionFilter): boolean;
+
+  /** Disconnect from the daemon */
+  disconnect(): void;
+
+  /** Check if connected and subscribed */
+  isConnected(): boolean;
+
+  on(event: "text-selection", listener: (data: TextSelectionData) => void): this;
+  on(event: "mouse-up" | "mouse-down" | "mouse-move", listener: (data: MouseEventData) => void): this;
+  on(event: "mouse-wheel", listener: (data: MouseWheelEventData) => void): this;
+  on(event: "key-down" | "key-up", listener: (data: KeyboardEventData) => void): this;
+  on(event: "status", listener: (status: string) => void): this;
+  on(event: "error", listener: (error: Error) => void): this;
+
+  /**
+   * Emitted for native diagnostic log entries while started with `debug: true` (Linux only)
+   */
+  on(event: "debug", listener: (entry: LinuxLogEntry) => void): this;
+}
+
 /**
  * SelectionHook - Main class for text selection monitoring
  *
@@ -181,7 +489,7 @@ declare class SelectionHook extends EventEmitter {
     FOCUSCTL: 2;
     ACCESSIBLE: 3;
     AXAPI: 11;
-    /** @reserved AT-SPI method is reserved for future use */
+    /** AT-SPI2 accessible text (Linux, see linuxSetAtspi()) */
     ATSPI: 21;
     PRIMARY: 22;
     CLIPBOARD: 99;
@@ -246,6 +554,16 @@ declare class SelectionHook extends EventEmitter {
     COSMIC_COMP: 6;
   };
 
+  /** Subscriber for the out-of-process selection-hook daemon */
+  static Client: typeof SelectionHookClient;
+
+  /**
+   * Create a hook for the display of the environment, or for several X11 displays at once
+   *
+   * @param options Optional constructor options, see SelectionHookOptions
+   */
+  constructor(options?: SelectionHookOptions | null);
+
   /**
    * Start monitoring text selections
    *
@@ -286,11 +604,48 @@ declare class SelectionHook extends EventEmitter {
    *
    * Retrieves the current text selection, if any exists.
    * Returns null if no text is currently selected or hook isn't running.
+   * With several displays (`linuxDisplays`), reads the display of the latest click or key press.
    *
    * @returns Current selection data or null if no selection exists
    */
   getCurrentSelection(): TextSelectionData | null;
 
+  /**
+   * Get only the requested fields of the current selection
+   *
+   * Skips the work behind fields that were not requested (active window and
+   * program name lookup, cursor query, text transfer). On Linux, `hasSelection`
+   * and `byteLength` without `text` are answered from the selection owner/offer
+   * where possible. On Windows and macOS the snapshot is derived from a full
+   * getCurrentSelection() read and `cursor` is not available. With several displays
+   * (`linuxDisplays`), reads the display of the latest click or key press.
+   *
+   * @param options.fields Fields to read (default: all)
+   * @returns Object with the requested fields, or null if the hook isn't running
+   */
+  getSelectionSnapshot(options?: { fields?: SelectionSnapshotField[] }): SelectionSnapshot | null;
+
+  /**
+   * Keep a native history of emitted selections (Linux only)
+   *
+   * Each distinct text is stored once; a selection repeated back to back only
+   * increments the count of the newest entry. The oldest entries are evicted
+   * beyond maxEntries or maxBytes. Kept across stop()/start(). Disabled by default.
+   *
+   * @param options History limits; null disables the history and frees it
+   * @returns Success status, false on non-Linux platforms
+   */
+  setSelectionHistory(options: SelectionHistoryOptions | null): boolean;
+
+  /**
+   * Get entries of the selection history, newest first (Linux only)
+   *
+   * @param options.since Only entries last emitted after this time (ms since the epoch, default 0)
+   * @param options.limit Maximum number of entries (default 0 = all)
+   * @returns History entries, or null on non-Linux platforms
+   */
+  getSelectionHistory(options?: { since?: number; limit?: number }): SelectionHistoryEntry[] | null;
+
   /**
    * Enable mousemove events (high CPU usage)
    *
@@ -313,6 +668,27 @@ declare class SelectionHook extends EventEmitter {
    */
   disableMouseMoveEvent(): boolean;
 
+  /**
+   * Enable selection-change events (Linux only)
+   *
+   * Emits "selection-change" on every selection owner change, including changes
+   * during a drag, with the time and the owner where known. The selected text is
+   * not read, so this is the cheapest signal that the selection changed.
+   * Can be called before start().
+   *
+   * @returns Success status (false on non-Linux)
+   */
+  enableSelectionChangeEvent(): boolean;
+
+  /**
+   * Disable selection-change events (Linux only)
+   *
+   * This is the default state.
+   *
+   * @returns Success status (false on non-Linux)
+   */
+  disableSelectionChangeEvent(): boolean;
+
   /**
    * Enable clipboard fallback for text selection
    *
@@ -320,6 +696,8 @@ declare class SelectionHook extends EventEmitter {
    * This might modify clipboard contents.
    * Can be called before start().
    *
+   * Linux: X11 only, disabled by default. The previous clipboard text is restored afterwards.
+   *
    * @returns Success status (true if enabled successfully)
    */
   enableClipboard(): boolean;
@@ -457,6 +835,135 @@ declare class SelectionHook extends EventEmitter {
    */
   linuxGetEnvInfo(): LinuxEnvInfo | null;
 
+  /**
+   * Get the native event counters (Linux only)
+   *
+   * Counters are cumulative since construction and survive stop()/start() cycles.
+   *
+   * @returns {LinuxStats | null} Stats or null on non-Linux
+   */
+  linuxGetStats(): LinuxStats | null;
+
+  /**
+   * Take the native diagnostic log entries written since the last drain (Linux only)
+   *
+   * Native errors, warnings and setup notes are kept in a lock-free in-memory ring of
+   * the last 256 entries instead of being printed to stderr. With `debug: true` they
+   * are also emitted as "debug" events.
+   *
+   * @returns {LinuxLogEntry[] | null} Entries, oldest first, or null on non-Linux
+   */
+  linuxDrainLog(): LinuxLogEntry[] | null;
+
+  /**
+   * Read selection change events on the Node event loop (Linux X11, or Wayland via XWayland)
+   *
+   * When enabled, the XFixes connection is polled by the Node event loop instead of
+   * a background thread, removing a thread hop per selection change.
+   * Takes effect at the next start(). No effect with Wayland data-control; applies
+   * on Wayland only in the XWayland hybrid mode (e.g. GNOME).
+   *
+   * @param {boolean} enabled - Whether to use in-loop selection events
+   * @returns {boolean} Success status (false on non-Linux)
+   */
+  linuxSetSelectionInLoop(enabled: boolean): boolean;
+
+  /**
+   * Add classification tags to text-selection events (Linux only)
+   *
+   * When enabled, selection data carries a `tags` array (url, email, path, number,
+   * code, multiline and the scripts of the text), computed natively over at most
+   * the first 64 KiB of the text before the event is delivered.
+   *
+   * @param {boolean} enabled - Whether to classify selections
+   * @returns {boolean} Success status (false on non-Linux)
+   */
+  linuxSetTextClassification(enabled: boolean): boolean;
+
+  /**
+   * Read selections through AT-SPI2 alongside PRIMARY, hedged (Linux only)
+   *
+   * Listens for text selection changes on the accessibility bus. When a gesture is
+   * confirmed and the focused accessible reported a selection since it started, the
+   * text is read from AT-SPI2 (method ATSPI) and, on X11, the selection corners are
+   * filled in (posLevel SEL_FULL). Falls back to PRIMARY otherwise. Needs libdbus-1
+   * and applications with accessibility enabled. Takes effect at the next start().
+   *
+   * @param {boolean} enabled - Whether to use the AT-SPI2 selection source
+   * @returns {boolean} Success status (false on non-Linux)
+   */
+  linuxSetAtspi(enabled: boolean): boolean;
+
+  /**
+   * Suspend input and selection events while the session is idle or locked (Linux only)
+   *
+   * Watches LockedHint and IdleHint of the logind session and, on X11, the screen saver.
+   * While any of them is set, the input threads drop events before decoding them, no
+   * gestures are detected and no selections are read. Emits "status" with "suspended"
+   * and "resumed". On by default; needs libdbus-1 and a logind session, or the X11
+   * MIT-SCREEN-SAVER extension, and stays active without them. Takes effect at the next start().
+   *
+   * @param {boolean} enabled - Whether to suspend automatically
+   * @returns {boolean} Success status (false on non-Linux)
+   */
+  linuxSetAutoSuspend(enabled: boolean): boolean;
+
+  /**
+   * Suspend input and selection events while a fullscreen window is focused (Linux only)
+   *
+   * Meant for games, where high-rate mouse input would otherwise be read and queued for
+   * nothing. Fullscreen is known from _NET_WM_STATE on X11 and XWayland, and from
+   * wlr-foreign-toplevel-management on wlroots compositors. Emits "status" with "suspended"
+   * and "resumed". Off by default. Takes effect at the next start().
+   *
+   * @param {boolean} enabled - Whether to suspend while a fullscreen window is focused
+   * @param {string[]} keepRunningList - Programs whose fullscreen windows keep the hook running
+   * @returns {boolean} Success status (false on non-Linux)
+   */
+  linuxSetFullscreenSuspend(enabled: boolean, keepRunningList?: string[]): boolean;
+
+  /**
+   * Set scheduling of the input monitoring threads (Linux only)
+   *
+   * Raises the priority or pins the CPUs of the threads that read input and selection
+   * events, so that gestures are still correlated in time under heavy CPU load.
+   * Threads are always named (sh-xrecord, sh-xi2, sh-xfixes, sh-x11, sh-evdev, sh-wl-selection) for perf/htop.
+   * Takes effect at the next start(). Failures (e.g. missing privileges) are not fatal.
+   *
+   * @param {LinuxThreadScheduling | null} options - Scheduling options, null to reset
+   * @returns {boolean} Success status (false on non-Linux)
+   */
+  linuxSetThreadScheduling(options: LinuxThreadScheduling | null): boolean;
+
+  /**
+   * Set the input devices to monitor (Linux only)
+   *
+   * On Wayland the hook reads /dev/input devices directly: devices that match a deny rule,
+   * or no allow rule when there are any, are not opened, and excludeVirtual skips uinput
+   * devices. Skipped devices are logged. On X11 the server reads the devices, so only
+   * excludeXTest applies: events generated by XTestFakeInput requests are dropped.
+   * Takes effect at the next start().
+   *
+   * @param {LinuxInputDeviceFilter | null} options - Device filter, null to monitor all devices
+   * @returns {boolean} Success status (false on non-Linux)
+   */
+  linuxSetInputDeviceFilter(options: LinuxInputDeviceFilter | null): boolean;
+
+  /**
+   * Set the source of input events on X11 (Linux only)
+   *
+   * "xrecord" (default) records the core input events through an XRecord context.
+   * "xinput2" reads XInput2 raw events on the root window instead, on the connection that
+   * already reads smooth scrolling, without opening an XRecord context: mouse and keyboard
+   * events then carry `deviceId` and `time`, and pointer motion read at once is delivered
+   * as one mouse-move event. Falls back to XRecord without XInput 2.1. Ignored on Wayland.
+   * Takes effect at the next start().
+   *
+   * @param {LinuxX11InputBackend} backend - Input backend
+   * @returns {boolean} Success status (false on non-Linux or for an unknown backend)
+   */
+  linuxSetX11InputBackend(backend: LinuxX11InputBackend): boolean;
+
   /**
    * Release resources
    *
@@ -483,10 +990,19 @@ declare class SelectionHook extends EventEmitter {
   on(event: "mouse-move", listener: (data: MouseEventData) => void): this;
   on(event: "mouse-wheel", listener: (data: MouseWheelEventData) => void): this;
 
+  /**
+   * Emitted when the selection changes, without its text (Linux only, see enableSelectionChangeEvent())
+   */
+  on(event: "selection-change", listener: (data: SelectionChangeEventData) => void): this;
+
   on(event: "key-down", listener: (data: KeyboardEventData) => void): this;
   on(event: "key-up", listener: (data: KeyboardEventData) => void): this;
 
-  on(event: "status", listener: (status: string) => void): this;
+  /**
+   * "started", "stopped", and on Linux "suspended"/"resumed" (see linuxSetAutoSuspend(), linuxSetFullscreenSuspend()),
+   * with the display when the hook monitors explicit displays
+   */
+  on(event: "status", listener: (status: string, display?: string) => void): this;
   on(event: "error", listener: (error: Error) => void): this;
 
   // Same events available with once() for one-time listeners
@@ -495,10 +1011,12 @@ declare class SelectionHook extends EventEmitter {
   once(event: "mouse-down", listener: (data: MouseEventData) => void): this;
   once(event: "mouse-move", listener: (data: MouseEventData) => void): this;
   once(event: "mouse-wheel", listener: (data: MouseWheelEventData) => void): this;
+  once(event: "selection-change", listener: (data: SelectionChangeEventData) => void): this;
   once(event: "key-down", listener: (data: KeyboardEventData) => void): this;
   once(event: "key-up", listener: (data: KeyboardEventData) => void): this;
-  once(event: "status", listener: (status: string) => void): this;
+  once(event: "status", listener: (status: string, display?: string) => void): this;
   once(event: "error", listener: (error: Error) => void): this;
+  once(event: "debug", listener: (entry: LinuxLogEntry) => void): this;
 }
 
 /**
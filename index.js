@@ -10,7 +10,9 @@
 
 const EventEmitter = require("events");
 const gypBuild = require("node-gyp-build");
+const net = require("net");
 const path = require("path");
+const daemonProtocol = require("./daemon-protocol.js");
 
 const isWindows = process.platform === "win32";
 const isMac = process.platform === "darwin";
@@ -29,9 +31,207 @@ try {
   console.error("[selection-hook] Failed to load native module:", err.message);
 }
 
+// Field bits for getSelectionSnapshot() (SNAPSHOT_* in selection_core.h)
+const SNAPSHOT_FIELDS = {
+  text: 0x01,
+  programName: 0x02,
+  cursor: 0x04,
+  hasSelection: 0x08,
+  byteLength: 0x10,
+};
+
+// Input backends for linuxSetX11InputBackend() (X11InputBackend in common.h)
+const X11_INPUT_BACKENDS = {
+  xrecord: 0,
+  xinput2: 1,
+};
+
+// Event kinds for the test-only injectTestEvents() (InjectEventKind in selection_core.h)
+const INJECT_EVENT_KINDS = {
+  "mouse-move": 0,
+  "mouse-wheel": 1,
+  "mouse-click": 2,
+  keyboard: 3,
+  "text-selection": 4,
+};
+
+/**
+ * Subscriber for the selection-hook daemon (daemon.js)
+ *
+ * Receives the same events as SelectionHook, with the same data shapes, from a
+ * daemon shared by all apps in the session. Does not load input sources itself.
+ */
+class SelectionHookClient extends EventEmitter {
+  /** @type {net.Socket | null} */
+  #socket = null;
+  #connected = false;
+  #debug = false;
+  /** @type {{ events: string[], programs: string[], excludePrograms: string[] }} */
+  #filter = { events: ["text-selection"], programs: [], excludePrograms: [] };
+
+  /**
+   * Connect to the daemon and subscribe
+   * @param {object} [options]
+   * @param {string} [options.socketPath] - Daemon socket path (default: $XDG_RUNTIME_DIR/selection-hook.sock)
+   * @param {string[]} [options.events] - Events to receive (default: ["text-selection"])
+   * @param {string[]} [options.programs] - Only receive text-selection events from these programs
+   * @param {string[]} [options.excludePrograms] - Never receive text-selection events from these programs
+   * @param {boolean} [options.debug] - Log errors and debug messages to the console
+   * @returns {Promise<boolean>} Resolves true once subscribed, false on failure
+   */
+  connect(options = {}) {
+    this.#debug = !!options.debug;
+
+    if (this.#socket) {
+      this.#logDebug("Already connected to daemon");
+      return Promise.resolve(this.#connected);
+    }
+
+    if (!this.#setFilter(options)) return Promise.resolve(false);
+
+    const socketPath = options.socketPath || daemonProtocol.defaultSocketPath();
+
+    return new Promise((resolve) => {
+      const socket = net.connect(socketPath);
+      const decoder = new daemonProtocol.FrameDecoder();
+      this.#socket = socket;
+
+      socket.on("data", (chunk) => {
+        try {
+          for (const frame of decoder.push(chunk)) {
+            if (frame.type === daemonProtocol.FrameType.HELLO) {
+              const version = frame.payload.readUInt16LE(0);
+              if (version !== daemonProtocol.PROTOCOL_VERSION) {
+                throw new Error(`Unsupported daemon protocol version ${version}`);
+              }
+              socket.write(daemonProtocol.encodeSubscribe(this.#filter));
+              this.#connected = true;
+              this.emit("status", "connected");
+              resolve(true);
+              continue;
+            }
+
+            const event = daemonProtocol.decodeEvent(frame.type, frame.payload);
+            if (event) {
+              this.emit(event[0], event[1]);
+            }
+          }
+        } catch (err) {
+          this.#handleError("Failed to process daemon data", /** @type {Error} */ (err));
+          socket.destroy();
+        }
+      });
+
+      socket.on("error", (err) => {
+        this.#handleError("Daemon connection error", err);
+      });
+
+      socket.on("close", () => {
+        const wasConnected = this.#connected;
+        this.#socket = null;
+        this.#connected = false;
+        if (wasConnected) {
+          this.emit("status", "disconnected");
+        }
+        resolve(false);
+      });
+    });
+  }
+
+  /**
+   * Replace the subscription filter of a connected client
+   * @param {object} filter
+   * @param {string[]} [filter.events]
+   * @param {string[]} [filter.programs]
+   * @param {string[]} [filter.excludePrograms]
+   * @returns {boolean} Success status
+   */
+  subscribe(filter) {
+    if (!this.#socket || !this.#connected) {
+      this.#logDebug("Not connected to daemon");
+      return false;
+    }
+
+    if (!this.#setFilter(filter)) return false;
+
+    this.#socket.write(daemonProtocol.encodeSubscribe(this.#filter));
+    return true;
+  }
+
+  /**
+   * Disconnect from the daemon
+   */
+  disconnect() {
+    if (this.#socket) {
+      this.#socket.end();
+    }
+  }
+
+  /**
+   * Check if connected and subscribed
+   * @returns {boolean} Connection status
+   */
+  isConnected() {
+    return this.#connected;
+  }
+
+  /**
+   * @param {{ events?: string[], programs?: string[], excludePrograms?: string[] }} filter
+   */
+  #setFilter(filter) {
+    const events = filter.events ?? this.#filter.events;
+    const programs = filter.programs ?? this.#filter.programs;
+    const excludePrograms = filter.excludePrograms ?? this.#filter.excludePrograms;
+
+    if (!Array.isArray(events) || !Array.isArray(programs) || !Array.isArray(excludePrograms)) {
+      this.#handleError("Events and program lists must be arrays", new Error("Invalid argument"));
+      return false;
+    }
+
+    const invalid = events.find((event) => !daemonProtocol.SUBSCRIBABLE_EVENTS.includes(event));
+    if (invalid !== undefined) {
+      this.#handleError(`Invalid event: ${invalid}`, new Error("Invalid argument"));
+      return false;
+    }
+
+    this.#filter = { events, programs, excludePrograms };
+    return true;
+  }
+
+  /**
+   * @param {string} message
+   * @param {Error} err
+   */
+  #handleError(message, err) {
+    const errorMsg = `${message}: ${err.message}`;
+    if (this.#debug || _debugFlag) {
+      console.error("[selection-hook] ", errorMsg);
+    }
+
+    // Reported whenever someone listens; an unhandled "error" event would throw
+    if (this.listenerCount("error") > 0) {
+      this.emit("error", new Error(errorMsg));
+    }
+  }
+
+  /**
+   * @param {string} message
+   */
+  #logDebug(message) {
+    if (this.#debug || _debugFlag) {
+      console.warn("[selection-hook] ", message);
+    }
+  }
+}
+
 class SelectionHook extends EventEmitter {
   #instance = null;
   #running = false;
+  /** @type {string[] | null} X11 displays monitored instead of $DISPLAY (Linux) */
+  #displays = null;
+
+  /** Subscriber for the out-of-process selection-hook daemon (daemon.js) */
+  static Client = SelectionHookClient;
 
   static SelectionMethod = {
     NONE: 0,
@@ -40,7 +240,7 @@ class SelectionHook extends EventEmitter {
     FOCUSCTL: 2,
     ACCESSIBLE: 3,
     AXAPI: 11,
-    /** @reserved AT-SPI method is reserved for future use */
+    /** AT-SPI2 accessible text (Linux, see linuxSetAtspi()) */
     ATSPI: 21,
     PRIMARY: 22,
     CLIPBOARD: 99,
@@ -95,15 +295,23 @@ class SelectionHook extends EventEmitter {
     COSMIC_COMP: 6,
   };
 
-  constructor() {
+  /**
+   * @param {object} [options]
+   * @param {string[]} [options.linuxDisplays] - X11 displays to monitor at once instead of $DISPLAY
+   *   (Linux), e.g. [":10", ":11"]; events are tagged with their display
+   */
+  constructor(options = null) {
     if (!nativeModule) {
       throw new Error(
         "[selection-hook] Native module failed to load - only works on Windows, macOS, and Linux"
       );
     }
     super();
+    if (isLinux && options?.linuxDisplays?.length) {
+      this.#displays = [...options.linuxDisplays];
+    }
     try {
-      this.#instance = new nativeModule.TextSelectionHook();
+      this.#instance = this.#createInstance();
     } catch (err) {
       throw new Error(`[selection-hook] Failed to create native instance: ${err.message}`);
     }
@@ -126,7 +334,7 @@ class SelectionHook extends EventEmitter {
 
     if (!this.#instance) {
       try {
-        this.#instance = new nativeModule.TextSelectionHook();
+        this.#instance = this.#createInstance();
       } catch (err) {
         this.#handleError("Failed to create hook instance", err);
         return false;
@@ -150,24 +358,53 @@ class SelectionHook extends EventEmitter {
               }
               break;
             case "mouse-event":
-              if (data.action === "mouse-wheel") {
-                const { x, y, button, flag } = data;
-                this.emit(data.action, { x, y, button, flag });
-              } else {
-                const { x, y, button } = data;
-                this.emit(data.action, { x, y, button });
+              {
+                let mouseData;
+                if (data.action === "mouse-wheel") {
+                  const { x, y, button, flag, delta } = data;
+                  mouseData = delta === undefined ? { x, y, button, flag } : { x, y, button, flag, delta };
+                } else {
+                  const { x, y, button, deviceId, time } = data;
+                  mouseData = deviceId === undefined ? { x, y, button } : { x, y, button, deviceId, time };
+                }
+                if (data.display !== undefined) mouseData.display = data.display;
+                this.emit(data.action, mouseData);
+              }
+              break;
+            case "selection-change":
+              {
+                const { timestamp, owner, programName, isDragging } = data;
+                const changeData = { timestamp, owner, programName, isDragging };
+                if (data.display !== undefined) changeData.display = data.display;
+                this.emit("selection-change", changeData);
               }
               break;
             case "keyboard-event":
               {
-                const { uniKey, vkCode, sys, scanCode, flags } = data;
+                const { uniKey, vkCode, sys, scanCode, flags, deviceId, time } = data;
                 const keyData = { uniKey, vkCode, sys, flags };
                 if (scanCode !== undefined) keyData.scanCode = scanCode;
+                if (deviceId !== undefined) {
+                  keyData.deviceId = deviceId;
+                  keyData.time = time;
+                }
+                if (data.display !== undefined) keyData.display = data.display;
                 this.emit(data.action, keyData);
               }
               break;
+            case "debug":
+              {
+                const { seq, level, timestamp, message } = data;
+                this.#logDebug(`[native] ${message}`);
+                this.emit("debug", { seq, level, timestamp, message });
+              }
+              break;
             case "status":
-              this.emit("status", data.status);
+              if (data.display !== undefined) {
+                this.emit("status", data.status, data.display);
+              } else {
+                this.emit("status", data.status);
+              }
               break;
             case "error":
               this.emit("error", new Error(data.error));
@@ -178,6 +415,11 @@ class SelectionHook extends EventEmitter {
         }
       };
 
+      // Native diagnostic log entries are delivered as "debug" events while debugging
+      if (isLinux) {
+        this.#instance.linuxSetLogEvents(_debugFlag);
+      }
+
       this.#instance.start(callback);
       this.#running = true;
       this.emit("status", "started");
@@ -229,6 +471,104 @@ class SelectionHook extends EventEmitter {
     }
   }
 
+  /**
+   * Get only the requested fields of the current selection
+   * @param {object} [options]
+   * @param {string[]} [options.fields] - Fields to read: "text", "programName", "cursor",
+   *   "hasSelection", "byteLength" (default: all)
+   * @returns {object|null} Object with the requested fields, or null
+   */
+  getSelectionSnapshot(options = {}) {
+    if (!this.#instance || !this.#running) {
+      this.#logDebug("Text selection hook not running");
+      return null;
+    }
+
+    const fields = options?.fields ?? Object.keys(SNAPSHOT_FIELDS);
+    let mask = 0;
+    for (const field of fields) {
+      if (!(field in SNAPSHOT_FIELDS)) {
+        this.#handleError("Failed to get selection snapshot", new Error(`Unknown field: ${field}`));
+        return null;
+      }
+      mask |= SNAPSHOT_FIELDS[field];
+    }
+
+    try {
+      if (isLinux) {
+        return this.#instance.getSelectionSnapshot(mask);
+      }
+
+      // Windows/macOS: derived from a full read
+      const data = this.#instance.getCurrentSelection();
+      const snapshot = {};
+      if (mask & SNAPSHOT_FIELDS.text) snapshot.text = data ? data.text : "";
+      if (mask & SNAPSHOT_FIELDS.programName) snapshot.programName = data ? data.programName : "";
+      if (mask & SNAPSHOT_FIELDS.cursor) {
+        snapshot.cursor = { x: SelectionHook.INVALID_COORDINATE, y: SelectionHook.INVALID_COORDINATE };
+      }
+      if (mask & SNAPSHOT_FIELDS.hasSelection) snapshot.hasSelection = !!data;
+      if (mask & SNAPSHOT_FIELDS.byteLength) snapshot.byteLength = data ? Buffer.byteLength(data.text, "utf8") : 0;
+      return snapshot;
+    } catch (err) {
+      this.#handleError("Failed to get selection snapshot", err);
+      return null;
+    }
+  }
+
+  /**
+   * Keep a native history of emitted selections (Linux only). Each distinct text is stored
+   * once; a selection repeated back to back only increments the count of the newest entry.
+   * Kept across stop()/start(). Disabled by default.
+   * @param {object|null} options - History limits; null disables the history and frees it
+   * @param {number} [options.maxEntries=100] - Maximum number of entries
+   * @param {number} [options.maxBytes=1048576] - Maximum bytes of stored text (program names included)
+   * @returns {boolean} Success status
+   */
+  setSelectionHistory(options) {
+    if (!isLinux) {
+      this.#logDebug("setSelectionHistory is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      if (options) {
+        this.#instance.setSelectionHistory(options.maxEntries ?? 100, options.maxBytes ?? 1024 * 1024);
+      } else {
+        this.#instance.setSelectionHistory(0, 0);
+      }
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set selection history", err);
+      return false;
+    }
+  }
+
+  /**
+   * Get entries of the selection history, newest first (Linux only)
+   * @param {object} [options]
+   * @param {number} [options.since=0] - Only entries last seen after this time (ms since the epoch)
+   * @param {number} [options.limit=0] - Maximum number of entries, 0 = all
+   * @returns {object[]|null} History entries, or null
+   */
+  getSelectionHistory(options = {}) {
+    if (!isLinux) {
+      this.#logDebug("getSelectionHistory is only supported on Linux");
+      return null;
+    }
+
+    if (!this.#checkInstance()) return null;
+
+    try {
+      return this.#instance.getSelectionHistory(options?.since ?? 0, options?.limit ?? 0);
+    } catch (err) {
+      this.#handleError("Failed to get selection history", err);
+      return null;
+    }
+  }
+
   /**
    * Enable mousemove events (high CPU usage)
    * @returns {boolean} Success status
@@ -261,6 +601,49 @@ class SelectionHook extends EventEmitter {
     }
   }
 
+  /**
+   * Enable selection-change events (Linux only): emitted on every selection
+   * owner change, without reading the selected text
+   * @returns {boolean} Success status
+   */
+  enableSelectionChangeEvent() {
+    if (!isLinux) {
+      this.#logDebug("enableSelectionChangeEvent is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.enableSelectionChangeEvent();
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to enable selection change events", err);
+      return false;
+    }
+  }
+
+  /**
+   * Disable selection-change events
+   * @returns {boolean} Success status
+   */
+  disableSelectionChangeEvent() {
+    if (!isLinux) {
+      this.#logDebug("disableSelectionChangeEvent is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.disableSelectionChangeEvent();
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to disable selection change events", err);
+      return false;
+    }
+  }
+
   /**
    * Enable clipboard fallback for text selection
    * Uses Ctrl+C as a last resort to get selected text
@@ -530,6 +913,294 @@ class SelectionHook extends EventEmitter {
     }
   }
 
+  /**
+   * Get the native event counters (Linux only), cumulative since construction.
+   * Useful to spot dropped events or a growing queue in long-running sessions.
+   * @returns {object|null} Stats object or null on non-Linux
+   */
+  linuxGetStats() {
+    if (!isLinux) {
+      this.#logDebug("linuxGetStats is only supported on Linux");
+      return null;
+    }
+
+    if (!this.#checkInstance()) return null;
+
+    try {
+      return this.#instance.linuxGetStats();
+    } catch (err) {
+      this.#handleError("Failed to get Linux stats", err);
+      return null;
+    }
+  }
+
+  /**
+   * Take the native diagnostic log entries written since the last drain, oldest
+   * first (Linux only). The native code keeps its errors, warnings and setup notes
+   * in an in-memory ring of the last 256 entries instead of printing them.
+   * @returns {object[]|null} Log entries or null on non-Linux
+   */
+  linuxDrainLog() {
+    if (!isLinux) {
+      this.#logDebug("linuxDrainLog is only supported on Linux");
+      return null;
+    }
+
+    if (!this.#checkInstance()) return null;
+
+    try {
+      return this.#instance.linuxDrainLog();
+    } catch (err) {
+      this.#handleError("Failed to drain Linux log", err);
+      return null;
+    }
+  }
+
+  /**
+   * Read X11 selection change events on the Node event loop instead of a
+   * background thread (Linux X11 only). Takes effect at the next start().
+   * @param {boolean} enabled - Whether to use in-loop selection events
+   * @returns {boolean} Success status
+   */
+  linuxSetSelectionInLoop(enabled) {
+    if (!isLinux) {
+      this.#logDebug("linuxSetSelectionInLoop is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.linuxSetSelectionInLoop(!!enabled);
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set in-loop selection mode", err);
+      return false;
+    }
+  }
+
+  /**
+   * Attach classification tags to text-selection events (Linux only): content
+   * tags ("url", "email", "path", "number", "code", "multiline") and script
+   * tags ("latin", "cyrillic", "cjk", ...), computed natively before delivery
+   * @param {boolean} enabled - Whether to add the tags array to selection data
+   * @returns {boolean} Success status
+   */
+  linuxSetTextClassification(enabled) {
+    if (!isLinux) {
+      this.#logDebug("linuxSetTextClassification is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.linuxSetTextClassification(!!enabled);
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set text classification", err);
+      return false;
+    }
+  }
+
+  /**
+   * Read selections through AT-SPI2 alongside PRIMARY, hedged (Linux only), which also
+   * provides selection coordinates on X11. Takes effect at the next start().
+   * @param {boolean} enabled - Whether to use the AT-SPI2 selection source
+   * @returns {boolean} Success status
+   */
+  linuxSetAtspi(enabled) {
+    if (!isLinux) {
+      this.#logDebug("linuxSetAtspi is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.linuxSetAtspi(!!enabled);
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set AT-SPI mode", err);
+      return false;
+    }
+  }
+
+  /**
+   * Suspend input and selection events while the session is locked or idle, or the X11
+   * screen saver is active (Linux only, on by default). Emits "status" with "suspended"
+   * and "resumed". Takes effect at the next start().
+   * @param {boolean} enabled - Whether to suspend automatically
+   * @returns {boolean} Success status
+   */
+  linuxSetAutoSuspend(enabled) {
+    if (!isLinux) {
+      this.#logDebug("linuxSetAutoSuspend is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.linuxSetAutoSuspend(!!enabled);
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set auto-suspend mode", err);
+      return false;
+    }
+  }
+
+  /**
+   * Suspend input and selection events while the focused window is fullscreen, e.g. a game
+   * (Linux only, off by default). Programs in keepRunningList (case-insensitive substrings)
+   * keep the hook running. Emits "status" with "suspended" and "resumed". Takes effect at the
+   * next start().
+   * @param {boolean} enabled - Whether to suspend while a fullscreen window is focused
+   * @param {string[]} [keepRunningList] - Programs whose fullscreen windows keep the hook running
+   * @returns {boolean} Success status
+   */
+  linuxSetFullscreenSuspend(enabled, keepRunningList = []) {
+    if (!isLinux) {
+      this.#logDebug("linuxSetFullscreenSuspend is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.linuxSetFullscreenSuspend(!!enabled, Array.isArray(keepRunningList) ? keepRunningList : []);
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set fullscreen suspend mode", err);
+      return false;
+    }
+  }
+
+  /**
+   * Set scheduling of the input monitoring threads (Linux only), to keep gesture
+   * correlation reliable under CPU contention. Takes effect at the next start().
+   * Threads are always named (sh-xrecord, sh-xi2, sh-xfixes, sh-x11, sh-evdev, ...) for perf/htop.
+   * @param {Object|null} options - Scheduling options, null to reset
+   * @param {number} [options.nice] - Nice value of the input threads (-20..19)
+   * @param {boolean} [options.realtime] - Use SCHED_RR when permitted, otherwise falls back to nice
+   * @param {number[]} [options.cpus] - CPU affinity of the input threads
+   * @returns {boolean} Success status
+   */
+  linuxSetThreadScheduling(options) {
+    if (!isLinux) {
+      this.#logDebug("linuxSetThreadScheduling is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.linuxSetThreadScheduling(options ?? {});
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set thread scheduling", err);
+      return false;
+    }
+  }
+
+  /**
+   * Set the input devices to monitor (Linux only). Takes effect at the next start().
+   * On Wayland devices are filtered when they are probed; on X11 only excludeXTest applies.
+   * @param {Object|null} options - Device filter, null to monitor all devices
+   * @param {Object[]} [options.allow] - Only devices matching one of these rules are monitored
+   * @param {Object[]} [options.deny] - Devices matching one of these rules are never monitored
+   * @param {boolean} [options.excludeVirtual] - Skip virtual (uinput) devices
+   * @param {boolean} [options.excludeXTest] - X11: drop events synthesized through XTest
+   * @returns {boolean} Success status
+   */
+  linuxSetInputDeviceFilter(options) {
+    if (!isLinux) {
+      this.#logDebug("linuxSetInputDeviceFilter is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    try {
+      this.#instance.linuxSetInputDeviceFilter(options ?? {});
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set input device filter", err);
+      return false;
+    }
+  }
+
+  /**
+   * Set the source of input events on X11 (Linux only). Takes effect at the next start().
+   * "xinput2" reads XInput2 raw events instead of XRecord; mouse and keyboard events then
+   * carry deviceId and time. Falls back to XRecord without XInput 2.1; ignored on Wayland.
+   * @param {"xrecord"|"xinput2"} backend - Input backend (default "xrecord")
+   * @returns {boolean} Success status
+   */
+  linuxSetX11InputBackend(backend) {
+    if (!isLinux) {
+      this.#logDebug("linuxSetX11InputBackend is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance()) return false;
+
+    const value = X11_INPUT_BACKENDS[backend];
+    if (value === undefined) {
+      this.#handleError("Failed to set X11 input backend", new Error(`Unknown backend: ${backend}`));
+      return false;
+    }
+
+    try {
+      this.#instance.linuxSetX11InputBackend(value);
+      return true;
+    } catch (err) {
+      this.#handleError("Failed to set X11 input backend", err);
+      return false;
+    }
+  }
+
+  /**
+   * Test-only: feed synthetic events through the native delivery pipeline (queue,
+   * dispatch, N-API objects and the event switch) without real input (Linux only).
+   * Requires a started hook and SELECTION_HOOK_TEST_INJECTION=1 in the environment.
+   * Not part of the public API.
+   * @param {"mouse-move"|"mouse-wheel"|"mouse-click"|"keyboard"|"text-selection"} type - Event type
+   * @param {number} count - Number of events (down/up pairs for mouse-click and keyboard)
+   * @param {number} [rate=0] - Events per second, 0 = as fast as possible
+   * @returns {boolean} Whether the injection was started
+   */
+  _injectTestEvents(type, count, rate = 0) {
+    if (!isLinux) {
+      this.#logDebug("_injectTestEvents is only supported on Linux");
+      return false;
+    }
+
+    if (!this.#checkInstance() || !this.#running) return false;
+
+    const kind = INJECT_EVENT_KINDS[type];
+    if (kind === undefined) {
+      this.#handleError("Failed to inject test events", new Error(`Unknown event type: ${type}`));
+      return false;
+    }
+
+    try {
+      return this.#instance.injectTestEvents(kind, count, rate);
+    } catch (err) {
+      this.#handleError("Failed to inject test events", err);
+      return false;
+    }
+  }
+
+  /**
+   * Test-only: whether an injection started by _injectTestEvents() is still producing events
+   * @returns {boolean}
+   */
+  _isInjectingTestEvents() {
+    if (!isLinux || !this.#instance) return false;
+    return this.#instance.isInjectingTestEvents();
+  }
+
   /**
    * Check if hook is running
    * @returns {boolean} Running status
@@ -551,12 +1222,23 @@ class SelectionHook extends EventEmitter {
     return {
       debug: false,
       enableMouseMoveEvent: false,
-      enableClipboard: true,
+      enableSelectionChangeEvent: false,
+      enableClipboard: !isLinux,
       selectionPassiveMode: false,
       clipboardMode: SelectionHook.FilterMode.DEFAULT,
       globalFilterMode: SelectionHook.FilterMode.DEFAULT,
       clipboardFilterList: [],
       globalFilterList: [],
+      linuxSelectionInLoop: false,
+      linuxThreadScheduling: null,
+      linuxInputDeviceFilter: null,
+      linuxX11InputBackend: "xrecord",
+      linuxTextClassification: false,
+      linuxAtspi: false,
+      linuxAutoSuspend: true,
+      linuxFullscreenSuspend: false,
+      linuxFullscreenKeepRunningList: [],
+      selectionHistory: null,
     };
   }
 
@@ -579,6 +1261,14 @@ class SelectionHook extends EventEmitter {
       }
     }
 
+    if (config.enableSelectionChangeEvent !== undefined && isLinux) {
+      if (config.enableSelectionChangeEvent) {
+        this.#instance.enableSelectionChangeEvent();
+      } else {
+        this.#instance.disableSelectionChangeEvent();
+      }
+    }
+
     if (config.enableClipboard !== undefined) {
       if (config.enableClipboard) {
         this.#instance.enableClipboard();
@@ -604,6 +1294,49 @@ class SelectionHook extends EventEmitter {
         config.globalFilterList ?? defaultConfig.globalFilterList
       );
     }
+
+    if (config.linuxSelectionInLoop !== undefined && isLinux) {
+      this.#instance.linuxSetSelectionInLoop(!!config.linuxSelectionInLoop);
+    }
+
+    if (config.linuxThreadScheduling !== undefined && isLinux) {
+      this.#instance.linuxSetThreadScheduling(config.linuxThreadScheduling ?? {});
+    }
+
+    if (config.linuxInputDeviceFilter !== undefined && isLinux) {
+      this.#instance.linuxSetInputDeviceFilter(config.linuxInputDeviceFilter ?? {});
+    }
+
+    if (config.linuxX11InputBackend !== undefined && isLinux) {
+      const backend = X11_INPUT_BACKENDS[config.linuxX11InputBackend];
+      if (backend !== undefined) this.#instance.linuxSetX11InputBackend(backend);
+    }
+
+    if (config.linuxTextClassification !== undefined && isLinux) {
+      this.#instance.linuxSetTextClassification(!!config.linuxTextClassification);
+    }
+
+    if (config.linuxAtspi !== undefined && isLinux) {
+      this.#instance.linuxSetAtspi(!!config.linuxAtspi);
+    }
+
+    if (config.linuxAutoSuspend !== undefined && isLinux) {
+      this.#instance.linuxSetAutoSuspend(!!config.linuxAutoSuspend);
+    }
+
+    if (
+      (config.linuxFullscreenSuspend !== undefined || config.linuxFullscreenKeepRunningList !== undefined) &&
+      isLinux
+    ) {
+      this.#instance.linuxSetFullscreenSuspend(
+        !!(config.linuxFullscreenSuspend ?? defaultConfig.linuxFullscreenSuspend),
+        config.linuxFullscreenKeepRunningList ?? defaultConfig.linuxFullscreenKeepRunningList
+      );
+    }
+
+    if (config.selectionHistory !== undefined && isLinux) {
+      this.setSelectionHistory(config.selectionHistory);
+    }
   }
 
   #formatSelectionData(data) {
@@ -626,9 +1359,23 @@ class SelectionHook extends EventEmitter {
       selectionInfo.isFullscreen = data.isFullscreen;
     }
 
+    if (data.tags) {
+      selectionInfo.tags = data.tags;
+    }
+
+    if (data.display !== undefined) {
+      selectionInfo.display = data.display;
+    }
+
     return selectionInfo;
   }
 
+  #createInstance() {
+    return this.#displays
+      ? new nativeModule.TextSelectionHook(this.#displays)
+      : new nativeModule.TextSelectionHook();
+  }
+
   // Private helper methods
   #checkInstance() {
     if (!this.#instance) {
@@ -0,0 +1,330 @@
+/**
+ * Native microbenchmarks for the Linux per-event helpers
+ *
+ * Measures the helpers that run once per input event or per selection:
+ * key name conversion, program filter lists and name interning, whitespace checks, window movement
+ * checks, modifier tracking, XRecord payload decoding, the selection history and
+ * text classification. Reports ns/op and heap allocations/op (counted by
+ * replacing the global operator new).
+ *
+ * Build and run (not part of the default build):
+ *   npm run bench:native
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <X11/X.h>
+
+// Undefine X11 None macro that conflicts with our enum
+#ifdef None
+#undef None
+#endif
+
+#include "../common.h"
+#include "../lib/keyboard.h"
+#include "../lib/program_names.h"
+#include "../lib/selection_history.h"
+#include "../lib/text_classifier.h"
+#include "../lib/utils.h"
+#include "../lib/xrecord.h"
+
+//=============================================================================
+// Allocation counting
+//=============================================================================
+
+static size_t allocation_count = 0;
+
+void *operator new(size_t size)
+{
+    allocation_count++;
+    if (void *ptr = malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    allocation_count++;
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+//=============================================================================
+// Runner
+//=============================================================================
+
+// Keep a result alive so the compiler cannot drop the benchmarked call
+template <typename T>
+static inline void DoNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+constexpr double MIN_RUN_SECONDS = 0.2;
+
+/**
+ * Run fn(i) in batches until the run takes at least MIN_RUN_SECONDS, then
+ * report the time and allocations per call.
+ */
+template <typename Fn>
+static void Run(const char *name, Fn &&fn)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Warm up caches and any lazily built tables
+    for (size_t i = 0; i < 1000; i++)
+        fn(i);
+
+    size_t iterations = 1;
+    for (;;)
+    {
+        size_t allocationsBefore = allocation_count;
+        auto begin = Clock::now();
+        for (size_t i = 0; i < iterations; i++)
+            fn(i);
+        double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        size_t allocations = allocation_count - allocationsBefore;
+
+        if (seconds >= MIN_RUN_SECONDS || iterations >= (size_t(1) << 32))
+        {
+            printf("%-48s %12.1f %12.2f\n", name, seconds * 1e9 / iterations,
+                   static_cast<double>(allocations) / iterations);
+            return;
+        }
+
+        // Aim just past the minimum run time
+        double scale = seconds > 0 ? (MIN_RUN_SECONDS * 1.2) / seconds : 100;
+        iterations = static_cast<size_t>(iterations * (scale > 100 ? 100 : (scale < 2 ? 2 : scale)));
+    }
+}
+
+//=============================================================================
+// Benchmarks
+//=============================================================================
+
+static void BenchKeyboard()
+{
+    static const unsigned int letters[] = {KEY_A, KEY_S, KEY_D, KEY_F, KEY_J, KEY_K, KEY_L, KEY_E};
+    static const unsigned int named[] = {KEY_ENTER, KEY_BACKSPACE, KEY_LEFTCTRL, KEY_F5,
+                                         KEY_PAGEDOWN, KEY_ESC, KEY_LEFT, KEY_TAB};
+
+    Run("convertKeyCodeToUniKey/letter", [](size_t i) { DoNotOptimize(convertKeyCodeToUniKey(letters[i & 7], 0)); });
+    Run("convertKeyCodeToUniKey/shifted digit",
+        [](size_t i) { DoNotOptimize(convertKeyCodeToUniKey(KEY_1 + (i & 7), MODIFIER_SHIFT)); });
+    Run("convertKeyCodeToUniKey/named key", [](size_t i) { DoNotOptimize(convertKeyCodeToUniKey(named[i & 7], 0)); });
+
+    ModifierState state;
+    Run("ModifierState::UpdateFromKeyCode", [&state](size_t i) {
+        static const unsigned int keys[] = {KEY_LEFTCTRL, KEY_A, KEY_LEFTSHIFT, KEY_RIGHTALT};
+        state.UpdateFromKeyCode(keys[i & 3], (i & 4) == 0);
+        DoNotOptimize(state.GetFlags());
+    });
+}
+
+static void BenchFilterList()
+{
+    char name[64];
+    for (size_t size : {10, 100, 1000})
+    {
+        // Fixed-width names, so that no entry is a substring of another
+        std::vector<std::string> list;
+        for (size_t i = 0; i < size; i++)
+        {
+            snprintf(name, sizeof(name), "program-%04zu", i);
+            list.push_back(name);
+        }
+
+        // Miss scans the whole list; hit matches the last entry
+        std::string miss = "Mozilla Firefox";
+        snprintf(name, sizeof(name), "Program-%04zu", size - 1);
+        std::string hit = name;
+
+        snprintf(name, sizeof(name), "IsInFilterList/%zu entries/miss", size);
+        Run(name, [&](size_t) { DoNotOptimize(IsInFilterList(miss, list)); });
+        snprintf(name, sizeof(name), "IsInFilterList/%zu entries/hit last", size);
+        Run(name, [&](size_t) { DoNotOptimize(IsInFilterList(hit, list)); });
+
+        // Interned: the match is computed once per program and list
+        ProgramNameTable programs;
+        uint32_t missId = programs.Intern(miss);
+        snprintf(name, sizeof(name), "ProgramNameTable::IsInList/%zu entries", size);
+        Run(name, [&](size_t) { DoNotOptimize(programs.IsInList(missId, 0, list)); });
+    }
+
+    ProgramNameTable programs;
+    std::string program = "Mozilla Firefox";
+    programs.Intern(program);
+    Run("ProgramNameTable::Intern/known", [&](size_t) { DoNotOptimize(programs.Intern(program)); });
+}
+
+static void BenchTrimmedEmpty()
+{
+    char name[64];
+    for (size_t size : {size_t(1), size_t(1) << 10, size_t(64) << 10, size_t(1) << 20})
+    {
+        // All whitespace is the worst case: every byte is checked
+        std::string blank(size, ' ');
+        snprintf(name, sizeof(name), "IsTrimmedEmpty/%zu B whitespace", size);
+        Run(name, [&](size_t) { DoNotOptimize(IsTrimmedEmpty(blank)); });
+    }
+
+    std::string text = "  " + std::string(size_t(1) << 20, 'x');
+    Run("IsTrimmedEmpty/1 MB text", [&](size_t) { DoNotOptimize(IsTrimmedEmpty(text)); });
+}
+
+static void BenchWindowMoved()
+{
+    WindowRect last{100, 100, 800, 600};
+    WindowRect rects[] = {{100, 100, 800, 600}, {101, 99, 800, 600}, {140, 100, 800, 600}, {100, 100, 820, 600}};
+
+    Run("HasWindowMoved", [&](size_t i) { DoNotOptimize(HasWindowMoved(rects[i & 3], last)); });
+}
+
+// Core protocol event as captured by XRecord: type, detail, sequence, time, root, event, child,
+// root/event coordinates, state, same_screen
+static std::vector<unsigned char> MakeXEvent(int type, unsigned char detail)
+{
+    std::vector<unsigned char> event(X11_EVENT_SIZE, 0);
+    event[0] = static_cast<unsigned char>(type);
+    event[1] = detail;
+    event[2] = 0x34;  // sequence
+    event[3] = 0x12;
+    event[20] = 0x80;  // root-x
+    event[22] = 0x40;  // root-y
+    event[30] = 1;     // same-screen
+    return event;
+}
+
+static void BenchXRecordDecode()
+{
+    std::vector<std::vector<unsigned char>> payloads = {
+        MakeXEvent(KeyPress, KEY_A + 8),
+        MakeXEvent(KeyRelease, KEY_A + 8),
+        MakeXEvent(ButtonPress, 1),
+        MakeXEvent(ButtonRelease, 1),
+        MakeXEvent(MotionNotify, 0),
+        MakeXEvent(ButtonPress, 4),
+        MakeXEvent(KeyPress, KEY_LEFTCTRL + 8),
+        MakeXEvent(KeyRelease, KEY_LEFTCTRL + 8),
+    };
+    std::vector<unsigned char> nonInput = MakeXEvent(Expose, 0);
+
+    // Decode and map, as ProcessXRecordData does before handing events to the core
+    ModifierState state;
+    Run("XRecord decode/input events", [&](size_t i) {
+        const auto &payload = payloads[i & 7];
+        XRecordInputEvent event;
+        if (!DecodeXRecordInputEvent(payload.data(), payload.size(), event))
+            return;
+
+        if (event.type == ButtonPress || event.type == ButtonRelease)
+        {
+            MouseEventContext mouseEvent;
+            MapX11ButtonToMouseEvent(event.detail, event.type == ButtonPress, mouseEvent);
+            DoNotOptimize(mouseEvent);
+        }
+        else if (event.type == KeyPress || event.type == KeyRelease)
+        {
+            state.UpdateFromKeyCode(X11KeycodeToLinux(event.detail), event.type == KeyPress);
+            DoNotOptimize(state.GetFlags());
+        }
+    });
+
+    Run("XRecord decode/non-input event", [&](size_t) {
+        XRecordInputEvent event;
+        DoNotOptimize(DecodeXRecordInputEvent(nonInput.data(), nonInput.size(), event));
+    });
+}
+
+static void BenchSelectionHistory()
+{
+    // 64 distinct selections cycled through a 100-entry history: every text is already stored
+    std::vector<std::string> texts;
+    for (int i = 0; i < 64; i++)
+        texts.push_back("selected text " + std::to_string(i) + std::string(100, 'x'));
+    std::string program = "firefox";
+
+    SelectionHistory history;
+    history.SetLimits(100, 1 << 20);
+    int64_t time = 0;
+    Run("SelectionHistory::Add/dedup", [&](size_t i) { history.Add(texts[i & 63], program, 1, ++time); });
+
+    std::vector<SelectionHistory::View> views;
+    views.reserve(100);
+    Run("SelectionHistory::Query/100 entries", [&](size_t) {
+        history.Query(0, 0, views);
+        DoNotOptimize(views.size());
+    });
+}
+
+static void BenchClassifyText()
+{
+    std::string prose;
+    while (prose.size() < 1024)
+        prose += "The quick brown fox jumps over the lazy dog, see https://example.com/docs. ";
+    prose.resize(1024);
+    Run("ClassifyText/1 KB prose", [&](size_t) { DoNotOptimize(ClassifyText(prose)); });
+
+    std::string code;
+    while (code.size() < (size_t(64) << 10))
+        code += "    if (value != nullptr) { return std::max(count, 42); }\n";
+    code.resize(size_t(64) << 10);
+    Run("ClassifyText/64 KB code", [&](size_t) { DoNotOptimize(ClassifyText(code)); });
+
+    std::string cjk;
+    while (cjk.size() < 1024)
+        cjk += "\u9009\u4e2d\u7684\u6587\u672c\u3002";
+    Run("ClassifyText/1 KB CJK", [&](size_t) { DoNotOptimize(ClassifyText(cjk)); });
+}
+
+int main()
+{
+    printf("%-48s %12s %12s\n", "benchmark", "ns/op", "allocs/op");
+
+    BenchKeyboard();
+    BenchFilterList();
+    BenchTrimmedEmpty();
+    BenchWindowMoved();
+    BenchXRecordDecode();
+    BenchSelectionHistory();
+    BenchClassifyText();
+
+    return 0;
+}
@@ -7,9 +7,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Linux input constants for ModifierState
 #include <linux/input.h>
@@ -105,6 +107,7 @@ enum class SelectionDetectType
 enum class SelectionMethod
 {
     None = 0,
+    Atspi = 21,    // AT-SPI2 accessible text
     Primary = 22,  // primary selection
     Clipboard = 99
 };
@@ -127,6 +130,13 @@ enum class FilterMode
     ExcludeList = 2   // only trigger when the program name is not in the exclude list
 };
 
+// Fine-tuned list type enum (clipboard fallback behaviors)
+enum class FineTunedListType
+{
+    ExcludeClipboardCursorDetect = 0,  // skip text-cursor detection before clipboard fallback
+    IncludeClipboardDelayRead = 1      // wait for the clipboard to settle before reading it
+};
+
 // Keyboard modifier flags (bitmask for KeyboardEventContext::flags)
 constexpr int MODIFIER_SHIFT = 0x01;
 constexpr int MODIFIER_CTRL = 0x02;
@@ -198,6 +208,7 @@ struct TextSelectionInfo
 {
     std::string text;         ///< Selected text content (UTF-8)
     std::string programName;  ///< program name that triggered the selection
+    uint32_t programId;       ///< interned programName (lib/program_names.h), 0 when unknown
 
     Point startTop;     ///< First paragraph left-top (screen coordinates)
     Point startBottom;  ///< First paragraph left-bottom (screen coordinates)
@@ -210,12 +221,18 @@ struct TextSelectionInfo
     SelectionMethod method;
     SelectionPositionLevel posLevel;
 
-    TextSelectionInfo() : method(SelectionMethod::None), posLevel(SelectionPositionLevel::None) {}
+    uint32_t tags;  ///< TEXT_TAG_* bits (lib/text_classifier.h); 0 unless text classification is enabled
+
+    TextSelectionInfo()
+        : programId(0), method(SelectionMethod::None), posLevel(SelectionPositionLevel::None), tags(0)
+    {
+    }
 
     void clear()
     {
         text.clear();
         programName.clear();
+        programId = 0;
         startTop = Point();
         startBottom = Point();
         endTop = Point();
@@ -224,39 +241,94 @@ struct TextSelectionInfo
         mousePosEnd = Point();
         method = SelectionMethod::None;
         posLevel = SelectionPositionLevel::None;
+        tags = 0;
     }
 };
 
 // Structure to store mouse event information
 struct MouseEventContext
 {
-    int type;    ///< Linux input event type (EV_KEY, EV_REL, etc.)
-    int code;    ///< Event code (BTN_LEFT, REL_X, etc.)
-    int value;   ///< Event value
-    Point pos;   ///< Mouse position (calculated)
-    int button;  ///< Mouse button
-    int flag;    ///< Mouse extra flag (eg. wheel direction)
+    int type;           ///< Linux input event type (EV_KEY, EV_REL, etc.)
+    int code;           ///< Event code (BTN_LEFT, REL_X, etc.)
+    int value;          ///< Event value
+    Point pos;          ///< Mouse position (calculated)
+    int button;         ///< Mouse button
+    int flag;           ///< Mouse extra flag (eg. wheel direction)
+    double delta = 0;   ///< Wheel notches, fractional for smooth scrolling (0 = use value)
+    int device = 0;     ///< Source device id (X11 XInput2 slave), 0 when unknown
+    uint32_t time = 0;  ///< X server time in ms (X11 XInput2), 0 when unknown
 };
 
 // Structure to store keyboard event information
 struct KeyboardEventContext
 {
-    int type;   ///< Linux input event type (EV_KEY)
-    int code;   ///< Linux KEY_* code from <linux/input-event-codes.h>
-    int value;  ///< Key value (0=release, 1=press, 2=repeat)
-    int flags;  ///< Modifier bitmask (MODIFIER_SHIFT/CTRL/ALT/META)
+    int type;           ///< Linux input event type (EV_KEY)
+    int code;           ///< Linux KEY_* code from <linux/input-event-codes.h>
+    int value;          ///< Key value (0=release, 1=press, 2=repeat)
+    int flags;          ///< Modifier bitmask (MODIFIER_SHIFT/CTRL/ALT/META)
+    int device = 0;     ///< Source device id (X11 XInput2 slave), 0 when unknown
+    uint32_t time = 0;  ///< X server time in ms (X11 XInput2), 0 when unknown
 };
 
 // Structure for selection change event (XFixes on X11, data-control on Wayland)
 struct SelectionChangeContext
 {
     uint64_t timestamp_ms;
+    uint64_t owner = 0;  ///< new owner window (X11), 0 when unknown
+};
+
+// Scheduling options for the input and selection monitoring threads, so that gestures
+// are still correlated in time when the system is under heavy CPU load
+struct ThreadSchedulingOptions
+{
+    bool setNice = false;
+    int niceValue = 0;      ///< per-thread nice value (-20..19); below 0 needs CAP_SYS_NICE or RLIMIT_NICE
+    bool realtime = false;  ///< SCHED_RR at minimum priority when permitted, otherwise niceValue applies
+    std::vector<int> cpus;  ///< CPU affinity, empty = unrestricted
+};
+
+// Source of mouse and keyboard events on X11
+enum class X11InputBackend
+{
+    XRecord = 0,  // XRecord data connection (core events of all clients)
+    XInput2 = 1   // XInput2 raw events on the root window, with device ids and server time
+};
+
+// Input device classes (bitmask), from the evdev capabilities of a device
+constexpr int INPUT_DEVICE_MOUSE = 0x01;     ///< mouse buttons or relative axes
+constexpr int INPUT_DEVICE_KEYBOARD = 0x02;  ///< letter keys
+constexpr int INPUT_DEVICE_TOUCHPAD = 0x04;  ///< finger tool with absolute axes
+constexpr int INPUT_DEVICE_TABLET = 0x08;    ///< pen or stylus tool
+constexpr int INPUT_DEVICE_GAMEPAD = 0x10;   ///< gamepad or joystick buttons
+
+// Input device rule; empty or negative fields match any device
+struct InputDeviceRule
+{
+    std::string name;  ///< case-insensitive substring of the device name (stored lowercased)
+    int bus = -1;      ///< BUS_* id, e.g. BUS_USB (0x03), BUS_VIRTUAL (0x06)
+    int vendor = -1;
+    int product = -1;
+    int classes = 0;  ///< INPUT_DEVICE_* bits, any of which must be present
+};
+
+// Input devices to monitor, applied when the devices are probed. Deny rules win over allow rules.
+struct InputDeviceFilter
+{
+    std::vector<InputDeviceRule> allow;  ///< when not empty, only matching devices are monitored
+    std::vector<InputDeviceRule> deny;   ///< matching devices are never monitored
+    bool excludeVirtual = false;         ///< skip BUS_VIRTUAL (uinput) devices
+    bool excludeXTest = false;           ///< X11: drop events synthesized through XTest
 };
 
 // Input monitoring callback function types
 typedef void (*MouseEventCallback)(void *context, MouseEventContext *mouseEvent);
 typedef void (*KeyboardEventCallback)(void *context, KeyboardEventContext *keyboardEvent);
 typedef void (*SelectionEventCallback)(void *context, SelectionChangeContext *selectionEvent);
+// Whether the focused window is fullscreen, and its program while it is
+typedef void (*FullscreenEventCallback)(void *context, bool fullscreen, const std::string &programName);
+
+// Reader of the input connections shared by the protocols of several displays (lib/event_reactor.h)
+class EventReactor;
 
 // Protocol abstraction base class
 // Abstract base class for protocol-specific implementations
@@ -280,6 +352,36 @@ class ProtocolBase
     // Text selection
     virtual bool GetTextViaPrimary(std::string &text) = 0;
 
+    // Whether a PRIMARY selection exists; protocols answer from owner/offer metadata when they can
+    virtual bool HasPrimarySelection()
+    {
+        std::string text;
+        return GetTextViaPrimary(text) && !text.empty();
+    }
+
+    // Byte length of the PRIMARY selection text; protocols avoid transferring the text when they can
+    virtual bool GetPrimarySelectionLength(size_t &length)
+    {
+        std::string text;
+        if (!GetTextViaPrimary(text))
+            return false;
+
+        length = text.size();
+        return true;
+    }
+
+    // Clipboard fallback: synthesize Ctrl+C, wait for the copy to land, read it and
+    // restore the previous clipboard. delayRead waits until the clipboard settles.
+    virtual bool GetTextViaClipboard(std::string &text, bool delayRead)
+    {
+        (void)text;
+        (void)delayRead;
+        return false;
+    }
+
+    // Whether the pointer currently shows a text (I-beam) cursor
+    virtual bool IsTextCursor() { return false; }
+
     // Clipboard operations
     virtual bool WriteClipboard(const std::string &text) = 0;
     virtual bool ReadClipboard(std::string &text) = 0;
@@ -293,12 +395,66 @@ class ProtocolBase
     // Set environment info from top-level detection
     virtual void SetEnvInfo(const LinuxEnvInfo &info) { (void)info; }
 
+    // X11 display to connect to instead of $DISPLAY (e.g. ":10"); ignored by other protocols.
+    // Must be set before Initialize().
+    virtual void SetDisplayName(const std::string &name) { (void)name; }
+
+    // Scheduling for the threads started by StartInputMonitoring(). Must be set before it.
+    virtual void SetThreadScheduling(const ThreadSchedulingOptions &options) { (void)options; }
+
+    // Input devices to monitor (evdev) and synthetic input filtering (XTest). Must be set before
+    // InitializeInputMonitoring().
+    virtual void SetInputDeviceFilter(const InputDeviceFilter &filter) { (void)filter; }
+
+    // Source of input events on X11; ignored by other protocols. Must be set before
+    // InitializeInputMonitoring().
+    virtual void SetX11InputBackend(X11InputBackend backend) { (void)backend; }
+
+    // X11: read the input and selection connections on this running reactor, shared with the
+    // protocols of other displays, instead of threads of their own; ignored by other protocols.
+    // Must be set before StartInputMonitoring(), and the reactor must run until StopInputMonitoring().
+    virtual void SetEventReactor(EventReactor *reactor) { (void)reactor; }
+
     // Input monitoring (for mouse and keyboard events)
     virtual bool InitializeInputMonitoring(MouseEventCallback mouseCallback, KeyboardEventCallback keyboardCallback,
                                            SelectionEventCallback selectionCallback, void *context) = 0;
     virtual void CleanupInputMonitoring() = 0;
     virtual bool StartInputMonitoring() = 0;
     virtual void StopInputMonitoring() = 0;
+
+    // In-loop selection events: instead of a protocol thread, the host event loop polls
+    // GetSelectionEventFd() and calls DispatchSelectionEvents() when it is readable, so
+    // the selection callback runs on the host thread. Must be set before StartInputMonitoring().
+    virtual bool SetSelectionEventsInLoop(bool inLoop) { return !inLoop; }
+    virtual int GetSelectionEventFd() { return -1; }
+    virtual void DispatchSelectionEvents() {}
+
+    // Fullscreen tracking: the callback is invoked whenever the focused window enters or leaves
+    // fullscreen, or another program's window is focused while fullscreen, on the thread that
+    // reads the window events. Set before InitializeInputMonitoring(), cleared with nullptr after
+    // CleanupInputMonitoring(). Returns false when the protocol can't tell fullscreen windows.
+    virtual bool SetFullscreenCallback(FullscreenEventCallback callback, void *context)
+    {
+        (void)callback;
+        (void)context;
+        return false;
+    }
+
+    // Hedged reads: while a flag is set, GetTextViaPrimary() gives up early once it
+    // becomes true. Set and cleared on the thread that reads PRIMARY.
+    virtual void SetPrimaryReadCancel(const std::atomic<bool> *cancel) { primary_read_cancel = cancel; }
+
+    // Suspension (e.g. session locked or idle): while set, the input threads drop mouse and
+    // keyboard events as they read them, before decoding or queueing. May be set from any thread.
+    void SetInputSuspended(bool suspended) { input_suspended.store(suspended); }
+
+  protected:
+    bool IsPrimaryReadCancelled() const { return primary_read_cancel && primary_read_cancel->load(); }
+    bool IsInputSuspended() const { return input_suspended.load(std::memory_order_relaxed); }
+
+  private:
+    const std::atomic<bool> *primary_read_cancel = nullptr;
+    std::atomic<bool> input_suspended{false};
 };
 
 // Forward declarations for protocol implementations
@@ -312,3 +468,7 @@ std::unique_ptr<ProtocolBase> CreateProtocol(DisplayProtocol protocol);
 // Factory function declarations for protocol implementations
 extern std::unique_ptr<ProtocolBase> CreateX11Protocol();
 extern std::unique_ptr<ProtocolBase> CreateWaylandProtocol();
+
+// X11 protocol limited to XFixes owner changes and PRIMARY reads (no XRecord input), opened on
+// $DISPLAY. Used by Wayland sessions without data-control to watch XWayland's PRIMARY selection.
+extern std::unique_ptr<ProtocolBase> CreateX11SelectionBridge();
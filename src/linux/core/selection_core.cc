@@ -0,0 +1,2277 @@
+/**
+ * Selection Hook Core for Linux
+ *
+ * Node-independent text selection engine: display protocol setup, input
+ * monitoring, gesture detection and gesture/selection change correlation.
+ * Events from protocol and timer threads are queued and handled on the host
+ * thread in Dispatch(); see selection_core.h for the threading model.
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "selection_core.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+// Standard C headers
+#include <cstdlib>
+#include <cstring>
+
+// Linux system headers
+#include <dirent.h>
+#include <fcntl.h>
+#include <grp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+// Diagnostic log
+#include "../lib/log_ring.h"
+
+// Keyboard utility for Linux key code conversion
+#include "../lib/keyboard.h"
+
+// Selection tags
+#include "../lib/text_classifier.h"
+
+// Utility functions
+#include "../lib/utils.h"
+
+/**
+ * Factory function to create protocol instances
+ */
+std::unique_ptr<ProtocolBase> CreateProtocol(DisplayProtocol protocol)
+{
+    switch (protocol)
+    {
+        case DisplayProtocol::X11:
+            return CreateX11Protocol();
+        case DisplayProtocol::Wayland:
+            return CreateWaylandProtocol();
+        default:
+            return nullptr;
+    }
+}
+
+/**
+ * Detect the current display protocol (X11 or Wayland)
+ */
+DisplayProtocol DetectDisplayProtocol()
+{
+    // Check for Wayland by looking for WAYLAND_DISPLAY environment variable
+    const char *wayland_display = std::getenv("WAYLAND_DISPLAY");
+    if (wayland_display && strlen(wayland_display) > 0)
+    {
+        return DisplayProtocol::Wayland;
+    }
+
+    // Check for X11 by looking for DISPLAY environment variable
+    const char *x11_display = std::getenv("DISPLAY");
+    if (x11_display && strlen(x11_display) > 0)
+    {
+        return DisplayProtocol::X11;
+    }
+
+    // Default to X11 if neither is clearly set
+    return DisplayProtocol::X11;
+}
+
+/**
+ * Detect the running Wayland compositor type.
+ *
+ * Standalone compositors (Hyprland, sway) set their own environment variables,
+ * so we check those first. DE-bundled compositors (KWin, mutter, cosmic-comp)
+ * are inferred from XDG_CURRENT_DESKTOP because each DE uses exactly one
+ * compositor: KDE→KWin, GNOME→mutter, COSMIC→cosmic-comp.
+ */
+CompositorType DetectCompositorType()
+{
+    // 1. Standalone compositors — detected via compositor-specific env vars
+    if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE"))
+        return CompositorType::Hyprland;
+    if (std::getenv("SWAYSOCK"))
+        return CompositorType::Sway;
+
+    // 2. DE-bundled compositors — inferred from XDG_CURRENT_DESKTOP
+    //    (each DE has a 1:1 relationship with its compositor)
+    const char *desktop = std::getenv("XDG_CURRENT_DESKTOP");
+    if (desktop)
+    {
+        std::string desktop_str(desktop);
+        std::transform(desktop_str.begin(), desktop_str.end(), desktop_str.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+
+        if (desktop_str.find("kde") != std::string::npos)
+            return CompositorType::KWin;  // KDE Plasma → KWin
+        if (desktop_str.find("gnome") != std::string::npos)
+            return CompositorType::Mutter;  // GNOME → mutter
+        if (desktop_str.find("cosmic") != std::string::npos)
+            return CompositorType::CosmicComp;  // COSMIC → cosmic-comp
+        if (desktop_str.find("wlroots") != std::string::npos)
+            return CompositorType::Wlroots;  // Generic wlroots-based
+    }
+
+    return CompositorType::Unknown;
+}
+
+/**
+ * Check if the current user can access input devices.
+ * X11 uses XRecord (always available). Wayland uses libevdev (/dev/input).
+ * For Wayland: checks root > input group > actual device open (covers ACL, capabilities, etc.)
+ */
+bool CheckInputDeviceAccess(DisplayProtocol protocol)
+{
+    // X11 uses XRecord for input monitoring — always available
+    if (protocol == DisplayProtocol::X11)
+        return true;
+
+    // Root always has access
+    if (geteuid() == 0)
+        return true;
+
+    // Check input group membership (fast path, no I/O)
+    struct group *grp = getgrnam("input");
+    if (grp)
+    {
+        gid_t input_gid = grp->gr_gid;
+        if (getegid() == input_gid)
+            return true;
+
+        int ngroups = getgroups(0, nullptr);
+        if (ngroups > 0)
+        {
+            std::vector<gid_t> groups(ngroups);
+            if (getgroups(ngroups, groups.data()) >= 0)
+            {
+                for (int i = 0; i < ngroups; i++)
+                {
+                    if (groups[i] == input_gid)
+                        return true;
+                }
+            }
+        }
+    }
+
+    // Fallback: try opening any input device (covers ACL, capabilities, etc.)
+    DIR *dir = opendir("/dev/input");
+    if (dir)
+    {
+        struct dirent *entry;
+        while ((entry = readdir(dir)))
+        {
+            if (strncmp(entry->d_name, "event", 5) == 0)
+            {
+                std::string path = std::string("/dev/input/") + entry->d_name;
+                int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
+                if (fd >= 0)
+                {
+                    close(fd);
+                    closedir(dir);
+                    return true;
+                }
+            }
+        }
+        closedir(dir);
+    }
+
+    return false;
+}
+
+// Event queue bounds: input events are dropped while the host is not dispatching
+constexpr size_t MAX_QUEUED_MOUSE_EVENTS = 512;
+constexpr size_t MAX_QUEUED_KEYBOARD_EVENTS = 128;
+constexpr size_t MAX_QUEUED_SELECTION_EVENTS = 64;
+
+// Mouse interaction constants
+constexpr int MIN_DRAG_DISTANCE = 8;
+constexpr uint64_t MAX_DRAG_TIME_MS = 8000;
+constexpr int DOUBLE_CLICK_MAX_DISTANCE = 3;
+static uint64_t DOUBLE_CLICK_TIME_MS = 500;
+
+// Path A/B correlation window (ms): maximum elapsed time between a mouse gesture
+// and a selection change event for them to be considered related.
+// Total latency includes event dispatch, app processing, and XFixes notification.
+// Some apps (e.g., Konsole) take ~300ms from gesture to XFixes event, so 500ms
+// provides sufficient margin.  On Wayland, data-control events typically arrive
+// within ~50ms after drag end.
+constexpr uint64_t CORRELATION_WINDOW_MS = 500;
+
+// No-input fallback (Path C): debounce quiet period before firing selection event
+constexpr uint64_t NO_INPUT_DEBOUNCE_MS = 200;
+
+// Hedged reads: the first source gets its p90 read latency for the program, clamped to
+// this range, before the second one starts; HEDGE_DEFAULT_DELAY_MS until enough reads
+// are known. Once PRIMARY gives up, AT-SPI2 gets HEDGE_ATSPI_TIMEOUT_MS (its read is at
+// most three 100ms calls).
+constexpr uint32_t HEDGE_MIN_DELAY_MS = 5;
+constexpr uint32_t HEDGE_MAX_DELAY_MS = 200;
+constexpr uint32_t HEDGE_DEFAULT_DELAY_MS = 20;
+constexpr uint32_t HEDGE_ATSPI_TIMEOUT_MS = 350;
+
+// Program name of the selections delivered by InjectEvents()
+constexpr const char *INJECT_PROGRAM_NAME = "selection-hook-inject";
+
+static uint64_t NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Monotonic ms, for latencies
+static uint64_t SteadyMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+//=============================================================================
+// SelectionCore Implementation
+//=============================================================================
+
+SelectionCore::SelectionCore()
+{
+    event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    poll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (event_fd >= 0 && poll_fd >= 0)
+    {
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = event_fd;
+        epoll_ctl(poll_fd, EPOLL_CTL_ADD, event_fd, &ev);
+    }
+}
+
+SelectionCore::~SelectionCore()
+{
+    Stop();
+    // An injection that ended on its own is not joined by Stop() when the core was already stopped
+    StopInjection();
+
+    // Cleanup protocol
+    if (protocol)
+    {
+        protocol->Cleanup();
+    }
+
+    if (poll_fd >= 0)
+        close(poll_fd);
+    if (event_fd >= 0)
+    {
+        LogClearNotifyFd(event_fd);
+        close(event_fd);
+    }
+}
+
+/**
+ * Detect all environment information and initialize the display protocol
+ */
+bool SelectionCore::Initialize(std::string &error)
+{
+    if (event_fd < 0 || poll_fd < 0)
+    {
+        error = "Failed to create event notification fd";
+        return false;
+    }
+
+    env_info.displayProtocol = display_name.empty() ? DetectDisplayProtocol() : DisplayProtocol::X11;
+    env_info.compositorType = DetectCompositorType();
+    env_info.hasInputDeviceAccess = CheckInputDeviceAccess(env_info.displayProtocol);
+    env_info.isRoot = (geteuid() == 0);
+
+    protocol = CreateProtocol(env_info.displayProtocol);
+    if (!protocol)
+    {
+        error = "Failed to create protocol interface";
+        return false;
+    }
+
+    // Pass environment info to protocol layer
+    protocol->SetEnvInfo(env_info);
+    protocol->SetDisplayName(display_name);
+
+    if (!protocol->Initialize())
+    {
+        protocol.reset();
+        error = "Failed to initialize display protocol";
+        return false;
+    }
+
+    // Get system double-click time (placeholder - Linux specific implementation needed)
+    DOUBLE_CLICK_TIME_MS = 500;  // Default value
+
+    // Initialize current mouse position
+    current_mouse_pos = Point();
+    return true;
+}
+
+void SelectionCore::SetCallbacks(CoreSelectionCallback selectionCallback, CoreMouseCallback mouseCallback,
+                                 CoreKeyboardCallback keyboardCallback, void *context)
+{
+    selection_callback = selectionCallback;
+    mouse_callback = mouseCallback;
+    keyboard_callback = keyboardCallback;
+    callback_context = context;
+}
+
+/**
+ * Start input monitoring, selection monitoring and the Path C/D timer threads
+ */
+bool SelectionCore::Start(std::string &error)
+{
+    if (!protocol)
+    {
+        error = "Display protocol is not initialized";
+        return false;
+    }
+
+    // Don't start if already running
+    if (running)
+    {
+        error = "Text selection hook is already running";
+        return false;
+    }
+
+    ClearEventQueue();
+
+    // Window ids may have been reused since the last run
+    change_owner = 0;
+
+    // Devices are probed and the X11 input source is chosen by InitializeInputMonitoring()
+    protocol->SetInputDeviceFilter(input_device_filter);
+    protocol->SetX11InputBackend(x11_input_backend);
+
+    // Fullscreen tracking starts with input monitoring; its state is applied once running
+    is_fullscreen_focused.store(false);
+    if (is_fullscreen_suspend)
+    {
+        fullscreen_keep_running = fullscreen_keep_list;
+        if (!protocol->SetFullscreenCallback(&SelectionCore::OnFullscreenCallback, this))
+            LogMessage(LogLevel::Info, "[Session] Fullscreen suspension not available: fullscreen windows unknown");
+    }
+
+    // Initialize input monitoring via protocol
+    if (!protocol->InitializeInputMonitoring(&SelectionCore::OnMouseEventCallback,
+                                             &SelectionCore::OnKeyboardEventCallback,
+                                             &SelectionCore::OnSelectionEventCallback, this))
+    {
+        error = "Failed to initialize input monitoring";
+        return false;
+    }
+
+    // In-loop selection mode is only honored by protocols that support it (X11, Wayland via XWayland)
+    bool selection_in_loop = protocol->SetSelectionEventsInLoop(is_selection_in_loop) && is_selection_in_loop;
+
+    protocol->SetThreadScheduling(thread_scheduling);
+    protocol->SetEventReactor(event_reactor);
+
+    // Set running before the protocol threads can deliver events
+    running = true;
+
+    if (!protocol->StartInputMonitoring())
+    {
+        running = false;
+        protocol->CleanupInputMonitoring();
+        error = "Failed to start input monitoring";
+        return false;
+    }
+
+    // A protocol without a selection fd (e.g. XFixes unavailable) leaves selection
+    // monitoring off, as in threaded mode.
+    if (selection_in_loop)
+    {
+        int fd = protocol->GetSelectionEventFd();
+        if (fd >= 0)
+        {
+            struct epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            if (epoll_ctl(poll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+            {
+                running = false;
+                protocol->CleanupInputMonitoring();
+                error = "Failed to poll selection events";
+                return false;
+            }
+            selection_fd = fd;
+        }
+    }
+
+    // Start debounce thread for no-input fallback (Wayland without libevdev)
+    // Note: !isRoot is redundant (CheckInputDeviceAccess already returns true for root)
+    // but kept as defensive guard
+    is_no_input_fallback = (env_info.displayProtocol == DisplayProtocol::Wayland && !env_info.hasInputDeviceAccess &&
+                            !env_info.isRoot);
+    if (is_no_input_fallback)
+    {
+        LogMessage(LogLevel::Info,
+                   "[Wayland] No input devices available, using data-control debounce fallback (Path C)");
+        debounce_running = true;
+        debounce_thread = std::thread(&SelectionCore::DebounceThreadProc, this);
+    }
+
+    // AT-SPI2 is optional: without an accessibility bus, PRIMARY is used as before. The bus is
+    // the one of this process's session, so an explicit display reads PRIMARY only.
+    if (is_atspi_enabled && !display_name.empty())
+    {
+        LogMessage(LogLevel::Info, "[AT-SPI] Not used for display %s, using PRIMARY only", display_name.c_str());
+    }
+    else if (is_atspi_enabled)
+    {
+        std::string atspiError;
+        if (!atspi.Start(atspiError))
+        {
+            LogMessage(LogLevel::Warn, "[AT-SPI] Not available, using PRIMARY only: %s", atspiError.c_str());
+        }
+        else
+        {
+            hedge_running = true;
+            hedge_thread = std::thread(&SelectionCore::HedgeThreadProc, this);
+        }
+    }
+
+    // Start clipboard fallback timer thread (Path D), X11 only
+    if (env_info.displayProtocol == DisplayProtocol::X11)
+    {
+        clipboard_fallback_running = true;
+        clipboard_fallback_thread = std::thread(&SelectionCore::ClipboardFallbackThreadProc, this);
+    }
+
+    // Auto-suspension is optional: without logind or MIT-SCREEN-SAVER the hook stays active
+    if (is_auto_suspend)
+    {
+        std::string sessionError;
+        bool watchScreenSaver = (env_info.displayProtocol == DisplayProtocol::X11);
+        session_state.SetDisplayName(display_name);
+        if (!session_state.Start(watchScreenSaver, &SelectionCore::OnSessionStateCallback, this, sessionError))
+        {
+            LogMessage(LogLevel::Info, "[Session] Auto-suspension not available: %s", sessionError.c_str());
+        }
+        else
+        {
+            UpdateSuspendReasons(SESSION_STATE_ALL, session_state.GetState());
+        }
+    }
+
+    // A fullscreen window may have been focused before running was set
+    if (is_fullscreen_suspend && is_fullscreen_focused.load())
+        UpdateSuspendReasons(SESSION_FULLSCREEN, SESSION_FULLSCREEN);
+
+    stats.starts++;
+    return true;
+}
+
+/**
+ * Stop all monitoring threads and drop queued events
+ */
+void SelectionCore::Stop()
+{
+    // Do nothing if not running
+    if (!running.exchange(false))
+    {
+        return;
+    }
+
+    // No more suspend changes from the session watcher
+    session_state.Stop();
+
+    // Unregister the protocol fd before the protocol closes it
+    if (selection_fd >= 0)
+    {
+        epoll_ctl(poll_fd, EPOLL_CTL_DEL, selection_fd, nullptr);
+        selection_fd = -1;
+    }
+
+    // Stop and cleanup input monitoring via protocol (this will wait for threads to finish)
+    if (protocol)
+    {
+        protocol->CleanupInputMonitoring();
+        protocol->SetFullscreenCallback(nullptr, nullptr);
+    }
+
+    StopInjection();
+
+    StopHedgeThread();
+    atspi.Stop();
+
+    // Stop debounce thread (Path C)
+    debounce_running = false;
+    debounce_cv.notify_one();
+    if (debounce_thread.joinable())
+        debounce_thread.join();
+    debounce_last_event_time.store(0);
+
+    // Stop clipboard fallback thread (Path D)
+    clipboard_fallback_running = false;
+    clipboard_fallback_cv.notify_one();
+    if (clipboard_fallback_thread.joinable())
+        clipboard_fallback_thread.join();
+    clipboard_fallback_gesture_time.store(0);
+
+    is_gesture_button_down.store(false);
+    had_selection_during_drag.store(false);
+    last_selection_event_time.store(0);
+    pending_gesture.active = false;
+    is_no_input_fallback = false;
+
+    // Leave the protocol active for the next Start(); the host is not notified
+    suspend_reasons.store(0);
+    if (protocol)
+        protocol->SetInputSuspended(false);
+
+    // All producers have stopped: nothing queued can be delivered anymore
+    ClearEventQueue();
+}
+
+/**
+ * Queue an event for Dispatch() and wake the host.
+ * Input and selection events are bounded per kind; timer events are never dropped.
+ */
+void SelectionCore::QueueEvent(const QueuedEvent &event)
+{
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        switch (event.kind)
+        {
+            case QueuedEvent::Kind::Mouse:
+                if (queued_mouse_events >= MAX_QUEUED_MOUSE_EVENTS)
+                {
+                    stats.droppedEvents++;
+                    return;
+                }
+                queued_mouse_events++;
+                stats.mouseEvents++;
+                break;
+            case QueuedEvent::Kind::Keyboard:
+                if (queued_keyboard_events >= MAX_QUEUED_KEYBOARD_EVENTS)
+                {
+                    stats.droppedEvents++;
+                    return;
+                }
+                queued_keyboard_events++;
+                stats.keyboardEvents++;
+                break;
+            case QueuedEvent::Kind::SelectionChange:
+            case QueuedEvent::Kind::InjectedSelection:
+                if (queued_selection_events >= MAX_QUEUED_SELECTION_EVENTS)
+                {
+                    stats.droppedEvents++;
+                    return;
+                }
+                queued_selection_events++;
+                if (!event.notifyOnly)
+                    stats.selectionChanges++;
+                break;
+            default:
+                break;
+        }
+        event_queue.push_back(event);
+        stats.queueHighWater = std::max(stats.queueHighWater, event_queue.size());
+    }
+
+    uint64_t one = 1;
+    ssize_t written = write(event_fd, &one, sizeof(one));
+    (void)written;  // EAGAIN only when the counter is saturated, which still wakes the host
+}
+
+/**
+ * Wake the host for diagnostic log entries through the event fd
+ */
+void SelectionCore::SetLogNotify(bool enabled)
+{
+    if (event_fd < 0)
+        return;
+
+    if (enabled)
+        LogSetNotifyFd(event_fd);
+    else
+        LogClearNotifyFd(event_fd);
+}
+
+/**
+ * Snapshot of the cumulative counters (dispatch thread)
+ */
+CoreStats SelectionCore::GetStats()
+{
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    CoreStats snapshot = stats;
+    snapshot.queueLength = event_queue.size();
+    return snapshot;
+}
+
+void SelectionCore::ClearEventQueue()
+{
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    event_queue.clear();
+    queued_mouse_events = 0;
+    queued_keyboard_events = 0;
+    queued_selection_events = 0;
+}
+
+/**
+ * Handle all queued events on the host thread.
+ * Called when GetFd() is readable; callbacks are invoked synchronously from here.
+ * Events queued while dispatching (e.g. by a callback) are left for the next call.
+ */
+void SelectionCore::Dispatch()
+{
+    // Reset the wakeup counter first, so a concurrent QueueEvent re-arms it
+    uint64_t counter;
+    ssize_t bytes = read(event_fd, &counter, sizeof(counter));
+    (void)bytes;
+
+    if (!running.load())
+    {
+        ClearEventQueue();
+        return;
+    }
+
+    // In-loop mode: read selection change events from the protocol connection.
+    // OnSelectionEventCallback queues them, so they are handled below.
+    if (selection_fd >= 0)
+    {
+        protocol->DispatchSelectionEvents();
+    }
+
+    std::deque<QueuedEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        events.swap(event_queue);
+        queued_mouse_events = 0;
+        queued_keyboard_events = 0;
+        queued_selection_events = 0;
+    }
+
+    for (const auto &event : events)
+    {
+        // A callback may have stopped the core
+        if (!running.load())
+            break;
+
+        stats.dispatchedEvents++;
+
+        switch (event.kind)
+        {
+            case QueuedEvent::Kind::Mouse:
+                ProcessMouseEvent(event.mouse);
+                break;
+            case QueuedEvent::Kind::Keyboard:
+                ProcessKeyboardEvent(event.keyboard);
+                break;
+            case QueuedEvent::Kind::SelectionChange:
+                if (is_enabled_selection_change_event && selection_change_callback)
+                    DeliverSelectionChange(event);
+                if (!event.notifyOnly && running.load())
+                    ProcessSelectionEvent(event.timestamp);
+                break;
+            case QueuedEvent::Kind::DebounceExpired:
+            {
+                if (suspend_reasons.load() != 0)
+                    break;
+
+                Point cursorPos = protocol->GetCurrentMousePosition();
+                EmitSelectionEvent(SelectionDetectType::Drag, cursorPos, cursorPos);
+                break;
+            }
+            case QueuedEvent::Kind::GestureExpired:
+                ProcessGestureExpired(event.timestamp);
+                break;
+            case QueuedEvent::Kind::InjectedSelection:
+                if (!is_selection_passive_mode)
+                    DeliverSelection(*event.selection);
+                break;
+            case QueuedEvent::Kind::SuspendChanged:
+                ProcessSuspendChanged(static_cast<int>(event.owner));
+                break;
+        }
+    }
+}
+
+void SelectionCore::SetClipboardMode(FilterMode mode, const std::vector<std::string> &list)
+{
+    clipboard_filter_mode = mode;
+    CopyToLowerCaseList(list, clipboard_filter_list);
+    program_names.InvalidateList(PROGRAM_LIST_CLIPBOARD);
+}
+
+void SelectionCore::SetGlobalFilterMode(FilterMode mode, const std::vector<std::string> &list)
+{
+    global_filter_mode = mode;
+    CopyToLowerCaseList(list, global_filter_list);
+    program_names.InvalidateList(PROGRAM_LIST_GLOBAL);
+}
+
+void SelectionCore::SetFullscreenSuspend(bool enabled, const std::vector<std::string> &keepRunning)
+{
+    is_fullscreen_suspend = enabled;
+    CopyToLowerCaseList(keepRunning, fullscreen_keep_list);
+}
+
+void SelectionCore::SetInputDeviceFilter(const InputDeviceFilter &filter)
+{
+    input_device_filter = filter;
+
+    // Device names match as case-insensitive substrings
+    for (auto *rules : {&input_device_filter.allow, &input_device_filter.deny})
+    {
+        for (InputDeviceRule &rule : *rules)
+            std::transform(rule.name.begin(), rule.name.end(), rule.name.begin(), ::tolower);
+    }
+}
+
+/**
+ * Set fine-tuned list based on type. Returns false for an unknown list type.
+ */
+bool SelectionCore::SetFineTunedList(FineTunedListType type, const std::vector<std::string> &list)
+{
+    switch (type)
+    {
+        case FineTunedListType::ExcludeClipboardCursorDetect:
+            CopyToLowerCaseList(list, ftl_exclude_clipboard_cursor_detect);
+            program_names.InvalidateList(PROGRAM_LIST_EXCLUDE_CURSOR_DETECT);
+            return true;
+        case FineTunedListType::IncludeClipboardDelayRead:
+            CopyToLowerCaseList(list, ftl_include_clipboard_delay_read);
+            program_names.InvalidateList(PROGRAM_LIST_INCLUDE_DELAY_READ);
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Get the currently selected text from the active window
+ */
+bool SelectionCore::GetCurrentSelection(TextSelectionInfo &selectionInfo)
+{
+    if (!protocol)
+        return false;
+
+    // Get the currently active window
+    uint64_t activeWindow = protocol->GetActiveWindow();
+    if (!activeWindow)
+        return false;
+
+    is_triggered_by_user = true;
+    bool result = GetSelectedText(activeWindow, selectionInfo) && !IsTrimmedEmpty(selectionInfo.text);
+    is_triggered_by_user = false;
+
+    if (result && is_text_classification)
+        selectionInfo.tags = ClassifyText(selectionInfo.text);
+
+    return result;
+}
+
+/**
+ * Read the requested fields of the current selection.
+ *
+ * Fields that were not requested cost nothing: the active window and program name
+ * are resolved only for SNAPSHOT_PROGRAM_NAME, the global filter list and the
+ * clipboard fallback; the cursor is queried only for SNAPSHOT_CURSOR. Without
+ * SNAPSHOT_TEXT, hasSelection and byteLength come from the protocol's owner/offer
+ * metadata where it has any, so the selection text is not transferred.
+ */
+bool SelectionCore::GetSelectionSnapshot(int fields, SelectionSnapshot &snapshot)
+{
+    if (!protocol)
+        return false;
+
+    snapshot = SelectionSnapshot();
+    snapshot.fields = fields & SNAPSHOT_ALL;
+
+    bool needsSelection = (fields & (SNAPSHOT_TEXT | SNAPSHOT_HAS_SELECTION | SNAPSHOT_BYTE_LENGTH)) != 0;
+    bool needsProgramName =
+        (fields & SNAPSHOT_PROGRAM_NAME) || (needsSelection && global_filter_mode != FilterMode::Default);
+
+    uint64_t window = 0;
+    bool hasProgramName = false;
+    if (needsProgramName)
+    {
+        window = protocol->GetActiveWindow();
+        hasProgramName = window && protocol->GetProgramNameFromWindow(window, snapshot.programName);
+        if (!hasProgramName)
+            snapshot.programName = "";
+        snapshot.programId = program_names.Intern(snapshot.programName);
+    }
+
+    if (fields & SNAPSHOT_CURSOR)
+        snapshot.cursor = protocol->GetCurrentMousePosition();
+
+    // A filtered program reports no selection
+    bool isFiltered =
+        needsSelection && IsFilteredByGlobalList(hasProgramName, snapshot.programId, snapshot.programName);
+
+    // Resolved for the filter or the clipboard fallback only: not part of the result
+    auto clearUnrequested = [&]()
+    {
+        if (!(fields & SNAPSHOT_PROGRAM_NAME))
+        {
+            snapshot.programName = "";
+            snapshot.programId = ProgramNameTable::UNKNOWN;
+        }
+    };
+
+    if (!needsSelection || isFiltered)
+    {
+        clearUnrequested();
+        return true;
+    }
+
+    if (is_processing.load())
+        return false;
+    else
+        is_processing.store(true);
+
+    if (fields & SNAPSHOT_TEXT)
+    {
+        std::string text;
+        if (protocol->GetTextViaPrimary(text) && !IsTrimmedEmpty(text))
+        {
+            snapshot.text = std::move(text);
+        }
+        else if (is_enabled_clipboard && env_info.displayProtocol == DisplayProtocol::X11)
+        {
+            // The clipboard fallback needs the window and its program name for the fine-tuned lists
+            if (!needsProgramName)
+            {
+                window = protocol->GetActiveWindow();
+                if (window && !protocol->GetProgramNameFromWindow(window, snapshot.programName))
+                    snapshot.programName = "";
+                snapshot.programId = program_names.Intern(snapshot.programName);
+            }
+
+            TextSelectionInfo selectionInfo;
+            selectionInfo.programName = snapshot.programName;
+            selectionInfo.programId = snapshot.programId;
+
+            is_triggered_by_user = true;
+            if (window && ShouldProcessViaClipboard(selectionInfo.programId, selectionInfo.programName) &&
+                GetTextViaClipboard(window, selectionInfo))
+                snapshot.text = std::move(selectionInfo.text);
+            is_triggered_by_user = false;
+        }
+
+        snapshot.hasSelection = !snapshot.text.empty();
+        snapshot.byteLength = snapshot.text.size();
+    }
+    else
+    {
+        if (fields & SNAPSHOT_HAS_SELECTION)
+            snapshot.hasSelection = protocol->HasPrimarySelection();
+
+        size_t length = 0;
+        if ((fields & SNAPSHOT_BYTE_LENGTH) && protocol->GetPrimarySelectionLength(length))
+            snapshot.byteLength = length;
+    }
+
+    clearUnrequested();
+    is_processing.store(false);
+    return true;
+}
+
+/**
+ * Keep the last maxEntries emitted selections within maxBytes of text (maxEntries = 0 disables)
+ */
+void SelectionCore::SetSelectionHistory(size_t maxEntries, size_t maxBytes)
+{
+    history.SetLimits(maxEntries, maxBytes);
+}
+
+void SelectionCore::GetSelectionHistory(int64_t sinceMs, size_t limit, std::vector<SelectionHistory::View> &views)
+{
+    history.Query(sinceMs, limit, views);
+}
+
+/**
+ * Write string to clipboard
+ *
+ * Linux WriteClipboard has limited reliability due to X11's lazy clipboard model:
+ * The clipboard owner must keep a window alive and respond to SelectionRequest events
+ * from other applications requesting the data. This requires an event loop or dedicated thread.
+ */
+bool SelectionCore::WriteClipboard(const std::string &text)
+{
+    return protocol && protocol->WriteClipboard(text);
+}
+
+bool SelectionCore::ReadClipboard(std::string &text)
+{
+    return protocol && protocol->ReadClipboard(text);
+}
+
+/**
+ * Get selected text from the active window using multiple methods
+ */
+bool SelectionCore::GetSelectedText(uint64_t window, TextSelectionInfo &selectionInfo, bool skipPrimary)
+{
+    if (!window)
+        return false;
+
+    if (is_processing.load())
+        return false;
+    else
+        is_processing.store(true);
+
+    // Initialize structure
+    selectionInfo.clear();
+
+    // Get program name and store it in selectionInfo
+    bool hasProgramName = protocol->GetProgramNameFromWindow(window, selectionInfo.programName);
+    if (!hasProgramName)
+        selectionInfo.programName = "";
+    selectionInfo.programId = program_names.Intern(selectionInfo.programName);
+
+    if (IsFilteredByGlobalList(hasProgramName, selectionInfo.programId, selectionInfo.programName))
+    {
+        is_processing.store(false);
+        return false;
+    }
+
+    // AT-SPI2: the accessible that reported a selection change since the gesture started.
+    // With PRIMARY available as well, both are read hedged (see GetTextHedged()).
+    bool withAtspi = last_mouse_down_time && atspi.IsRunning();
+    if (withAtspi && !skipPrimary)
+    {
+        if (GetTextHedged(window, selectionInfo))
+        {
+            is_processing.store(false);
+            return true;
+        }
+    }
+    else
+    {
+        // Character extents are screen coordinates on X11 only
+        if (withAtspi &&
+            atspi.ReadSelection(last_mouse_down_time, env_info.displayProtocol == DisplayProtocol::X11, selectionInfo))
+        {
+            selectionInfo.method = SelectionMethod::Atspi;
+            is_processing.store(false);
+            return true;
+        }
+
+        // Primary Selection (covers both X11 and Wayland)
+        if (!skipPrimary && GetTextViaPrimary(window, selectionInfo))
+        {
+            selectionInfo.method = SelectionMethod::Primary;
+            is_processing.store(false);
+            return true;
+        }
+    }
+
+    // Last resort: try to get text using clipboard and Ctrl+C if enabled (X11 only)
+    if (ShouldProcessViaClipboard(selectionInfo.programId, selectionInfo.programName) &&
+        GetTextViaClipboard(window, selectionInfo))
+    {
+        selectionInfo.method = SelectionMethod::Clipboard;
+        is_processing.store(false);
+        return true;
+    }
+
+    is_processing.store(false);
+    return false;
+}
+
+/**
+ * Get text selection via protocol selection APIs
+ */
+bool SelectionCore::GetTextViaPrimary(uint64_t window, TextSelectionInfo &selectionInfo)
+{
+    if (!window)
+        return false;
+
+    // Try to get text from primary selection
+    std::string selectedText;
+    if (protocol->GetTextViaPrimary(selectedText) && !IsTrimmedEmpty(selectedText))
+    {
+        selectionInfo.text = selectedText;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Hedged read of AT-SPI2 and PRIMARY. The source with the lower p90 read latency for
+ * the program goes first (AT-SPI2 on a tie: it answers from the range it already has);
+ * if it has not answered within that p90, the other one starts in parallel. The first
+ * valid answer wins: a PRIMARY read still in progress is cancelled, an AT-SPI2 read in
+ * progress runs out on the hedge thread and its result is dropped. PRIMARY always runs
+ * on this thread, as the display connection is not shared with other threads.
+ * Sets selectionInfo.method on success.
+ */
+bool SelectionCore::GetTextHedged(uint64_t window, TextSelectionInfo &selectionInfo)
+{
+    using State = HedgeJob::State;
+
+    const std::string programName = selectionInfo.programName;
+    bool withExtents = env_info.displayProtocol == DisplayProtocol::X11;
+
+    auto p90 = [&](ReadSource source) {
+        uint32_t ms = read_latency.P90(programName, source, HEDGE_DEFAULT_DELAY_MS);
+        return std::min(std::max(ms, HEDGE_MIN_DELAY_MS), HEDGE_MAX_DELAY_MS);
+    };
+    uint32_t primaryP90 = p90(ReadSource::Primary);
+    uint32_t atspiP90 = p90(ReadSource::Atspi);
+    bool atspiFirst = atspiP90 <= primaryP90;
+
+    // Submit the AT-SPI2 read, unless the hedge thread is still running out a dropped one
+    bool submitted = false;
+    {
+        std::lock_guard<std::mutex> lock(hedge_mutex);
+        if (hedge_job.state == State::Idle)
+        {
+            hedge_job = HedgeJob();
+            hedge_job.state = State::Pending;
+            hedge_job.sinceMs = last_mouse_down_time;
+            hedge_job.withExtents = withExtents;
+            hedge_job.delayMs = atspiFirst ? 0 : primaryP90;
+            hedge_job.result = selectionInfo;
+            hedge_primary_cancel.store(false);
+            submitted = true;
+        }
+    }
+
+    if (!submitted)
+    {
+        // Sequential read
+        if (atspi.ReadSelection(last_mouse_down_time, withExtents, selectionInfo))
+        {
+            selectionInfo.method = SelectionMethod::Atspi;
+            return true;
+        }
+        if (GetTextViaPrimary(window, selectionInfo))
+        {
+            selectionInfo.method = SelectionMethod::Primary;
+            return true;
+        }
+        return false;
+    }
+    hedge_cv.notify_all();
+
+    std::unique_lock<std::mutex> lock(hedge_mutex);
+
+    // AT-SPI2 first: PRIMARY starts once AT-SPI2 is past its p90 without an answer
+    if (atspiFirst && hedge_cv.wait_for(lock, std::chrono::milliseconds(atspiP90),
+                                        [this] { return hedge_job.state == State::Done; }))
+    {
+        hedge_job.state = State::Idle;
+        if (hedge_job.ok)
+        {
+            read_latency.Record(programName, ReadSource::Atspi, hedge_job.latencyMs);
+            selectionInfo = std::move(hedge_job.result);
+            selectionInfo.method = SelectionMethod::Atspi;
+            return true;
+        }
+        lock.unlock();
+
+        // No AT-SPI2 selection: PRIMARY alone
+        uint64_t primaryStart = SteadyMs();
+        if (!GetTextViaPrimary(window, selectionInfo))
+            return false;
+
+        read_latency.Record(programName, ReadSource::Primary, static_cast<uint32_t>(SteadyMs() - primaryStart));
+        selectionInfo.method = SelectionMethod::Primary;
+        return true;
+    }
+    if (atspiFirst)
+        stats.hedgedReads++;
+    lock.unlock();
+
+    // PRIMARY, cancelled by the hedge thread when AT-SPI2 answers first
+    uint64_t primaryStart = SteadyMs();
+    protocol->SetPrimaryReadCancel(&hedge_primary_cancel);
+    bool primaryOk = GetTextViaPrimary(window, selectionInfo);
+    protocol->SetPrimaryReadCancel(nullptr);
+    uint32_t primaryMs = static_cast<uint32_t>(SteadyMs() - primaryStart);
+
+    lock.lock();
+
+    bool primaryCancelled = hedge_primary_cancel.load();
+    bool atspiWon = primaryCancelled;
+    if (!atspiWon && !primaryOk)
+    {
+        // PRIMARY has no answer: wait for AT-SPI2, starting it now if it is still delayed
+        hedge_job.hurry = true;
+        hedge_cv.notify_all();
+        hedge_cv.wait_for(lock, std::chrono::milliseconds(HEDGE_ATSPI_TIMEOUT_MS),
+                          [this] { return hedge_job.state == State::Done; });
+        atspiWon = hedge_job.state == State::Done && hedge_job.ok;
+    }
+
+    if (!atspiFirst && hedge_job.hedged)
+        stats.hedgedReads++;
+
+    if (atspiWon)
+    {
+        // A cancelled PRIMARY read took at least primaryMs
+        if (primaryOk || primaryCancelled)
+            read_latency.Record(programName, ReadSource::Primary, primaryMs);
+        read_latency.Record(programName, ReadSource::Atspi, hedge_job.latencyMs);
+        if (!atspiFirst && hedge_job.hedged)
+            stats.hedgeSecondaryWins++;
+
+        hedge_job.state = State::Idle;
+        selectionInfo = std::move(hedge_job.result);
+        selectionInfo.method = SelectionMethod::Atspi;
+        return true;
+    }
+
+    // Drop the AT-SPI2 read; one in progress took at least as long as it ran so far
+    if (hedge_job.started && hedge_job.state != State::Done)
+        read_latency.Record(programName, ReadSource::Atspi, static_cast<uint32_t>(SteadyMs() - hedge_job.startTime));
+    if (hedge_job.state == State::Done)
+        hedge_job.state = State::Idle;
+    else
+        hedge_job.cancelled = true;
+    hedge_cv.notify_all();
+
+    if (!primaryOk)
+        return false;
+
+    read_latency.Record(programName, ReadSource::Primary, primaryMs);
+    if (atspiFirst)
+        stats.hedgeSecondaryWins++;
+
+    selectionInfo.method = SelectionMethod::Primary;
+    return true;
+}
+
+/**
+ * Get text via the clipboard fallback (synthesized Ctrl+C)
+ */
+bool SelectionCore::GetTextViaClipboard(uint64_t window, TextSelectionInfo &selectionInfo)
+{
+    if (!window)
+        return false;
+
+    bool isInDelayReadList =
+        !selectionInfo.programName.empty() &&
+        IsProgramInList(selectionInfo.programId, selectionInfo.programName, PROGRAM_LIST_INCLUDE_DELAY_READ);
+
+    std::string selectedText;
+    if (protocol->GetTextViaClipboard(selectedText, isInDelayReadList) && !IsTrimmedEmpty(selectedText))
+    {
+        selectionInfo.text = selectedText;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Check if we should process GetTextViaClipboard
+ */
+bool SelectionCore::ShouldProcessViaClipboard(uint32_t programId, const std::string &programName)
+{
+    if (!is_enabled_clipboard || env_info.displayProtocol != DisplayProtocol::X11)
+        return false;
+
+    bool result = false;
+    switch (clipboard_filter_mode)
+    {
+        case FilterMode::Default:
+            result = true;
+            break;
+        case FilterMode::IncludeList:
+            result = IsProgramInList(programId, programName, PROGRAM_LIST_CLIPBOARD);
+            break;
+        case FilterMode::ExcludeList:
+            result = !IsProgramInList(programId, programName, PROGRAM_LIST_CLIPBOARD);
+            break;
+    }
+
+    if (!result)
+        return false;
+
+    // if trigger by user, we cannot determine the cursor shape
+    if (is_triggered_by_user)
+        return true;
+
+    // when mouse down or up, any one of them is a text cursor, we can use clipboard;
+    // otherwise only apps in the list can use clipboard (exclude cursor detection)
+    if (mouse_down_text_cursor || mouse_up_text_cursor)
+        return true;
+
+    return IsProgramInList(programId, programName, PROGRAM_LIST_EXCLUDE_CURSOR_DETECT);
+}
+
+/**
+ * Check if the global filter list rejects a program (an unknown program only passes exclude lists)
+ */
+bool SelectionCore::IsFilteredByGlobalList(bool hasProgramName, uint32_t programId, const std::string &programName)
+{
+    if (global_filter_mode == FilterMode::Default)
+        return false;
+
+    if (!hasProgramName)
+        return global_filter_mode == FilterMode::IncludeList;
+
+    bool isIn = IsProgramInList(programId, programName, PROGRAM_LIST_GLOBAL);
+    return (global_filter_mode == FilterMode::IncludeList && !isIn) ||
+           (global_filter_mode == FilterMode::ExcludeList && isIn);
+}
+
+/**
+ * Match a program against a filter list: cached per interned program, by value for a name
+ * past the interning limit
+ */
+bool SelectionCore::IsProgramInList(uint32_t programId, const std::string &programName, int list)
+{
+    const std::vector<std::string> *filterList = nullptr;
+    switch (list)
+    {
+        case PROGRAM_LIST_GLOBAL:
+            filterList = &global_filter_list;
+            break;
+        case PROGRAM_LIST_CLIPBOARD:
+            filterList = &clipboard_filter_list;
+            break;
+        case PROGRAM_LIST_EXCLUDE_CURSOR_DETECT:
+            filterList = &ftl_exclude_clipboard_cursor_detect;
+            break;
+        case PROGRAM_LIST_INCLUDE_DELAY_READ:
+            filterList = &ftl_include_clipboard_delay_read;
+            break;
+        default:
+            return false;
+    }
+
+    if (programId != ProgramNameTable::UNKNOWN)
+        return program_names.IsInList(programId, list, *filterList);
+    return IsInFilterList(programName, *filterList);
+}
+
+/**
+ * Helper method to copy a list of program names, lowercased for case-insensitive matching
+ */
+void SelectionCore::CopyToLowerCaseList(const std::vector<std::string> &source, std::vector<std::string> &targetList)
+{
+    // Clear existing list
+    targetList.clear();
+
+    for (std::string programName : source)
+    {
+        // Convert to lowercase
+        std::transform(programName.begin(), programName.end(), programName.begin(), ::tolower);
+
+        // Add to the target list
+        targetList.push_back(programName);
+    }
+}
+
+/**
+ * Input monitoring callback methods (protocol threads)
+ */
+void SelectionCore::OnMouseEventCallback(void *context, MouseEventContext *mouseEvent)
+{
+    SelectionCore *instance = static_cast<SelectionCore *>(context);
+    if (!instance || !mouseEvent || !instance->running.load() || !instance->AcceptInputEvent())
+    {
+        delete mouseEvent;
+        return;
+    }
+
+    // Update current mouse position
+    instance->current_mouse_pos = mouseEvent->pos;
+
+    // Track gesture button state for selection event suppression during drag.
+    // On X11, XRecord reports post-swap logical codes, so only BTN_LEFT matters.
+    // On Wayland, libevdev reports raw physical codes, so BTN_RIGHT must also
+    // be tracked for left-handed users (mirrors the guard at ProcessMouseEvent).
+    if (mouseEvent->code == BTN_LEFT ||
+        (mouseEvent->code == BTN_RIGHT && instance->env_info.displayProtocol == DisplayProtocol::Wayland))
+    {
+        instance->is_gesture_button_down.store(mouseEvent->value == 1);
+    }
+
+    QueuedEvent event;
+    event.kind = QueuedEvent::Kind::Mouse;
+    event.mouse = *mouseEvent;
+    instance->QueueEvent(event);
+
+    delete mouseEvent;
+}
+
+void SelectionCore::OnKeyboardEventCallback(void *context, KeyboardEventContext *keyboardEvent)
+{
+    SelectionCore *instance = static_cast<SelectionCore *>(context);
+    if (!instance || !keyboardEvent || !instance->running.load() || !instance->AcceptInputEvent())
+    {
+        delete keyboardEvent;
+        return;
+    }
+
+    QueuedEvent event;
+    event.kind = QueuedEvent::Kind::Keyboard;
+    event.keyboard = *keyboardEvent;
+    instance->QueueEvent(event);
+
+    delete keyboardEvent;
+}
+
+/**
+ * Selection change event callback (XFixes on X11, data-control on Wayland).
+ * Called from the protocol's selection monitoring thread, or from Dispatch() in in-loop mode.
+ */
+void SelectionCore::OnSelectionEventCallback(void *context, SelectionChangeContext *selectionEvent)
+{
+    SelectionCore *instance = static_cast<SelectionCore *>(context);
+    if (!instance || !selectionEvent || instance->suspend_reasons.load() != 0)
+    {
+        delete selectionEvent;
+        return;
+    }
+
+    uint64_t timestamp = selectionEvent->timestamp_ms;
+    uint64_t owner = selectionEvent->owner;
+    delete selectionEvent;
+
+    // Atomic write — executed in protocol selection thread, read by Path A in dispatch thread
+    instance->last_selection_event_time.store(timestamp);
+
+    // During mouse drag: skip queueing.  Path A will pick up
+    // last_selection_event_time when ButtonRelease is processed.  Only queue when:
+    //   - Path B: mouse is up (pending_gesture may be awaiting confirmation)
+    //   - Path C: no-input fallback mode (always needs dispatch for debounce)
+    if (instance->is_gesture_button_down.load())
+    {
+        // Mouse button held — record that a selection event arrived during drag,
+        // so drag gestures can bypass the 500ms correlation window at mouse-up.
+        instance->had_selection_during_drag.store(true);
+
+        // Still reported to the host when it asked for selection change events
+        if (instance->is_enabled_selection_change_event.load() && instance->running.load())
+        {
+            QueuedEvent event;
+            event.kind = QueuedEvent::Kind::SelectionChange;
+            event.timestamp = timestamp;
+            event.owner = owner;
+            event.notifyOnly = true;
+            instance->QueueEvent(event);
+        }
+        return;
+    }
+
+    // Queue for Path B / Path C processing
+    if (instance->running.load())
+    {
+        QueuedEvent event;
+        event.kind = QueuedEvent::Kind::SelectionChange;
+        event.timestamp = timestamp;
+        event.owner = owner;
+        instance->QueueEvent(event);
+    }
+}
+
+/**
+ * Process mouse event on the dispatch thread and detect text selection gestures.
+ * Correlates recognized gestures with selection change events via Path A or Path B;
+ * unconfirmed Path B gestures are handed to the clipboard fallback (Path D, X11).
+ */
+void SelectionCore::ProcessMouseEvent(const MouseEventContext &mouseEvent)
+{
+    // Get current time in milliseconds
+    auto currentTime =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+
+    Point currentPos = mouseEvent.pos;
+    auto mouseCode = mouseEvent.code;
+    auto mouseValue = mouseEvent.value;
+    MouseButton mouseButton = static_cast<MouseButton>(mouseEvent.button);
+
+    MouseAction mouseAction = MouseAction::Unknown;
+    bool hasMouseAction = true;
+    int mouseFlagValue = 0;
+    double mouseDelta = 0;
+
+    // Process different mouse events based on libevdev codes
+    switch (mouseCode)
+    {
+        case BTN_LEFT:
+        case BTN_RIGHT:
+            // Monitor both buttons for gesture detection so that left-handed users
+            // (who swap buttons) can trigger selections with their primary button.
+            // On Wayland, libevdev reads raw physical button codes from /dev/input,
+            // bypassing libinput's left-handed swap. The gesture-selection correlation
+            // mechanism (requiring both a gesture AND a selection-change event within
+            // 500ms) naturally filters out right-click actions that don't produce
+            // text selections.
+
+            // On X11, XRecord captures post-swap logical events, so left-handed
+            // users already report BTN_LEFT as their primary button. Skip gesture
+            // tracking for BTN_RIGHT on X11 — only Wayland (libevdev) needs it.
+            if (mouseCode == BTN_RIGHT && env_info.displayProtocol != DisplayProtocol::Wayland)
+            {
+                mouseAction = (mouseValue == 1) ? MouseAction::Down : MouseAction::Up;
+                mouseButton = MouseButton::Right;
+                break;
+            }
+
+            if (mouseValue == 1)  // Press
+            {
+                mouseAction = MouseAction::Down;
+                mouseButton = (mouseCode == BTN_LEFT) ? MouseButton::Left : MouseButton::Right;
+
+                // Update mouse-down state
+                last_mouse_down_time = currentTime;
+                last_mouse_down_pos = currentPos;
+
+                // Query display server for accurate screen coordinates at gesture start.
+                // On X11 this duplicates last_mouse_down_pos; on Wayland it provides the
+                // first reliable coordinate for drag gesture reporting (MouseDual).
+                if (env_info.displayProtocol == DisplayProtocol::Wayland)
+                {
+                    queried_mouse_down_pos = protocol->GetCurrentMousePosition();
+                }
+
+                // Clear pending gesture (prevent old pending from being triggered by new action)
+                pending_gesture.active = false;
+                had_selection_during_drag.store(false);
+
+                // Store mouse down cursor when clipboard is enabled
+                mouse_down_text_cursor = is_enabled_clipboard && protocol->IsTextCursor();
+
+                // Record window handle and position at mouse-down for movement detection
+                last_window_handler = protocol->GetActiveWindow();
+                if (last_window_handler)
+                {
+                    protocol->GetWindowRect(last_window_handler, last_window_rect);
+                }
+            }
+            else if (mouseValue == 0)  // Release
+            {
+                mouseAction = MouseAction::Up;
+                mouseButton = (mouseCode == BTN_LEFT) ? MouseButton::Left : MouseButton::Right;
+
+                // Update mouse-up state (save previous values first)
+                Point prevUp = last_mouse_up_pos;
+                uint64_t prevUpTime = last_mouse_up_time;
+                last_mouse_up_time = currentTime;
+                last_mouse_up_pos = currentPos;
+                last_mouse_up_modifier_flags = protocol->GetModifierFlags();
+                mouse_up_text_cursor = is_enabled_clipboard && protocol->IsTextCursor();
+
+                if (!is_selection_passive_mode)
+                {
+                    // Gesture detection
+                    auto detectionType = SelectionDetectType::None;
+
+                    double dx = currentPos.x - last_mouse_down_pos.x;
+                    double dy = currentPos.y - last_mouse_down_pos.y;
+                    double distance = sqrt(dx * dx + dy * dy);
+
+                    bool isCurrentValidClick = (currentTime - last_mouse_down_time) <= DOUBLE_CLICK_TIME_MS;
+
+                    if ((currentTime - last_mouse_down_time) > MAX_DRAG_TIME_MS)
+                    {
+                        // Too long drag, skip
+                    }
+                    // Check for drag selection
+                    else if (distance >= MIN_DRAG_DISTANCE)
+                    {
+                        uint64_t upWindow = protocol->GetActiveWindow();
+                        if (upWindow && upWindow == last_window_handler)
+                        {
+                            // Same window at mouse-down and mouse-up: verify window wasn't
+                            // dragged (moved) to distinguish text selection from window drag.
+                            WindowRect currentWindowRect;
+                            protocol->GetWindowRect(upWindow, currentWindowRect);
+                            if (!HasWindowMoved(currentWindowRect, last_window_rect))
+                            {
+                                detectionType = SelectionDetectType::Drag;
+                            }
+                        }
+                        else if (upWindow && upWindow != last_window_handler)
+                        {
+                            // Active window changed between mouse-down and mouse-up.
+                            // This happens when the user drags to select text in an unfocused
+                            // window — the click causes focus to shift.  Allow the drag gesture;
+                            // XFixes correlation will validate whether a real selection occurred.
+                            detectionType = SelectionDetectType::Drag;
+                        }
+                    }
+                    // Check for double-click selection
+                    else if (is_last_valid_click && isCurrentValidClick && distance <= DOUBLE_CLICK_MAX_DISTANCE)
+                    {
+                        double dx2 = currentPos.x - prevUp.x;
+                        double dy2 = currentPos.y - prevUp.y;
+                        double distance2 = sqrt(dx2 * dx2 + dy2 * dy2);
+
+                        if (distance2 <= DOUBLE_CLICK_MAX_DISTANCE &&
+                            (last_mouse_down_time - prevUpTime) <= DOUBLE_CLICK_TIME_MS)
+                        {
+                            uint64_t upWindow = protocol->GetActiveWindow();
+                            if (upWindow && upWindow == last_window_handler)
+                            {
+                                WindowRect currentWindowRect;
+                                protocol->GetWindowRect(upWindow, currentWindowRect);
+                                if (!HasWindowMoved(currentWindowRect, last_window_rect))
+                                {
+                                    detectionType = SelectionDetectType::DoubleClick;
+                                }
+                            }
+                        }
+                    }
+
+                    // Check shift+click selection
+                    if (detectionType == SelectionDetectType::None)
+                    {
+                        int modFlags = last_mouse_up_modifier_flags;
+                        bool isShiftPressed = (modFlags & MODIFIER_SHIFT) != 0;
+                        bool isCtrlPressed = (modFlags & MODIFIER_CTRL) != 0;
+                        bool isAltPressed = (modFlags & MODIFIER_ALT) != 0;
+                        if (isShiftPressed && !isCtrlPressed && !isAltPressed)
+                        {
+                            detectionType = SelectionDetectType::ShiftClick;
+                        }
+                    }
+
+                    // Correlate recognized gesture with selection change event
+                    if (detectionType != SelectionDetectType::None)
+                    {
+                        uint64_t lastSelectionEvent = last_selection_event_time.load();
+
+                        // Determine mouse coordinates for the event
+                        Point gestureStart, gestureEnd;
+                        switch (detectionType)
+                        {
+                            case SelectionDetectType::Drag:
+                                gestureStart = last_mouse_down_pos;
+                                gestureEnd = currentPos;
+                                break;
+                            case SelectionDetectType::DoubleClick:
+                                gestureStart = currentPos;
+                                gestureEnd = currentPos;
+                                break;
+                            case SelectionDetectType::ShiftClick:
+                                gestureStart = prev_mouse_up_pos;
+                                gestureEnd = currentPos;
+                                break;
+                            default:
+                                gestureStart = currentPos;
+                                gestureEnd = currentPos;
+                                break;
+                        }
+
+                        bool emitted = false;
+
+                        // Drag correlation: selection event arrived during drag — directly
+                        // correlated regardless of how long ago (bypasses 500ms window).
+                        if (detectionType == SelectionDetectType::Drag && had_selection_during_drag.load())
+                        {
+                            had_selection_during_drag.store(false);
+                            emitted = EmitSelectionEvent(detectionType, gestureStart, gestureEnd);
+                            if (emitted)
+                            {
+                                // Consume timestamps only on success to allow Path A retry on failure
+                                last_selection_event_time.store(0);
+                                lastSelectionEvent = 0;
+                            }
+                        }
+
+                        // Path A: selection change event already arrived within correlation window.
+                        // If EmitSelectionEvent fails (e.g., selection data not yet available),
+                        // fall through to Path B to wait for the actual selection event.
+                        if (!emitted && lastSelectionEvent > 0 &&
+                            (static_cast<uint64_t>(currentTime) - lastSelectionEvent) < CORRELATION_WINDOW_MS)
+                        {
+                            last_selection_event_time.store(0);  // Consume
+                            emitted = EmitSelectionEvent(detectionType, gestureStart, gestureEnd);
+                        }
+
+                        if (!emitted)
+                        {
+                            // Path B: store pending gesture, wait for selection change event
+                            pending_gesture.active = true;
+                            pending_gesture.type = detectionType;
+                            pending_gesture.mousePosStart = gestureStart;
+                            pending_gesture.mousePosEnd = gestureEnd;
+                            pending_gesture.timestamp = currentTime;
+
+                            // Path D: arm the clipboard fallback in case no selection change arrives
+                            if (clipboard_fallback_running.load() && is_enabled_clipboard)
+                            {
+                                clipboard_fallback_gesture_time.store(currentTime);
+                                clipboard_fallback_cv.notify_one();
+                            }
+                        }
+                    }
+
+                    is_last_valid_click = isCurrentValidClick;
+                }
+
+                prev_mouse_up_pos = prevUp;
+                prev_mouse_up_time = prevUpTime;
+            }
+            else
+            {
+                hasMouseAction = false;
+            }
+            break;
+
+        case BTN_MIDDLE:
+            mouseAction = (mouseValue == 1) ? MouseAction::Down : MouseAction::Up;
+            mouseButton = MouseButton::Middle;
+            break;
+
+        case REL_WHEEL:
+            mouseAction = MouseAction::Wheel;
+            mouseButton = MouseButton::WheelVertical;
+            mouseFlagValue = mouseValue > 0 ? 1 : -1;
+            mouseDelta = mouseEvent.delta != 0 ? mouseEvent.delta : mouseValue;
+            break;
+
+        case REL_HWHEEL:
+            mouseAction = MouseAction::Wheel;
+            mouseButton = MouseButton::WheelHorizontal;
+            mouseFlagValue = mouseValue > 0 ? 1 : -1;
+            mouseDelta = mouseEvent.delta != 0 ? mouseEvent.delta : mouseValue;
+            break;
+
+        default:
+            if (mouseCode == REL_X || mouseCode == REL_Y)
+            {
+                mouseAction = MouseAction::Move;
+                mouseButton = MouseButton::None;
+            }
+            else
+            {
+                mouseAction = MouseAction::Unknown;
+                mouseButton = MouseButton::Unknown;
+            }
+            break;
+    }
+
+    if (!hasMouseAction || !mouse_callback)
+        return;
+
+    // Filter mouse move events based on the flag
+    if (mouseAction == MouseAction::Move && !is_enabled_mouse_move_event)
+        return;
+
+    CoreMouseEvent coreEvent;
+    coreEvent.action = mouseAction;
+    coreEvent.pos = currentPos;
+    coreEvent.button = mouseButton;
+    coreEvent.flag = mouseFlagValue;
+    coreEvent.delta = mouseDelta;
+    coreEvent.device = mouseEvent.device;
+    coreEvent.time = mouseEvent.time;
+    mouse_callback(callback_context, coreEvent);
+}
+
+/**
+ * Process selection change event on the dispatch thread.
+ *
+ * Three paths for selection detection:
+ *   Path A: Mouse gesture detected, selection change event already arrived (fast path)
+ *   Path B: Mouse gesture detected, waiting for selection change event confirmation
+ *   Path C: No-input fallback — selection change event + debounce (no libevdev)
+ */
+void SelectionCore::ProcessSelectionEvent(uint64_t timestamp)
+{
+    if (pending_gesture.active)
+    {
+        // Use selection event timestamp (not wall clock "now") to avoid false expiry
+        // under host-thread load when Dispatch() is delayed.
+        // Note: timestamp is captured in the protocol thread (at XFixes/data-control
+        // event time), while pending_gesture.timestamp is captured later in the dispatch thread
+        // (at ProcessMouseEvent time).  The selection event timestamp is often slightly earlier,
+        // so we use signed arithmetic to handle either ordering correctly.
+        int64_t delta = (int64_t)timestamp - (int64_t)pending_gesture.timestamp;
+        if (std::abs(delta) < (int64_t)CORRELATION_WINDOW_MS)
+        {
+            // Path B: pending gesture confirmed by selection change event
+            last_selection_event_time.store(0);  // Consume
+            bool path_b_emitted = EmitSelectionEvent(pending_gesture.type, pending_gesture.mousePosStart,
+                                                     pending_gesture.mousePosEnd);
+            // Always clear pending gesture regardless of success — keeping it active risks
+            // misattributing a future unrelated selection event to this stale gesture.
+            pending_gesture.active = false;
+            (void)path_b_emitted;  // return value captured for observability; drop is accepted
+        }
+        else
+        {
+            // Pending expired, clear it
+            pending_gesture.active = false;
+        }
+    }
+    else if (is_no_input_fallback && !is_selection_passive_mode)
+    {
+        // Path C: No-input fallback - reset debounce timer
+        debounce_last_event_time.store(timestamp);
+        debounce_cv.notify_one();
+    }
+    // else: no pending gesture and no fallback, skip
+}
+
+/**
+ * Path D: the correlation window of a pending gesture elapsed (X11 only).
+ * The gesture came from an app that doesn't set PRIMARY; read via the clipboard fallback.
+ */
+void SelectionCore::ProcessGestureExpired(uint64_t gestureTime)
+{
+    // Confirmed (Path B) or replaced by a newer gesture meanwhile
+    if (!pending_gesture.active || pending_gesture.timestamp != gestureTime)
+        return;
+
+    pending_gesture.active = false;
+    EmitSelectionEvent(pending_gesture.type, pending_gesture.mousePosStart, pending_gesture.mousePosEnd, true);
+}
+
+void SelectionCore::OnSessionStateCallback(void *context, int state)
+{
+    static_cast<SelectionCore *>(context)->UpdateSuspendReasons(SESSION_STATE_ALL, state);
+}
+
+void SelectionCore::OnFullscreenCallback(void *context, bool fullscreen, const std::string &programName)
+{
+    SelectionCore *instance = static_cast<SelectionCore *>(context);
+
+    bool suspend = fullscreen && !IsInFilterList(programName, instance->fullscreen_keep_running);
+    instance->is_fullscreen_focused.store(suspend);
+    if (suspend && !programName.empty())
+        LogMessage(LogLevel::Debug, "[Session] Fullscreen window of %s focused", programName.c_str());
+
+    // Before running is set, Start() applies the recorded state
+    if (instance->running.load())
+        instance->UpdateSuspendReasons(SESSION_FULLSCREEN, suspend ? SESSION_FULLSCREEN : 0);
+}
+
+void SelectionCore::UpdateSuspendReasons(int mask, int reasons)
+{
+    std::lock_guard<std::mutex> lock(suspend_mutex);
+
+    int previous = suspend_reasons.load();
+    int next = (previous & ~mask) | (reasons & mask);
+    suspend_reasons.store(next);
+
+    // The input threads keep reading while only idle states are set, so the next input can resume
+    bool inputSuspended = (next & ~SESSION_ENDED_BY_INPUT) != 0;
+    if (protocol && inputSuspended != ((previous & ~SESSION_ENDED_BY_INPUT) != 0))
+        protocol->SetInputSuspended(inputSuspended);
+
+    // Only the transitions between active and suspended matter to the host
+    if ((previous != 0) == (next != 0))
+        return;
+
+    if (next != 0)
+        LogMessage(LogLevel::Info, "[Session] Input suspended (reasons 0x%x)", next);
+    else
+        LogMessage(LogLevel::Info, "[Session] Input resumed");
+
+    QueuedEvent event;
+    event.kind = QueuedEvent::Kind::SuspendChanged;
+    event.owner = static_cast<uint64_t>(next);
+    QueueEvent(event);
+}
+
+/**
+ * Whether an input event may be queued (protocol threads). Idle and the screen saver end
+ * with the first input: the hook resumes at once and the event is delivered, without
+ * waiting for logind or ScreenSaverNotify to report it. Other states drop the event.
+ */
+bool SelectionCore::AcceptInputEvent()
+{
+    int reasons = suspend_reasons.load();
+    if (reasons & ~SESSION_ENDED_BY_INPUT)
+        return false;
+
+    if (reasons != 0)
+        UpdateSuspendReasons(SESSION_ENDED_BY_INPUT, 0);
+    return true;
+}
+
+/**
+ * Input dispatch was suspended or resumed (dispatch thread).
+ * A gesture that started before the suspension can't be completed: its mouse-up is never seen.
+ */
+void SelectionCore::ProcessSuspendChanged(int reasons)
+{
+    if (reasons != 0)
+    {
+        pending_gesture.active = false;
+        last_mouse_down_time = 0;  // a mouse-up after resuming is then discarded as an overlong drag
+        is_gesture_button_down.store(false);
+        had_selection_during_drag.store(false);
+        debounce_last_event_time.store(0);
+        clipboard_fallback_gesture_time.store(0);
+    }
+
+    if (suspend_callback)
+        suspend_callback(callback_context, reasons);
+}
+
+/**
+ * Debounce thread for no-input fallback (Path C).
+ * When libevdev is unavailable, data-control events alone trigger selection
+ * detection after a quiet period (no new events for NO_INPUT_DEBOUNCE_MS).
+ */
+void SelectionCore::DebounceThreadProc()
+{
+    ApplyThreadScheduling("sh-debounce", nullptr);
+
+    while (debounce_running.load())
+    {
+        // Phase 1: Idle wait — block until a data-control event arrives or shutdown
+        {
+            std::unique_lock<std::mutex> lock(debounce_mutex);
+            debounce_cv.wait(lock, [this] { return debounce_last_event_time.load() != 0 || !debounce_running.load(); });
+        }
+
+        if (!debounce_running.load())
+            break;
+
+        // Phase 2: Active debounce — wait for quiet period
+        while (debounce_running.load())
+        {
+            uint64_t last = debounce_last_event_time.load();
+            if (last == 0)
+                break;  // Consumed elsewhere, go back to idle wait
+
+            uint64_t elapsed = NowMs() - last;
+            if (elapsed >= NO_INPUT_DEBOUNCE_MS)
+            {
+                // Quiet period elapsed — fire selection event on the dispatch thread
+                debounce_last_event_time.store(0);
+
+                if (!running.load())
+                    break;
+
+                QueuedEvent event;
+                event.kind = QueuedEvent::Kind::DebounceExpired;
+                QueueEvent(event);
+                break;
+            }
+            else
+            {
+                // Wait for remaining debounce time (or new event / shutdown)
+                auto remaining = std::chrono::milliseconds(NO_INPUT_DEBOUNCE_MS - elapsed);
+                std::unique_lock<std::mutex> lock(debounce_mutex);
+                debounce_cv.wait_for(lock, remaining);
+            }
+        }
+    }
+}
+
+/**
+ * Hedge thread: runs the AT-SPI2 read of GetTextHedged(), after the start delay when
+ * PRIMARY goes first. Started with AT-SPI2.
+ */
+void SelectionCore::HedgeThreadProc()
+{
+    using State = HedgeJob::State;
+
+    ApplyThreadScheduling("sh-hedge", nullptr);
+
+    std::unique_lock<std::mutex> lock(hedge_mutex);
+    while (true)
+    {
+        hedge_cv.wait(lock, [this] { return !hedge_running || hedge_job.state == State::Pending; });
+        if (!hedge_running)
+            break;
+
+        hedge_job.state = State::Running;
+        if (hedge_job.delayMs > 0)
+        {
+            hedge_cv.wait_for(lock, std::chrono::milliseconds(hedge_job.delayMs),
+                              [this] { return !hedge_running || hedge_job.cancelled || hedge_job.hurry; });
+            if (!hedge_running)
+                break;
+        }
+
+        if (hedge_job.cancelled)
+        {
+            hedge_job.state = State::Idle;
+            continue;
+        }
+
+        hedge_job.hedged = hedge_job.delayMs > 0 && !hedge_job.hurry;
+        hedge_job.started = true;
+        hedge_job.startTime = SteadyMs();
+        uint64_t sinceMs = hedge_job.sinceMs;
+        bool withExtents = hedge_job.withExtents;
+        TextSelectionInfo result = hedge_job.result;
+
+        lock.unlock();
+        bool ok = atspi.ReadSelection(sinceMs, withExtents, result);
+        uint64_t endTime = SteadyMs();
+        lock.lock();
+
+        if (hedge_job.cancelled)
+        {
+            hedge_job.state = State::Idle;
+            continue;
+        }
+
+        hedge_job.ok = ok;
+        hedge_job.latencyMs = static_cast<uint32_t>(endTime - hedge_job.startTime);
+        hedge_job.result = std::move(result);
+        hedge_job.state = State::Done;
+        if (ok)
+            hedge_primary_cancel.store(true);
+        hedge_cv.notify_all();
+    }
+}
+
+void SelectionCore::StopHedgeThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(hedge_mutex);
+        hedge_running = false;
+    }
+    hedge_cv.notify_all();
+    if (hedge_thread.joinable())
+        hedge_thread.join();
+    hedge_job = HedgeJob();
+}
+
+/**
+ * Clipboard fallback thread (Path D, X11 only).
+ * A gesture stored as pending (Path B) that is not confirmed by a selection change
+ * event within CORRELATION_WINDOW_MS came from an app that doesn't set PRIMARY.
+ * Once the window elapses, the gesture is handed to the dispatch thread, which reads
+ * the selection via the clipboard fallback.
+ */
+void SelectionCore::ClipboardFallbackThreadProc()
+{
+    ApplyThreadScheduling("sh-clip-timer", nullptr);
+
+    while (clipboard_fallback_running.load())
+    {
+        // Phase 1: Idle wait — block until a gesture is armed or shutdown
+        {
+            std::unique_lock<std::mutex> lock(clipboard_fallback_mutex);
+            clipboard_fallback_cv.wait(lock, [this] {
+                return clipboard_fallback_gesture_time.load() != 0 || !clipboard_fallback_running.load();
+            });
+        }
+
+        if (!clipboard_fallback_running.load())
+            break;
+
+        // Phase 2: Wait for the correlation window of the armed gesture to elapse
+        uint64_t gestureTime = clipboard_fallback_gesture_time.load();
+        if (gestureTime == 0)
+            continue;
+
+        uint64_t elapsed = NowMs() - gestureTime;
+        if (elapsed < CORRELATION_WINDOW_MS)
+        {
+            // Wait for remaining window (or a newer gesture / shutdown)
+            auto remaining = std::chrono::milliseconds(CORRELATION_WINDOW_MS - elapsed);
+            std::unique_lock<std::mutex> lock(clipboard_fallback_mutex);
+            clipboard_fallback_cv.wait_for(lock, remaining);
+            continue;
+        }
+
+        // Window elapsed — consume unless a newer gesture replaced it meanwhile
+        if (!clipboard_fallback_gesture_time.compare_exchange_strong(gestureTime, 0))
+            continue;
+
+        if (!running.load())
+            continue;
+
+        QueuedEvent event;
+        event.kind = QueuedEvent::Kind::GestureExpired;
+        event.timestamp = gestureTime;
+        QueueEvent(event);
+    }
+}
+
+/**
+ * Emit text selection event (shared by Path A, Path B, Path C, and Path D).
+ * Returns true if the event was successfully emitted, false otherwise.
+ */
+bool SelectionCore::EmitSelectionEvent(SelectionDetectType type, Point start, Point end, bool skipPrimary)
+{
+    if (is_selection_passive_mode || is_processing.load())
+        return false;
+
+    uint64_t activeWindow = protocol->GetActiveWindow();
+    if (!activeWindow)
+        return false;
+
+    TextSelectionInfo selectionInfo;
+    if (!GetSelectedText(activeWindow, selectionInfo, skipPrimary) || IsTrimmedEmpty(selectionInfo.text))
+        return false;
+
+    // Set coordinates and posLevel based on detection type
+    switch (type)
+    {
+        case SelectionDetectType::Drag:
+            selectionInfo.mousePosStart = start;
+            selectionInfo.mousePosEnd = end;
+            if (selectionInfo.posLevel == SelectionPositionLevel::None)
+                selectionInfo.posLevel = SelectionPositionLevel::MouseDual;
+            break;
+        case SelectionDetectType::DoubleClick:
+            selectionInfo.mousePosStart = start;
+            selectionInfo.mousePosEnd = end;
+            if (selectionInfo.posLevel == SelectionPositionLevel::None)
+                selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
+            break;
+        case SelectionDetectType::ShiftClick:
+            selectionInfo.mousePosStart = start;
+            selectionInfo.mousePosEnd = end;
+            if (selectionInfo.posLevel == SelectionPositionLevel::None)
+                selectionInfo.posLevel = SelectionPositionLevel::MouseDual;
+            break;
+        default:
+            break;
+    }
+
+    // Wayland: refine coordinates using display server query.
+    // Replaces unreliable libevdev positions with compositor/XWayland coordinates.
+    if (env_info.displayProtocol == DisplayProtocol::Wayland)
+    {
+        Point accuratePos = protocol->GetCurrentMousePosition();
+
+        switch (type)
+        {
+            case SelectionDetectType::Drag:
+            {
+                if (queried_mouse_down_pos.valid && accuratePos.valid)
+                {
+                    // XWayland frozen: position unchanged despite physical drag → stale coordinates
+                    if (accuratePos.x == queried_mouse_down_pos.x && accuratePos.y == queried_mouse_down_pos.y)
+                    {
+                        selectionInfo.mousePosStart.valid = false;
+                        selectionInfo.mousePosEnd.valid = false;
+                        selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
+                    }
+                    else
+                    {
+                        // Both start (mouse-down) and end (emission) are accurate
+                        selectionInfo.mousePosStart = queried_mouse_down_pos;
+                        selectionInfo.mousePosEnd = accuratePos;
+                        selectionInfo.posLevel = SelectionPositionLevel::MouseDual;
+                    }
+                }
+                else if (accuratePos.valid)
+                {
+                    // Only emission-time position is accurate
+                    selectionInfo.mousePosEnd = accuratePos;
+                    selectionInfo.mousePosStart = accuratePos;  // start = end
+                    selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
+                }
+                else
+                {
+                    // Both invalid (no compositor IPC, no XWayland)
+                    selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
+                }
+                break;
+            }
+            case SelectionDetectType::DoubleClick:
+                if (accuratePos.valid)
+                {
+                    selectionInfo.mousePosStart = accuratePos;
+                    selectionInfo.mousePosEnd = accuratePos;
+                }
+                // posLevel stays MouseSingle (double-click is always single point)
+                break;
+            case SelectionDetectType::ShiftClick:
+                if (accuratePos.valid)
+                {
+                    selectionInfo.mousePosEnd = accuratePos;
+                    selectionInfo.mousePosStart = accuratePos;  // start = end
+                }
+                selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (is_text_classification)
+        selectionInfo.tags = ClassifyText(selectionInfo.text);
+
+    DeliverSelection(selectionInfo);
+    return true;
+}
+
+/**
+ * Record an emitted selection in the history and hand it to the host
+ */
+void SelectionCore::DeliverSelection(const TextSelectionInfo &selectionInfo)
+{
+    history.Add(selectionInfo.text, selectionInfo.programName, selectionInfo.programId, static_cast<int64_t>(NowMs()));
+
+    if (selection_callback)
+    {
+        stats.selectionsEmitted++;
+        selection_callback(callback_context, selectionInfo);
+    }
+}
+
+/**
+ * Report a selection owner change to the host. The owner's program name is
+ * resolved once per owner window: owners re-assert the selection while it grows.
+ */
+void SelectionCore::DeliverSelectionChange(const QueuedEvent &event)
+{
+    CoreSelectionChangeEvent changeEvent;
+    changeEvent.timestamp = event.timestamp;
+    changeEvent.owner = event.owner;
+    changeEvent.isDragging = event.notifyOnly;
+
+    if (event.owner)
+    {
+        if (event.owner != change_owner)
+        {
+            change_owner_program.clear();
+            protocol->GetProgramNameFromWindow(event.owner, change_owner_program);
+            change_owner_program_id = program_names.Intern(change_owner_program);
+            change_owner = event.owner;
+        }
+        changeEvent.programName = change_owner_program;
+        changeEvent.programId = change_owner_program_id;
+    }
+
+    selection_change_callback(callback_context, changeEvent);
+}
+
+/**
+ * Process keyboard event on the dispatch thread
+ */
+void SelectionCore::ProcessKeyboardEvent(const KeyboardEventContext &keyboardEvent)
+{
+    if (!keyboard_callback)
+        return;
+
+    auto keyCode = keyboardEvent.code;
+    auto keyValue = keyboardEvent.value;
+    auto keyFlags = keyboardEvent.flags;
+
+    CoreKeyboardEvent coreEvent;
+
+    // Determine event type
+    switch (keyValue)
+    {
+        case 0:  // Key release
+            coreEvent.action = KeyboardAction::Up;
+            break;
+        case 1:  // Key press
+            coreEvent.action = KeyboardAction::Down;
+            break;
+        case 2:  // Key repeat
+            coreEvent.action = KeyboardAction::Down;
+            break;
+        default:
+            coreEvent.action = KeyboardAction::Unknown;
+            break;
+    }
+
+    coreEvent.code = keyCode;
+    coreEvent.flags = keyFlags;
+
+    // Check if any system key (Ctrl, Alt, Super) is being pressed
+    coreEvent.sys = (keyFlags & MODIFIER_CTRL) || (keyFlags & MODIFIER_ALT) || (keyFlags & MODIFIER_META);
+
+    // Convert Linux key code to universal key string (MDN KeyboardEvent.key)
+    coreEvent.uniKey = convertKeyCodeToUniKey(keyCode, keyFlags);
+
+    coreEvent.device = keyboardEvent.device;
+    coreEvent.time = keyboardEvent.time;
+
+    keyboard_callback(callback_context, coreEvent);
+}
+
+//=============================================================================
+// Event injection (test-only)
+//=============================================================================
+
+/**
+ * Start feeding synthetic events through the same entry points as the protocol
+ * threads, so that the whole delivery path (queue, Dispatch, host callbacks) can be
+ * measured without real input.
+ */
+bool SelectionCore::InjectEvents(InjectEventKind kind, uint32_t count, uint32_t ratePerSecond)
+{
+    if (!running.load() || inject_active.load())
+        return false;
+
+    // A finished injection leaves its thread joinable
+    StopInjection();
+
+    inject_running = true;
+    inject_active = true;
+    // Interned here: the table belongs to this thread
+    uint32_t programId = program_names.Intern(INJECT_PROGRAM_NAME);
+    inject_thread = std::thread(&SelectionCore::InjectThreadProc, this, kind, count, ratePerSecond, programId);
+    return true;
+}
+
+void SelectionCore::StopInjection()
+{
+    inject_running = false;
+    if (inject_thread.joinable())
+        inject_thread.join();
+    inject_active = false;
+}
+
+void SelectionCore::InjectThreadProc(InjectEventKind kind, uint32_t count, uint32_t ratePerSecond, uint32_t programId)
+{
+    ApplyThreadScheduling("sh-inject", nullptr);
+
+    auto selection = std::make_shared<TextSelectionInfo>();
+    selection->text = "selection-hook injected selection";
+    selection->programName = INJECT_PROGRAM_NAME;
+    selection->programId = programId;
+    selection->method = SelectionMethod::Primary;
+    selection->posLevel = SelectionPositionLevel::MouseDual;
+    selection->mousePosStart = Point(100, 100);
+    selection->mousePosEnd = Point(300, 100);
+    if (is_text_classification)
+        selection->tags = ClassifyText(selection->text);
+
+    auto interval = std::chrono::nanoseconds(ratePerSecond ? 1000000000ull / ratePerSecond : 0);
+    auto next = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0; i < count && inject_running.load() && running.load(); i++)
+    {
+        Point pos(100 + static_cast<int>(i % 200), 100);
+
+        switch (kind)
+        {
+            case InjectEventKind::MouseMove:
+                OnMouseEventCallback(this, new MouseEventContext{EV_REL, REL_X, 1, pos, 0, 0});
+                break;
+            case InjectEventKind::MouseWheel:
+            {
+                int direction = (i % 2) ? -1 : 1;
+                OnMouseEventCallback(this, new MouseEventContext{EV_REL, REL_WHEEL, direction, pos, 0, direction});
+                break;
+            }
+            case InjectEventKind::MouseClick:
+                OnMouseEventCallback(this, new MouseEventContext{EV_KEY, BTN_MIDDLE, 1, pos, 0, 0});
+                OnMouseEventCallback(this, new MouseEventContext{EV_KEY, BTN_MIDDLE, 0, pos, 0, 0});
+                break;
+            case InjectEventKind::Keyboard:
+                OnKeyboardEventCallback(this, new KeyboardEventContext{EV_KEY, KEY_A, 1, 0});
+                OnKeyboardEventCallback(this, new KeyboardEventContext{EV_KEY, KEY_A, 0, 0});
+                break;
+            case InjectEventKind::Selection:
+            {
+                QueuedEvent event;
+                event.kind = QueuedEvent::Kind::InjectedSelection;
+                event.timestamp = NowMs();
+                event.selection = selection;
+                QueueEvent(event);
+                break;
+            }
+        }
+
+        if (ratePerSecond)
+        {
+            next += interval;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    inject_active = false;
+}
@@ -0,0 +1,550 @@
+/**
+ * Selection Hook Core for Linux
+ *
+ * The text selection engine without any Node.js dependency: display protocol
+ * (X11/Wayland), input monitoring, gesture detection and the gesture/selection
+ * change correlation (Path A/B/C/D). Built as the selection-hook-core static
+ * library; the N-API addon (selection_hook.cc) and the C API
+ * (selection_hook_core.h) are thin wrappers around SelectionCore.
+ *
+ * Threading model:
+ * Protocol input threads and the Path C/D timer threads only queue events and
+ * signal GetFd(). The host waits for GetFd() to become readable and calls
+ * Dispatch() on its own thread. Gesture detection, selection reads and all
+ * callbacks run synchronously inside Dispatch(). Configuration setters,
+ * GetCurrentSelection() and GetSelectionSnapshot() must be called from that
+ * same thread.
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common.h"
+#include "../lib/atspi.h"
+#include "../lib/program_names.h"
+#include "../lib/read_latency.h"
+#include "../lib/selection_history.h"
+#include "../lib/session_state.h"
+
+// Mouse event action reported by SelectionCore
+enum class MouseAction
+{
+    Unknown = 0,
+    Move = 1,
+    Down = 2,
+    Up = 3,
+    Wheel = 4
+};
+
+// Keyboard event action reported by SelectionCore
+enum class KeyboardAction
+{
+    Unknown = 0,
+    Down = 1,  // press or auto-repeat
+    Up = 2
+};
+
+// Synthetic event stream for InjectEvents() (benchmarks of the delivery path)
+enum class InjectEventKind
+{
+    MouseMove = 0,   // REL_X moves (delivered only while mouse move events are enabled)
+    MouseWheel = 1,  // REL_WHEEL, alternating direction
+    MouseClick = 2,  // BTN_MIDDLE down + up: no display server round trips
+    Keyboard = 3,    // KEY_A down + up
+    Selection = 4    // a fixed TextSelectionInfo, bypassing gesture detection and selection reads
+};
+
+// Processed mouse event delivered to the host
+struct CoreMouseEvent
+{
+    MouseAction action = MouseAction::Unknown;
+    Point pos;  ///< invalid when the position source is unreliable (e.g. libevdev on Wayland)
+    MouseButton button = MouseButton::None;
+    int flag = 0;       ///< wheel direction: 1 or -1
+    double delta = 0;   ///< wheel notches, signed like flag; fractional for smooth scrolling
+    int device = 0;     ///< source device id (X11 XInput2 backend), 0 when unknown
+    uint32_t time = 0;  ///< X server time in ms (X11 XInput2 backend), 0 when unknown
+};
+
+// Processed keyboard event delivered to the host
+struct CoreKeyboardEvent
+{
+    KeyboardAction action = KeyboardAction::Unknown;
+    int code = 0;        ///< Linux KEY_* code
+    int flags = 0;       ///< Modifier bitmask (MODIFIER_SHIFT/CTRL/ALT/META)
+    bool sys = false;    ///< Ctrl, Alt or Super held
+    std::string uniKey;  ///< MDN KeyboardEvent.key
+    int device = 0;      ///< source device id (X11 XInput2 backend), 0 when unknown
+    uint32_t time = 0;   ///< X server time in ms (X11 XInput2 backend), 0 when unknown
+};
+
+// Selection owner change delivered to the host; no selection text is read for it
+struct CoreSelectionChangeEvent
+{
+    uint64_t timestamp = 0;   ///< ms since the Unix epoch
+    uint64_t owner = 0;       ///< owner window (X11), 0 when unknown (Wayland)
+    std::string programName;  ///< program of the owner window, empty when unknown
+    uint32_t programId = 0;   ///< interned programName, 0 when unknown
+    bool isDragging = false;  ///< a gesture button is held: the selection may still grow
+};
+
+// Cumulative counters since construction, for diagnostics and soak tests
+struct CoreStats
+{
+    uint64_t starts = 0;              ///< successful Start() calls
+    uint64_t mouseEvents = 0;         ///< mouse events queued by the input thread
+    uint64_t keyboardEvents = 0;      ///< keyboard events queued by the input thread
+    uint64_t selectionChanges = 0;    ///< selection change events queued (not suppressed by a drag)
+    uint64_t droppedEvents = 0;       ///< input/selection events dropped because the queue was full
+    uint64_t dispatchedEvents = 0;    ///< events handled by Dispatch()
+    uint64_t selectionsEmitted = 0;   ///< selections delivered to the host callback
+    uint64_t hedgedReads = 0;         ///< reads that started the second source while the first was pending
+    uint64_t hedgeSecondaryWins = 0;  ///< hedged reads answered by the second source
+    size_t queueLength = 0;           ///< events currently waiting for Dispatch()
+    size_t queueHighWater = 0;        ///< largest queue length seen
+};
+
+// Fields of GetSelectionSnapshot() (bitmask)
+constexpr int SNAPSHOT_TEXT = 0x01;
+constexpr int SNAPSHOT_PROGRAM_NAME = 0x02;
+constexpr int SNAPSHOT_CURSOR = 0x04;
+constexpr int SNAPSHOT_HAS_SELECTION = 0x08;
+constexpr int SNAPSHOT_BYTE_LENGTH = 0x10;
+constexpr int SNAPSHOT_ALL = 0x1F;
+
+// Result of GetSelectionSnapshot(); only the requested fields are filled
+struct SelectionSnapshot
+{
+    int fields = 0;           ///< SNAPSHOT_* fields that were requested
+    std::string text;         ///< empty when there is no selection
+    std::string programName;  ///< empty when unknown (always on Wayland)
+    uint32_t programId = 0;   ///< interned programName, 0 when unknown
+    Point cursor;             ///< invalid when the position is unavailable
+    bool hasSelection = false;
+    size_t byteLength = 0;  ///< UTF-8 byte length of the selection text
+};
+
+// Host callbacks, invoked on the Dispatch() thread
+typedef void (*CoreSelectionCallback)(void *context, const TextSelectionInfo &selectionInfo);
+typedef void (*CoreMouseCallback)(void *context, const CoreMouseEvent &mouseEvent);
+typedef void (*CoreKeyboardCallback)(void *context, const CoreKeyboardEvent &keyboardEvent);
+typedef void (*CoreSelectionChangeCallback)(void *context, const CoreSelectionChangeEvent &changeEvent);
+// reasons: SESSION_* bitmask while suspended, 0 when resumed
+typedef void (*CoreSuspendCallback)(void *context, int reasons);
+
+class SelectionCore
+{
+  public:
+    SelectionCore();
+    ~SelectionCore();
+
+    SelectionCore(const SelectionCore &) = delete;
+    SelectionCore &operator=(const SelectionCore &) = delete;
+
+    // Detect the environment and connect to the display server
+    bool Initialize(std::string &error);
+    // X11 display to monitor instead of $DISPLAY (e.g. ":10" of another session); set before
+    // Initialize(). The protocol is then X11 regardless of the environment, and the AT-SPI2
+    // source and logind, which belong to the session of this process, are not used.
+    void SetDisplayName(const std::string &name) { display_name = name; }
+    const std::string &GetDisplayName() const { return display_name; }
+
+    // Callbacks may be null; set them before Start()
+    void SetCallbacks(CoreSelectionCallback selectionCallback, CoreMouseCallback mouseCallback,
+                      CoreKeyboardCallback keyboardCallback, void *context);
+    // Invoked with the SetCallbacks() context while selection change events are enabled
+    void SetSelectionChangeCallback(CoreSelectionChangeCallback changeCallback)
+    {
+        selection_change_callback = changeCallback;
+    }
+    // Invoked with the SetCallbacks() context when input dispatch is suspended or resumed
+    void SetSuspendCallback(CoreSuspendCallback suspendCallback) { suspend_callback = suspendCallback; }
+
+    bool Start(std::string &error);
+    void Stop();
+    bool IsRunning() const { return running.load(); }
+
+    // Pollable fd (readable when Dispatch() has work) and the dispatcher
+    int GetFd() const { return poll_fd; }
+    void Dispatch();
+
+    // Configuration
+    void SetMouseMoveEventEnabled(bool enabled) { is_enabled_mouse_move_event = enabled; }
+    // Report every selection owner change, including those during a drag, without reading the text
+    void SetSelectionChangeEventEnabled(bool enabled) { is_enabled_selection_change_event = enabled; }
+    void SetClipboardEnabled(bool enabled) { is_enabled_clipboard = enabled; }
+    void SetClipboardMode(FilterMode mode, const std::vector<std::string> &list);
+    void SetGlobalFilterMode(FilterMode mode, const std::vector<std::string> &list);
+    bool SetFineTunedList(FineTunedListType type, const std::vector<std::string> &list);
+    void SetSelectionPassiveMode(bool passive) { is_selection_passive_mode = passive; }
+    // In-loop selection events (X11): applied at the next Start()
+    void SetSelectionInLoop(bool inLoop) { is_selection_in_loop = inLoop; }
+    // Nice value, SCHED_RR and CPU affinity of the input threads: applied at the next Start()
+    void SetThreadScheduling(const ThreadSchedulingOptions &options) { thread_scheduling = options; }
+    const ThreadSchedulingOptions &GetThreadScheduling() const { return thread_scheduling; }
+    // X11 connections read by a reactor shared with the cores of other displays instead of
+    // protocol threads (null: own threads); applied at the next Start(), must run until Stop()
+    void SetEventReactor(EventReactor *reactor) { event_reactor = reactor; }
+    // Input devices to monitor (Wayland evdev) and XTest filtering (X11): applied at the next Start()
+    void SetInputDeviceFilter(const InputDeviceFilter &filter);
+    // Source of X11 input events (XRecord or XInput2 raw events): applied at the next Start()
+    void SetX11InputBackend(X11InputBackend backend) { x11_input_backend = backend; }
+    // Read selections through AT-SPI2 as well as PRIMARY (hedged): applied at the next Start()
+    void SetAtspiEnabled(bool enabled) { is_atspi_enabled = enabled; }
+    // Suspend input dispatch while the session is locked, idle or blanked (SessionStateMonitor);
+    // on by default, applied at the next Start()
+    void SetAutoSuspend(bool enabled) { is_auto_suspend = enabled; }
+    // Suspend input dispatch while the focused window is fullscreen, unless its program is in
+    // keepRunning (case-insensitive substrings); off by default, applied at the next Start()
+    void SetFullscreenSuspend(bool enabled, const std::vector<std::string> &keepRunning);
+    // SESSION_* reasons input dispatch is suspended for, 0 while active
+    int GetSuspendReasons() const { return suspend_reasons.load(); }
+    // Also signal GetFd() when a diagnostic log entry is written (lib/log_ring.h); the host
+    // drains the log with LogDrain() after Dispatch()
+    void SetLogNotify(bool enabled);
+    // Tag emitted selections with ClassifyText() (TextSelectionInfo::tags)
+    void SetTextClassification(bool enabled) { is_text_classification = enabled; }
+    bool IsTextClassificationEnabled() const { return is_text_classification.load(); }
+
+    // Read the current selection of the active window on demand
+    bool GetCurrentSelection(TextSelectionInfo &selectionInfo);
+    // Read only the requested SNAPSHOT_* fields, skipping the round trips of the others
+    bool GetSelectionSnapshot(int fields, SelectionSnapshot &snapshot);
+
+    // History of emitted selections, kept across Stop()/Start(). Views stay valid until the
+    // next selection is emitted or the limits change.
+    void SetSelectionHistory(size_t maxEntries, size_t maxBytes);
+    void GetSelectionHistory(int64_t sinceMs, size_t limit, std::vector<SelectionHistory::View> &views);
+
+    bool WriteClipboard(const std::string &text);
+    bool ReadClipboard(std::string &text);
+
+    const LinuxEnvInfo &GetEnvInfo() const { return env_info; }
+
+    CoreStats GetStats();
+
+    // Test-only: feed count synthetic events (pairs for MouseClick/Keyboard) through the
+    // protocol thread entry points from an injector thread, at ratePerSecond (0 = unpaced).
+    // Requires a running core; returns false while a previous injection is still active.
+    bool InjectEvents(InjectEventKind kind, uint32_t count, uint32_t ratePerSecond);
+    bool IsInjecting() const { return inject_active.load(); }
+
+  private:
+    // Event queued by a protocol or timer thread, handled by Dispatch()
+    struct QueuedEvent
+    {
+        enum class Kind
+        {
+            Mouse,
+            Keyboard,
+            SelectionChange,
+            DebounceExpired,  // Path C quiet period elapsed
+            GestureExpired,   // Path D correlation window elapsed, timestamp = gesture time
+            InjectedSelection,  // InjectEvents(): selection delivered as-is
+            SuspendChanged      // suspend reasons changed from or to 0, owner = reasons
+        };
+
+        Kind kind;
+        MouseEventContext mouse;
+        KeyboardEventContext keyboard;
+        uint64_t timestamp = 0;
+        uint64_t owner = 0;       // SelectionChange only
+        bool notifyOnly = false;  // SelectionChange during a drag: host notification only
+        std::shared_ptr<const TextSelectionInfo> selection;  // InjectedSelection only
+    };
+
+    // Core functionality methods
+    bool GetSelectedText(uint64_t window, TextSelectionInfo &selectionInfo, bool skipPrimary = false);
+    bool GetTextViaPrimary(uint64_t window, TextSelectionInfo &selectionInfo);
+    bool GetTextHedged(uint64_t window, TextSelectionInfo &selectionInfo);
+    bool GetTextViaClipboard(uint64_t window, TextSelectionInfo &selectionInfo);
+    bool ShouldProcessViaClipboard(uint32_t programId, const std::string &programName);
+    bool IsFilteredByGlobalList(bool hasProgramName, uint32_t programId, const std::string &programName);
+    bool IsProgramInList(uint32_t programId, const std::string &programName, int list);
+
+    // Helper methods
+    static void CopyToLowerCaseList(const std::vector<std::string> &source, std::vector<std::string> &targetList);
+
+    // Event queue
+    void QueueEvent(const QueuedEvent &event);
+    void ClearEventQueue();
+
+    // Event handling (Dispatch thread)
+    void ProcessMouseEvent(const MouseEventContext &mouseEvent);
+    void ProcessKeyboardEvent(const KeyboardEventContext &keyboardEvent);
+    void ProcessSelectionEvent(uint64_t timestamp);
+    void ProcessGestureExpired(uint64_t gestureTime);
+
+    // Input monitoring callback methods (protocol threads)
+    static void OnMouseEventCallback(void *context, MouseEventContext *mouseEvent);
+    static void OnKeyboardEventCallback(void *context, KeyboardEventContext *keyboardEvent);
+    static void OnSelectionEventCallback(void *context, SelectionChangeContext *selectionEvent);
+
+    // Session state callback (watcher thread)
+    static void OnSessionStateCallback(void *context, int state);
+    // Focused window fullscreen state (protocol thread, or the host loop for in-loop selection events)
+    static void OnFullscreenCallback(void *context, bool fullscreen, const std::string &programName);
+    // Replace the reasons in mask; toggles the protocol input threads and notifies the host
+    // when input dispatch is suspended or resumed. Any thread.
+    void UpdateSuspendReasons(int mask, int reasons);
+    // Input callbacks: false drops the event; the first input resumes from idle suspension
+    bool AcceptInputEvent();
+    void ProcessSuspendChanged(int reasons);
+
+    // Emit text selection event (shared by Path A, Path B, Path C, and Path D).
+    // Returns true if the event was successfully emitted, false otherwise.
+    // skipPrimary: PRIMARY did not change for this gesture, so its content is stale.
+    bool EmitSelectionEvent(SelectionDetectType type, Point start, Point end, bool skipPrimary = false);
+    void DeliverSelection(const TextSelectionInfo &selectionInfo);
+    void DeliverSelectionChange(const QueuedEvent &event);
+
+    // Protocol interface for X11/Wayland abstraction
+    std::unique_ptr<ProtocolBase> protocol;
+
+    // Cached Linux environment information
+    LinuxEnvInfo env_info;
+
+    // Explicit X11 display, empty for the display of the environment
+    std::string display_name;
+
+    // Host callbacks
+    CoreSelectionCallback selection_callback = nullptr;
+    CoreMouseCallback mouse_callback = nullptr;
+    CoreKeyboardCallback keyboard_callback = nullptr;
+    CoreSelectionChangeCallback selection_change_callback = nullptr;
+    CoreSuspendCallback suspend_callback = nullptr;
+    void *callback_context = nullptr;
+
+    // Program names seen by the core, with their filter list matches (dispatch thread only).
+    // Never cleared: ids stay valid for the hosts and the history across Stop()/Start().
+    ProgramNameTable program_names;
+
+    // ProgramNameTable lists of the filter settings
+    static constexpr int PROGRAM_LIST_GLOBAL = 0;
+    static constexpr int PROGRAM_LIST_CLIPBOARD = 1;
+    static constexpr int PROGRAM_LIST_EXCLUDE_CURSOR_DETECT = 2;
+    static constexpr int PROGRAM_LIST_INCLUDE_DELAY_READ = 3;
+
+    // Program name of the last selection change owner (dispatch thread only)
+    uint64_t change_owner = 0;
+    std::string change_owner_program;
+    uint32_t change_owner_program_id = 0;
+
+    // Wakeup: event_fd is signaled on every queued event; poll_fd is an epoll set of
+    // event_fd and, in in-loop mode, the protocol's selection fd.
+    int event_fd = -1;
+    int poll_fd = -1;
+    int selection_fd = -1;  // protocol selection fd registered in poll_fd, -1 if none
+
+    std::mutex queue_mutex;
+    std::deque<QueuedEvent> event_queue;
+    size_t queued_mouse_events = 0;
+    size_t queued_keyboard_events = 0;
+    size_t queued_selection_events = 0;
+
+    // Queue counters are guarded by queue_mutex; the others are only touched on the dispatch thread
+    CoreStats stats;
+
+    // Emitted selections (dispatch thread only)
+    SelectionHistory history;
+
+    // AT-SPI2 selection source, started with the core when enabled
+    AtspiSelection atspi;
+
+    // Hedged reads: the AT-SPI2 read runs on the hedge thread while the dispatch thread
+    // reads PRIMARY; the first valid answer wins. One job at a time, guarded by hedge_mutex.
+    struct HedgeJob
+    {
+        enum class State
+        {
+            Idle,
+            Pending,  // submitted, not picked up yet
+            Running,  // start delay or read in progress
+            Done      // result ready for the dispatch thread
+        };
+
+        State state = State::Idle;
+        uint64_t sinceMs = 0;
+        bool withExtents = false;
+        uint32_t delayMs = 0;    // start delay: the PRIMARY p90 when PRIMARY goes first
+        bool hurry = false;      // PRIMARY gave up: skip the rest of the start delay
+        bool cancelled = false;  // PRIMARY won: skip the read or drop its result
+        bool started = false;
+        bool hedged = false;  // started while PRIMARY was still pending
+        bool ok = false;
+        uint64_t startTime = 0;  // steady clock ms
+        uint32_t latencyMs = 0;
+        TextSelectionInfo result;
+    };
+
+    std::mutex hedge_mutex;
+    std::condition_variable hedge_cv;
+    std::thread hedge_thread;
+    bool hedge_running = false;
+    HedgeJob hedge_job;
+    // Set by the hedge thread when AT-SPI2 answers first: cancels the PRIMARY read
+    std::atomic<bool> hedge_primary_cancel{false};
+    // Read latency per program and source (dispatch thread only)
+    ReadLatencyTracker read_latency;
+
+    void HedgeThreadProc();
+    void StopHedgeThread();
+
+    // Mouse position tracking
+    Point current_mouse_pos;
+
+    // Mouse state tracking (for selection gesture detection)
+    Point last_mouse_down_pos;
+    // Accurate screen position at mouse-down, obtained by querying the display
+    // server (compositor IPC or XWayland). Unlike last_mouse_down_pos which comes
+    // from the input event (unreliable on Wayland), this provides real screen
+    // coordinates for reporting to consumers. Also used to detect XWayland
+    // position freezing by comparing with the emission-time query.
+    Point queried_mouse_down_pos;
+    uint64_t last_mouse_down_time = 0;
+    Point last_mouse_up_pos;
+    uint64_t last_mouse_up_time = 0;
+    Point prev_mouse_up_pos;  // Previous mouse-up (for shift+click)
+    uint64_t prev_mouse_up_time = 0;
+    uint64_t last_window_handler = 0;
+    WindowRect last_window_rect;
+    bool is_last_valid_click = false;
+    int last_mouse_up_modifier_flags = 0;
+
+    // Atomic timestamp of the last selection change event, written by
+    // OnSelectionEventCallback in the protocol thread, read by
+    // ProcessMouseEvent on the dispatch thread (Path A).
+    std::atomic<uint64_t> last_selection_event_time{0};
+
+    // Gesture button state — written by OnMouseEventCallback (input thread),
+    // read by OnSelectionEventCallback (protocol selection thread).
+    // Tracks BTN_LEFT and BTN_RIGHT (Wayland left-handed support) to suppress
+    // intermediate selection change events during mouse drag.
+    std::atomic<bool> is_gesture_button_down{false};
+
+    // Set when a selection change event arrives while the mouse button is held
+    // (during a drag). Cleared at mouse-down and after consumption at mouse-up.
+    // Allows drag gestures to bypass the 500ms correlation window, since apps
+    // may fire XFixes at drag start rather than at mouse-up.
+    std::atomic<bool> had_selection_during_drag{false};
+
+    // Pending gesture for Path B (selection change event arrives after mouse-up)
+    struct
+    {
+        bool active = false;
+        SelectionDetectType type = SelectionDetectType::None;
+        Point mousePosStart;
+        Point mousePosEnd;
+        uint64_t timestamp = 0;
+    } pending_gesture;
+
+    // No-input fallback (Path C): debounce for Wayland without libevdev
+    bool is_no_input_fallback = false;
+    std::mutex debounce_mutex;
+    std::condition_variable debounce_cv;
+    std::thread debounce_thread;
+    std::atomic<bool> debounce_running{false};
+    std::atomic<uint64_t> debounce_last_event_time{0};
+
+    void DebounceThreadProc();
+
+    // Clipboard fallback (Path D): timer for gestures awaiting confirmation (X11 only)
+    std::mutex clipboard_fallback_mutex;
+    std::condition_variable clipboard_fallback_cv;
+    std::thread clipboard_fallback_thread;
+    std::atomic<bool> clipboard_fallback_running{false};
+    std::atomic<uint64_t> clipboard_fallback_gesture_time{0};
+
+    void ClipboardFallbackThreadProc();
+
+    // Event injection (test-only)
+    std::thread inject_thread;
+    std::atomic<bool> inject_running{false};  // cleared to cancel
+    std::atomic<bool> inject_active{false};   // cleared by the thread when done
+
+    void InjectThreadProc(InjectEventKind kind, uint32_t count, uint32_t ratePerSecond, uint32_t programId);
+    void StopInjection();
+
+    std::atomic<bool> running{false};
+
+    // the text selection is processing, we should ignore some events
+    std::atomic<bool> is_processing{false};
+    // user use GetCurrentSelection
+    bool is_triggered_by_user = false;
+
+    bool is_enabled_mouse_move_event = false;
+
+    // selection change events for the host; read by the protocol selection thread too
+    std::atomic<bool> is_enabled_selection_change_event{false};
+
+    // passive mode: only trigger when user call GetSelectionText
+    bool is_selection_passive_mode = false;
+
+    // tag emitted selections with ClassifyText(); read by the injector thread too
+    std::atomic<bool> is_text_classification{false};
+
+    // in-loop selection mode (X11): selection change events are read on the dispatch
+    // thread through poll_fd instead of the XFixes thread. Takes effect at the next Start().
+    bool is_selection_in_loop = false;
+
+    // AT-SPI2 selection source, takes effect at the next Start()
+    bool is_atspi_enabled = false;
+
+    // Auto-suspension: input and selection events are dropped at the source while any
+    // reason is set. Reasons are written by the session watcher thread.
+    bool is_auto_suspend = true;
+    SessionStateMonitor session_state;
+    std::mutex suspend_mutex;  // serializes UpdateSuspendReasons()
+    std::atomic<int> suspend_reasons{0};
+
+    // Fullscreen suspension: the keep-running list is copied at Start() for the protocol thread,
+    // which also records whether the focused fullscreen window suspends the hook
+    bool is_fullscreen_suspend = false;
+    std::vector<std::string> fullscreen_keep_list;
+    std::vector<std::string> fullscreen_keep_running;
+    std::atomic<bool> is_fullscreen_focused{false};
+
+    // scheduling of the protocol input/selection threads, applied at the next Start()
+    ThreadSchedulingOptions thread_scheduling;
+
+    // reactor reading the X11 connections of several displays, applied at the next Start()
+    EventReactor *event_reactor = nullptr;
+
+    // input devices to monitor, applied at the next Start()
+    InputDeviceFilter input_device_filter;
+
+    // source of X11 input events, applied at the next Start()
+    X11InputBackend x11_input_backend = X11InputBackend::XRecord;
+
+    // clipboard fallback (X11 only), disabled by default on Linux: Ctrl+C has
+    // side effects in some apps (e.g. SIGINT in terminals)
+    bool is_enabled_clipboard = false;
+    // text cursor shown at mouse down / mouse up, for clipboard detection
+    bool mouse_down_text_cursor = false;
+    bool mouse_up_text_cursor = false;
+
+    // clipboard filter mode
+    FilterMode clipboard_filter_mode = FilterMode::Default;
+    std::vector<std::string> clipboard_filter_list;
+
+    // fine-tuned lists
+    // apps whose text areas don't show an I-beam cursor can skip cursor detection
+    std::vector<std::string> ftl_exclude_clipboard_cursor_detect;
+    // apps that replace the clipboard content several times on copy
+    std::vector<std::string> ftl_include_clipboard_delay_read;
+
+    // global filter mode
+    FilterMode global_filter_mode = FilterMode::Default;
+    std::vector<std::string> global_filter_list;
+};
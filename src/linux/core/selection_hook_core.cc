@@ -0,0 +1,452 @@
+/**
+ * Selection Hook Core - C API implementation (Linux)
+ *
+ * Thin C facade over SelectionCore for non-Node consumers.
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "selection_hook_core.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "../lib/log_ring.h"
+#include "selection_core.h"
+
+struct sh_core
+{
+    SelectionCore engine;
+    std::string last_error;
+
+    sh_selection_cb on_selection = nullptr;
+    sh_mouse_cb on_mouse = nullptr;
+    sh_keyboard_cb on_keyboard = nullptr;
+    sh_selection_change_cb on_selection_change = nullptr;
+    sh_suspend_cb on_suspend = nullptr;
+    void *user_data = nullptr;
+};
+
+static sh_point ToPoint(const Point &p)
+{
+    sh_point point;
+    point.x = p.valid ? p.x : SH_INVALID_COORDINATE;
+    point.y = p.valid ? p.y : SH_INVALID_COORDINATE;
+    return point;
+}
+
+static void ToSelection(const TextSelectionInfo &info, sh_selection &selection)
+{
+    selection.text = info.text.c_str();
+    selection.program_name = info.programName.c_str();
+    selection.program_id = info.programId;
+    selection.method = static_cast<int>(info.method);
+    selection.pos_level = static_cast<int>(info.posLevel);
+    selection.start_top = ToPoint(info.startTop);
+    selection.start_bottom = ToPoint(info.startBottom);
+    selection.end_top = ToPoint(info.endTop);
+    selection.end_bottom = ToPoint(info.endBottom);
+    selection.mouse_start = ToPoint(info.mousePosStart);
+    selection.mouse_end = ToPoint(info.mousePosEnd);
+    selection.tags = info.tags;
+}
+
+static std::vector<std::string> ToList(const char *const *programs, size_t count)
+{
+    std::vector<std::string> list;
+    for (size_t i = 0; programs && i < count; i++)
+    {
+        if (programs[i])
+            list.emplace_back(programs[i]);
+    }
+    return list;
+}
+
+static std::vector<InputDeviceRule> ToRules(const sh_input_device_rule *rules, size_t count)
+{
+    std::vector<InputDeviceRule> result;
+    for (size_t i = 0; rules && i < count; i++)
+    {
+        InputDeviceRule rule;
+        rule.name = rules[i].name ? rules[i].name : "";
+        rule.bus = rules[i].bus;
+        rule.vendor = rules[i].vendor;
+        rule.product = rules[i].product;
+        rule.classes = rules[i].classes;
+        result.push_back(rule);
+    }
+    return result;
+}
+
+static void OnSelection(void *context, const TextSelectionInfo &info)
+{
+    sh_core *core = static_cast<sh_core *>(context);
+    if (!core->on_selection)
+        return;
+
+    sh_selection selection;
+    ToSelection(info, selection);
+    core->on_selection(core->user_data, &selection);
+}
+
+static void OnMouse(void *context, const CoreMouseEvent &mouseEvent)
+{
+    sh_core *core = static_cast<sh_core *>(context);
+    if (!core->on_mouse)
+        return;
+
+    sh_mouse_event event;
+    event.action = static_cast<int>(mouseEvent.action);
+    event.x = mouseEvent.pos.valid ? mouseEvent.pos.x : SH_INVALID_COORDINATE;
+    event.y = mouseEvent.pos.valid ? mouseEvent.pos.y : SH_INVALID_COORDINATE;
+    event.button = static_cast<int>(mouseEvent.button);
+    event.flag = mouseEvent.flag;
+    event.delta = mouseEvent.delta;
+    event.device = mouseEvent.device;
+    event.time = mouseEvent.time;
+    core->on_mouse(core->user_data, &event);
+}
+
+static void OnKeyboard(void *context, const CoreKeyboardEvent &keyboardEvent)
+{
+    sh_core *core = static_cast<sh_core *>(context);
+    if (!core->on_keyboard)
+        return;
+
+    sh_keyboard_event event;
+    event.action = static_cast<int>(keyboardEvent.action);
+    event.code = keyboardEvent.code;
+    event.flags = keyboardEvent.flags;
+    event.sys = keyboardEvent.sys ? 1 : 0;
+    event.uni_key = keyboardEvent.uniKey.c_str();
+    event.device = keyboardEvent.device;
+    event.time = keyboardEvent.time;
+    core->on_keyboard(core->user_data, &event);
+}
+
+static void OnSelectionChange(void *context, const CoreSelectionChangeEvent &changeEvent)
+{
+    sh_core *core = static_cast<sh_core *>(context);
+    if (!core->on_selection_change)
+        return;
+
+    sh_selection_change change;
+    change.timestamp = static_cast<long long>(changeEvent.timestamp);
+    change.owner = changeEvent.owner;
+    change.program_name = changeEvent.programName.c_str();
+    change.program_id = changeEvent.programId;
+    change.is_dragging = changeEvent.isDragging ? 1 : 0;
+    core->on_selection_change(core->user_data, &change);
+}
+
+static void OnSuspend(void *context, int reasons)
+{
+    sh_core *core = static_cast<sh_core *>(context);
+    if (core->on_suspend)
+        core->on_suspend(core->user_data, reasons);
+}
+
+extern "C" {
+
+sh_core *sh_core_create(void)
+{
+    return sh_core_create_for_display(nullptr);
+}
+
+sh_core *sh_core_create_for_display(const char *display)
+{
+    sh_core *core = new (std::nothrow) sh_core();
+    if (!core)
+        return nullptr;
+
+    if (display)
+        core->engine.SetDisplayName(display);
+
+    std::string error;
+    if (!core->engine.Initialize(error))
+    {
+        delete core;
+        return nullptr;
+    }
+
+    core->engine.SetCallbacks(&OnSelection, &OnMouse, &OnKeyboard, core);
+    core->engine.SetSelectionChangeCallback(&OnSelectionChange);
+    core->engine.SetSuspendCallback(&OnSuspend);
+    return core;
+}
+
+void sh_core_destroy(sh_core *core)
+{
+    delete core;
+}
+
+void sh_core_set_callbacks(sh_core *core, sh_selection_cb on_selection, sh_mouse_cb on_mouse,
+                           sh_keyboard_cb on_keyboard, void *user_data)
+{
+    core->on_selection = on_selection;
+    core->on_mouse = on_mouse;
+    core->on_keyboard = on_keyboard;
+    core->user_data = user_data;
+}
+
+void sh_core_set_selection_change_callback(sh_core *core, sh_selection_change_cb on_selection_change)
+{
+    core->on_selection_change = on_selection_change;
+    core->engine.SetSelectionChangeEventEnabled(on_selection_change != nullptr);
+}
+
+void sh_core_set_suspend_callback(sh_core *core, sh_suspend_cb on_suspend)
+{
+    core->on_suspend = on_suspend;
+}
+
+int sh_core_start(sh_core *core)
+{
+    core->last_error.clear();
+    return core->engine.Start(core->last_error) ? 0 : -1;
+}
+
+void sh_core_stop(sh_core *core)
+{
+    core->engine.Stop();
+}
+
+const char *sh_core_last_error(const sh_core *core)
+{
+    return core->last_error.c_str();
+}
+
+int sh_core_get_fd(const sh_core *core)
+{
+    return core->engine.GetFd();
+}
+
+void sh_core_dispatch(sh_core *core)
+{
+    core->engine.Dispatch();
+}
+
+void sh_core_set_mouse_move_enabled(sh_core *core, int enabled)
+{
+    core->engine.SetMouseMoveEventEnabled(enabled != 0);
+}
+
+void sh_core_set_clipboard_enabled(sh_core *core, int enabled)
+{
+    core->engine.SetClipboardEnabled(enabled != 0);
+}
+
+void sh_core_set_clipboard_mode(sh_core *core, int mode, const char *const *programs, size_t count)
+{
+    core->engine.SetClipboardMode(static_cast<FilterMode>(mode), ToList(programs, count));
+}
+
+void sh_core_set_global_filter_mode(sh_core *core, int mode, const char *const *programs, size_t count)
+{
+    core->engine.SetGlobalFilterMode(static_cast<FilterMode>(mode), ToList(programs, count));
+}
+
+int sh_core_set_fine_tuned_list(sh_core *core, int type, const char *const *programs, size_t count)
+{
+    return core->engine.SetFineTunedList(static_cast<FineTunedListType>(type), ToList(programs, count)) ? 0 : -1;
+}
+
+void sh_core_set_passive_mode(sh_core *core, int passive)
+{
+    core->engine.SetSelectionPassiveMode(passive != 0);
+}
+
+void sh_core_set_selection_in_loop(sh_core *core, int in_loop)
+{
+    core->engine.SetSelectionInLoop(in_loop != 0);
+}
+
+void sh_core_set_text_classification(sh_core *core, int enabled)
+{
+    core->engine.SetTextClassification(enabled != 0);
+}
+
+void sh_core_set_atspi(sh_core *core, int enabled)
+{
+    core->engine.SetAtspiEnabled(enabled != 0);
+}
+
+void sh_core_set_auto_suspend(sh_core *core, int enabled)
+{
+    core->engine.SetAutoSuspend(enabled != 0);
+}
+
+void sh_core_set_fullscreen_suspend(sh_core *core, int enabled, const char *const *keep_running, size_t count)
+{
+    core->engine.SetFullscreenSuspend(enabled != 0, ToList(keep_running, count));
+}
+
+void sh_core_set_thread_scheduling(sh_core *core, int set_nice, int nice, int realtime, const int *cpus,
+                                   size_t count)
+{
+    ThreadSchedulingOptions options;
+    options.setNice = set_nice != 0;
+    options.niceValue = nice;
+    options.realtime = realtime != 0;
+    if (cpus)
+        options.cpus.assign(cpus, cpus + count);
+    core->engine.SetThreadScheduling(options);
+}
+
+void sh_core_set_input_device_filter(sh_core *core, const sh_input_device_rule *allow, size_t allow_count,
+                                     const sh_input_device_rule *deny, size_t deny_count, int exclude_virtual,
+                                     int exclude_xtest)
+{
+    InputDeviceFilter filter;
+    filter.allow = ToRules(allow, allow_count);
+    filter.deny = ToRules(deny, deny_count);
+    filter.excludeVirtual = exclude_virtual != 0;
+    filter.excludeXTest = exclude_xtest != 0;
+    core->engine.SetInputDeviceFilter(filter);
+}
+
+int sh_core_set_x11_input_backend(sh_core *core, int backend)
+{
+    if (backend != SH_X11_INPUT_XRECORD && backend != SH_X11_INPUT_XINPUT2)
+        return -1;
+
+    core->engine.SetX11InputBackend(static_cast<X11InputBackend>(backend));
+    return 0;
+}
+
+int sh_core_get_current_selection(sh_core *core, sh_selection_cb callback, void *user_data)
+{
+    TextSelectionInfo info;
+    if (!core->engine.GetCurrentSelection(info))
+        return 0;
+
+    if (callback)
+    {
+        sh_selection selection;
+        ToSelection(info, selection);
+        callback(user_data, &selection);
+    }
+    return 1;
+}
+
+int sh_core_get_selection_snapshot(sh_core *core, int fields, sh_snapshot_cb callback, void *user_data)
+{
+    SelectionSnapshot result;
+    if (!core->engine.GetSelectionSnapshot(fields, result))
+        return 0;
+
+    if (callback)
+    {
+        sh_snapshot snapshot;
+        snapshot.fields = result.fields;
+        snapshot.text = result.text.c_str();
+        snapshot.program_name = result.programName.c_str();
+        snapshot.program_id = result.programId;
+        snapshot.cursor = ToPoint(result.cursor);
+        snapshot.has_selection = result.hasSelection ? 1 : 0;
+        snapshot.byte_length = result.byteLength;
+        callback(user_data, &snapshot);
+    }
+    return 1;
+}
+
+void sh_core_set_selection_history(sh_core *core, size_t max_entries, size_t max_bytes)
+{
+    core->engine.SetSelectionHistory(max_entries, max_bytes);
+}
+
+size_t sh_core_get_selection_history(sh_core *core, long long since_ms, size_t limit, sh_history_cb callback,
+                                     void *user_data)
+{
+    std::vector<SelectionHistory::View> views;
+    core->engine.GetSelectionHistory(since_ms, limit, views);
+
+    if (callback)
+    {
+        for (const auto &view : views)
+        {
+            sh_history_entry entry;
+            entry.id = view.id;
+            entry.text = view.text;
+            entry.text_length = view.textLength;
+            entry.program_name = view.programName;
+            entry.program_id = view.programId;
+            entry.first_time = view.firstTime;
+            entry.last_time = view.lastTime;
+            entry.count = view.count;
+            callback(user_data, &entry);
+        }
+    }
+    return views.size();
+}
+
+int sh_core_write_clipboard(sh_core *core, const char *text)
+{
+    return (text && core->engine.WriteClipboard(text)) ? 1 : 0;
+}
+
+char *sh_core_read_clipboard(sh_core *core)
+{
+    std::string text;
+    if (!core->engine.ReadClipboard(text))
+        return nullptr;
+
+    char *result = static_cast<char *>(malloc(text.size() + 1));
+    if (result)
+        memcpy(result, text.c_str(), text.size() + 1);
+    return result;
+}
+
+void sh_core_get_env_info(const sh_core *core, sh_env_info *info)
+{
+    const LinuxEnvInfo &envInfo = core->engine.GetEnvInfo();
+    info->display_protocol = static_cast<int>(envInfo.displayProtocol);
+    info->compositor_type = static_cast<int>(envInfo.compositorType);
+    info->has_input_device_access = envInfo.hasInputDeviceAccess ? 1 : 0;
+    info->is_root = envInfo.isRoot ? 1 : 0;
+}
+
+void sh_core_get_stats(sh_core *core, sh_stats *stats)
+{
+    CoreStats coreStats = core->engine.GetStats();
+    stats->starts = coreStats.starts;
+    stats->mouse_events = coreStats.mouseEvents;
+    stats->keyboard_events = coreStats.keyboardEvents;
+    stats->selection_changes = coreStats.selectionChanges;
+    stats->dropped_events = coreStats.droppedEvents;
+    stats->dispatched_events = coreStats.dispatchedEvents;
+    stats->selections_emitted = coreStats.selectionsEmitted;
+    stats->queue_length = coreStats.queueLength;
+    stats->queue_high_water = coreStats.queueHighWater;
+    stats->hedged_reads = coreStats.hedgedReads;
+    stats->hedge_secondary_wins = coreStats.hedgeSecondaryWins;
+}
+
+void sh_core_set_log_notify(sh_core *core, int enabled)
+{
+    core->engine.SetLogNotify(enabled != 0);
+}
+
+size_t sh_log_drain(sh_log_cb callback, void *user_data)
+{
+    std::vector<LogEntry> entries;
+    LogDrain(entries);
+
+    if (callback)
+    {
+        for (const auto &logEntry : entries)
+        {
+            sh_log_entry entry;
+            entry.seq = logEntry.seq;
+            entry.time_ns = logEntry.timeNs;
+            entry.level = static_cast<int>(logEntry.level);
+            entry.message = logEntry.message.c_str();
+            callback(user_data, &entry);
+        }
+    }
+    return entries.size();
+}
+
+}  // extern "C"
@@ -0,0 +1,335 @@
+/**
+ * Selection Hook Core - C API (Linux)
+ *
+ * Embeds the selection-hook engine without Node.js. Link the selection-hook-core
+ * static library and its system libraries:
+ *   -levdev -lX11 -lXtst -lXfixes -lXi -lXss -lwayland-client -lstdc++ -lpthread
+ *
+ * Usage:
+ *   sh_core *core = sh_core_create();
+ *   sh_core_set_callbacks(core, on_selection, on_mouse, on_keyboard, user_data);
+ *   sh_core_start(core);
+ *   // poll(sh_core_get_fd(core)) for POLLIN, then call sh_core_dispatch(core)
+ *   sh_core_stop(core);
+ *   sh_core_destroy(core);
+ *
+ * Threading: all functions and all callbacks run on the thread that calls
+ * sh_core_dispatch(). Callbacks must not call sh_core_destroy(). Strings passed
+ * to callbacks are only valid during the callback.
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#ifndef SELECTION_HOOK_CORE_H
+#define SELECTION_HOOK_CORE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct sh_core sh_core;
+
+/* Coordinate value for unreliable/unavailable positions */
+#define SH_INVALID_COORDINATE (-99999)
+
+/* Filter modes for sh_core_set_global_filter_mode() and sh_core_set_clipboard_mode() */
+#define SH_FILTER_DEFAULT 0
+#define SH_FILTER_INCLUDE_LIST 1
+#define SH_FILTER_EXCLUDE_LIST 2
+
+/* Fine-tuned list types for sh_core_set_fine_tuned_list() */
+#define SH_FTL_EXCLUDE_CLIPBOARD_CURSOR_DETECT 0
+#define SH_FTL_INCLUDE_CLIPBOARD_DELAY_READ 1
+
+/* Mouse actions */
+#define SH_MOUSE_UNKNOWN 0
+#define SH_MOUSE_MOVE 1
+#define SH_MOUSE_DOWN 2
+#define SH_MOUSE_UP 3
+#define SH_MOUSE_WHEEL 4
+
+/* Keyboard actions */
+#define SH_KEY_UNKNOWN 0
+#define SH_KEY_DOWN 1
+#define SH_KEY_UP 2
+
+/* Fields for sh_core_get_selection_snapshot() (bitmask) */
+#define SH_SNAPSHOT_TEXT 0x01
+#define SH_SNAPSHOT_PROGRAM_NAME 0x02
+#define SH_SNAPSHOT_CURSOR 0x04
+#define SH_SNAPSHOT_HAS_SELECTION 0x08
+#define SH_SNAPSHOT_BYTE_LENGTH 0x10
+
+/* Selection tags (sh_selection.tags), set when sh_core_set_text_classification() is enabled */
+#define SH_TAG_URL 0x00001
+#define SH_TAG_EMAIL 0x00002
+#define SH_TAG_PATH 0x00004
+#define SH_TAG_NUMBER 0x00008
+#define SH_TAG_CODE 0x00010
+#define SH_TAG_MULTILINE 0x00020
+#define SH_TAG_LATIN 0x00100
+#define SH_TAG_CYRILLIC 0x00200
+#define SH_TAG_GREEK 0x00400
+#define SH_TAG_ARABIC 0x00800
+#define SH_TAG_HEBREW 0x01000
+#define SH_TAG_DEVANAGARI 0x02000
+#define SH_TAG_THAI 0x04000
+#define SH_TAG_CJK 0x08000
+#define SH_TAG_HANGUL 0x10000
+
+/* Reasons input dispatch is suspended (sh_suspend_cb), see sh_core_set_auto_suspend() */
+#define SH_SUSPEND_LOCKED 0x01      /* logind LockedHint */
+#define SH_SUSPEND_IDLE 0x02        /* logind IdleHint */
+#define SH_SUSPEND_SCREENSAVER 0x04 /* X11 screen saver active */
+#define SH_SUSPEND_FULLSCREEN 0x08  /* focused window fullscreen, see sh_core_set_fullscreen_suspend() */
+
+/* Input device classes (sh_input_device_rule.classes), from the evdev capabilities */
+#define SH_INPUT_DEVICE_MOUSE 0x01    /* mouse buttons or relative axes */
+#define SH_INPUT_DEVICE_KEYBOARD 0x02 /* letter keys */
+#define SH_INPUT_DEVICE_TOUCHPAD 0x04 /* finger tool with absolute axes */
+#define SH_INPUT_DEVICE_TABLET 0x08   /* pen or stylus tool */
+#define SH_INPUT_DEVICE_GAMEPAD 0x10  /* gamepad or joystick buttons */
+
+/* X11 input sources for sh_core_set_x11_input_backend() */
+#define SH_X11_INPUT_XRECORD 0 /* XRecord (default) */
+#define SH_X11_INPUT_XINPUT2 1 /* XInput2 raw events, with device ids and server time */
+
+/* Diagnostic log levels (sh_log_entry.level) */
+#define SH_LOG_ERROR 0
+#define SH_LOG_WARN 1
+#define SH_LOG_INFO 2
+#define SH_LOG_DEBUG 3
+
+typedef struct sh_point
+{
+    int x;
+    int y;
+} sh_point;
+
+typedef struct sh_selection
+{
+    const char *text;         /* UTF-8, NUL-terminated */
+    const char *program_name; /* may be empty */
+    unsigned int program_id;  /* program name id, stable for the core's lifetime; 0 when unknown */
+    int method;               /* SelectionMethod: 21 = AT-SPI, 22 = primary, 99 = clipboard */
+    int pos_level;            /* SelectionPositionLevel */
+    sh_point start_top;
+    sh_point start_bottom;
+    sh_point end_top;
+    sh_point end_bottom;
+    sh_point mouse_start;
+    sh_point mouse_end;
+    unsigned int tags; /* SH_TAG_* bits, 0 unless text classification is enabled */
+} sh_selection;
+
+/* Input device rule for sh_core_set_input_device_filter(); NULL or negative fields match any device */
+typedef struct sh_input_device_rule
+{
+    const char *name; /* case-insensitive substring of the device name, may be NULL */
+    int bus;          /* BUS_* id, e.g. 0x03 (USB), 0x06 (virtual), or -1 */
+    int vendor;       /* or -1 */
+    int product;      /* or -1 */
+    int classes;      /* SH_INPUT_DEVICE_* bits, any of which must be present; 0 = any */
+} sh_input_device_rule;
+
+typedef struct sh_mouse_event
+{
+    int action;        /* SH_MOUSE_* */
+    int x;
+    int y;
+    int button;        /* MouseButton */
+    int flag;          /* wheel direction: 1 or -1 */
+    double delta;      /* wheel notches, signed like flag; fractional for smooth scrolling */
+    int device;        /* source device id (SH_X11_INPUT_XINPUT2), 0 when unknown */
+    unsigned int time; /* X server time in ms (SH_X11_INPUT_XINPUT2), 0 when unknown */
+} sh_mouse_event;
+
+typedef struct sh_keyboard_event
+{
+    int action;          /* SH_KEY_* */
+    int code;            /* Linux KEY_* code */
+    int flags;           /* modifier bitmask: shift 0x01, ctrl 0x02, alt 0x04, meta 0x08 */
+    int sys;             /* Ctrl, Alt or Super held */
+    const char *uni_key; /* MDN KeyboardEvent.key */
+    int device;          /* source device id (SH_X11_INPUT_XINPUT2), 0 when unknown */
+    unsigned int time;   /* X server time in ms (SH_X11_INPUT_XINPUT2), 0 when unknown */
+} sh_keyboard_event;
+
+/* Selection owner change; no selection text is read for it */
+typedef struct sh_selection_change
+{
+    long long timestamp;       /* ms since the Unix epoch */
+    unsigned long long owner;  /* owner window (X11), 0 when unknown */
+    const char *program_name;  /* program of the owner window, may be empty */
+    unsigned int program_id;   /* program name id as in sh_selection, 0 when unknown */
+    int is_dragging;           /* a gesture button is held: the selection may still grow */
+} sh_selection_change;
+
+typedef struct sh_env_info
+{
+    int display_protocol; /* 1 = X11, 2 = Wayland */
+    int compositor_type;  /* CompositorType */
+    int has_input_device_access;
+    int is_root;
+} sh_env_info;
+
+/* Only the requested fields are set; the others are empty, 0 or SH_INVALID_COORDINATE */
+typedef struct sh_snapshot
+{
+    int fields;               /* SH_SNAPSHOT_* fields that were requested */
+    const char *text;         /* UTF-8, NUL-terminated; empty when there is no selection */
+    const char *program_name; /* may be empty */
+    unsigned int program_id;  /* program name id as in sh_selection, 0 when unknown */
+    sh_point cursor;
+    int has_selection;
+    size_t byte_length;
+} sh_snapshot;
+
+/* Entry of the selection history; strings are NUL-terminated and valid during the callback */
+typedef struct sh_history_entry
+{
+    unsigned long long id; /* increases with every new entry */
+    const char *text;
+    size_t text_length;
+    const char *program_name; /* may be empty */
+    unsigned int program_id;  /* program name id as in sh_selection, 0 when unknown */
+    long long first_time;     /* ms since the Unix epoch */
+    long long last_time;      /* ms since the Unix epoch */
+    unsigned int count;       /* consecutive repeats of the same selection */
+} sh_history_entry;
+
+/* Entry of the diagnostic log; message is NUL-terminated and valid during the callback */
+typedef struct sh_log_entry
+{
+    unsigned long long seq;     /* write order; a gap means entries were overwritten */
+    unsigned long long time_ns; /* CLOCK_MONOTONIC */
+    int level;                  /* SH_LOG_* */
+    const char *message;
+} sh_log_entry;
+
+/* Cumulative counters since sh_core_create() */
+typedef struct sh_stats
+{
+    unsigned long long starts;
+    unsigned long long mouse_events;      /* queued by the input thread */
+    unsigned long long keyboard_events;   /* queued by the input thread */
+    unsigned long long selection_changes; /* queued selection change events */
+    unsigned long long dropped_events;    /* dropped because the queue was full */
+    unsigned long long dispatched_events;
+    unsigned long long selections_emitted;
+    size_t queue_length;
+    size_t queue_high_water;
+    unsigned long long hedged_reads;         /* reads that started the second source (AT-SPI2/PRIMARY) early */
+    unsigned long long hedge_secondary_wins; /* hedged reads answered by the second source */
+} sh_stats;
+
+typedef void (*sh_selection_cb)(void *user_data, const sh_selection *selection);
+typedef void (*sh_mouse_cb)(void *user_data, const sh_mouse_event *event);
+typedef void (*sh_keyboard_cb)(void *user_data, const sh_keyboard_event *event);
+typedef void (*sh_selection_change_cb)(void *user_data, const sh_selection_change *change);
+/* reasons: SH_SUSPEND_* bits when suspended, 0 when resumed */
+typedef void (*sh_suspend_cb)(void *user_data, int reasons);
+typedef void (*sh_snapshot_cb)(void *user_data, const sh_snapshot *snapshot);
+typedef void (*sh_log_cb)(void *user_data, const sh_log_entry *entry);
+typedef void (*sh_history_cb)(void *user_data, const sh_history_entry *entry);
+
+/* Connect to the display server. Returns NULL on failure. */
+sh_core *sh_core_create(void);
+/* Connect to an X11 display instead of $DISPLAY, e.g. ":10" of another session. One core per
+ * display; poll the fd of each. AT-SPI2 and logind (of this process's session) are not used.
+ * Returns NULL on failure. */
+sh_core *sh_core_create_for_display(const char *display);
+void sh_core_destroy(sh_core *core);
+
+/* Any callback may be NULL. Set before sh_core_start(). */
+void sh_core_set_callbacks(sh_core *core, sh_selection_cb on_selection, sh_mouse_cb on_mouse,
+                           sh_keyboard_cb on_keyboard, void *user_data);
+/* Report every selection owner change (with the user_data of sh_core_set_callbacks()).
+ * Disabled while NULL, the default. */
+void sh_core_set_selection_change_callback(sh_core *core, sh_selection_change_cb on_selection_change);
+/* Notified (with the user_data of sh_core_set_callbacks()) when input dispatch is suspended or resumed */
+void sh_core_set_suspend_callback(sh_core *core, sh_suspend_cb on_suspend);
+
+/* Returns 0 on success, -1 on failure (see sh_core_last_error()) */
+int sh_core_start(sh_core *core);
+void sh_core_stop(sh_core *core);
+const char *sh_core_last_error(const sh_core *core);
+
+/* Readable (POLLIN) when sh_core_dispatch() has work; valid for the lifetime of core */
+int sh_core_get_fd(const sh_core *core);
+void sh_core_dispatch(sh_core *core);
+
+/* Configuration; program name lists match as case-insensitive substrings */
+void sh_core_set_mouse_move_enabled(sh_core *core, int enabled);
+void sh_core_set_clipboard_enabled(sh_core *core, int enabled);
+void sh_core_set_clipboard_mode(sh_core *core, int mode, const char *const *programs, size_t count);
+void sh_core_set_global_filter_mode(sh_core *core, int mode, const char *const *programs, size_t count);
+/* Returns 0, or -1 for an unknown list type */
+int sh_core_set_fine_tuned_list(sh_core *core, int type, const char *const *programs, size_t count);
+void sh_core_set_passive_mode(sh_core *core, int passive);
+void sh_core_set_selection_in_loop(sh_core *core, int in_loop);
+/* Tag emitted selections (URL, email, path, number, code, multi-line, scripts) */
+void sh_core_set_text_classification(sh_core *core, int enabled);
+/* Read selections through AT-SPI2 (with selection extents on X11) alongside PRIMARY, applied at
+ * the next sh_core_start(). Needs libdbus-1 and an accessibility bus; falls back to PRIMARY. */
+void sh_core_set_atspi(sh_core *core, int enabled);
+/* Drop input and selection events while the logind session is locked or idle, or the X11
+ * screen saver is active (default on), applied at the next sh_core_start(). Needs libdbus-1
+ * and a logind session, or the MIT-SCREEN-SAVER extension; stays active without them. */
+void sh_core_set_auto_suspend(sh_core *core, int enabled);
+/* Drop input and selection events while the focused window is fullscreen (default off), except
+ * for the programs in keep_running, applied at the next sh_core_start(). Known on X11 through
+ * _NET_WM_STATE, on Wayland through wlr-foreign-toplevel-management or XWayland. */
+void sh_core_set_fullscreen_suspend(sh_core *core, int enabled, const char *const *keep_running, size_t count);
+/* Input thread scheduling, applied at the next sh_core_start(). set_nice = 0 keeps the
+ * inherited nice value; realtime requests SCHED_RR and falls back to nice when not
+ * permitted; cpus/count restrict CPU affinity (NULL/0 = unrestricted). */
+void sh_core_set_thread_scheduling(sh_core *core, int set_nice, int nice, int realtime, const int *cpus,
+                                   size_t count);
+/* Input devices to monitor, applied at the next sh_core_start(). Wayland (evdev): devices
+ * matching a deny rule, or no allow rule when allow_count > 0, are not opened; exclude_virtual
+ * skips uinput devices. X11: exclude_xtest drops events synthesized through XTest. */
+void sh_core_set_input_device_filter(sh_core *core, const sh_input_device_rule *allow, size_t allow_count,
+                                     const sh_input_device_rule *deny, size_t deny_count, int exclude_virtual,
+                                     int exclude_xtest);
+/* Source of X11 input events, SH_X11_INPUT_*, applied at the next sh_core_start(). XInput2 reads
+ * raw device events on the XI2 connection instead of opening an XRecord context, and falls back
+ * to XRecord without XInput 2.1. Returns 0, or -1 for an unknown backend. */
+int sh_core_set_x11_input_backend(sh_core *core, int backend);
+
+/* Read the current selection synchronously. Returns 1 and invokes callback, or 0 if none. */
+int sh_core_get_current_selection(sh_core *core, sh_selection_cb callback, void *user_data);
+/* Read only the requested SH_SNAPSHOT_* fields. Returns 1 and invokes callback, or 0 on failure. */
+int sh_core_get_selection_snapshot(sh_core *core, int fields, sh_snapshot_cb callback, void *user_data);
+
+/* Keep the last max_entries emitted selections within max_bytes of text (0 = 1 GB). Each
+ * distinct text is stored once. max_entries = 0 disables the history and frees it. */
+void sh_core_set_selection_history(sh_core *core, size_t max_entries, size_t max_bytes);
+/* Invoke callback for entries last seen after since_ms, newest first, at most limit (0 = all).
+ * Returns the number of entries. */
+size_t sh_core_get_selection_history(sh_core *core, long long since_ms, size_t limit, sh_history_cb callback,
+                                     void *user_data);
+
+/* Clipboard. sh_core_read_clipboard() returns a malloc'd string (free() it) or NULL. */
+int sh_core_write_clipboard(sh_core *core, const char *text);
+char *sh_core_read_clipboard(sh_core *core);
+
+void sh_core_get_env_info(const sh_core *core, sh_env_info *info);
+void sh_core_get_stats(sh_core *core, sh_stats *stats);
+
+/* Diagnostic log. Native errors, warnings and setup notes are kept in a process-wide ring
+ * of the last 256 entries instead of being printed; writers never block. With notify set,
+ * sh_core_get_fd() also becomes readable when an entry is written. */
+void sh_core_set_log_notify(sh_core *core, int enabled);
+/* Invoke callback for the entries written since the last drain, oldest first; callable from
+ * any thread. Returns the number of entries. */
+size_t sh_log_drain(sh_log_cb callback, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SELECTION_HOOK_CORE_H */
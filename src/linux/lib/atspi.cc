@@ -0,0 +1,386 @@
+/**
+ * AT-SPI2 text selection source for Linux
+ *
+ * Talks to the accessibility bus through libdbus-1, loaded with dlopen:
+ *   org.a11y.Bus.GetAddress (session bus)   → accessibility bus address
+ *   org.a11y.atspi.Registry.RegisterEvent   → apps start emitting the event
+ *   Event.Object.TextSelectionChanged       → Text.GetSelection(0) on the event thread
+ *   ReadSelection()                         → Text.GetText + Text.GetCharacterExtents
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "atspi.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include "dbus_loader.h"
+#include "log_ring.h"
+#include "utils.h"
+
+// Reply timeout of calls to the bus and to applications
+constexpr int ATSPI_CALL_TIMEOUT_MS = 100;
+// Event thread wakeup interval, bounds the latency of Stop()
+constexpr int ATSPI_POLL_MS = 100;
+
+// AT-SPI coordinate type for GetCharacterExtents
+constexpr uint32_t ATSPI_COORD_TYPE_SCREEN = 0;
+
+static const char *const ATSPI_TEXT_INTERFACE = "org.a11y.atspi.Text";
+static const char *const ATSPI_SELECTION_MATCH_RULE =
+    "type='signal',interface='org.a11y.atspi.Event.Object',member='TextSelectionChanged'";
+
+// libdbus-1 functions, loaded by LoadDBusLibrary()
+static const DBusLibrary &dbus_fn = dbus_library;
+
+static uint64_t NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static void CloseConnection(void *&conn)
+{
+    if (!conn)
+        return;
+
+    dbus_fn.connection_close(conn);
+    dbus_fn.connection_unref(conn);
+    conn = nullptr;
+}
+
+/**
+ * Call a method and return the reply (message_unref it), or nullptr on error/timeout.
+ * Takes ownership of msg.
+ */
+static void *CallMethod(void *conn, void *msg)
+{
+    if (!msg)
+        return nullptr;
+
+    DBusError_ABI err;
+    dbus_fn.error_init(&err);
+    void *reply = dbus_fn.connection_send_with_reply_and_block(conn, msg, ATSPI_CALL_TIMEOUT_MS, &err);
+    dbus_fn.message_unref(msg);
+    dbus_fn.error_free(&err);
+    return reply;
+}
+
+// Read count consecutive basic arguments of the same type from a reply
+template <typename T>
+static bool ReadReplyArgs(void *reply, int type, T *values, int count)
+{
+    DBusMessageIter_ABI iter;
+    if (!dbus_fn.message_iter_init(reply, &iter))
+        return false;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (dbus_fn.message_iter_get_arg_type(&iter) != type)
+            return false;
+
+        dbus_fn.message_iter_get_basic(&iter, &values[i]);
+        if (i + 1 < count && !dbus_fn.message_iter_next(&iter))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Address of the accessibility bus: AT_SPI_BUS_ADDRESS, else org.a11y.Bus on the session bus
+ */
+static bool GetAccessibilityBusAddress(std::string &address, std::string &error)
+{
+    const char *envAddress = getenv("AT_SPI_BUS_ADDRESS");
+    if (envAddress && *envAddress)
+    {
+        address = envAddress;
+        return true;
+    }
+
+    DBusError_ABI err;
+    dbus_fn.error_init(&err);
+    void *session = dbus_fn.bus_get_private(DBUS_ABI_BUS_SESSION, &err);
+    if (!session)
+    {
+        error = std::string("Failed to connect to the session bus: ") + (err.message ? err.message : "unknown");
+        dbus_fn.error_free(&err);
+        return false;
+    }
+    dbus_fn.error_free(&err);
+
+    // A private bus connection exits the process on disconnect by default
+    dbus_fn.connection_set_exit_on_disconnect(session, 0);
+
+    void *reply = CallMethod(session, dbus_fn.message_new_method_call("org.a11y.Bus", "/org/a11y/bus",
+                                                                      "org.a11y.Bus", "GetAddress"));
+    const char *value = nullptr;
+    if (reply && ReadReplyArgs(reply, DBUS_ABI_TYPE_STRING, &value, 1) && value && *value)
+        address = value;
+
+    if (reply)
+        dbus_fn.message_unref(reply);
+    CloseConnection(session);
+
+    if (address.empty())
+    {
+        error = "Accessibility bus is not available (org.a11y.Bus)";
+        return false;
+    }
+    return true;
+}
+
+static void *OpenAccessibilityConnection(const std::string &address, std::string &error)
+{
+    DBusError_ABI err;
+    dbus_fn.error_init(&err);
+    void *conn = dbus_fn.connection_open_private(address.c_str(), &err);
+    if (!conn)
+    {
+        error = std::string("Failed to connect to the accessibility bus: ") + (err.message ? err.message : "unknown");
+        dbus_fn.error_free(&err);
+        return nullptr;
+    }
+    dbus_fn.error_free(&err);
+
+    dbus_fn.connection_set_exit_on_disconnect(conn, 0);
+
+    dbus_fn.error_init(&err);
+    if (!dbus_fn.bus_register(conn, &err))
+    {
+        error = std::string("Failed to register on the accessibility bus: ") + (err.message ? err.message : "unknown");
+        dbus_fn.error_free(&err);
+        CloseConnection(conn);
+        return nullptr;
+    }
+    dbus_fn.error_free(&err);
+
+    return conn;
+}
+
+AtspiSelection::~AtspiSelection()
+{
+    Stop();
+}
+
+bool AtspiSelection::Start(std::string &error)
+{
+    if (running)
+        return true;
+
+    if (!LoadDBusLibrary())
+    {
+        error = "libdbus-1.so.3 is not available";
+        return false;
+    }
+
+    std::string address;
+    if (!GetAccessibilityBusAddress(address, error))
+        return false;
+
+    event_conn = OpenAccessibilityConnection(address, error);
+    if (!event_conn)
+        return false;
+
+    query_conn = OpenAccessibilityConnection(address, error);
+    if (!query_conn)
+    {
+        CloseConnection(event_conn);
+        return false;
+    }
+
+    DBusError_ABI err;
+    dbus_fn.error_init(&err);
+    dbus_fn.bus_add_match(event_conn, ATSPI_SELECTION_MATCH_RULE, &err);
+    dbus_fn.error_free(&err);
+
+    // Applications only emit events that a listener registered with the registry
+    void *msg = dbus_fn.message_new_method_call("org.a11y.atspi.Registry", "/org/a11y/atspi/registry",
+                                                "org.a11y.atspi.Registry", "RegisterEvent");
+    if (msg)
+    {
+        const char *event = "object:text-selection-changed";
+        dbus_fn.message_append_args(msg, DBUS_ABI_TYPE_STRING, &event, DBUS_ABI_TYPE_INVALID);
+        void *reply = CallMethod(event_conn, msg);
+        if (reply)
+            dbus_fn.message_unref(reply);
+        else
+            LogMessage(LogLevel::Info, "[AT-SPI] RegisterEvent failed, relying on already registered listeners");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(source_mutex);
+        source = Source{};
+    }
+
+    running = true;
+    event_thread = std::thread(&AtspiSelection::EventThreadProc, this);
+    return true;
+}
+
+void AtspiSelection::Stop()
+{
+    if (!running.exchange(false))
+        return;
+
+    if (event_thread.joinable())
+        event_thread.join();
+
+    CloseConnection(event_conn);
+    CloseConnection(query_conn);
+}
+
+/**
+ * Event thread: drain TextSelectionChanged signals and cache the range of the latest source.
+ * A burst (e.g. during a drag) is coalesced into one GetSelection call.
+ */
+void AtspiSelection::EventThreadProc()
+{
+    ApplyThreadScheduling("sh-atspi", nullptr);
+
+    while (running.load())
+    {
+        std::string busName;
+        std::string path;
+
+        while (void *msg = dbus_fn.connection_pop_message(event_conn))
+        {
+            if (dbus_fn.message_get_type(msg) == DBUS_ABI_MESSAGE_TYPE_SIGNAL)
+            {
+                const char *iface = dbus_fn.message_get_interface(msg);
+                const char *member = dbus_fn.message_get_member(msg);
+                const char *sender = dbus_fn.message_get_sender(msg);
+                const char *objectPath = dbus_fn.message_get_path(msg);
+
+                if (iface && member && sender && objectPath && strcmp(iface, "org.a11y.atspi.Event.Object") == 0 &&
+                    strcmp(member, "TextSelectionChanged") == 0)
+                {
+                    busName = sender;
+                    path = objectPath;
+                }
+            }
+            dbus_fn.message_unref(msg);
+        }
+
+        // Signals read while waiting for the GetSelection reply are drained before blocking again
+        if (!busName.empty())
+        {
+            OnTextSelectionChanged(busName.c_str(), path.c_str());
+            continue;
+        }
+
+        if (!dbus_fn.connection_read_write(event_conn, ATSPI_POLL_MS))
+        {
+            LogMessage(LogLevel::Warn, "[AT-SPI] Accessibility bus disconnected");
+            break;
+        }
+    }
+}
+
+void AtspiSelection::OnTextSelectionChanged(const char *busName, const char *path)
+{
+    Source changed;
+    changed.busName = busName;
+    changed.path = path;
+    changed.time = NowMs();
+
+    void *msg = dbus_fn.message_new_method_call(busName, path, ATSPI_TEXT_INTERFACE, "GetSelection");
+    if (msg)
+    {
+        int32_t selectionNum = 0;
+        dbus_fn.message_append_args(msg, DBUS_ABI_TYPE_INT32, &selectionNum, DBUS_ABI_TYPE_INVALID);
+
+        // Keep the source even when the range is unknown, so an older one is not used
+        int32_t range[2] = {0, 0};
+        if (void *reply = CallMethod(event_conn, msg))
+        {
+            if (ReadReplyArgs(reply, DBUS_ABI_TYPE_INT32, range, 2))
+            {
+                changed.start = std::min(range[0], range[1]);
+                changed.end = std::max(range[0], range[1]);
+            }
+            dbus_fn.message_unref(reply);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(source_mutex);
+    source = changed;
+}
+
+bool AtspiSelection::ReadSelection(uint64_t sinceMs, bool withExtents, TextSelectionInfo &selectionInfo)
+{
+    if (!running.load())
+        return false;
+
+    Source current;
+    {
+        std::lock_guard<std::mutex> lock(source_mutex);
+        current = source;
+    }
+
+    if (current.time < sinceMs || current.end <= current.start)
+        return false;
+
+    const char *busName = current.busName.c_str();
+    const char *path = current.path.c_str();
+
+    // Text of the cached range
+    void *msg = dbus_fn.message_new_method_call(busName, path, ATSPI_TEXT_INTERFACE, "GetText");
+    if (!msg)
+        return false;
+    dbus_fn.message_append_args(msg, DBUS_ABI_TYPE_INT32, &current.start, DBUS_ABI_TYPE_INT32, &current.end,
+                                DBUS_ABI_TYPE_INVALID);
+
+    void *reply = CallMethod(query_conn, msg);
+    if (!reply)
+        return false;
+
+    const char *text = nullptr;
+    bool hasText = ReadReplyArgs(reply, DBUS_ABI_TYPE_STRING, &text, 1) && text && !IsTrimmedEmpty(text);
+    if (hasText)
+        selectionInfo.text = text;
+    dbus_fn.message_unref(reply);
+
+    if (!hasText)
+        return false;
+
+    if (!withExtents)
+        return true;
+
+    // Screen extents {x, y, width, height} of the first and the last selected character
+    auto getExtents = [&](int32_t offset, int32_t extents[4])
+    {
+        void *extentsMsg = dbus_fn.message_new_method_call(busName, path, ATSPI_TEXT_INTERFACE, "GetCharacterExtents");
+        if (!extentsMsg)
+            return false;
+
+        uint32_t coordType = ATSPI_COORD_TYPE_SCREEN;
+        dbus_fn.message_append_args(extentsMsg, DBUS_ABI_TYPE_INT32, &offset, DBUS_ABI_TYPE_UINT32, &coordType,
+                                    DBUS_ABI_TYPE_INVALID);
+
+        void *extentsReply = CallMethod(query_conn, extentsMsg);
+        if (!extentsReply)
+            return false;
+
+        bool ok = ReadReplyArgs(extentsReply, DBUS_ABI_TYPE_INT32, extents, 4) && extents[3] > 0;
+        dbus_fn.message_unref(extentsReply);
+        return ok;
+    };
+
+    int32_t first[4];
+    int32_t last[4];
+    if (getExtents(current.start, first) && getExtents(current.end - 1, last))
+    {
+        selectionInfo.startTop = Point(first[0], first[1]);
+        selectionInfo.startBottom = Point(first[0], first[1] + first[3]);
+        selectionInfo.endTop = Point(last[0] + last[2], last[1]);
+        selectionInfo.endBottom = Point(last[0] + last[2], last[1] + last[3]);
+        selectionInfo.posLevel = SelectionPositionLevel::Full;
+    }
+
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../common.h"
+
+/**
+ * AT-SPI2 text selection source
+ *
+ * Listens on the accessibility bus for object:text-selection-changed and keeps
+ * the selection range of the accessible that reported it last. The text and the
+ * character extents are fetched only when a gesture is confirmed, through
+ * ReadSelection(). libdbus-1 is loaded with dlopen, so there is no build or
+ * runtime dependency when AT-SPI is not used.
+ *
+ * Toolkits only expose their text through AT-SPI while accessibility is enabled
+ * (e.g. org.a11y.Status.IsEnabled, or an assistive technology running).
+ * AT_SPI_BUS_ADDRESS selects the bus, e.g. a private bus in a test session.
+ */
+class AtspiSelection
+{
+  public:
+    AtspiSelection() = default;
+    ~AtspiSelection();
+
+    AtspiSelection(const AtspiSelection &) = delete;
+    AtspiSelection &operator=(const AtspiSelection &) = delete;
+
+    // Connect to the accessibility bus and start the event thread (sh-atspi)
+    bool Start(std::string &error);
+    void Stop();
+    bool IsRunning() const { return running.load(); }
+
+    // Read the selection reported after sinceMs (ms since the Unix epoch) into
+    // selectionInfo.text and, with withExtents, the first/last character corners
+    // (screen coordinates). Returns false when no fresh, non-empty selection is known.
+    bool ReadSelection(uint64_t sinceMs, bool withExtents, TextSelectionInfo &selectionInfo);
+
+  private:
+    // Accessible that reported the last selection change and its selection range
+    struct Source
+    {
+        std::string busName;
+        std::string path;
+        int32_t start = 0;
+        int32_t end = 0;
+        uint64_t time = 0;
+    };
+
+    void EventThreadProc();
+    void OnTextSelectionChanged(const char *busName, const char *path);
+
+    // Private connections: event_conn is read by the event thread only, query_conn
+    // is used by ReadSelection() on the dispatch and hedge threads (libdbus is
+    // initialized for threads)
+    void *event_conn = nullptr;
+    void *query_conn = nullptr;
+
+    std::thread event_thread;
+    std::atomic<bool> running{false};
+
+    std::mutex source_mutex;
+    Source source;
+};
@@ -0,0 +1,47 @@
+/**
+ * libdbus-1 ABI types for code that loads libdbus with dlopen
+ *
+ * These match the libdbus-1 public ABI and are safe to use with dlsym'd
+ * functions, so no libdbus headers or link dependency are needed.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+struct DBusError_ABI
+{
+    const char *name;
+    const char *message;
+    unsigned int dummy1 : 1;
+    unsigned int dummy2 : 1;
+    unsigned int dummy3 : 1;
+    unsigned int dummy4 : 1;
+    unsigned int dummy5 : 1;
+    void *padding1;
+};
+
+struct DBusMessageIter_ABI
+{
+    void *dummy1;
+    void *dummy2;
+    uint32_t dummy3;
+    int dummy4, dummy5, dummy6, dummy7, dummy8, dummy9, dummy10, dummy11;
+    int pad1;
+    void *pad2;
+    void *pad3;
+};
+
+// DBusBusType, DBusMessage type and argument type codes used with the dlsym'd functions
+constexpr int DBUS_ABI_BUS_SESSION = 0;
+constexpr int DBUS_ABI_BUS_SYSTEM = 1;
+constexpr int DBUS_ABI_MESSAGE_TYPE_SIGNAL = 4;
+constexpr int DBUS_ABI_TYPE_INVALID = '\0';
+constexpr int DBUS_ABI_TYPE_BOOLEAN = 'b';
+constexpr int DBUS_ABI_TYPE_INT32 = 'i';
+constexpr int DBUS_ABI_TYPE_UINT32 = 'u';
+constexpr int DBUS_ABI_TYPE_STRING = 's';
+constexpr int DBUS_ABI_TYPE_OBJECT_PATH = 'o';
+constexpr int DBUS_ABI_TYPE_ARRAY = 'a';
+constexpr int DBUS_ABI_TYPE_VARIANT = 'v';
+constexpr int DBUS_ABI_TYPE_DICT_ENTRY = 'e';
@@ -0,0 +1,84 @@
+/**
+ * libdbus-1 loader for Linux
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "dbus_loader.h"
+
+#include <dlfcn.h>
+
+#include <mutex>
+
+#include "log_ring.h"
+
+static DBusLibrary loaded_library;
+const DBusLibrary &dbus_library = loaded_library;
+
+static bool LoadFunctions()
+{
+    void *lib = dlopen("libdbus-1.so.3", RTLD_LAZY);
+    if (!lib)
+    {
+        LogMessage(LogLevel::Info, "[D-Bus] Failed to load libdbus-1.so.3: %s", dlerror());
+        return false;
+    }
+
+    DBusLibrary &fn = loaded_library;
+
+// Load all required function pointers
+#define LOAD_DBUS_FN(name)                                                    \
+    fn.name = reinterpret_cast<decltype(fn.name)>(dlsym(lib, "dbus_" #name)); \
+    if (!fn.name)                                                             \
+    {                                                                         \
+        LogMessage(LogLevel::Warn, "[D-Bus] Missing dbus_%s", #name);         \
+        goto fail;                                                            \
+    }
+
+    LOAD_DBUS_FN(threads_init_default);
+    LOAD_DBUS_FN(error_init);
+    LOAD_DBUS_FN(error_free);
+    LOAD_DBUS_FN(bus_get_private);
+    LOAD_DBUS_FN(bus_register);
+    LOAD_DBUS_FN(bus_add_match);
+    LOAD_DBUS_FN(connection_open_private);
+    LOAD_DBUS_FN(connection_set_exit_on_disconnect);
+    LOAD_DBUS_FN(connection_close);
+    LOAD_DBUS_FN(connection_unref);
+    LOAD_DBUS_FN(connection_read_write);
+    LOAD_DBUS_FN(connection_pop_message);
+    LOAD_DBUS_FN(connection_send_with_reply_and_block);
+    LOAD_DBUS_FN(message_new_method_call);
+    LOAD_DBUS_FN(message_append_args);
+    LOAD_DBUS_FN(message_get_type);
+    LOAD_DBUS_FN(message_get_interface);
+    LOAD_DBUS_FN(message_get_member);
+    LOAD_DBUS_FN(message_get_sender);
+    LOAD_DBUS_FN(message_get_path);
+    LOAD_DBUS_FN(message_iter_init);
+    LOAD_DBUS_FN(message_iter_get_arg_type);
+    LOAD_DBUS_FN(message_iter_get_basic);
+    LOAD_DBUS_FN(message_iter_next);
+    LOAD_DBUS_FN(message_iter_recurse);
+    LOAD_DBUS_FN(message_unref);
+
+#undef LOAD_DBUS_FN
+
+    // Connections are opened on the host thread and used from the event, watcher and dispatch threads
+    fn.threads_init_default();
+    fn.loaded = true;
+    return true;
+
+fail:
+    dlclose(lib);
+    fn = DBusLibrary{};
+    return false;
+}
+
+bool LoadDBusLibrary()
+{
+    static std::once_flag once;
+    std::call_once(once, LoadFunctions);
+    return loaded_library.loaded;
+}
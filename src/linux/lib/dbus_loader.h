@@ -0,0 +1,48 @@
+/**
+ * libdbus-1 loaded with dlopen, shared by the AT-SPI2 source and the session state monitor
+ *
+ * The library is loaded on first use and never unloaded: libdbus keeps process-wide state.
+ * No libdbus headers or link dependency are needed (see dbus_abi.h).
+ */
+
+#pragma once
+
+#include "dbus_abi.h"
+
+struct DBusLibrary
+{
+    bool loaded = false;
+
+    int (*threads_init_default)() = nullptr;
+    void (*error_init)(DBusError_ABI *) = nullptr;
+    void (*error_free)(DBusError_ABI *) = nullptr;
+    void *(*bus_get_private)(int, DBusError_ABI *) = nullptr;
+    int (*bus_register)(void *, DBusError_ABI *) = nullptr;
+    void (*bus_add_match)(void *, const char *, DBusError_ABI *) = nullptr;
+    void *(*connection_open_private)(const char *, DBusError_ABI *) = nullptr;
+    void (*connection_set_exit_on_disconnect)(void *, int) = nullptr;
+    void (*connection_close)(void *) = nullptr;
+    void (*connection_unref)(void *) = nullptr;
+    int (*connection_read_write)(void *, int) = nullptr;
+    void *(*connection_pop_message)(void *) = nullptr;
+    void *(*connection_send_with_reply_and_block)(void *, void *, int, DBusError_ABI *) = nullptr;
+    void *(*message_new_method_call)(const char *, const char *, const char *, const char *) = nullptr;
+    int (*message_append_args)(void *, int, ...) = nullptr;
+    int (*message_get_type)(void *) = nullptr;
+    const char *(*message_get_interface)(void *) = nullptr;
+    const char *(*message_get_member)(void *) = nullptr;
+    const char *(*message_get_sender)(void *) = nullptr;
+    const char *(*message_get_path)(void *) = nullptr;
+    int (*message_iter_init)(void *, DBusMessageIter_ABI *) = nullptr;
+    int (*message_iter_get_arg_type)(DBusMessageIter_ABI *) = nullptr;
+    void (*message_iter_get_basic)(DBusMessageIter_ABI *, void *) = nullptr;
+    int (*message_iter_next)(DBusMessageIter_ABI *) = nullptr;
+    void (*message_iter_recurse)(DBusMessageIter_ABI *, DBusMessageIter_ABI *) = nullptr;
+    void (*message_unref)(void *) = nullptr;
+};
+
+// The loaded functions; all null until LoadDBusLibrary() succeeds
+extern const DBusLibrary &dbus_library;
+
+// Load libdbus-1 on first use. Only attempts loading once; safe to call from any thread.
+bool LoadDBusLibrary();
@@ -0,0 +1,187 @@
+/**
+ * Event reactor for Linux
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "event_reactor.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include "../common.h"
+#include "log_ring.h"
+#include "utils.h"
+
+static uint64_t SteadyMs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+EventReactor::~EventReactor()
+{
+    Stop();
+}
+
+bool EventReactor::Start(const ThreadSchedulingOptions &scheduling)
+{
+    if (running)
+        return false;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd;
+    if (epoll_fd < 0 || wake_fd < 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev) != 0)
+    {
+        LogMessage(LogLevel::Error, "[Reactor] Failed to create the event fds: %s", strerror(errno));
+        if (epoll_fd >= 0)
+            close(epoll_fd);
+        if (wake_fd >= 0)
+            close(wake_fd);
+        epoll_fd = -1;
+        wake_fd = -1;
+        return false;
+    }
+
+    running = true;
+    reactor_thread = std::thread(
+        [this, scheduling]()
+        {
+            ApplyThreadScheduling("sh-x11", &scheduling);
+            ThreadProc();
+        });
+    return true;
+}
+
+void EventReactor::Stop()
+{
+    if (!running)
+        return;
+
+    running = false;
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd, &one, sizeof(one));
+    (void)written;  // a nonblocking eventfd only fails when saturated, which still wakes the thread
+
+    if (reactor_thread.joinable())
+        reactor_thread.join();
+
+    close(epoll_fd);
+    close(wake_fd);
+    epoll_fd = -1;
+    wake_fd = -1;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+}
+
+bool EventReactor::Add(int fd, ReactorHandler handler, void *context)
+{
+    if (!running || fd < 0 || !handler)
+        return false;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        LogMessage(LogLevel::Error, "[Reactor] Failed to watch fd %d: %s", fd, strerror(errno));
+        return false;
+    }
+
+    // Due right away; the wakeup makes the thread recompute its wait
+    entries.push_back({fd, handler, context, SteadyMs()});
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd, &one, sizeof(one));
+    (void)written;
+    return true;
+}
+
+void EventReactor::Remove(int fd)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = std::find_if(entries.begin(), entries.end(), [fd](const Entry &entry) { return entry.fd == fd; });
+    if (it == entries.end())
+        return;
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    entries.erase(it);
+}
+
+void EventReactor::Invoke(Entry &entry)
+{
+    int64_t delayMs = entry.handler(entry.context);
+    entry.dueMs = delayMs >= 0 ? SteadyMs() + static_cast<uint64_t>(delayMs) : 0;
+}
+
+void EventReactor::ThreadProc()
+{
+    while (running)
+    {
+        // Wait for input until the earliest due handler
+        int timeoutMs = -1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            uint64_t now = SteadyMs();
+            for (const Entry &entry : entries)
+            {
+                if (entry.dueMs == 0)
+                    continue;
+                int remaining = entry.dueMs > now ? static_cast<int>(entry.dueMs - now) : 0;
+                if (timeoutMs < 0 || remaining < timeoutMs)
+                    timeoutMs = remaining;
+            }
+        }
+
+        struct epoll_event ready[16];
+        int count = epoll_wait(epoll_fd, ready, 16, timeoutMs);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            LogMessage(LogLevel::Error, "[Reactor] epoll_wait failed: %s", strerror(errno));
+            break;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int i = 0; i < count; i++)
+        {
+            int fd = ready[i].data.fd;
+            if (fd == wake_fd)
+            {
+                uint64_t value;
+                ssize_t drained = read(wake_fd, &value, sizeof(value));
+                (void)drained;
+                continue;
+            }
+
+            // The fd may have been removed while epoll_wait returned
+            auto it =
+                std::find_if(entries.begin(), entries.end(), [fd](const Entry &entry) { return entry.fd == fd; });
+            if (it != entries.end())
+                Invoke(*it);
+        }
+
+        uint64_t now = SteadyMs();
+        for (Entry &entry : entries)
+        {
+            if (entry.dueMs != 0 && entry.dueMs <= now)
+                Invoke(entry);
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * Event reactor for Linux: one thread reading the connections of several displays
+ *
+ * With several X11 displays in one hook, the XRecord, XI2 and XFixes connections of
+ * every display are read by the reactor thread (sh-x11) instead of one thread per
+ * connection and display (protocols/x11.cc, X11Protocol::SetEventReactor).
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ThreadSchedulingOptions;
+
+/**
+ * Invoked on the reactor thread when the fd is readable, or when the delay it returned last
+ * has elapsed. Returns the ms until it wants to be invoked without input, or -1 for none.
+ */
+typedef int64_t (*ReactorHandler)(void *context);
+
+/**
+ * epoll loop on one thread. Handlers run one at a time and must not call Add() or Remove().
+ */
+class EventReactor
+{
+  public:
+    EventReactor() = default;
+    ~EventReactor();
+
+    EventReactor(const EventReactor &) = delete;
+    EventReactor &operator=(const EventReactor &) = delete;
+
+    // Start the reactor thread (sh-x11) with the scheduling of the input threads
+    bool Start(const ThreadSchedulingOptions &scheduling);
+    void Stop();
+    bool IsRunning() const { return running.load(); }
+
+    // Watch fd for input. The handler is also invoked once right away, for input that the
+    // owner of the fd has already read into its buffers (e.g. Xlib's event queue).
+    bool Add(int fd, ReactorHandler handler, void *context);
+    // Stop watching fd. Once this returns, its handler is not running and is not invoked again.
+    void Remove(int fd);
+
+  private:
+    struct Entry
+    {
+        int fd;
+        ReactorHandler handler;
+        void *context;
+        uint64_t dueMs;  // Steady clock ms of the next invocation without input, 0 = none
+    };
+
+    void ThreadProc();
+    void Invoke(Entry &entry);
+
+    int epoll_fd = -1;
+    int wake_fd = -1;  // eventfd, recomputes the wait after Add() and ends it on Stop()
+
+    // Held while handlers run, so Remove() waits for a running handler
+    std::mutex mutex;
+    std::vector<Entry> entries;
+
+    std::thread reactor_thread;
+    std::atomic<bool> running{false};
+};
@@ -0,0 +1,59 @@
+/**
+ * Input device selection for Linux
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "input_devices.h"
+
+#include <algorithm>
+
+#include <linux/input.h>
+
+bool MatchInputDeviceRule(const InputDeviceInfo &device, const InputDeviceRule &rule)
+{
+    if (rule.bus >= 0 && rule.bus != device.bus)
+        return false;
+    if (rule.vendor >= 0 && rule.vendor != device.vendor)
+        return false;
+    if (rule.product >= 0 && rule.product != device.product)
+        return false;
+    if (rule.classes && !(rule.classes & device.classes))
+        return false;
+
+    if (!rule.name.empty())
+    {
+        std::string lowerName = device.name;
+        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+        if (lowerName.find(rule.name) == std::string::npos)
+            return false;
+    }
+
+    return true;
+}
+
+bool IsInputDeviceAllowed(const InputDeviceInfo &device, const InputDeviceFilter &filter, const char **reason)
+{
+    const char *rejected = nullptr;
+
+    if (filter.excludeVirtual && device.bus == BUS_VIRTUAL)
+    {
+        rejected = "virtual device";
+    }
+    else if (std::any_of(filter.deny.begin(), filter.deny.end(),
+                         [&](const InputDeviceRule &rule) { return MatchInputDeviceRule(device, rule); }))
+    {
+        rejected = "deny list";
+    }
+    else if (!filter.allow.empty() &&
+             std::none_of(filter.allow.begin(), filter.allow.end(),
+                          [&](const InputDeviceRule &rule) { return MatchInputDeviceRule(device, rule); }))
+    {
+        rejected = "not in allow list";
+    }
+
+    if (reason)
+        *reason = rejected;
+    return rejected == nullptr;
+}
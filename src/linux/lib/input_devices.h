@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "../common.h"
+
+// Identity and classes of an input device, read when it is probed
+struct InputDeviceInfo
+{
+    std::string name;
+    int bus = 0;  ///< BUS_* id
+    int vendor = 0;
+    int product = 0;
+    int classes = 0;  ///< INPUT_DEVICE_* bits
+};
+
+/**
+ * Whether a probed device passes the filter: not virtual when virtual devices are
+ * excluded, matching no deny rule and, when there are allow rules, at least one of them.
+ * @param reason Set to a short description when the device is rejected (may be null)
+ */
+bool IsInputDeviceAllowed(const InputDeviceInfo &device, const InputDeviceFilter &filter, const char **reason);
+
+// Whether a device matches a rule; rule names are lowercased
+bool MatchInputDeviceRule(const InputDeviceInfo &device, const InputDeviceRule &rule);
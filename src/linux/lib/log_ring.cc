@@ -0,0 +1,181 @@
+/**
+ * Lock-free diagnostic log ring
+ *
+ * Bounded multi-producer/multi-consumer queue with a sequence number per slot
+ * (D. Vyukov): a slot is free for position pos when its sequence equals pos and
+ * holds a published entry when it equals pos + 1.
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "log_ring.h"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <ctime>
+
+#include <unistd.h>
+
+static_assert((LOG_RING_CAPACITY & (LOG_RING_CAPACITY - 1)) == 0, "LOG_RING_CAPACITY must be a power of two");
+
+// A full ring drops its oldest entry to make room; writers racing on it give up after this many tries
+constexpr int MAX_WRITE_ATTEMPTS = 4;
+
+namespace
+{
+
+struct Slot
+{
+    std::atomic<uint64_t> sequence;
+    uint64_t timeNs;
+    LogLevel level;
+    char message[LOG_MESSAGE_MAX];
+};
+
+class LogRing
+{
+  public:
+    LogRing()
+    {
+        for (size_t i = 0; i < LOG_RING_CAPACITY; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Claim the slot for the next entry; nullptr when the ring stays full
+    Slot *Claim(uint64_t &pos)
+    {
+        pos = write_pos.load(std::memory_order_relaxed);
+        for (int attempt = 0;;)
+        {
+            Slot &slot = slots[pos & (LOG_RING_CAPACITY - 1)];
+            int64_t diff = static_cast<int64_t>(slot.sequence.load(std::memory_order_acquire) - pos);
+            if (diff == 0)
+            {
+                if (write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    return &slot;
+            }
+            else if (diff < 0)
+            {
+                // Full: overwrite the oldest entry
+                if (++attempt > MAX_WRITE_ATTEMPTS || !Pop(nullptr))
+                    return nullptr;
+                pos = write_pos.load(std::memory_order_relaxed);
+            }
+            else
+            {
+                pos = write_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Publish(Slot *slot, uint64_t pos) { slot->sequence.store(pos + 1, std::memory_order_release); }
+
+    // Take the oldest published entry (into entry, unless nullptr)
+    bool Pop(LogEntry *entry)
+    {
+        uint64_t pos = read_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Slot &slot = slots[pos & (LOG_RING_CAPACITY - 1)];
+            int64_t diff = static_cast<int64_t>(slot.sequence.load(std::memory_order_acquire) - (pos + 1));
+            if (diff == 0)
+            {
+                if (read_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    if (entry)
+                    {
+                        entry->seq = pos;
+                        entry->timeNs = slot.timeNs;
+                        entry->level = slot.level;
+                        entry->message = slot.message;
+                    }
+                    slot.sequence.store(pos + LOG_RING_CAPACITY, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;  // empty, or the oldest entry is still being written
+            }
+            else
+            {
+                pos = read_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::atomic<int> notify_fd{-1};
+
+  private:
+    Slot slots[LOG_RING_CAPACITY];
+    alignas(64) std::atomic<uint64_t> write_pos{0};
+    alignas(64) std::atomic<uint64_t> read_pos{0};
+};
+
+LogRing ring;
+
+}  // namespace
+
+void LogMessage(LogLevel level, const char *format, ...)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    uint64_t pos;
+    Slot *slot = ring.Claim(pos);
+    if (!slot)
+        return;
+
+    slot->timeNs = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    slot->level = level;
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(slot->message, sizeof(slot->message), format, args);
+    va_end(args);
+
+    ring.Publish(slot, pos);
+
+    int fd = ring.notify_fd.load(std::memory_order_acquire);
+    if (fd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(fd, &one, sizeof(one));
+        (void)written;  // a nonblocking eventfd only fails when saturated, which still wakes the host
+    }
+}
+
+void LogDrain(std::vector<LogEntry> &entries)
+{
+    LogEntry entry;
+    while (ring.Pop(&entry))
+        entries.push_back(std::move(entry));
+}
+
+void LogSetNotifyFd(int fd)
+{
+    ring.notify_fd.store(fd, std::memory_order_release);
+}
+
+void LogClearNotifyFd(int fd)
+{
+    ring.notify_fd.compare_exchange_strong(fd, -1);
+}
+
+const char *GetLogLevelName(LogLevel level)
+{
+    switch (level)
+    {
+        case LogLevel::Error:
+            return "error";
+        case LogLevel::Warn:
+            return "warn";
+        case LogLevel::Info:
+            return "info";
+        case LogLevel::Debug:
+            return "debug";
+    }
+    return "info";
+}
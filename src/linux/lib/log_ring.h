@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Diagnostic log of the native code
+ *
+ * A process-wide, fixed-size ring of LOG_RING_CAPACITY entries, written
+ * lock-free from any thread: a writer claims a slot with a compare-and-swap,
+ * formats into it and publishes it, and never waits on a reader or on I/O.
+ * When the ring is full the oldest entry is overwritten. Nothing is printed;
+ * the host drains the entries with LogDrain(). Timestamps are CLOCK_MONOTONIC.
+ */
+
+enum class LogLevel : uint8_t
+{
+    Error = 0,
+    Warn = 1,
+    Info = 2,
+    Debug = 3
+};
+
+constexpr size_t LOG_RING_CAPACITY = 256;
+constexpr size_t LOG_MESSAGE_MAX = 232;  // bytes, NUL included; longer messages are truncated
+
+struct LogEntry
+{
+    uint64_t seq;     ///< write order; a gap means entries were overwritten before they were drained
+    uint64_t timeNs;  ///< CLOCK_MONOTONIC
+    LogLevel level;
+    std::string message;
+};
+
+void LogMessage(LogLevel level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+// Move the published entries, oldest first, into entries (appended)
+void LogDrain(std::vector<LogEntry> &entries);
+
+// Signal this eventfd after every write, e.g. the core's wakeup fd; -1 = none.
+// LogClearNotifyFd() only clears fd if it is still the one set.
+void LogSetNotifyFd(int fd);
+void LogClearNotifyFd(int fd);
+
+// "error", "warn", "info" or "debug"
+const char *GetLogLevelName(LogLevel level);
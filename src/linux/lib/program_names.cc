@@ -0,0 +1,78 @@
+/**
+ * Interned program names
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "program_names.h"
+
+#include <algorithm>
+
+static_assert(ProgramNameTable::MAX_LISTS <= 8, "list bits are kept in a uint8_t");
+
+ProgramNameTable::ProgramNameTable()
+{
+    names.emplace_back();  // UNKNOWN
+}
+
+uint32_t ProgramNameTable::Intern(const std::string &name)
+{
+    if (name.empty())
+        return UNKNOWN;
+
+    auto it = ids.find(name);
+    if (it != ids.end())
+        return it->second;
+
+    if (Size() >= MAX_NAMES)
+        return UNKNOWN;
+
+    Entry entry;
+    entry.name = name;
+    entry.lowerName = name;
+    std::transform(entry.lowerName.begin(), entry.lowerName.end(), entry.lowerName.begin(), ::tolower);
+
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.push_back(std::move(entry));
+    ids.emplace(name, id);
+    return id;
+}
+
+bool ProgramNameTable::IsInList(uint32_t id, int list, const std::vector<std::string> &filterList)
+{
+    if (id == UNKNOWN || id >= names.size() || list < 0 || list >= MAX_LISTS)
+        return false;
+
+    Entry &entry = names[id];
+    uint8_t bit = static_cast<uint8_t>(1u << list);
+    if (entry.listKnown & bit)
+        return (entry.listMatch & bit) != 0;
+
+    bool match = false;
+    for (const auto &filterItem : filterList)
+    {
+        if (entry.lowerName.find(filterItem) != std::string::npos)
+        {
+            match = true;
+            break;
+        }
+    }
+
+    entry.listKnown |= bit;
+    if (match)
+        entry.listMatch |= bit;
+    else
+        entry.listMatch &= static_cast<uint8_t>(~bit);
+    return match;
+}
+
+void ProgramNameTable::InvalidateList(int list)
+{
+    if (list < 0 || list >= MAX_LISTS)
+        return;
+
+    uint8_t mask = static_cast<uint8_t>(~(1u << list));
+    for (Entry &entry : names)
+        entry.listKnown &= mask;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Interned program names
+ *
+ * Maps each distinct program name to a small id, stable for the lifetime of the
+ * table, so that events, the selection history and the hosts can refer to a
+ * program without copying or converting its name again. Id 0 stands for an
+ * unknown program (empty name) and for names past MAX_NAMES, which are then
+ * used by value. Also caches, per name and filter list, whether the name
+ * matches the list (case-insensitive substring, as IsInFilterList()).
+ *
+ * Not thread-safe: used on the Dispatch() thread only.
+ */
+class ProgramNameTable
+{
+  public:
+    static constexpr uint32_t UNKNOWN = 0;
+    static constexpr size_t MAX_NAMES = 4096;
+    static constexpr int MAX_LISTS = 8;
+
+    ProgramNameTable();
+
+    // Id of name, added on first use; UNKNOWN for an empty name or a full table
+    uint32_t Intern(const std::string &name);
+
+    // Name of an id; empty for UNKNOWN
+    const std::string &Name(uint32_t id) const { return id < names.size() ? names[id].name : names[0].name; }
+    size_t Size() const { return names.size() - 1; }
+
+    // Whether the program matches filterList (lowercased entries); cached until InvalidateList(list)
+    bool IsInList(uint32_t id, int list, const std::vector<std::string> &filterList);
+    void InvalidateList(int list);
+
+  private:
+    struct Entry
+    {
+        std::string name;
+        std::string lowerName;
+        uint8_t listKnown = 0;  ///< bit per list: listMatch is valid
+        uint8_t listMatch = 0;  ///< bit per list: the name matches
+    };
+
+    std::vector<Entry> names;  // indexed by id; names[0] is UNKNOWN
+    std::unordered_map<std::string, uint32_t> ids;
+};
@@ -0,0 +1,60 @@
+/**
+ * Per-program read latency of the selection sources
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "read_latency.h"
+
+#include <algorithm>
+
+void ReadLatencyTracker::Record(const std::string &programName, ReadSource source, uint32_t latencyMs)
+{
+    auto it = programs.find(programName);
+    if (it == programs.end())
+    {
+        // Evict the least recently used program
+        if (programs.size() >= MAX_PROGRAMS)
+        {
+            auto oldest = std::min_element(programs.begin(), programs.end(), [](const auto &a, const auto &b) {
+                return a.second.lastUsed < b.second.lastUsed;
+            });
+            programs.erase(oldest);
+        }
+        it = programs.emplace(programName, Program()).first;
+    }
+
+    it->second.lastUsed = ++tick;
+
+    Samples &samples = it->second.sources[static_cast<int>(source)];
+    samples.ms[samples.next] = static_cast<uint16_t>(std::min<uint32_t>(latencyMs, UINT16_MAX));
+    samples.next = static_cast<uint8_t>((samples.next + 1) % SAMPLE_WINDOW);
+    if (samples.count < SAMPLE_WINDOW)
+        samples.count++;
+}
+
+uint32_t ReadLatencyTracker::P90(const std::string &programName, ReadSource source, uint32_t defaultMs) const
+{
+    auto it = programs.find(programName);
+    if (it == programs.end())
+        return defaultMs;
+
+    const Samples &samples = it->second.sources[static_cast<int>(source)];
+    if (samples.count < MIN_SAMPLES)
+        return defaultMs;
+
+    uint16_t sorted[SAMPLE_WINDOW];
+    std::copy(samples.ms, samples.ms + samples.count, sorted);
+
+    // Nearest rank: the smallest sample with at least 90% of the samples at or below it
+    size_t rank = (samples.count * 9 + 9) / 10 - 1;
+    std::nth_element(sorted, sorted + rank, sorted + samples.count);
+    return sorted[rank];
+}
+
+void ReadLatencyTracker::Clear()
+{
+    programs.clear();
+    tick = 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Selection sources whose read latency is tracked
+enum class ReadSource
+{
+    Primary = 0,
+    Atspi = 1,
+};
+
+/**
+ * Per-program read latency of the selection sources
+ *
+ * Keeps the last SAMPLE_WINDOW read latencies of each source for the most
+ * recently used MAX_PROGRAMS programs and answers their 90th percentile. Used
+ * to decide how long a hedged read waits for the first source before starting
+ * the second one. An empty program name (e.g. always on Wayland) is a bucket
+ * of its own.
+ *
+ * Not thread-safe: used on the Dispatch() thread only.
+ */
+class ReadLatencyTracker
+{
+  public:
+    static constexpr size_t SAMPLE_WINDOW = 32;
+    static constexpr size_t MIN_SAMPLES = 4;  // below this, P90() answers its default
+    static constexpr size_t MAX_PROGRAMS = 64;
+
+    void Record(const std::string &programName, ReadSource source, uint32_t latencyMs);
+
+    // 90th percentile of the recent latencies in ms, or defaultMs until MIN_SAMPLES are known
+    uint32_t P90(const std::string &programName, ReadSource source, uint32_t defaultMs) const;
+
+    void Clear();
+
+  private:
+    struct Samples
+    {
+        uint16_t ms[SAMPLE_WINDOW];
+        uint8_t count = 0;
+        uint8_t next = 0;
+    };
+
+    struct Program
+    {
+        Samples sources[2];
+        uint64_t lastUsed = 0;
+    };
+
+    std::unordered_map<std::string, Program> programs;
+    uint64_t tick = 0;
+};
@@ -0,0 +1,200 @@
+/**
+ * Bounded selection history with deduplicated text storage
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "selection_history.h"
+
+#include <cstring>
+
+// Arena offsets are 32-bit; also bounds maxBytes = 0 (no byte cap)
+constexpr size_t MAX_HISTORY_BYTES = size_t(1) << 30;
+
+// FNV-1a, 64-bit
+static uint64_t HashString(const std::string &value)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : value)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void SelectionHistory::SetLimits(size_t maxEntries, size_t maxBytes)
+{
+    max_entries = maxEntries;
+    max_bytes = (maxBytes == 0 || maxBytes > MAX_HISTORY_BYTES) ? MAX_HISTORY_BYTES : maxBytes;
+
+    if (max_entries == 0)
+    {
+        Clear();
+        return;
+    }
+
+    EvictToLimits();
+}
+
+/**
+ * Record a selection. A repeat of the newest entry only updates its time and count.
+ */
+void SelectionHistory::Add(const std::string &text, const std::string &programName, uint32_t programId,
+                           int64_t timeMs)
+{
+    if (!IsEnabled() || text.empty())
+        return;
+
+    // Never stored: would evict everything else and still not fit
+    if (text.size() + programName.size() + 2 > max_bytes)
+        return;
+
+    if (!entries.empty())
+    {
+        Entry &newest = entries.back();
+        const Record &textRecord = records.at(newest.textKey);
+        const Record &programRecord = records.at(newest.programKey);
+
+        if (textRecord.length == text.size() && programRecord.length == programName.size() &&
+            memcmp(Data(newest.textKey), text.data(), text.size()) == 0 &&
+            memcmp(Data(newest.programKey), programName.data(), programName.size()) == 0)
+        {
+            newest.lastTime = timeMs;
+            newest.count++;
+            return;
+        }
+    }
+
+    Entry entry;
+    entry.id = next_id++;
+    entry.textKey = Intern(text);
+    entry.programKey = Intern(programName);
+    entry.programId = programId;
+    entry.firstTime = timeMs;
+    entry.lastTime = timeMs;
+    entry.count = 1;
+    entries.push_back(entry);
+
+    EvictToLimits();
+}
+
+void SelectionHistory::Query(int64_t sinceMs, size_t limit, std::vector<View> &views) const
+{
+    views.clear();
+
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+    {
+        if (it->lastTime <= sinceMs || (limit && views.size() >= limit))
+            break;
+
+        View view;
+        view.id = it->id;
+        view.text = Data(it->textKey);
+        view.textLength = records.at(it->textKey).length;
+        view.programName = Data(it->programKey);
+        view.programId = it->programId;
+        view.firstTime = it->firstTime;
+        view.lastTime = it->lastTime;
+        view.count = it->count;
+        views.push_back(view);
+    }
+}
+
+void SelectionHistory::Clear()
+{
+    entries.clear();
+    records.clear();
+    live_bytes = 0;
+
+    // Release the arena memory, not just its contents
+    std::vector<char>().swap(arena);
+}
+
+/**
+ * Return the key of value in the arena, appending it if it is not stored yet
+ */
+uint64_t SelectionHistory::Intern(const std::string &value)
+{
+    uint64_t key = HashString(value);
+
+    for (;;)
+    {
+        auto it = records.find(key);
+        if (it == records.end())
+            break;
+
+        Record &record = it->second;
+        if (record.length == value.size() && memcmp(&arena[record.offset], value.data(), value.size()) == 0)
+        {
+            record.refs++;
+            return key;
+        }
+
+        // Hash collision with a different string: probe the next key
+        key++;
+    }
+
+    Record record;
+    record.offset = static_cast<uint32_t>(arena.size());
+    record.length = static_cast<uint32_t>(value.size());
+    record.refs = 1;
+
+    arena.insert(arena.end(), value.begin(), value.end());
+    arena.push_back('\0');
+    live_bytes += value.size() + 1;
+
+    records.emplace(key, record);
+    return key;
+}
+
+void SelectionHistory::Release(uint64_t key)
+{
+    auto it = records.find(key);
+    if (it == records.end() || --it->second.refs > 0)
+        return;
+
+    live_bytes -= it->second.length + 1;
+    records.erase(it);
+}
+
+void SelectionHistory::EvictToLimits()
+{
+    while (!entries.empty() && (entries.size() > max_entries || live_bytes > max_bytes))
+    {
+        const Entry &oldest = entries.front();
+        Release(oldest.textKey);
+        Release(oldest.programKey);
+        entries.pop_front();
+    }
+
+    // Keep the arena within twice the live bytes
+    if (arena.size() - live_bytes > live_bytes)
+        Compact();
+}
+
+/**
+ * Move the referenced strings to a fresh arena, dropping the evicted ones
+ */
+void SelectionHistory::Compact()
+{
+    std::vector<char> compacted;
+    compacted.reserve(live_bytes);
+
+    for (auto &item : records)
+    {
+        Record &record = item.second;
+        uint32_t offset = static_cast<uint32_t>(compacted.size());
+        compacted.insert(compacted.end(), arena.begin() + record.offset,
+                         arena.begin() + record.offset + record.length + 1);
+        record.offset = offset;
+    }
+
+    arena.swap(compacted);
+}
+
+const char *SelectionHistory::Data(uint64_t key) const
+{
+    return &arena[records.at(key).offset];
+}
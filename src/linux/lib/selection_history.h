@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Bounded history of emitted selections
+ *
+ * Keeps the last maxEntries selections within maxBytes of stored text. Every
+ * distinct string (selection text or program name) is stored once in a single
+ * byte arena, NUL-terminated, and shared by all entries that reference it; a
+ * selection repeated back to back only bumps the count of the newest entry.
+ * Arena space freed by evicted strings is reclaimed by compaction once it
+ * exceeds the live bytes.
+ *
+ * Not thread-safe: used on the Dispatch() thread only.
+ */
+class SelectionHistory
+{
+  public:
+    // Lightweight view of an entry; the pointers stay valid until the next Add()/SetLimits()/Clear()
+    struct View
+    {
+        uint64_t id;
+        const char *text;
+        size_t textLength;
+        const char *programName;
+        uint32_t programId;  ///< interned program name (ProgramNameTable), 0 when unknown
+        int64_t firstTime;  ///< ms since the Unix epoch
+        int64_t lastTime;   ///< ms since the Unix epoch
+        uint32_t count;     ///< consecutive repeats of the same selection
+    };
+
+    // maxEntries = 0 disables the history and frees its memory; maxBytes = 0 means 1 GB
+    void SetLimits(size_t maxEntries, size_t maxBytes);
+    bool IsEnabled() const { return max_entries > 0; }
+
+    void Add(const std::string &text, const std::string &programName, uint32_t programId, int64_t timeMs);
+
+    // Entries whose lastTime is after sinceMs, newest first, at most limit (0 = no limit)
+    void Query(int64_t sinceMs, size_t limit, std::vector<View> &views) const;
+
+    void Clear();
+
+    size_t GetEntryCount() const { return entries.size(); }
+    size_t GetTextBytes() const { return live_bytes; }
+
+  private:
+    // A string in the arena, shared by reference count
+    struct Record
+    {
+        uint32_t offset;
+        uint32_t length;  ///< without the terminating NUL
+        uint32_t refs;
+    };
+
+    struct Entry
+    {
+        uint64_t id;
+        uint64_t textKey;
+        uint64_t programKey;
+        uint32_t programId;
+        int64_t firstTime;
+        int64_t lastTime;
+        uint32_t count;
+    };
+
+    uint64_t Intern(const std::string &value);
+    void Release(uint64_t key);
+    void EvictToLimits();
+    void Compact();
+    const char *Data(uint64_t key) const;
+
+    size_t max_entries = 0;
+    size_t max_bytes = 0;
+
+    std::deque<Entry> entries;                   // oldest first
+    std::unordered_map<uint64_t, Record> records;  // by content hash (probed on collision)
+    std::vector<char> arena;
+    size_t live_bytes = 0;  // bytes of referenced records, NULs included
+    uint64_t next_id = 1;
+};
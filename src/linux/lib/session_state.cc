@@ -0,0 +1,393 @@
+/**
+ * Session lock and idle state for Linux
+ *
+ * logind, through libdbus-1 loaded with dlopen:
+ *   Manager.GetSession(XDG_SESSION_ID | "auto")  → session object path
+ *   Properties.GetAll(Session)                   → initial LockedHint / IdleHint
+ *   Properties.PropertiesChanged (signal)        → changes, read on the watcher thread
+ * X11: MIT-SCREEN-SAVER ScreenSaverNotify on a dedicated connection.
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "session_state.h"
+
+#include <sys/select.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "dbus_loader.h"
+#include "log_ring.h"
+#include "utils.h"
+
+#include <X11/Xlib.h>
+#include <X11/extensions/scrnsaver.h>
+
+// Reply timeout of calls to logind
+constexpr int SESSION_CALL_TIMEOUT_MS = 500;
+// Watcher thread wakeup interval, bounds the latency of Stop() and of screen saver changes
+constexpr int SESSION_POLL_MS = 100;
+
+static const char *const LOGIND_SERVICE = "org.freedesktop.login1";
+static const char *const LOGIND_SESSION_INTERFACE = "org.freedesktop.login1.Session";
+static const char *const DBUS_PROPERTIES_INTERFACE = "org.freedesktop.DBus.Properties";
+
+// libdbus-1 functions, loaded by LoadDBusLibrary()
+static const DBusLibrary &dbus_fn = dbus_library;
+
+static void CloseConnection(void *&conn)
+{
+    if (!conn)
+        return;
+
+    dbus_fn.connection_close(conn);
+    dbus_fn.connection_unref(conn);
+    conn = nullptr;
+}
+
+/**
+ * Call a method and return the reply (message_unref it), or nullptr on error/timeout.
+ * Takes ownership of msg.
+ */
+static void *CallMethod(void *conn, void *msg)
+{
+    if (!msg)
+        return nullptr;
+
+    DBusError_ABI err;
+    dbus_fn.error_init(&err);
+    void *reply = dbus_fn.connection_send_with_reply_and_block(conn, msg, SESSION_CALL_TIMEOUT_MS, &err);
+    dbus_fn.message_unref(msg);
+    dbus_fn.error_free(&err);
+    return reply;
+}
+
+/**
+ * Read the LockedHint/IdleHint entries of the a{sv} dictionary at iter.
+ * known gets the SESSION_* flags present in it, set those that are true.
+ */
+static void ReadHints(DBusMessageIter_ABI *iter, int &known, int &set)
+{
+    if (dbus_fn.message_iter_get_arg_type(iter) != DBUS_ABI_TYPE_ARRAY)
+        return;
+
+    DBusMessageIter_ABI entries;
+    dbus_fn.message_iter_recurse(iter, &entries);
+    while (dbus_fn.message_iter_get_arg_type(&entries) == DBUS_ABI_TYPE_DICT_ENTRY)
+    {
+        DBusMessageIter_ABI entry;
+        dbus_fn.message_iter_recurse(&entries, &entry);
+
+        const char *key = nullptr;
+        if (dbus_fn.message_iter_get_arg_type(&entry) == DBUS_ABI_TYPE_STRING)
+            dbus_fn.message_iter_get_basic(&entry, &key);
+
+        int flag = 0;
+        if (key && strcmp(key, "LockedHint") == 0)
+            flag = SESSION_LOCKED;
+        else if (key && strcmp(key, "IdleHint") == 0)
+            flag = SESSION_IDLE;
+
+        if (flag && dbus_fn.message_iter_next(&entry) &&
+            dbus_fn.message_iter_get_arg_type(&entry) == DBUS_ABI_TYPE_VARIANT)
+        {
+            DBusMessageIter_ABI variant;
+            dbus_fn.message_iter_recurse(&entry, &variant);
+            if (dbus_fn.message_iter_get_arg_type(&variant) == DBUS_ABI_TYPE_BOOLEAN)
+            {
+                uint32_t value = 0;  // dbus_bool_t
+                dbus_fn.message_iter_get_basic(&variant, &value);
+                known |= flag;
+                if (value)
+                    set |= flag;
+            }
+        }
+
+        if (!dbus_fn.message_iter_next(&entries))
+            break;
+    }
+}
+
+SessionStateMonitor::~SessionStateMonitor()
+{
+    Stop();
+}
+
+bool SessionStateMonitor::Start(bool watchScreenSaver, SessionStateCallback callback, void *context,
+                                std::string &error)
+{
+    if (running)
+        return true;
+
+    state_callback = callback;
+    callback_context = context;
+    state = 0;
+
+    std::string logindError = "not watched for an explicit display";
+    bool hasLogind = display_name.empty() && ConnectLogind(logindError);
+    if (!hasLogind)
+        LogMessage(LogLevel::Info, "[Session] logind not available: %s", logindError.c_str());
+
+    bool hasScreenSaver = watchScreenSaver && ConnectScreenSaver();
+
+    if (!hasLogind && !hasScreenSaver)
+    {
+        error = logindError;
+        return false;
+    }
+
+    running = true;
+    watcher_thread = std::thread(&SessionStateMonitor::ThreadProc, this);
+    return true;
+}
+
+void SessionStateMonitor::Stop()
+{
+    running = false;
+    if (watcher_thread.joinable())
+        watcher_thread.join();
+
+    if (system_conn)
+        CloseConnection(system_conn);
+    session_path.clear();
+
+    if (screensaver_display)
+    {
+        XCloseDisplay(screensaver_display);
+        screensaver_display = nullptr;
+    }
+}
+
+/**
+ * Find the logind session (XDG_SESSION_ID, else the one logind picks for the caller),
+ * subscribe to its property changes and read the current hints.
+ */
+bool SessionStateMonitor::ConnectLogind(std::string &error)
+{
+    if (!LoadDBusLibrary())
+    {
+        error = "libdbus-1.so.3 is not available";
+        return false;
+    }
+
+    DBusError_ABI err;
+    dbus_fn.error_init(&err);
+    system_conn = dbus_fn.bus_get_private(DBUS_ABI_BUS_SYSTEM, &err);
+    if (!system_conn)
+    {
+        error = std::string("Failed to connect to the system bus: ") + (err.message ? err.message : "unknown");
+        dbus_fn.error_free(&err);
+        return false;
+    }
+    dbus_fn.error_free(&err);
+
+    // A private bus connection exits the process on disconnect by default
+    dbus_fn.connection_set_exit_on_disconnect(system_conn, 0);
+
+    const char *sessionId = getenv("XDG_SESSION_ID");
+    if (!sessionId || !*sessionId)
+        sessionId = "auto";
+
+    void *msg = dbus_fn.message_new_method_call(LOGIND_SERVICE, "/org/freedesktop/login1",
+                                                "org.freedesktop.login1.Manager", "GetSession");
+    if (msg)
+        dbus_fn.message_append_args(msg, DBUS_ABI_TYPE_STRING, &sessionId, DBUS_ABI_TYPE_INVALID);
+
+    if (void *reply = CallMethod(system_conn, msg))
+    {
+        DBusMessageIter_ABI iter;
+        const char *path = nullptr;
+        if (dbus_fn.message_iter_init(reply, &iter) &&
+            dbus_fn.message_iter_get_arg_type(&iter) == DBUS_ABI_TYPE_OBJECT_PATH)
+        {
+            dbus_fn.message_iter_get_basic(&iter, &path);
+        }
+        if (path)
+            session_path = path;
+        dbus_fn.message_unref(reply);
+    }
+
+    if (session_path.empty())
+    {
+        error = std::string("No logind session for ") + sessionId;
+        CloseConnection(system_conn);
+        return false;
+    }
+
+    std::string rule = std::string("type='signal',sender='") + LOGIND_SERVICE + "',interface='" +
+                       DBUS_PROPERTIES_INTERFACE + "',member='PropertiesChanged',path='" + session_path + "'";
+    dbus_fn.error_init(&err);
+    dbus_fn.bus_add_match(system_conn, rule.c_str(), &err);
+    dbus_fn.error_free(&err);
+
+    ReadLogindHints();
+    return true;
+}
+
+void SessionStateMonitor::ReadLogindHints()
+{
+    void *msg = dbus_fn.message_new_method_call(LOGIND_SERVICE, session_path.c_str(), DBUS_PROPERTIES_INTERFACE,
+                                                "GetAll");
+    if (msg)
+        dbus_fn.message_append_args(msg, DBUS_ABI_TYPE_STRING, &LOGIND_SESSION_INTERFACE, DBUS_ABI_TYPE_INVALID);
+
+    void *reply = CallMethod(system_conn, msg);
+    if (!reply)
+        return;
+
+    int known = 0;
+    int set = 0;
+    DBusMessageIter_ABI iter;
+    if (dbus_fn.message_iter_init(reply, &iter))
+        ReadHints(&iter, known, set);
+    dbus_fn.message_unref(reply);
+
+    if (known & SESSION_LOCKED)
+        UpdateState(SESSION_LOCKED, set & SESSION_LOCKED);
+    if (known & SESSION_IDLE)
+        UpdateState(SESSION_IDLE, set & SESSION_IDLE);
+}
+
+// PropertiesChanged(s interface, a{sv} changed, as invalidated)
+void SessionStateMonitor::OnPropertiesChanged(void *msg)
+{
+    DBusMessageIter_ABI iter;
+    if (!dbus_fn.message_iter_init(msg, &iter) || dbus_fn.message_iter_get_arg_type(&iter) != DBUS_ABI_TYPE_STRING)
+        return;
+
+    const char *iface = nullptr;
+    dbus_fn.message_iter_get_basic(&iter, &iface);
+    if (!iface || strcmp(iface, LOGIND_SESSION_INTERFACE) != 0 || !dbus_fn.message_iter_next(&iter))
+        return;
+
+    int known = 0;
+    int set = 0;
+    ReadHints(&iter, known, set);
+
+    if (known & SESSION_LOCKED)
+        UpdateState(SESSION_LOCKED, set & SESSION_LOCKED);
+    if (known & SESSION_IDLE)
+        UpdateState(SESSION_IDLE, set & SESSION_IDLE);
+
+    // Properties invalidated without a value are read again
+    if (dbus_fn.message_iter_next(&iter) && dbus_fn.message_iter_get_arg_type(&iter) == DBUS_ABI_TYPE_ARRAY)
+    {
+        DBusMessageIter_ABI names;
+        dbus_fn.message_iter_recurse(&iter, &names);
+        if (dbus_fn.message_iter_get_arg_type(&names) == DBUS_ABI_TYPE_STRING)
+            ReadLogindHints();
+    }
+}
+
+bool SessionStateMonitor::ConnectScreenSaver()
+{
+    Display *display = XOpenDisplay(display_name.empty() ? nullptr : display_name.c_str());
+    if (!display)
+        return false;
+
+    int error_base = 0;
+    if (!XScreenSaverQueryExtension(display, &screensaver_event_base, &error_base))
+    {
+        LogMessage(LogLevel::Info, "[Session] MIT-SCREEN-SAVER extension not available");
+        XCloseDisplay(display);
+        return false;
+    }
+
+    Window root = DefaultRootWindow(display);
+    XScreenSaverSelectInput(display, root, ScreenSaverNotifyMask);
+
+    if (XScreenSaverInfo *info = XScreenSaverAllocInfo())
+    {
+        if (XScreenSaverQueryInfo(display, root, info))
+            UpdateState(SESSION_SCREENSAVER, info->state == ScreenSaverOn);
+        XFree(info);
+    }
+    XFlush(display);
+
+    screensaver_display = display;
+    return true;
+}
+
+void SessionStateMonitor::ProcessScreenSaverEvents()
+{
+    while (XPending(screensaver_display))
+    {
+        XEvent event;
+        XNextEvent(screensaver_display, &event);
+
+        if (event.type == screensaver_event_base + ScreenSaverNotify)
+        {
+            const XScreenSaverNotifyEvent *notify = reinterpret_cast<const XScreenSaverNotifyEvent *>(&event);
+            UpdateState(SESSION_SCREENSAVER, notify->state == ScreenSaverOn || notify->state == ScreenSaverCycle);
+        }
+    }
+}
+
+// Written by Start() before the watcher thread exists, then by the watcher thread only
+void SessionStateMonitor::UpdateState(int flag, bool set)
+{
+    int previous = state.load();
+    int current = set ? (previous | flag) : (previous & ~flag);
+    if (current == previous)
+        return;
+
+    state.store(current);
+    if (running.load() && state_callback)
+        state_callback(callback_context, current);
+}
+
+void SessionStateMonitor::ThreadProc()
+{
+    ApplyThreadScheduling("sh-session", nullptr);
+
+    int x11_fd = screensaver_display ? ConnectionNumber(screensaver_display) : -1;
+
+    while (running.load())
+    {
+        if (system_conn)
+        {
+            while (void *msg = dbus_fn.connection_pop_message(system_conn))
+            {
+                const char *iface = dbus_fn.message_get_interface(msg);
+                const char *member = dbus_fn.message_get_member(msg);
+                const char *path = dbus_fn.message_get_path(msg);
+
+                if (dbus_fn.message_get_type(msg) == DBUS_ABI_MESSAGE_TYPE_SIGNAL && iface && member && path &&
+                    strcmp(iface, DBUS_PROPERTIES_INTERFACE) == 0 && strcmp(member, "PropertiesChanged") == 0 &&
+                    session_path == path)
+                {
+                    OnPropertiesChanged(msg);
+                }
+                dbus_fn.message_unref(msg);
+            }
+
+            if (!dbus_fn.connection_read_write(system_conn, SESSION_POLL_MS))
+            {
+                LogMessage(LogLevel::Warn,
+                           "[Session] System bus disconnected, lock and idle hints are no longer watched");
+                CloseConnection(system_conn);
+                UpdateState(SESSION_LOCKED, false);
+                UpdateState(SESSION_IDLE, false);
+            }
+        }
+        else
+        {
+            // Screen saver only: wait on the X connection
+            fd_set read_fds;
+            FD_ZERO(&read_fds);
+            if (x11_fd >= 0)
+                FD_SET(x11_fd, &read_fds);
+
+            struct timeval timeout;
+            timeout.tv_sec = 0;
+            timeout.tv_usec = SESSION_POLL_MS * 1000;
+            select(x11_fd + 1, &read_fds, nullptr, nullptr, &timeout);
+        }
+
+        if (screensaver_display)
+            ProcessScreenSaverEvents();
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+struct _XDisplay;
+
+// Session states that suspend the hook (bitmask)
+constexpr int SESSION_LOCKED = 0x01;       // logind LockedHint
+constexpr int SESSION_IDLE = 0x02;         // logind IdleHint
+constexpr int SESSION_SCREENSAVER = 0x04;  // X11 MIT-SCREEN-SAVER active
+constexpr int SESSION_STATE_ALL = SESSION_LOCKED | SESSION_IDLE | SESSION_SCREENSAVER;
+// States that the next input event ends: input is still read while only these are set
+constexpr int SESSION_ENDED_BY_INPUT = SESSION_IDLE | SESSION_SCREENSAVER;
+// Focused window fullscreen: reported by the protocol (SetFullscreenCallback), not watched here
+constexpr int SESSION_FULLSCREEN = 0x08;
+
+// Invoked on the watcher thread with the new SESSION_* state
+typedef void (*SessionStateCallback)(void *context, int state);
+
+/**
+ * Session lock and idle state
+ *
+ * Watches the logind session of this process on the system bus (LockedHint and
+ * IdleHint of org.freedesktop.login1.Session, through PropertiesChanged) and,
+ * on X11, the MIT-SCREEN-SAVER state of the display (ScreenSaverNotify).
+ * libdbus-1 is loaded with dlopen like the AT-SPI2 source; either source may be
+ * unavailable, e.g. outside a logind session or without the extension.
+ */
+class SessionStateMonitor
+{
+  public:
+    SessionStateMonitor() = default;
+    ~SessionStateMonitor();
+
+    SessionStateMonitor(const SessionStateMonitor &) = delete;
+    SessionStateMonitor &operator=(const SessionStateMonitor &) = delete;
+
+    // Read the current state and start the watcher thread (sh-session). Fails when neither
+    // source is available. The callback is invoked on every later change of GetState().
+    bool Start(bool watchScreenSaver, SessionStateCallback callback, void *context, std::string &error);
+    void Stop();
+    bool IsRunning() const { return running.load(); }
+
+    int GetState() const { return state.load(); }
+
+    // X11 display watched for MIT-SCREEN-SAVER instead of $DISPLAY; applied at the next Start().
+    // An explicit display belongs to another session than this process, so logind is not watched.
+    void SetDisplayName(const std::string &name) { display_name = name; }
+
+  private:
+    bool ConnectLogind(std::string &error);
+    bool ConnectScreenSaver();
+    void ReadLogindHints();
+    void OnPropertiesChanged(void *msg);
+    void ProcessScreenSaverEvents();
+    void UpdateState(int flag, bool set);
+    void ThreadProc();
+
+    // System bus connection and the session object path (/org/freedesktop/login1/session/...)
+    void *system_conn = nullptr;
+    std::string session_path;
+
+    // Dedicated X11 connection for ScreenSaverNotify, to display_name (empty: $DISPLAY)
+    std::string display_name;
+    struct _XDisplay *screensaver_display = nullptr;
+    int screensaver_event_base = 0;
+
+    SessionStateCallback state_callback = nullptr;
+    void *callback_context = nullptr;
+
+    std::thread watcher_thread;
+    std::atomic<bool> running{false};
+    std::atomic<int> state{0};
+};
@@ -0,0 +1,476 @@
+/**
+ * Text classification for selection events on Linux
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "text_classifier.h"
+
+#include <cstring>
+#include <queue>
+#include <vector>
+
+//=============================================================================
+// Multi-pattern matcher
+//=============================================================================
+
+namespace
+{
+
+enum PatternGroup : uint8_t
+{
+    GROUP_URL = 0x01,
+    GROUP_CODE = 0x02
+};
+
+struct Pattern
+{
+    const char *text;  // lowercase
+    PatternGroup group;
+};
+
+// URL schemes need a host character after them; code tokens are counted
+const Pattern PATTERNS[] = {
+    {"http://", GROUP_URL},    {"https://", GROUP_URL},  {"ftp://", GROUP_URL},     {"file://", GROUP_URL},
+    {"www.", GROUP_URL},       {"mailto:", GROUP_URL},   {"=>", GROUP_CODE},        {"->", GROUP_CODE},
+    {"::", GROUP_CODE},        {"==", GROUP_CODE},       {"!=", GROUP_CODE},        {"&&", GROUP_CODE},
+    {"||", GROUP_CODE},        {"();", GROUP_CODE},      {"){", GROUP_CODE},        {") {", GROUP_CODE},
+    {"};", GROUP_CODE},        {"#include", GROUP_CODE}, {"#define", GROUP_CODE},   {"function ", GROUP_CODE},
+    {"return ", GROUP_CODE},   {"const ", GROUP_CODE},   {"let ", GROUP_CODE},      {"var ", GROUP_CODE},
+    {"def ", GROUP_CODE},      {"import ", GROUP_CODE},  {"class ", GROUP_CODE},    {"public ", GROUP_CODE},
+    {"private ", GROUP_CODE},  {"static ", GROUP_CODE},  {"struct ", GROUP_CODE},   {"fn ", GROUP_CODE},
+    {"func ", GROUP_CODE},     {"println", GROUP_CODE},  {"printf", GROUP_CODE},    {"console.", GROUP_CODE},
+    {"self.", GROUP_CODE},     {"this.", GROUP_CODE},    {"null", GROUP_CODE},      {"nullptr", GROUP_CODE},
+    {"#!/", GROUP_CODE},       {"</", GROUP_CODE},       {"/>", GROUP_CODE},        {"sudo ", GROUP_CODE},
+};
+
+/**
+ * Aho-Corasick automaton compiled to a DFA over case-folded bytes: one table
+ * lookup per input byte, built once on first use.
+ */
+class PatternMatcher
+{
+  public:
+    PatternMatcher()
+    {
+        AddState();
+        for (const Pattern &pattern : PATTERNS)
+        {
+            uint16_t state = 0;
+            for (const char *c = pattern.text; *c; c++)
+            {
+                uint8_t byte = static_cast<uint8_t>(*c);
+                if (!next[state * 256 + byte])
+                {
+                    uint16_t added = AddState();
+                    next[state * 256 + byte] = added;
+                }
+                state = next[state * 256 + byte];
+            }
+            output[state] |= pattern.group;
+        }
+
+        // Breadth-first: fill missing transitions from the failure links and merge outputs
+        std::vector<uint16_t> fail(output.size(), 0);
+        std::queue<uint16_t> pending;
+        for (int byte = 0; byte < 256; byte++)
+        {
+            if (uint16_t child = next[byte])
+                pending.push(child);
+        }
+
+        while (!pending.empty())
+        {
+            uint16_t state = pending.front();
+            pending.pop();
+            output[state] |= output[fail[state]];
+
+            for (int byte = 0; byte < 256; byte++)
+            {
+                uint16_t &child = next[state * 256 + byte];
+                uint16_t fallback = next[fail[state] * 256 + byte];
+                if (child)
+                {
+                    fail[child] = fallback;
+                    pending.push(child);
+                }
+                else
+                {
+                    child = fallback;
+                }
+            }
+        }
+    }
+
+    uint16_t Step(uint16_t state, uint8_t byte) const { return next[state * 256 + byte]; }
+    uint8_t Output(uint16_t state) const { return output[state]; }
+
+  private:
+    uint16_t AddState()
+    {
+        output.push_back(0);
+        next.resize(next.size() + 256, 0);
+        return static_cast<uint16_t>(output.size() - 1);
+    }
+
+    std::vector<uint16_t> next;   // state * 256 + byte -> state
+    std::vector<uint8_t> output;  // PatternGroup bits matched when entering a state
+};
+
+const PatternMatcher &GetMatcher()
+{
+    static const PatternMatcher matcher;
+    return matcher;
+}
+
+//=============================================================================
+// Character classes
+//=============================================================================
+
+inline uint8_t FoldCase(uint8_t c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<uint8_t>(c + 32) : c;
+}
+
+inline bool IsSpace(uint8_t c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool IsAsciiAlnum(uint8_t c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline bool IsEmailLocalChar(uint8_t c)
+{
+    return IsAsciiAlnum(c) || c == '.' || c == '_' || c == '%' || c == '+' || c == '-';
+}
+
+inline bool IsDomainChar(uint8_t c)
+{
+    return IsAsciiAlnum(c) || c == '.' || c == '-';
+}
+
+enum Script
+{
+    SCRIPT_LATIN,
+    SCRIPT_CYRILLIC,
+    SCRIPT_GREEK,
+    SCRIPT_ARABIC,
+    SCRIPT_HEBREW,
+    SCRIPT_DEVANAGARI,
+    SCRIPT_THAI,
+    SCRIPT_CJK,
+    SCRIPT_HANGUL,
+    SCRIPT_COUNT,
+    SCRIPT_NONE = SCRIPT_COUNT
+};
+
+const uint32_t SCRIPT_TAGS[SCRIPT_COUNT] = {TEXT_TAG_LATIN,  TEXT_TAG_CYRILLIC,   TEXT_TAG_GREEK,
+                                            TEXT_TAG_ARABIC, TEXT_TAG_HEBREW,     TEXT_TAG_DEVANAGARI,
+                                            TEXT_TAG_THAI,   TEXT_TAG_CJK,        TEXT_TAG_HANGUL};
+
+// Script of a non-ASCII letter code point (approximate block ranges)
+Script GetScript(uint32_t cp)
+{
+    if ((cp >= 0xC0 && cp <= 0x24F && cp != 0xD7 && cp != 0xF7) || (cp >= 0x1E00 && cp <= 0x1EFF))
+        return SCRIPT_LATIN;
+    if (cp >= 0x370 && cp <= 0x3FF)
+        return SCRIPT_GREEK;
+    if (cp >= 0x400 && cp <= 0x52F)
+        return SCRIPT_CYRILLIC;
+    if (cp >= 0x5D0 && cp <= 0x5EA)
+        return SCRIPT_HEBREW;
+    if ((cp >= 0x620 && cp <= 0x64A) || (cp >= 0x671 && cp <= 0x6D3) || (cp >= 0x750 && cp <= 0x77F))
+        return SCRIPT_ARABIC;
+    if (cp >= 0x904 && cp <= 0x939)
+        return SCRIPT_DEVANAGARI;
+    if (cp >= 0xE01 && cp <= 0xE30)
+        return SCRIPT_THAI;
+    if ((cp >= 0x1100 && cp <= 0x11FF) || (cp >= 0x3130 && cp <= 0x318F) || (cp >= 0xAC00 && cp <= 0xD7AF))
+        return SCRIPT_HANGUL;
+    if ((cp >= 0x3040 && cp <= 0x30FF) || (cp >= 0x3400 && cp <= 0x4DBF) || (cp >= 0x4E00 && cp <= 0x9FFF) ||
+        (cp >= 0xF900 && cp <= 0xFAFF) || (cp >= 0x20000 && cp <= 0x2FFFF))
+        return SCRIPT_CJK;
+    return SCRIPT_NONE;
+}
+
+// Decode one UTF-8 sequence at text[i]; invalid bytes decode as themselves, length 1
+uint32_t DecodeUtf8(const uint8_t *text, size_t length, size_t i, size_t &sequenceLength)
+{
+    uint8_t lead = text[i];
+    size_t needed = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+    if (needed == 0 || i + needed >= length)
+    {
+        sequenceLength = 1;
+        return lead;
+    }
+
+    uint32_t cp = lead & (0x3F >> needed);
+    for (size_t k = 1; k <= needed; k++)
+    {
+        if ((text[i + k] & 0xC0) != 0x80)
+        {
+            sequenceLength = 1;
+            return lead;
+        }
+        cp = (cp << 6) | (text[i + k] & 0x3F);
+    }
+
+    sequenceLength = needed + 1;
+    return cp;
+}
+
+//=============================================================================
+// Whole-text shapes (trimmed, single line)
+//=============================================================================
+
+constexpr size_t MAX_TOKEN_BYTES = 4096;
+
+bool IsPath(const char *text, size_t length)
+{
+    if (length < 2 || length > MAX_TOKEN_BYTES || memchr(text, '\n', length))
+        return false;
+
+    bool unixPath = text[0] == '/' || (text[0] == '~' && text[1] == '/') ||
+                    (length > 2 && text[0] == '.' && text[1] == '/') ||
+                    (length > 3 && text[0] == '.' && text[1] == '.' && text[2] == '/');
+    bool windowsPath = (length > 3 && IsAsciiAlnum(static_cast<uint8_t>(text[0])) && text[1] == ':' &&
+                        (text[2] == '\\' || text[2] == '/')) ||
+                       (length > 2 && text[0] == '\\' && text[1] == '\\');
+    if (!unixPath && !windowsPath)
+        return false;
+
+    // "//" comments and "/* */" blocks are not paths
+    if (text[0] == '/' && (text[1] == '/' || text[1] == '*'))
+        return false;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        uint8_t c = static_cast<uint8_t>(text[i]);
+        if (c < 0x20 || c == '<' || c == '>' || c == '|' || c == '"')
+            return false;
+    }
+    return true;
+}
+
+bool IsNumber(const char *text, size_t length)
+{
+    if (length == 0 || length > 64)
+        return false;
+
+    size_t i = 0;
+    if (text[i] == '+' || text[i] == '-')
+        i++;
+    if (i < length && text[i] == '$')
+        i++;
+
+    // Hexadecimal
+    if (i + 2 < length && text[i] == '0' && (text[i + 1] == 'x' || text[i + 1] == 'X'))
+    {
+        size_t digits = 0;
+        for (i += 2; i < length && (IsAsciiAlnum(static_cast<uint8_t>(text[i])) || text[i] == '_'); i++)
+        {
+            char c = static_cast<char>(FoldCase(static_cast<uint8_t>(text[i])));
+            if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || c == '_'))
+                return false;
+            digits++;
+        }
+        return digits > 0 && i == length;
+    }
+
+    // Digits with grouping separators and a decimal part
+    size_t digits = 0;
+    for (; i < length; i++)
+    {
+        char c = text[i];
+        if (c >= '0' && c <= '9')
+            digits++;
+        else if ((c == ',' || c == '.' || c == '_' || c == '\'') && digits > 0 && i + 1 < length &&
+                 text[i + 1] >= '0' && text[i + 1] <= '9')
+            continue;
+        else
+            break;
+    }
+    if (digits == 0)
+        return false;
+
+    // Exponent
+    if (i < length && (text[i] == 'e' || text[i] == 'E'))
+    {
+        size_t j = i + 1;
+        if (j < length && (text[j] == '+' || text[j] == '-'))
+            j++;
+        size_t exponentDigits = 0;
+        while (j < length && text[j] >= '0' && text[j] <= '9')
+        {
+            j++;
+            exponentDigits++;
+        }
+        if (exponentDigits == 0)
+            return false;
+        i = j;
+    }
+
+    if (i < length && text[i] == '%')
+        i++;
+    return i == length;
+}
+
+}  // namespace
+
+//=============================================================================
+// Classification
+//=============================================================================
+
+uint32_t ClassifyText(const std::string &text)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(text.data());
+    size_t length = text.size() < MAX_CLASSIFY_BYTES ? text.size() : MAX_CLASSIFY_BYTES;
+
+    // Trimmed bounds for the whole-text shapes
+    size_t begin = 0, end = text.size();
+    while (begin < end && IsSpace(data[begin]))
+        begin++;
+    while (end > begin && IsSpace(data[end - 1]))
+        end--;
+    if (begin == end)
+        return 0;
+
+    uint32_t tags = 0;
+    const PatternMatcher &matcher = GetMatcher();
+
+    uint16_t state = 0;
+    size_t codeTokens = 0;
+    size_t codeSymbols = 0;  // ; { } = ( ) at any position
+    size_t visible = 0;
+    size_t letters = 0;
+    size_t scriptCounts[SCRIPT_COUNT] = {};
+
+    for (size_t i = 0; i < length;)
+    {
+        uint8_t c = data[i];
+
+        if (c < 0x80)
+        {
+            state = matcher.Step(state, FoldCase(c));
+            if (uint8_t groups = matcher.Output(state))
+            {
+                if ((groups & GROUP_URL) && i + 1 < length && IsAsciiAlnum(data[i + 1]))
+                    tags |= TEXT_TAG_URL;
+                if (groups & GROUP_CODE)
+                    codeTokens++;
+            }
+
+            if (c == '\n' && i > begin && i < end)
+                tags |= TEXT_TAG_MULTILINE;
+            else if (c == '@' && !(tags & TEXT_TAG_EMAIL))
+            {
+                // local@domain.tld
+                size_t local = 0;
+                while (local < 64 && local < i && IsEmailLocalChar(data[i - local - 1]))
+                    local++;
+
+                size_t j = i + 1, lastDot = 0;
+                while (j < length && j - i < 255 && IsDomainChar(data[j]))
+                {
+                    if (data[j] == '.')
+                        lastDot = j;
+                    j++;
+                }
+                while (j > i + 1 && (data[j - 1] == '.' || data[j - 1] == '-'))
+                    j--;
+
+                size_t tld = lastDot ? j - lastDot - 1 : 0;
+                if (local > 0 && lastDot > i + 1 && tld >= 2)
+                    tags |= TEXT_TAG_EMAIL;
+            }
+
+            if (c == ';' || c == '{' || c == '}' || c == '=' || c == '(' || c == ')')
+                codeSymbols++;
+            if (c > ' ')
+                visible++;
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+            {
+                letters++;
+                scriptCounts[SCRIPT_LATIN]++;
+            }
+            i++;
+            continue;
+        }
+
+        // Non-ASCII: a code point outside every pattern, resets the matcher
+        size_t sequenceLength;
+        uint32_t cp = DecodeUtf8(data, length, i, sequenceLength);
+        state = 0;
+        visible++;
+
+        Script script = GetScript(cp);
+        if (script != SCRIPT_NONE)
+        {
+            letters++;
+            scriptCounts[script]++;
+        }
+        i += sequenceLength;
+    }
+
+    // Code: several code tokens and a noticeable share of code punctuation
+    if (codeTokens >= 2 && codeSymbols * 25 >= visible)
+        tags |= TEXT_TAG_CODE;
+
+    const char *trimmed = text.data() + begin;
+    size_t trimmedLength = end - begin;
+    if (!(tags & TEXT_TAG_URL) && IsPath(trimmed, trimmedLength))
+        tags |= TEXT_TAG_PATH;
+    if (IsNumber(trimmed, trimmedLength))
+        return tags | TEXT_TAG_NUMBER;  // hex digits and exponents are not words
+
+    for (int script = 0; script < SCRIPT_COUNT; script++)
+    {
+        if (scriptCounts[script] > 0 && scriptCounts[script] * 4 >= letters)
+            tags |= SCRIPT_TAGS[script];
+    }
+
+    return tags;
+}
+
+const char *GetTextTagName(uint32_t tag)
+{
+    switch (tag)
+    {
+        case TEXT_TAG_URL:
+            return "url";
+        case TEXT_TAG_EMAIL:
+            return "email";
+        case TEXT_TAG_PATH:
+            return "path";
+        case TEXT_TAG_NUMBER:
+            return "number";
+        case TEXT_TAG_CODE:
+            return "code";
+        case TEXT_TAG_MULTILINE:
+            return "multiline";
+        case TEXT_TAG_LATIN:
+            return "latin";
+        case TEXT_TAG_CYRILLIC:
+            return "cyrillic";
+        case TEXT_TAG_GREEK:
+            return "greek";
+        case TEXT_TAG_ARABIC:
+            return "arabic";
+        case TEXT_TAG_HEBREW:
+            return "hebrew";
+        case TEXT_TAG_DEVANAGARI:
+            return "devanagari";
+        case TEXT_TAG_THAI:
+            return "thai";
+        case TEXT_TAG_CJK:
+            return "cjk";
+        case TEXT_TAG_HANGUL:
+            return "hangul";
+        default:
+            return nullptr;
+    }
+}
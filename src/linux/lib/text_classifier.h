@@ -0,0 +1,43 @@
+/**
+ * Text classification for selection events on Linux
+ *
+ * Tags a selection as URL, email, path, number, code or multi-line text and
+ * with the scripts of its letters, in one pass over at most the first
+ * MAX_CLASSIFY_BYTES bytes: a precompiled multi-pattern matcher (Aho-Corasick
+ * DFA) finds URL schemes and code tokens, and a UTF-8 decoder builds a
+ * character class histogram. Heuristic: meant for routing, not validation.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Only this prefix of a selection is scanned
+constexpr size_t MAX_CLASSIFY_BYTES = 64 * 1024;
+
+// Content tags (bitmask)
+constexpr uint32_t TEXT_TAG_URL = 1u << 0;        // contains an http(s)/ftp/file URL, www. host or mailto:
+constexpr uint32_t TEXT_TAG_EMAIL = 1u << 1;      // contains an email address
+constexpr uint32_t TEXT_TAG_PATH = 1u << 2;       // is a single absolute/relative/home/Windows/UNC path
+constexpr uint32_t TEXT_TAG_NUMBER = 1u << 3;     // is a single number (sign, separators, decimals, exponent, %, hex)
+constexpr uint32_t TEXT_TAG_CODE = 1u << 4;       // looks like source code
+constexpr uint32_t TEXT_TAG_MULTILINE = 1u << 5;  // spans more than one line
+
+// Script tags: set for each script with at least a quarter of the letters
+constexpr uint32_t TEXT_TAG_LATIN = 1u << 8;
+constexpr uint32_t TEXT_TAG_CYRILLIC = 1u << 9;
+constexpr uint32_t TEXT_TAG_GREEK = 1u << 10;
+constexpr uint32_t TEXT_TAG_ARABIC = 1u << 11;
+constexpr uint32_t TEXT_TAG_HEBREW = 1u << 12;
+constexpr uint32_t TEXT_TAG_DEVANAGARI = 1u << 13;
+constexpr uint32_t TEXT_TAG_THAI = 1u << 14;
+constexpr uint32_t TEXT_TAG_CJK = 1u << 15;  // Han and kana
+constexpr uint32_t TEXT_TAG_HANGUL = 1u << 16;
+
+// Classify text; returns TEXT_TAG_* bits
+uint32_t ClassifyText(const std::string &text);
+
+// Name of a single TEXT_TAG_* bit ("url", "latin", ...), nullptr for unknown bits
+const char *GetTextTagName(uint32_t tag);
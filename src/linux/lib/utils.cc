@@ -4,8 +4,19 @@
 
 #include "utils.h"
 
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <cstring>
+
+#include "../common.h"
+#include "log_ring.h"
 
 /**
  * Check if string is empty after trimming whitespace
@@ -14,3 +25,81 @@ bool IsTrimmedEmpty(const std::string &text)
 {
     return std::all_of(text.cbegin(), text.cend(), [](unsigned char c) { return std::isspace(c); });
 }
+
+/**
+ * Check if program name is in the filter list
+ */
+bool IsInFilterList(const std::string &programName, const std::vector<std::string> &filterList)
+{
+    // If filter list is empty, allow all
+    if (filterList.empty())
+    {
+        return false;
+    }
+
+    // Convert program name to lowercase for case-insensitive comparison
+    std::string lowerProgramName = programName;
+    std::transform(lowerProgramName.begin(), lowerProgramName.end(), lowerProgramName.begin(), ::tolower);
+
+    // Check if program name is in the filter list
+    for (const auto &filterItem : filterList)
+    {
+        if (lowerProgramName.find(filterItem) != std::string::npos)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Name the calling thread and apply scheduling options to it.
+ * Failures are reported but not fatal: the thread keeps its default scheduling.
+ */
+void ApplyThreadScheduling(const char *name, const ThreadSchedulingOptions *options)
+{
+    pthread_setname_np(pthread_self(), name);
+
+    if (!options)
+        return;
+
+    if (!options->cpus.empty())
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (int cpu : options->cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &cpuSet);
+        }
+
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+        if (err != 0)
+            LogMessage(LogLevel::Warn, "[SelectionHook] %s: failed to set CPU affinity: %s", name, strerror(err));
+    }
+
+    if (options->realtime)
+    {
+        // Lowest SCHED_RR priority: enough to preempt SCHED_OTHER work without
+        // competing with audio or other real-time threads
+        struct sched_param param = {};
+        param.sched_priority = sched_get_priority_min(SCHED_RR);
+
+        int err = pthread_setschedparam(pthread_self(), SCHED_RR, &param);
+        if (err == 0)
+            return;
+
+        // Not permitted (no CAP_SYS_NICE, RLIMIT_RTPRIO is 0): fall back to the nice value
+        LogMessage(LogLevel::Warn, "[SelectionHook] %s: SCHED_RR not permitted: %s", name, strerror(err));
+    }
+
+    if (options->setNice)
+    {
+        // On Linux the nice value is a per-thread attribute addressed by thread id
+        pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        if (setpriority(PRIO_PROCESS, tid, options->niceValue) != 0)
+            LogMessage(LogLevel::Warn, "[SelectionHook] %s: failed to set nice %d: %s", name, options->niceValue,
+                       strerror(errno));
+    }
+}
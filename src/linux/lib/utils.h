@@ -5,8 +5,22 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+struct ThreadSchedulingOptions;
 
 /**
  * Check if string is empty after trimming whitespace
  */
 bool IsTrimmedEmpty(const std::string &text);
+
+/**
+ * Check if program name contains any entry of a lowercased filter list (case-insensitive)
+ */
+bool IsInFilterList(const std::string &programName, const std::vector<std::string> &filterList);
+
+/**
+ * Name the calling thread (max 15 chars, shown in perf/htop) and apply scheduling
+ * options to it. options may be null to only set the name.
+ */
+void ApplyThreadScheduling(const char *name, const ThreadSchedulingOptions *options);
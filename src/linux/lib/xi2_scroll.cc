@@ -0,0 +1,61 @@
+/**
+ * XInput2 smooth-scroll aggregation for Linux X11
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "xi2_scroll.h"
+
+double ScrollValuatorNotches(ScrollValuator &valuator, double value)
+{
+    double delta = value;
+    if (valuator.absolute)
+    {
+        delta = valuator.hasLast ? value - valuator.last : 0;
+        valuator.last = value;
+        valuator.hasLast = true;
+    }
+
+    if (valuator.increment == 0)
+        return 0;
+
+    // XI2 scrolls down/right for positive values; wheel events are positive for up/right
+    double notches = delta / valuator.increment;
+    return valuator.horizontal ? notches : -notches;
+}
+
+void ScrollFrame::Add(bool horizontal, double notches, uint64_t nowMs)
+{
+    if (notches == 0)
+        return;
+
+    if (!started)
+    {
+        started = true;
+        start_ms = nowMs;
+    }
+
+    if (horizontal)
+        horizontal_sum += notches;
+    else
+        vertical_sum += notches;
+}
+
+int64_t ScrollFrame::MsUntilDue(uint64_t nowMs) const
+{
+    if (!started)
+        return -1;
+
+    uint64_t elapsed = nowMs - start_ms;
+    return elapsed >= FRAME_MS ? 0 : static_cast<int64_t>(FRAME_MS - elapsed);
+}
+
+void ScrollFrame::Take(double &vertical, double &horizontal)
+{
+    vertical = vertical_sum;
+    horizontal = horizontal_sum;
+    vertical_sum = 0;
+    horizontal_sum = 0;
+    started = false;
+}
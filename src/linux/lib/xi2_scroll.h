@@ -0,0 +1,55 @@
+/**
+ * XInput2 smooth-scroll aggregation for Linux X11
+ *
+ * Turns scroll valuator motion into wheel notches and sums it per frame, so a
+ * touchpad swipe becomes a few wheel events with fractional deltas instead of
+ * dozens of emulated button 4-7 clicks. Pure logic without a Display
+ * connection, fed by the XI2 thread (protocols/x11.cc).
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// Scroll valuator of a slave pointer (XIScrollClassInfo + the mode of its XIValuatorClassInfo)
+struct ScrollValuator
+{
+    int number = -1;          ///< Valuator index
+    bool horizontal = false;  ///< XIScrollTypeHorizontal
+    double increment = 0;     ///< Valuator distance of one wheel notch; negative when inverted
+    bool absolute = false;    ///< Reports positions (XIModeAbsolute) rather than deltas
+    double last = 0;          ///< Previous position of an absolute valuator
+    bool hasLast = false;
+};
+
+/**
+ * Wheel notches for a valuator value, signed like MouseEventContext::flag
+ * (positive = up/right). An absolute valuator is converted to a delta from its
+ * previous value; its first value yields 0.
+ */
+double ScrollValuatorNotches(ScrollValuator &valuator, double value);
+
+// Wheel notches summed over one frame
+class ScrollFrame
+{
+  public:
+    static constexpr uint64_t FRAME_MS = 16;
+
+    // Add notches to the frame; the first addition starts it
+    void Add(bool horizontal, double notches, uint64_t nowMs);
+
+    // ms until the frame is due (0 = due now), or -1 when no frame is started
+    int64_t MsUntilDue(uint64_t nowMs) const;
+
+    // End the frame and take its sums
+    void Take(double &vertical, double &horizontal);
+
+  private:
+    double vertical_sum = 0;
+    double horizontal_sum = 0;
+    uint64_t start_ms = 0;
+    bool started = false;
+};
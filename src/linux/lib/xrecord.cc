@@ -0,0 +1,202 @@
+/**
+ * XRecord payload decoding for Linux X11
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#include "xrecord.h"
+
+#include <X11/X.h>
+
+#include <cstring>
+
+// Undefine X11 None macro that conflicts with our enum
+#ifdef None
+#undef None
+#endif
+
+#include "../common.h"
+
+bool DecodeXRecordInputEvent(const unsigned char *data, size_t length, XRecordInputEvent &event)
+{
+    if (!data || length < X11_EVENT_SIZE)
+        return false;
+
+    // Event type in the first byte, without the send_event bit
+    int type = data[0] & 0x7f;
+    switch (type)
+    {
+        case KeyPress:
+        case KeyRelease:
+        case ButtonPress:
+        case ButtonRelease:
+        case MotionNotify:
+            event.type = type;
+            event.detail = data[1];
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool DecodeXTestFakeInput(const unsigned char *data, size_t length, int xtestOpcode, XTestFakeInput &input)
+{
+    // reqType, xtReqType, length, type, detail, pad, time (delay in ms), ...
+    if (!data || length < XTEST_FAKE_INPUT_SIZE || data[0] != xtestOpcode || data[1] != XTEST_FAKE_INPUT_MINOR)
+        return false;
+
+    int type = data[4];
+    if (type < KeyPress || type > MotionNotify)
+        return false;
+
+    uint32_t delay;
+    memcpy(&delay, data + 8, sizeof(delay));
+
+    input.type = type;
+    input.detail = data[5];
+    input.delayMs = delay;
+    return true;
+}
+
+void SyntheticInputTracker::Add(const XTestFakeInput &input, uint64_t nowMs)
+{
+    if (count == CAPACITY)
+        Remove(0);
+
+    pending[count].type = input.type;
+    pending[count].detail = input.detail;
+    pending[count].expiryMs = nowMs + input.delayMs + MAX_AGE_MS;
+    count++;
+}
+
+void SyntheticInputTracker::SetButtonMap(const unsigned char *map, size_t size)
+{
+    button_map_size = size < sizeof(button_map) ? size : sizeof(button_map);
+    if (button_map_size > 0)
+        memcpy(button_map, map, button_map_size);
+}
+
+bool SyntheticInputTracker::Matches(const Pending &entry, const XRecordInputEvent &event) const
+{
+    if (entry.type != event.type)
+        return false;
+
+    switch (event.type)
+    {
+        case KeyPress:
+        case KeyRelease:
+            return entry.detail == event.detail;
+        case ButtonPress:
+        case ButtonRelease:
+            // The request names the physical button; the recorded event may carry the mapped one
+            if (entry.detail == event.detail)
+                return true;
+            return entry.detail >= 1 && entry.detail <= button_map_size && button_map[entry.detail - 1] == event.detail;
+        default:
+            return true;
+    }
+}
+
+bool SyntheticInputTracker::Consume(const XRecordInputEvent &event, uint64_t nowMs)
+{
+    size_t i = 0;
+    while (i < count)
+    {
+        const Pending &entry = pending[i];
+        if (entry.expiryMs < nowMs)
+        {
+            Remove(i);
+            continue;
+        }
+
+        if (Matches(entry, event))
+        {
+            Remove(i);
+            return true;
+        }
+        i++;
+    }
+    return false;
+}
+
+void SyntheticInputTracker::Remove(size_t index)
+{
+    for (size_t i = index + 1; i < count; i++)
+        pending[i - 1] = pending[i];
+    count--;
+}
+
+void MapX11ButtonToMouseEvent(unsigned char button, bool press, MouseEventContext &mouseEvent)
+{
+    mouseEvent.value = press ? 1 : 0;
+
+    // Map X11 button numbers to Linux input event codes
+    switch (button)
+    {
+        case 1:  // Left button
+            mouseEvent.type = EV_KEY;
+            mouseEvent.code = BTN_LEFT;
+            mouseEvent.button = static_cast<int>(MouseButton::Left);
+            mouseEvent.flag = 0;
+            break;
+        case 2:  // Middle button
+            mouseEvent.type = EV_KEY;
+            mouseEvent.code = BTN_MIDDLE;
+            mouseEvent.button = static_cast<int>(MouseButton::Middle);
+            mouseEvent.flag = 0;
+            break;
+        case 3:  // Right button
+            mouseEvent.type = EV_KEY;
+            mouseEvent.code = BTN_RIGHT;
+            mouseEvent.button = static_cast<int>(MouseButton::Right);
+            mouseEvent.flag = 0;
+            break;
+        case 4:  // Wheel up
+            mouseEvent.type = EV_REL;
+            mouseEvent.code = REL_WHEEL;
+            mouseEvent.value = 1;
+            mouseEvent.button = static_cast<int>(MouseButton::WheelVertical);
+            mouseEvent.flag = 1;
+            break;
+        case 5:  // Wheel down
+            mouseEvent.type = EV_REL;
+            mouseEvent.code = REL_WHEEL;
+            mouseEvent.value = -1;
+            mouseEvent.button = static_cast<int>(MouseButton::WheelVertical);
+            mouseEvent.flag = -1;
+            break;
+        case 6:  // Wheel left
+            mouseEvent.type = EV_REL;
+            mouseEvent.code = REL_HWHEEL;
+            mouseEvent.value = -1;
+            mouseEvent.button = static_cast<int>(MouseButton::WheelHorizontal);
+            mouseEvent.flag = -1;
+            break;
+        case 7:  // Wheel right
+            mouseEvent.type = EV_REL;
+            mouseEvent.code = REL_HWHEEL;
+            mouseEvent.value = 1;
+            mouseEvent.button = static_cast<int>(MouseButton::WheelHorizontal);
+            mouseEvent.flag = 1;
+            break;
+        case 8:  // Back button
+            mouseEvent.type = EV_KEY;
+            mouseEvent.code = BTN_BACK;
+            mouseEvent.button = static_cast<int>(MouseButton::Back);
+            mouseEvent.flag = 0;
+            break;
+        case 9:  // Forward button
+            mouseEvent.type = EV_KEY;
+            mouseEvent.code = BTN_FORWARD;
+            mouseEvent.button = static_cast<int>(MouseButton::Forward);
+            mouseEvent.flag = 0;
+            break;
+        default:
+            mouseEvent.type = EV_KEY;
+            mouseEvent.code = button;
+            mouseEvent.button = static_cast<int>(MouseButton::Unknown);
+            mouseEvent.flag = 0;
+            break;
+    }
+}
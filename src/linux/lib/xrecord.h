@@ -0,0 +1,118 @@
+/**
+ * XRecord payload decoding for Linux X11
+ *
+ * Turns the raw core protocol events delivered by XRecord into input event
+ * contexts. Pure functions without a Display connection, shared by the XRecord
+ * thread (protocols/x11.cc) and the native microbenchmarks.
+ *
+ * Copyright (c) 2025 0xfullex (https://github.com/0xfullex/selection-hook)
+ * Licensed under the MIT License
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct MouseEventContext;
+
+// Size of a core X protocol event
+constexpr size_t X11_EVENT_SIZE = 32;
+
+// XTestFakeInput request: minor opcode (X_XTestFakeInput) and size (xXTestFakeInputReq)
+constexpr int XTEST_FAKE_INPUT_MINOR = 2;
+constexpr size_t XTEST_FAKE_INPUT_SIZE = 36;
+
+// Input event decoded from an XRecordFromServer payload
+struct XRecordInputEvent
+{
+    int type = 0;              ///< KeyPress, KeyRelease, ButtonPress, ButtonRelease or MotionNotify
+    unsigned char detail = 0;  ///< X11 keycode (key events) or button number (button events)
+};
+
+/**
+ * Decode a server-to-client payload captured by XRecord.
+ * @param data Raw event bytes
+ * @param length Payload length in bytes (XRecordInterceptData::data_len * 4)
+ * @return false if the payload is not a core input event
+ */
+bool DecodeXRecordInputEvent(const unsigned char *data, size_t length, XRecordInputEvent &event);
+
+// XTestFakeInput request decoded from an XRecordFromClient payload
+struct XTestFakeInput
+{
+    int type = 0;              ///< KeyPress, KeyRelease, ButtonPress, ButtonRelease or MotionNotify
+    unsigned char detail = 0;  ///< X11 keycode or physical button number
+    uint32_t delayMs = 0;      ///< Delay before the server generates the event
+};
+
+/**
+ * Decode a client-to-server payload captured by XRecord.
+ * @param xtestOpcode Major opcode of the XTEST extension
+ * @return false if the payload is not an XTestFakeInput request
+ */
+bool DecodeXTestFakeInput(const unsigned char *data, size_t length, int xtestOpcode, XTestFakeInput &input);
+
+/**
+ * Pending XTestFakeInput requests, matched against the device events recorded
+ * after them so that synthetic input can be told apart from real input. The
+ * server executes a request before recording the event it generates, in the
+ * same XRecord stream. Keys match by keycode, buttons by the physical button
+ * of the request or the logical button it maps to, motion by type only.
+ * Requests whose event never comes (e.g. a press of a button already down, or
+ * a grab) expire after MAX_AGE_MS past their delay; until then they may still
+ * consume a real event of the same key or button, or any real motion.
+ */
+class SyntheticInputTracker
+{
+  public:
+    static constexpr size_t CAPACITY = 32;
+    static constexpr uint64_t MAX_AGE_MS = 100;
+
+    // Record a request; the oldest one is dropped when full
+    void Add(const XTestFakeInput &input, uint64_t nowMs);
+
+    // Whether the event was generated by a pending request, which is then consumed
+    bool Consume(const XRecordInputEvent &event, uint64_t nowMs);
+
+    // Core pointer mapping (logical button by physical button - 1) applied to requested buttons
+    void SetButtonMap(const unsigned char *map, size_t size);
+
+    void Clear() { count = 0; }
+    size_t Size() const { return count; }
+
+  private:
+    struct Pending
+    {
+        int type;
+        unsigned char detail;
+        uint64_t expiryMs;
+    };
+
+    bool Matches(const Pending &entry, const XRecordInputEvent &event) const;
+    void Remove(size_t index);
+
+    Pending pending[CAPACITY];  // oldest first
+    size_t count = 0;
+
+    unsigned char button_map[256];
+    size_t button_map_size = 0;
+};
+
+/**
+ * Map an X11 button number to Linux input codes (BTN_*, REL_WHEEL/REL_HWHEEL).
+ * Fills type, code, value, button and flag; the position is left to the caller.
+ */
+void MapX11ButtonToMouseEvent(unsigned char button, bool press, MouseEventContext &mouseEvent);
+
+// Buttons 4-7 are wheel notches: one per press, the release carries nothing
+inline bool IsX11WheelButton(unsigned char button)
+{
+    return button >= 4 && button <= 7;
+}
+
+// X11 keycodes are Linux KEY_* codes offset by 8 (evdev keymap)
+inline unsigned int X11KeycodeToLinux(unsigned char x11Keycode)
+{
+    return (x11Keycode >= 8) ? (x11Keycode - 8) : x11Keycode;
+}
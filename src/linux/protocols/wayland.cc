@@ -5,15 +5,19 @@
  * clipboard operations, and window management.
  *
  * Uses ext-data-control-v1 (preferred) or wlr-data-control-unstable-v1 v2+
- * (fallback) protocol for PRIMARY selection monitoring.
+ * (fallback) protocol for PRIMARY selection monitoring, and
+ * wlr-foreign-toplevel-management-unstable-v1 or ext-foreign-toplevel-list-v1
+ * for the focused app's app_id where the compositor offers them.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <climits>
 #include <cmath>
 #include <condition_variable>
 #include <cstring>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -35,7 +39,9 @@
 
 // Data control protocol headers (pre-generated)
 #include "wayland/ext-data-control-v1-client.h"
+#include "wayland/ext-foreign-toplevel-list-v1-client.h"
 #include "wayland/wlr-data-control-unstable-v1-client.h"
+#include "wayland/wlr-foreign-toplevel-management-unstable-v1-client.h"
 
 // X11 headers for XWayland cursor position fallback
 #include <X11/Xlib.h>
@@ -58,6 +64,10 @@
 
 // Include common definitions
 #include "../common.h"
+#include "../lib/dbus_abi.h"
+#include "../lib/input_devices.h"
+#include "../lib/log_ring.h"
+#include "../lib/utils.h"
 
 // Input device structure for libevdev
 struct InputDevice
@@ -77,31 +87,6 @@ enum class DataControlType
     Wlr
 };
 
-// DBus ABI-stable types for dlopen-based KDE cursor position query
-// These match the libdbus-1 public ABI and are safe to use with dlsym'd functions
-struct DBusError_ABI
-{
-    const char *name;
-    const char *message;
-    unsigned int dummy1 : 1;
-    unsigned int dummy2 : 1;
-    unsigned int dummy3 : 1;
-    unsigned int dummy4 : 1;
-    unsigned int dummy5 : 1;
-    void *padding1;
-};
-
-struct DBusMessageIter_ABI
-{
-    void *dummy1;
-    void *dummy2;
-    uint32_t dummy3;
-    int dummy4, dummy5, dummy6, dummy7, dummy8, dummy9, dummy10, dummy11;
-    int pad1;
-    void *pad2;
-    void *pad3;
-};
-
 // DBus function pointers (loaded via dlopen at runtime to avoid build dependency)
 struct DBusFunctions
 {
@@ -174,6 +159,37 @@ class WaylandProtocol : public ProtocolBase
     struct ext_data_control_device_v1 *ext_dc_device;
     struct zwlr_data_control_device_v1 *wlr_dc_device;
 
+    // Foreign-toplevel tracking for the focused app (wlroots, COSMIC).
+    // zwlr-foreign-toplevel-management reports the activated state; ext-foreign-toplevel-list
+    // (bound only without it) reports app_ids only. Events update the table on the monitoring
+    // thread, GetActiveWindow()/GetProgramNameFromWindow() read it under toplevel_mutex.
+    struct Toplevel
+    {
+        void *handle;  // zwlr_foreign_toplevel_handle_v1 (wlr) or ext_foreign_toplevel_handle_v1
+        bool wlr;
+        uint64_t id;
+        std::string app_id;
+        bool fullscreen = false;
+        // Double-buffered until the done event
+        std::string pending_app_id;
+        bool pending_activated = false;
+        bool pending_fullscreen = false;
+    };
+    struct zwlr_foreign_toplevel_manager_v1 *wlr_toplevel_manager = nullptr;
+    struct ext_foreign_toplevel_list_v1 *ext_toplevel_list = nullptr;
+    uint32_t ext_toplevel_list_name = 0;  // Registry name, bound after the roundtrip if wlr is missing
+    std::mutex toplevel_mutex;
+    std::vector<Toplevel> toplevels;
+    bool toplevel_activation = false;  // Whether the bound protocol reports the activated state
+    uint64_t active_toplevel = 0;
+    uint64_t next_toplevel_id = 2;  // 1 is the "window unknown" sentinel
+
+    // Fullscreen tracking from the activated toplevel's state (wlr only); only changes are reported
+    FullscreenEventCallback fullscreen_callback = nullptr;
+    void *fullscreen_context = nullptr;
+    bool fullscreen_reported = false;
+    std::string fullscreen_app_id;
+
     // Current PRIMARY selection offer (mutex protected)
     std::mutex primary_offer_mutex;
     struct ext_data_control_offer_v1 *current_ext_offer;
@@ -204,11 +220,22 @@ class WaylandProtocol : public ProtocolBase
     // Environment info (set by top-level detection via SetEnvInfo)
     LinuxEnvInfo env_info;
 
+    // Scheduling applied by the input and Wayland monitoring threads at startup
+    ThreadSchedulingOptions thread_scheduling;
+
+    // Devices to monitor, applied by InitializeInputDevices()
+    InputDeviceFilter input_device_filter;
+
     // XWayland fallback for cursor position
     Display *xwayland_display = nullptr;
     bool xwayland_tried = false;
     double xwayland_scale = 1.0;  // Scale factor for converting compositor IPC logical coords to X11 screen coords
 
+    // Hybrid mode (no data-control, e.g. GNOME): PRIMARY owner changes and reads go through
+    // XFixes on XWayland's DISPLAY, input still comes from libevdev
+    std::unique_ptr<ProtocolBase> xwayland_selection;
+    bool xwayland_selection_monitoring = false;
+
     // KDE DBus for cursor position (dlopen'd libdbus-1.so.3)
     DBusFunctions dbus_fn;
     bool dbus_tried = false;
@@ -232,7 +259,6 @@ class WaylandProtocol : public ProtocolBase
     // libevdev helper methods
     bool InitializeInputDevices();
     void CleanupInputDevices();
-    bool IsInputDevice(const std::string &device_path);
     bool SetupInputDevice(const std::string &device_path);
     void ProcessLibevdevEvent(const struct input_event &ev, const InputDevice &device);
     void InputMonitoringThreadProc();
@@ -245,6 +271,9 @@ class WaylandProtocol : public ProtocolBase
     // MIME type matching helper
     static bool IsTextMimeType(const char *mime_type);
 
+    // XWayland selection bridge
+    bool InitializeXWaylandSelection();
+
     // Cursor position methods
     void EnsureXWaylandInitialized();
     bool GetCursorPositionHyprland(Point &pos);
@@ -255,6 +284,13 @@ class WaylandProtocol : public ProtocolBase
     // Handle primary selection change (common for both protocols)
     void HandlePrimarySelectionChange();
 
+    // Foreign-toplevel helpers (caller holds toplevel_mutex)
+    Toplevel *FindToplevel(void *handle);
+    void AddToplevel(void *handle, bool wlr);
+    void RemoveToplevel(void *handle);
+    // Report a change of the activated toplevel's fullscreen state (takes toplevel_mutex)
+    void UpdateFullscreenState();
+
   public:
     // Static callbacks (public for listener table access)
     // Registry callbacks
@@ -286,6 +322,33 @@ class WaylandProtocol : public ProtocolBase
     // wlr-data-control offer callbacks
     static void WlrOfferOffer(void *data, struct zwlr_data_control_offer_v1 *offer, const char *mime_type);
 
+    // wlr-foreign-toplevel-management callbacks
+    static void WlrToplevelManagerToplevel(void *data, struct zwlr_foreign_toplevel_manager_v1 *manager,
+                                           struct zwlr_foreign_toplevel_handle_v1 *handle);
+    static void WlrToplevelManagerFinished(void *data, struct zwlr_foreign_toplevel_manager_v1 *manager);
+    static void WlrToplevelTitle(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle, const char *title);
+    static void WlrToplevelAppId(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle, const char *app_id);
+    static void WlrToplevelOutputEnter(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle,
+                                       struct wl_output *output);
+    static void WlrToplevelOutputLeave(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle,
+                                       struct wl_output *output);
+    static void WlrToplevelState(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle, struct wl_array *state);
+    static void WlrToplevelDone(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle);
+    static void WlrToplevelClosed(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle);
+    static void WlrToplevelParent(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle,
+                                  struct zwlr_foreign_toplevel_handle_v1 *parent);
+
+    // ext-foreign-toplevel-list callbacks
+    static void ExtToplevelListToplevel(void *data, struct ext_foreign_toplevel_list_v1 *list,
+                                        struct ext_foreign_toplevel_handle_v1 *handle);
+    static void ExtToplevelListFinished(void *data, struct ext_foreign_toplevel_list_v1 *list);
+    static void ExtToplevelClosed(void *data, struct ext_foreign_toplevel_handle_v1 *handle);
+    static void ExtToplevelDone(void *data, struct ext_foreign_toplevel_handle_v1 *handle);
+    static void ExtToplevelTitle(void *data, struct ext_foreign_toplevel_handle_v1 *handle, const char *title);
+    static void ExtToplevelAppId(void *data, struct ext_foreign_toplevel_handle_v1 *handle, const char *app_id);
+    static void ExtToplevelIdentifier(void *data, struct ext_foreign_toplevel_handle_v1 *handle,
+                                      const char *identifier);
+
     WaylandProtocol()
         : initialized(false),
           epoll_fd(-1),
@@ -324,6 +387,22 @@ class WaylandProtocol : public ProtocolBase
     // Set environment info from top-level detection
     void SetEnvInfo(const LinuxEnvInfo &info) override { env_info = info; }
 
+    void SetThreadScheduling(const ThreadSchedulingOptions &options) override
+    {
+        thread_scheduling = options;
+        if (xwayland_selection)
+            xwayland_selection->SetThreadScheduling(options);
+    }
+
+    void SetInputDeviceFilter(const InputDeviceFilter &filter) override { input_device_filter = filter; }
+
+    void SetPrimaryReadCancel(const std::atomic<bool> *cancel) override
+    {
+        ProtocolBase::SetPrimaryReadCancel(cancel);
+        if (xwayland_selection)
+            xwayland_selection->SetPrimaryReadCancel(cancel);
+    }
+
     // Get accurate cursor position from compositor
     Point GetCurrentMousePosition() override;
 
@@ -332,11 +411,11 @@ class WaylandProtocol : public ProtocolBase
     {
         initialized = true;
 
-        if (!InitializeWaylandConnection())
+        if (!InitializeWaylandConnection() && !InitializeXWaylandSelection())
         {
-            fprintf(stderr,
-                    "[Wayland] WARNING: Failed to initialize Wayland connection. "
-                    "Selection monitoring will not be available.\n");
+            LogMessage(LogLevel::Warn,
+                       "[Wayland] Failed to initialize Wayland connection. "
+                       "Selection monitoring will not be available.");
             // Don't fail - input monitoring via libevdev can still work
         }
 
@@ -352,6 +431,13 @@ class WaylandProtocol : public ProtocolBase
         // Cleanup Wayland resources
         CleanupWaylandConnection();
 
+        // Cleanup XWayland selection bridge
+        if (xwayland_selection)
+        {
+            xwayland_selection->Cleanup();
+            xwayland_selection.reset();
+        }
+
         // Cleanup XWayland connection
         if (xwayland_display)
         {
@@ -399,7 +485,17 @@ class WaylandProtocol : public ProtocolBase
         if (!initialized)
             return 0;
 
-        // Wayland security model does not expose window information.
+        // The focused toplevel, when a foreign-toplevel protocol tells it (wlroots, COSMIC)
+        {
+            std::lock_guard<std::mutex> lock(toplevel_mutex);
+            if (active_toplevel)
+                return active_toplevel;
+            // ext-foreign-toplevel-list has no activated state: only a lone toplevel is known to be focused
+            if (!toplevel_activation && toplevels.size() == 1)
+                return toplevels[0].id;
+        }
+
+        // Otherwise the window is unknown (GNOME, KDE, or no toplevel focused).
         // Return a sentinel value to avoid checks in selection_hook.cc blocking events.
         return 1;
     }
@@ -415,13 +511,45 @@ class WaylandProtocol : public ProtocolBase
         if (!initialized || !window)
             return false;
 
-        // Wayland security model does not expose program names
+        // The toplevel's app_id; the sentinel and closed toplevels have none
+        std::lock_guard<std::mutex> lock(toplevel_mutex);
+        for (const auto &toplevel : toplevels)
+        {
+            if (toplevel.id == window)
+            {
+                programName = toplevel.app_id;
+                return !programName.empty();
+            }
+        }
         return false;
     }
 
     // Text selection
     bool GetTextViaPrimary(std::string &text) override;
 
+    // The current offer advertises a text MIME type. Offers carry no size, so
+    // GetPrimarySelectionLength() keeps the default (reads the text) unless the
+    // XWayland selection bridge answers.
+    bool HasPrimarySelection() override
+    {
+        if (xwayland_selection)
+            return xwayland_selection->HasPrimarySelection();
+
+        if (!initialized || dc_type == DataControlType::None)
+            return false;
+
+        std::lock_guard<std::mutex> lock(primary_offer_mutex);
+        return has_text_mime && (current_ext_offer || current_wlr_offer);
+    }
+
+    bool GetPrimarySelectionLength(size_t &length) override
+    {
+        if (xwayland_selection)
+            return xwayland_selection->GetPrimarySelectionLength(length);
+
+        return ProtocolBase::GetPrimarySelectionLength(length);
+    }
+
     // Clipboard operations
     bool WriteClipboard(const std::string &text) override
     {
@@ -457,14 +585,26 @@ class WaylandProtocol : public ProtocolBase
         {
             if (!InitializeInputDevices())
             {
-                fprintf(stderr,
-                        "[Wayland] WARNING: Failed to initialize input devices. "
-                        "Mouse/keyboard events will not be available.\n");
+                LogMessage(LogLevel::Warn,
+                           "[Wayland] Failed to initialize input devices. "
+                           "Mouse/keyboard events will not be available.");
+            }
+        }
+
+        if (xwayland_selection)
+        {
+            xwayland_selection_monitoring =
+                xwayland_selection->InitializeInputMonitoring(nullptr, nullptr, selectionCb, context);
+            if (!xwayland_selection_monitoring)
+            {
+                LogMessage(LogLevel::Warn,
+                           "[Wayland] XWayland: Failed to initialize XFixes. "
+                           "Selection change detection will not work.");
             }
         }
 
-        // Succeed if we have either input devices or data-control protocol
-        return (!input_devices.empty()) || (dc_type != DataControlType::None);
+        // Succeed if we have input devices, data-control protocol or the XWayland selection bridge
+        return (!input_devices.empty()) || (dc_type != DataControlType::None) || xwayland_selection_monitoring;
     }
 
     void CleanupInputMonitoring() override
@@ -473,6 +613,9 @@ class WaylandProtocol : public ProtocolBase
         StopInputMonitoring();
 
         CleanupInputDevices();
+        if (xwayland_selection)
+            xwayland_selection->CleanupInputMonitoring();
+        xwayland_selection_monitoring = false;
         mouse_callback = nullptr;
         keyboard_callback = nullptr;
         selection_callback = nullptr;
@@ -498,11 +641,61 @@ class WaylandProtocol : public ProtocolBase
             wayland_monitoring_thread = std::thread(&WaylandProtocol::WaylandMonitoringThreadProc, this);
         }
 
-        return input_monitoring_running || wayland_monitoring_running;
+        // Start XFixes monitoring on XWayland in hybrid mode
+        bool xwayland_started = xwayland_selection_monitoring && xwayland_selection->StartInputMonitoring();
+
+        return input_monitoring_running || wayland_monitoring_running || xwayland_started;
+    }
+
+    // Fullscreen state from wlr-foreign-toplevel-management, or from _NET_WM_STATE of XWayland
+    // windows in hybrid mode
+    bool SetFullscreenCallback(FullscreenEventCallback callback, void *context) override
+    {
+        if (xwayland_selection)
+            return xwayland_selection->SetFullscreenCallback(callback, context);
+
+        bool tracked;
+        {
+            std::lock_guard<std::mutex> lock(toplevel_mutex);
+            fullscreen_callback = callback;
+            fullscreen_context = context;
+            fullscreen_reported = false;
+            fullscreen_app_id.clear();
+            tracked = toplevel_activation;
+        }
+
+        // The table is current up to the last dispatch: report a focused fullscreen toplevel now
+        if (callback && tracked)
+            UpdateFullscreenState();
+        return tracked;
+    }
+
+    // In-loop selection events are only available through the XWayland selection bridge
+    bool SetSelectionEventsInLoop(bool inLoop) override
+    {
+        if (xwayland_selection_monitoring)
+            return xwayland_selection->SetSelectionEventsInLoop(inLoop);
+
+        return !inLoop;
+    }
+
+    int GetSelectionEventFd() override
+    {
+        return xwayland_selection_monitoring ? xwayland_selection->GetSelectionEventFd() : -1;
+    }
+
+    void DispatchSelectionEvents() override
+    {
+        if (xwayland_selection_monitoring)
+            xwayland_selection->DispatchSelectionEvents();
     }
 
     void StopInputMonitoring() override
     {
+        // Stop XFixes monitoring on XWayland
+        if (xwayland_selection)
+            xwayland_selection->StopInputMonitoring();
+
         // Stop Wayland monitoring thread
         wayland_monitoring_running = false;
         // Wake up any pending read request
@@ -557,6 +750,27 @@ static const struct zwlr_data_control_offer_v1_listener wlr_offer_listener = {
     WaylandProtocol::WlrOfferOffer,
 };
 
+static const struct zwlr_foreign_toplevel_manager_v1_listener wlr_toplevel_manager_listener = {
+    WaylandProtocol::WlrToplevelManagerToplevel,
+    WaylandProtocol::WlrToplevelManagerFinished,
+};
+
+static const struct zwlr_foreign_toplevel_handle_v1_listener wlr_toplevel_listener = {
+    WaylandProtocol::WlrToplevelTitle,       WaylandProtocol::WlrToplevelAppId, WaylandProtocol::WlrToplevelOutputEnter,
+    WaylandProtocol::WlrToplevelOutputLeave, WaylandProtocol::WlrToplevelState, WaylandProtocol::WlrToplevelDone,
+    WaylandProtocol::WlrToplevelClosed,      WaylandProtocol::WlrToplevelParent,
+};
+
+static const struct ext_foreign_toplevel_list_v1_listener ext_toplevel_list_listener = {
+    WaylandProtocol::ExtToplevelListToplevel,
+    WaylandProtocol::ExtToplevelListFinished,
+};
+
+static const struct ext_foreign_toplevel_handle_v1_listener ext_toplevel_listener = {
+    WaylandProtocol::ExtToplevelClosed,  WaylandProtocol::ExtToplevelDone,       WaylandProtocol::ExtToplevelTitle,
+    WaylandProtocol::ExtToplevelAppId,   WaylandProtocol::ExtToplevelIdentifier,
+};
+
 bool WaylandProtocol::IsTextMimeType(const char *mime_type)
 {
     return (strcmp(mime_type, "text/plain;charset=utf-8") == 0 || strcmp(mime_type, "text/plain") == 0 ||
@@ -568,14 +782,14 @@ bool WaylandProtocol::InitializeWaylandConnection()
     wl_display_monitor = wl_display_connect(nullptr);
     if (!wl_display_monitor)
     {
-        fprintf(stderr, "[Wayland] Failed to connect to Wayland display\n");
+        LogMessage(LogLevel::Error, "[Wayland] Failed to connect to Wayland display");
         return false;
     }
 
     wl_registry_monitor = wl_display_get_registry(wl_display_monitor);
     if (!wl_registry_monitor)
     {
-        fprintf(stderr, "[Wayland] Failed to get registry\n");
+        LogMessage(LogLevel::Error, "[Wayland] Failed to get registry");
         wl_display_disconnect(wl_display_monitor);
         wl_display_monitor = nullptr;
         return false;
@@ -588,21 +802,32 @@ bool WaylandProtocol::InitializeWaylandConnection()
 
     if (!wl_seat_monitor)
     {
-        fprintf(stderr, "[Wayland] WARNING: No wl_seat found\n");
+        LogMessage(LogLevel::Warn, "[Wayland] No wl_seat found");
         CleanupWaylandConnection();
         return false;
     }
 
     if (dc_type == DataControlType::None)
     {
-        fprintf(stderr,
-                "[Wayland] WARNING: No data-control protocol available "
-                "(ext-data-control-v1 or wlr-data-control-unstable-v1 v2+). "
-                "Selection monitoring will not work.\n");
+        LogMessage(LogLevel::Warn,
+                   "[Wayland] No data-control protocol available "
+                   "(ext-data-control-v1 or wlr-data-control-unstable-v1 v2+). "
+                   "Selection monitoring will not work.");
         CleanupWaylandConnection();
         return false;
     }
 
+    // Focused-app tracking: ext-foreign-toplevel-list only when wlr-foreign-toplevel-management is missing
+    if (!wlr_toplevel_manager && ext_toplevel_list_name)
+    {
+        ext_toplevel_list = static_cast<struct ext_foreign_toplevel_list_v1 *>(
+            wl_registry_bind(wl_registry_monitor, ext_toplevel_list_name, &ext_foreign_toplevel_list_v1_interface, 1));
+        if (ext_toplevel_list)
+            ext_foreign_toplevel_list_v1_add_listener(ext_toplevel_list, &ext_toplevel_list_listener, this);
+    }
+    if (!wlr_toplevel_manager && !ext_toplevel_list)
+        LogMessage(LogLevel::Info, "[Wayland] No foreign-toplevel protocol, program names will not be available");
+
     // Create data device for the seat
     if (dc_type == DataControlType::Ext)
     {
@@ -621,7 +846,7 @@ bool WaylandProtocol::InitializeWaylandConnection()
         }
     }
 
-    // Roundtrip to receive initial selection events
+    // Roundtrip to receive initial selection events and toplevels
     wl_display_roundtrip(wl_display_monitor);
 
     return true;
@@ -671,6 +896,34 @@ void WaylandProtocol::CleanupWaylandConnection()
         pending_offer = nullptr;
     }
 
+    // Destroy toplevel handles before their manager
+    {
+        std::lock_guard<std::mutex> lock(toplevel_mutex);
+        for (auto &toplevel : toplevels)
+        {
+            if (toplevel.wlr)
+                zwlr_foreign_toplevel_handle_v1_destroy((struct zwlr_foreign_toplevel_handle_v1 *)toplevel.handle);
+            else
+                ext_foreign_toplevel_handle_v1_destroy((struct ext_foreign_toplevel_handle_v1 *)toplevel.handle);
+        }
+        toplevels.clear();
+        active_toplevel = 0;
+        toplevel_activation = false;
+    }
+    if (wlr_toplevel_manager)
+    {
+        zwlr_foreign_toplevel_manager_v1_stop(wlr_toplevel_manager);
+        zwlr_foreign_toplevel_manager_v1_destroy(wlr_toplevel_manager);
+        wlr_toplevel_manager = nullptr;
+    }
+    if (ext_toplevel_list)
+    {
+        ext_foreign_toplevel_list_v1_stop(ext_toplevel_list);
+        ext_foreign_toplevel_list_v1_destroy(ext_toplevel_list);
+        ext_toplevel_list = nullptr;
+    }
+    ext_toplevel_list_name = 0;
+
     // Destroy managers
     if (ext_dc_manager)
     {
@@ -740,6 +993,24 @@ void WaylandProtocol::RegistryGlobal(void *data, struct wl_registry *registry, u
             self->dc_type = DataControlType::Wlr;
         }
     }
+    else if (strcmp(interface, "zwlr_foreign_toplevel_manager_v1") == 0)
+    {
+        // Preferred for focused-app tracking: reports the activated state
+        if (!self->wlr_toplevel_manager)
+        {
+            self->wlr_toplevel_manager = static_cast<struct zwlr_foreign_toplevel_manager_v1 *>(
+                wl_registry_bind(registry, name, &zwlr_foreign_toplevel_manager_v1_interface, std::min(version, 3u)));
+            zwlr_foreign_toplevel_manager_v1_add_listener(self->wlr_toplevel_manager, &wlr_toplevel_manager_listener,
+                                                          self);
+            std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+            self->toplevel_activation = true;
+        }
+    }
+    else if (strcmp(interface, "ext_foreign_toplevel_list_v1") == 0)
+    {
+        // Bound after the roundtrip, only if wlr-foreign-toplevel-management is missing
+        self->ext_toplevel_list_name = name;
+    }
 }
 
 void WaylandProtocol::RegistryGlobalRemove(void *data, struct wl_registry *registry, uint32_t name)
@@ -965,6 +1236,252 @@ void WaylandProtocol::WlrOfferOffer(void *data, struct zwlr_data_control_offer_v
     }
 }
 
+// ============================================================================
+// Foreign-toplevel tracking (focused app)
+// ============================================================================
+
+WaylandProtocol::Toplevel *WaylandProtocol::FindToplevel(void *handle)
+{
+    for (auto &toplevel : toplevels)
+    {
+        if (toplevel.handle == handle)
+            return &toplevel;
+    }
+    return nullptr;
+}
+
+void WaylandProtocol::AddToplevel(void *handle, bool wlr)
+{
+    Toplevel toplevel;
+    toplevel.handle = handle;
+    toplevel.wlr = wlr;
+    toplevel.id = next_toplevel_id++;
+    toplevels.push_back(std::move(toplevel));
+}
+
+void WaylandProtocol::RemoveToplevel(void *handle)
+{
+    for (auto it = toplevels.begin(); it != toplevels.end(); ++it)
+    {
+        if (it->handle == handle)
+        {
+            if (active_toplevel == it->id)
+                active_toplevel = 0;
+            toplevels.erase(it);
+            return;
+        }
+    }
+}
+
+void WaylandProtocol::UpdateFullscreenState()
+{
+    FullscreenEventCallback callback;
+    void *context;
+    bool fullscreen = false;
+    std::string app_id;
+    {
+        std::lock_guard<std::mutex> lock(toplevel_mutex);
+        if (!fullscreen_callback)
+            return;
+
+        for (const auto &toplevel : toplevels)
+        {
+            if (toplevel.id == active_toplevel && toplevel.fullscreen)
+            {
+                fullscreen = true;
+                app_id = toplevel.app_id;
+                break;
+            }
+        }
+
+        if (fullscreen == fullscreen_reported && app_id == fullscreen_app_id)
+            return;
+
+        fullscreen_reported = fullscreen;
+        fullscreen_app_id = app_id;
+        callback = fullscreen_callback;
+        context = fullscreen_context;
+    }
+
+    // Outside the lock: the callback may query the active window
+    callback(context, fullscreen, app_id);
+}
+
+void WaylandProtocol::WlrToplevelManagerToplevel(void *data, struct zwlr_foreign_toplevel_manager_v1 *manager,
+                                                 struct zwlr_foreign_toplevel_handle_v1 *handle)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    zwlr_foreign_toplevel_handle_v1_add_listener(handle, &wlr_toplevel_listener, self);
+
+    std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+    self->AddToplevel(handle, true);
+}
+
+void WaylandProtocol::WlrToplevelManagerFinished(void *data, struct zwlr_foreign_toplevel_manager_v1 *manager)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    // The compositor destroyed the manager; existing handles still get their closed events
+    LogMessage(LogLevel::Warn, "[Wayland] Foreign-toplevel manager finished");
+    zwlr_foreign_toplevel_manager_v1_destroy(manager);
+    if (self->wlr_toplevel_manager == manager)
+        self->wlr_toplevel_manager = nullptr;
+}
+
+void WaylandProtocol::WlrToplevelTitle(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle, const char *title)
+{
+    // Not used
+}
+
+void WaylandProtocol::WlrToplevelAppId(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle,
+                                       const char *app_id)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+    if (Toplevel *toplevel = self->FindToplevel(handle))
+        toplevel->pending_app_id = app_id ? app_id : "";
+}
+
+void WaylandProtocol::WlrToplevelOutputEnter(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle,
+                                             struct wl_output *output)
+{
+    // Not used
+}
+
+void WaylandProtocol::WlrToplevelOutputLeave(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle,
+                                             struct wl_output *output)
+{
+    // Not used
+}
+
+void WaylandProtocol::WlrToplevelState(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle,
+                                       struct wl_array *state)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    // wl_array_for_each does not compile as C++ (void * conversion), walk the array by hand
+    bool activated = false;
+    bool fullscreen = false;
+    const uint32_t *states = static_cast<const uint32_t *>(state->data);
+    for (size_t i = 0; i < state->size / sizeof(uint32_t); i++)
+    {
+        if (states[i] == ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_ACTIVATED)
+            activated = true;
+        else if (states[i] == ZWLR_FOREIGN_TOPLEVEL_HANDLE_V1_STATE_FULLSCREEN)
+            fullscreen = true;
+    }
+
+    std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+    if (Toplevel *toplevel = self->FindToplevel(handle))
+    {
+        toplevel->pending_activated = activated;
+        toplevel->pending_fullscreen = fullscreen;
+    }
+}
+
+void WaylandProtocol::WlrToplevelDone(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    {
+        std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+        Toplevel *toplevel = self->FindToplevel(handle);
+        if (!toplevel)
+            return;
+
+        toplevel->app_id = toplevel->pending_app_id;
+        toplevel->fullscreen = toplevel->pending_fullscreen;
+        if (toplevel->pending_activated)
+            self->active_toplevel = toplevel->id;
+        else if (self->active_toplevel == toplevel->id)
+            self->active_toplevel = 0;
+    }
+
+    self->UpdateFullscreenState();
+}
+
+void WaylandProtocol::WlrToplevelClosed(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    {
+        std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+        self->RemoveToplevel(handle);
+    }
+    zwlr_foreign_toplevel_handle_v1_destroy(handle);
+
+    self->UpdateFullscreenState();
+}
+
+void WaylandProtocol::WlrToplevelParent(void *data, struct zwlr_foreign_toplevel_handle_v1 *handle,
+                                        struct zwlr_foreign_toplevel_handle_v1 *parent)
+{
+    // Not used
+}
+
+void WaylandProtocol::ExtToplevelListToplevel(void *data, struct ext_foreign_toplevel_list_v1 *list,
+                                              struct ext_foreign_toplevel_handle_v1 *handle)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    ext_foreign_toplevel_handle_v1_add_listener(handle, &ext_toplevel_listener, self);
+
+    std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+    self->AddToplevel(handle, false);
+}
+
+void WaylandProtocol::ExtToplevelListFinished(void *data, struct ext_foreign_toplevel_list_v1 *list)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    LogMessage(LogLevel::Warn, "[Wayland] Foreign-toplevel list finished");
+    ext_foreign_toplevel_list_v1_destroy(list);
+    if (self->ext_toplevel_list == list)
+        self->ext_toplevel_list = nullptr;
+}
+
+void WaylandProtocol::ExtToplevelClosed(void *data, struct ext_foreign_toplevel_handle_v1 *handle)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    {
+        std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+        self->RemoveToplevel(handle);
+    }
+    ext_foreign_toplevel_handle_v1_destroy(handle);
+}
+
+void WaylandProtocol::ExtToplevelDone(void *data, struct ext_foreign_toplevel_handle_v1 *handle)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+    if (Toplevel *toplevel = self->FindToplevel(handle))
+        toplevel->app_id = toplevel->pending_app_id;
+}
+
+void WaylandProtocol::ExtToplevelTitle(void *data, struct ext_foreign_toplevel_handle_v1 *handle, const char *title)
+{
+    // Not used
+}
+
+void WaylandProtocol::ExtToplevelAppId(void *data, struct ext_foreign_toplevel_handle_v1 *handle, const char *app_id)
+{
+    WaylandProtocol *self = static_cast<WaylandProtocol *>(data);
+
+    std::lock_guard<std::mutex> lock(self->toplevel_mutex);
+    if (Toplevel *toplevel = self->FindToplevel(handle))
+        toplevel->pending_app_id = app_id ? app_id : "";
+}
+
+void WaylandProtocol::ExtToplevelIdentifier(void *data, struct ext_foreign_toplevel_handle_v1 *handle,
+                                            const char *identifier)
+{
+    // Not used
+}
+
 // ============================================================================
 // Selection event handling
 // ============================================================================
@@ -993,6 +1510,8 @@ void WaylandProtocol::WaylandMonitoringThreadProc()
     if (!wl_display_monitor)
         return;
 
+    ApplyThreadScheduling("sh-wl-selection", &thread_scheduling);
+
     int wl_fd = wl_display_get_fd(wl_display_monitor);
 
     while (wayland_monitoring_running)
@@ -1057,7 +1576,8 @@ void WaylandProtocol::WaylandMonitoringThreadProc()
             {
                 // Shutdown requested or fatal Wayland error — no read lock held, safe to exit
                 if (wayland_monitoring_running)
-                    fprintf(stderr, "[Wayland] wl_display_dispatch_pending() failed, exiting monitoring thread\n");
+                    LogMessage(LogLevel::Error,
+                               "[Wayland] wl_display_dispatch_pending() failed, exiting monitoring thread");
                 break;
             }
         }
@@ -1079,7 +1599,7 @@ void WaylandProtocol::WaylandMonitoringThreadProc()
             wl_display_cancel_read(wl_display_monitor);
             if (errno == EINTR)
                 continue;
-            fprintf(stderr, "[Wayland] select() error: %s\n", strerror(errno));
+            LogMessage(LogLevel::Error, "[Wayland] select() error: %s", strerror(errno));
             break;
         }
 
@@ -1093,14 +1613,14 @@ void WaylandProtocol::WaylandMonitoringThreadProc()
         // Data available, read events
         if (wl_display_read_events(wl_display_monitor) < 0)
         {
-            fprintf(stderr, "[Wayland] wl_display_read_events() failed: %s\n", strerror(errno));
+            LogMessage(LogLevel::Error, "[Wayland] wl_display_read_events() failed: %s", strerror(errno));
             break;
         }
 
         // Dispatch pending events
         if (wl_display_dispatch_pending(wl_display_monitor) < 0)
         {
-            fprintf(stderr, "[Wayland] wl_display_dispatch_pending() failed: %s\n", strerror(errno));
+            LogMessage(LogLevel::Error, "[Wayland] wl_display_dispatch_pending() failed: %s", strerror(errno));
             break;
         }
     }
@@ -1139,6 +1659,9 @@ void WaylandProtocol::WaylandMonitoringThreadProc()
 
 bool WaylandProtocol::GetTextViaPrimary(std::string &text)
 {
+    if (xwayland_selection)
+        return xwayland_selection->GetTextViaPrimary(text);
+
     if (!initialized || dc_type == DataControlType::None)
         return false;
 
@@ -1216,7 +1739,7 @@ bool WaylandProtocol::GetTextViaPrimary(std::string &text)
     char buf[4096];
 
     auto start_time = std::chrono::steady_clock::now();
-    while (std::chrono::steady_clock::now() - start_time < std::chrono::seconds(1))
+    while (std::chrono::steady_clock::now() - start_time < std::chrono::seconds(1) && !IsPrimaryReadCancelled())
     {
         fd_set rfds;
         FD_ZERO(&rfds);
@@ -1224,7 +1747,7 @@ bool WaylandProtocol::GetTextViaPrimary(std::string &text)
 
         struct timeval tv;
         tv.tv_sec = 0;
-        tv.tv_usec = 100000;  // 100ms
+        tv.tv_usec = 10000;  // 10ms, so that a cancelled hedged read returns promptly
 
         int ret = select(fds[0] + 1, &rfds, nullptr, nullptr, &tv);
         if (ret < 0)
@@ -1299,10 +1822,7 @@ bool WaylandProtocol::InitializeInputDevices()
         if (strncmp(entry->d_name, "event", 5) == 0)
         {
             std::string device_path = std::string(input_dir) + "/" + entry->d_name;
-            if (IsInputDevice(device_path))
-            {
-                SetupInputDevice(device_path);
-            }
+            SetupInputDevice(device_path);
         }
     }
 
@@ -1352,9 +1872,10 @@ void WaylandProtocol::CleanupInputDevices()
 }
 
 /**
- * Check if a device path is a valid input device
+ * Probe a device and, when it is a mouse/touchpad or keyboard that passes the
+ * input device filter, set it up for monitoring with epoll
  */
-bool WaylandProtocol::IsInputDevice(const std::string &device_path)
+bool WaylandProtocol::SetupInputDevice(const std::string &device_path)
 {
     int fd = open(device_path.c_str(), O_RDONLY | O_NONBLOCK);
     if (fd < 0)
@@ -1369,31 +1890,42 @@ bool WaylandProtocol::IsInputDevice(const std::string &device_path)
     }
 
     // Check if device has mouse/touchpad or keyboard capabilities
-    bool is_mouse = libevdev_has_event_code(dev, EV_KEY, BTN_LEFT) || libevdev_has_event_code(dev, EV_REL, REL_X) ||
-                    libevdev_has_event_code(dev, EV_REL, REL_Y) || libevdev_has_event_code(dev, EV_ABS, ABS_X) ||
-                    libevdev_has_event_code(dev, EV_ABS, ABS_MT_POSITION_X);
-
-    bool is_keyboard = libevdev_has_event_code(dev, EV_KEY, KEY_A) || libevdev_has_event_code(dev, EV_KEY, KEY_SPACE);
+    bool has_pointer = libevdev_has_event_code(dev, EV_KEY, BTN_LEFT) ||
+                       libevdev_has_event_code(dev, EV_REL, REL_X) || libevdev_has_event_code(dev, EV_REL, REL_Y);
+    bool has_abs_pointer =
+        libevdev_has_event_code(dev, EV_ABS, ABS_X) || libevdev_has_event_code(dev, EV_ABS, ABS_MT_POSITION_X);
+    bool has_keys = libevdev_has_event_code(dev, EV_KEY, KEY_A) || libevdev_has_event_code(dev, EV_KEY, KEY_SPACE);
 
-    libevdev_free(dev);
-    close(fd);
-
-    return is_mouse || is_keyboard;
-}
-
-/**
- * Setup an input device for monitoring with epoll
- */
-bool WaylandProtocol::SetupInputDevice(const std::string &device_path)
-{
-    int fd = open(device_path.c_str(), O_RDONLY | O_NONBLOCK);
-    if (fd < 0)
+    if (!has_pointer && !has_abs_pointer && !has_keys)
+    {
+        libevdev_free(dev);
+        close(fd);
         return false;
+    }
 
-    struct libevdev *dev = nullptr;
-    int rc = libevdev_new_from_fd(fd, &dev);
-    if (rc < 0)
-    {
+    InputDeviceInfo info;
+    const char *name = libevdev_get_name(dev);
+    info.name = name ? name : "";
+    info.bus = libevdev_get_id_bustype(dev);
+    info.vendor = libevdev_get_id_vendor(dev);
+    info.product = libevdev_get_id_product(dev);
+    if (has_pointer)
+        info.classes |= INPUT_DEVICE_MOUSE;
+    if (has_keys)
+        info.classes |= INPUT_DEVICE_KEYBOARD;
+    if (libevdev_has_event_code(dev, EV_KEY, BTN_TOOL_FINGER) && has_abs_pointer)
+        info.classes |= INPUT_DEVICE_TOUCHPAD;
+    if (libevdev_has_event_code(dev, EV_KEY, BTN_TOOL_PEN) || libevdev_has_event_code(dev, EV_KEY, BTN_STYLUS))
+        info.classes |= INPUT_DEVICE_TABLET;
+    if (libevdev_has_event_code(dev, EV_KEY, BTN_GAMEPAD) || libevdev_has_event_code(dev, EV_KEY, BTN_JOYSTICK))
+        info.classes |= INPUT_DEVICE_GAMEPAD;
+
+    const char *reason = nullptr;
+    if (!IsInputDeviceAllowed(info, input_device_filter, &reason))
+    {
+        LogMessage(LogLevel::Info, "[Wayland] Skipping input device %s \"%s\" (%s)", device_path.c_str(),
+                   info.name.c_str(), reason);
+        libevdev_free(dev);
         close(fd);
         return false;
     }
@@ -1404,10 +1936,8 @@ bool WaylandProtocol::SetupInputDevice(const std::string &device_path)
     device.path = device_path;
 
     // Determine device capabilities
-    device.is_mouse = libevdev_has_event_code(dev, EV_KEY, BTN_LEFT) || libevdev_has_event_code(dev, EV_REL, REL_X) ||
-                      libevdev_has_event_code(dev, EV_REL, REL_Y);
-
-    device.is_keyboard = libevdev_has_event_code(dev, EV_KEY, KEY_A) || libevdev_has_event_code(dev, EV_KEY, KEY_SPACE);
+    device.is_mouse = has_pointer;
+    device.is_keyboard = has_keys;
 
     // Add to epoll for monitoring
     if (epoll_fd >= 0)
@@ -1436,6 +1966,8 @@ void WaylandProtocol::InputMonitoringThreadProc()
     if (input_devices.empty() || epoll_fd < 0)
         return;
 
+    ApplyThreadScheduling("sh-evdev", &thread_scheduling);
+
     const int MAX_EVENTS = 64;
     struct epoll_event events[MAX_EVENTS];
 
@@ -1515,6 +2047,13 @@ void WaylandProtocol::ProcessLibevdevEvent(const struct input_event &ev, const I
     if (ev.type == EV_SYN)
         return;  // Skip sync events
 
+    // Suspended: drop the event and forget held modifiers, whose releases may be missed
+    if (IsInputSuspended())
+    {
+        modifier_state = ModifierState();
+        return;
+    }
+
     // Handle mouse events
     if (device.is_mouse && mouse_callback)
     {
@@ -1750,7 +2289,7 @@ bool WaylandProtocol::LoadDBusFunctions()
     void *lib = dlopen("libdbus-1.so.3", RTLD_LAZY);
     if (!lib)
     {
-        fprintf(stderr, "[Wayland] KDE: Failed to load libdbus-1.so.3: %s\n", dlerror());
+        LogMessage(LogLevel::Warn, "[Wayland] KDE: Failed to load libdbus-1.so.3: %s", dlerror());
         return false;
     }
 
@@ -1761,7 +2300,7 @@ bool WaylandProtocol::LoadDBusFunctions()
     dbus_fn.field = reinterpret_cast<decltype(dbus_fn.field)>(dlsym(lib, "dbus_" #name)); \
     if (!dbus_fn.field)                                                                   \
     {                                                                                     \
-        fprintf(stderr, "[Wayland] KDE: Missing dbus_%s\n", #name);                       \
+        LogMessage(LogLevel::Warn, "[Wayland] KDE: Missing dbus_%s", #name);              \
         goto fail;                                                                        \
     }
 
@@ -1791,7 +2330,8 @@ bool WaylandProtocol::LoadDBusFunctions()
         dbus_fn.session_bus = dbus_fn.bus_get(0 /* DBUS_BUS_SESSION */, &err);
         if (!dbus_fn.session_bus)
         {
-            fprintf(stderr, "[Wayland] KDE: Failed to connect to session bus: %s\n", err.name ? err.name : "unknown");
+            LogMessage(LogLevel::Warn, "[Wayland] KDE: Failed to connect to session bus: %s",
+                       err.name ? err.name : "unknown");
             dbus_fn.error_free(&err);
             goto fail;
         }
@@ -1803,7 +2343,7 @@ bool WaylandProtocol::LoadDBusFunctions()
         const char *name = dbus_fn.bus_get_unique_name(dbus_fn.session_bus);
         if (!name)
         {
-            fprintf(stderr, "[Wayland] KDE: Failed to get unique bus name\n");
+            LogMessage(LogLevel::Warn, "[Wayland] KDE: Failed to get unique bus name");
             goto fail;
         }
         kde_bus_name = name;
@@ -1815,7 +2355,7 @@ bool WaylandProtocol::LoadDBusFunctions()
         FILE *f = fopen(kde_script_path.c_str(), "w");
         if (!f)
         {
-            fprintf(stderr, "[Wayland] KDE: Failed to write KWin script to %s\n", kde_script_path.c_str());
+            LogMessage(LogLevel::Warn, "[Wayland] KDE: Failed to write KWin script to %s", kde_script_path.c_str());
             kde_script_path.clear();
             goto fail;
         }
@@ -2028,6 +2568,34 @@ cleanup:
     return success;
 }
 
+/**
+ * Open the XWayland selection bridge (hybrid mode).
+ * Called when the compositor offers no data-control protocol (e.g. GNOME/Mutter). XWayland
+ * mirrors the Wayland PRIMARY selection to X11, so an X11 connection on DISPLAY sees every
+ * owner change through XFixes and can read the text, without polling.
+ */
+bool WaylandProtocol::InitializeXWaylandSelection()
+{
+    const char *display_env = getenv("DISPLAY");
+    if (!display_env || !*display_env)
+        return false;
+
+    std::unique_ptr<ProtocolBase> bridge = CreateX11SelectionBridge();
+    if (!bridge->Initialize())
+    {
+        LogMessage(LogLevel::Warn, "[Wayland] XWayland: Failed to open display %s for selection monitoring",
+                   display_env);
+        return false;
+    }
+
+    bridge->SetThreadScheduling(thread_scheduling);
+    xwayland_selection = std::move(bridge);
+
+    LogMessage(LogLevel::Info, "[Wayland] No data-control protocol, monitoring selections via XWayland (%s)",
+               display_env);
+    return true;
+}
+
 /**
  * Initialize XWayland connection and detect scale factor.
  * Called lazily on first cursor position query. Detects the XWayland scale factor
@@ -2044,14 +2612,14 @@ void WaylandProtocol::EnsureXWaylandInitialized()
     const char *display_env = getenv("DISPLAY");
     if (!display_env)
     {
-        fprintf(stderr, "[Wayland] XWayland: DISPLAY not set, fallback unavailable\n");
+        LogMessage(LogLevel::Warn, "[Wayland] XWayland: DISPLAY not set, fallback unavailable");
         return;
     }
 
     xwayland_display = XOpenDisplay(display_env);
     if (!xwayland_display)
     {
-        fprintf(stderr, "[Wayland] XWayland: Failed to open display %s\n", display_env);
+        LogMessage(LogLevel::Warn, "[Wayland] XWayland: Failed to open display %s", display_env);
         return;
     }
 
@@ -2092,8 +2660,8 @@ void WaylandProtocol::EnsureXWaylandInitialized()
 
     if (xwayland_scale != 1.0)
     {
-        printf("[Wayland] XWayland scale factor: %.2f (Xft.dpi=%.0f, GDK_SCALE=%d)\n", xwayland_scale, xft_dpi,
-               gdk_scale);
+        LogMessage(LogLevel::Info, "[Wayland] XWayland scale factor: %.2f (Xft.dpi=%.0f, GDK_SCALE=%d)", xwayland_scale,
+                   xft_dpi, gdk_scale);
     }
 }
 
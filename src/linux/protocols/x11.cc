@@ -5,30 +5,36 @@
  * clipboard operations, and window management.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <climits>
+#include <condition_variable>
 #include <cstring>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 // X11 headers
 #include <X11/XKBlib.h>
 #include <X11/Xatom.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <X11/extensions/XInput2.h>
 #include <X11/extensions/XTest.h>
 #include <X11/extensions/Xfixes.h>
 #include <X11/extensions/record.h>
 #include <X11/keysym.h>
 
 // System headers
+#include <fcntl.h>
 #include <sys/epoll.h>
 #include <sys/select.h>
 #include <unistd.h>
 
 #include <atomic>
 #include <cerrno>
-#include <cstdio>
 #include <thread>
 
 // Linux input event constants
@@ -44,9 +50,56 @@ constexpr long X11_None = None;
 
 // Include common definitions
 #include "../common.h"
+#include "../lib/event_reactor.h"
+#include "../lib/log_ring.h"
+#include "../lib/utils.h"
+#include "../lib/xi2_scroll.h"
+#include "../lib/xrecord.h"
 
 // Forward declaration for SelectionHook from selection_hook.cc
 
+// Clipboard fallback: maximum wait for the target app to take CLIPBOARD ownership after Ctrl+C
+constexpr int CLIPBOARD_COPY_TIMEOUT_MS = 300;
+// Clipboard fallback (delay-read apps): quiet period without further owner changes before reading
+constexpr int CLIPBOARD_SETTLE_QUIET_MS = 50;
+// Clipboard fallback (delay-read apps): upper bound for the settle phase
+constexpr int CLIPBOARD_SETTLE_MAX_MS = 500;
+// PRIMARY read: wait for TIMESTAMP once the text has arrived; owners that never answer it are not cached
+constexpr int PRIMARY_TIMESTAMP_GRACE_MS = 10;
+
+/**
+ * Program name of a window: WM_CLASS res_name, or the window name
+ */
+static bool ReadProgramName(Display *dpy, Window window, std::string &programName)
+{
+    // Try to get WM_CLASS property first
+    XClassHint classHint;
+    if (XGetClassHint(dpy, window, &classHint))
+    {
+        if (classHint.res_name)
+        {
+            programName = std::string(classHint.res_name);
+            XFree(classHint.res_name);
+            if (classHint.res_class)
+                XFree(classHint.res_class);
+            return true;
+        }
+        if (classHint.res_class)
+            XFree(classHint.res_class);
+    }
+
+    // Fallback to window name
+    char *window_name = nullptr;
+    if (XFetchName(dpy, window, &window_name) && window_name)
+    {
+        programName = std::string(window_name);
+        XFree(window_name);
+        return true;
+    }
+
+    return false;
+}
+
 /**
  * X11 Protocol Class Implementation
  */
@@ -56,6 +109,23 @@ class X11Protocol : public ProtocolBase
     Display *display;
     int screen;
     Window root;
+    // Display of every connection opened by this protocol, empty for $DISPLAY
+    std::string display_name;
+
+    // Selection-only bridge (see CreateX11SelectionBridge): XFixes owner changes and
+    // PRIMARY reads only, no XRecord input
+    bool selection_only;
+
+    // Text of the last PRIMARY read, keyed by the owner and the ICCCM TIMESTAMP of its acquisition.
+    // Reused while both are unchanged; primary_owner_serial is bumped by the XFixes thread on
+    // every PRIMARY owner change, so a known change skips the revalidation round trip.
+    std::mutex primary_cache_mutex;
+    bool primary_cache_valid;
+    Window primary_cache_owner;
+    Time primary_cache_timestamp;
+    uint64_t primary_cache_serial;
+    std::string primary_cache_text;
+    std::atomic<uint64_t> primary_owner_serial;
 
     // XRecord related
     XRecordContext record_context;
@@ -64,6 +134,13 @@ class X11Protocol : public ProtocolBase
     Display *control_display;  // Separate Display connection for control operations
     bool record_initialized;
 
+    // Synthetic input filtering: XTestFakeInput requests are recorded along with the device
+    // events and matched against them (XRecord thread), XTEST slave devices are skipped by XI2
+    InputDeviceFilter input_device_filter;
+    int xtest_opcode;  // Major opcode of XTEST while its requests are recorded, else 0
+    SyntheticInputTracker xtest_inputs;
+    std::vector<int> xi2_xtest_devices;  // XTEST slave device ids (XI2 thread)
+
     // Thread management
     std::atomic<bool> input_monitoring_running;
     std::thread input_monitoring_thread;
@@ -76,6 +153,23 @@ class X11Protocol : public ProtocolBase
     // Modifier key state tracking
     ModifierState modifier_state;
 
+    // XInput2 smooth scrolling: while the XI2 thread runs, wheel events come from scroll
+    // valuators and non-emulated wheel buttons, summed per frame, and XRecord skips buttons 4-7
+    Display *xi2_display;  // Dedicated Display connection for XI2 raw events
+    int xi2_opcode;
+    bool xi2_initialized;
+    std::atomic<bool> xi2_monitoring_running;
+    std::thread xi2_monitoring_thread;
+    std::unordered_map<int, std::vector<ScrollValuator>> xi2_scroll_valuators;  // By slave device id
+    ScrollFrame xi2_scroll_frame;
+
+    // XInput2 input backend: buttons, motion and keys also come from raw events on the XI2
+    // connection, which carry the slave device and server time, and no XRecord context is opened.
+    // Raw buttons are physical, so the core pointer mapping is applied to them.
+    X11InputBackend input_backend;
+    bool xi2_input;
+    std::vector<unsigned char> xi2_button_map;  // Logical button by physical button - 1 (XI2 thread)
+
     // XFixes related
     Display *xfixes_display;
     int xfixes_event_base;
@@ -84,39 +178,146 @@ class X11Protocol : public ProtocolBase
     std::atomic<bool> xfixes_monitoring_running;
     std::thread xfixes_monitoring_thread;
     SelectionEventCallback selection_callback;
+    bool xfixes_in_loop;  // XFixes events dispatched by the host event loop, no XFixes thread
+
+    // Selection atoms (server-global, interned once on xfixes_display)
+    Atom xfixes_primary_atom;
+    Atom xfixes_clipboard_atom;
+    Atom xfixes_targets_atom;
+    Atom xfixes_utf8_atom;
+    Atom xfixes_text_atom;
+
+    // Clipboard fallback related. CLIPBOARD owner changes are observed by the XFixes
+    // thread, which also owns clipboard_owner_window and serves the restored content.
+    Window clipboard_owner_window;
+    std::mutex clipboard_mutex;
+    std::condition_variable clipboard_cv;
+    uint64_t clipboard_owner_serial;     // Bumped on every foreign CLIPBOARD owner change
+    std::string clipboard_restore_text;  // Text served while clipboard_owner_window owns CLIPBOARD
+    bool clipboard_restore_pending;      // Main thread asked the XFixes thread to take ownership
+    int clipboard_wake_fds[2];           // Wakes the XFixes thread for restore requests
+
+    // Fullscreen tracking on the XFixes connection: _NET_ACTIVE_WINDOW of the root window and
+    // _NET_WM_STATE of the active window are watched through PropertyNotify, and the state of
+    // the active window is cached; only changes are reported
+    FullscreenEventCallback fullscreen_callback;
+    void *fullscreen_context;
+    Atom net_active_window_atom;
+    Atom net_wm_state_atom;
+    Atom net_wm_state_fullscreen_atom;
+    Window fullscreen_window;  // Active window whose _NET_WM_STATE is watched
+    bool fullscreen_reported;
+    std::string fullscreen_program;
+
+    // Scheduling applied by the XRecord and XFixes threads at startup
+    ThreadSchedulingOptions thread_scheduling;
+
+    // Reactor shared with other displays that reads the XRecord, XI2 and XFixes connections
+    // instead of their threads, else null (see SetEventReactor)
+    EventReactor *event_reactor;
 
     // Helper methods
+    Display *OpenDisplay() const { return XOpenDisplay(display_name.empty() ? nullptr : display_name.c_str()); }
     bool InitializeXRecord();
     void CleanupXRecord();
     void XRecordMonitoringThreadProc();
     static void XRecordDataCallback(XPointer closure, XRecordInterceptData *data);
     void ProcessXRecordData(XRecordInterceptData *data);
 
+    // XI2 smooth-scroll helper methods
+    bool InitializeXI2();
+    void CleanupXI2();
+    void XI2MonitoringThreadProc();
+    void ProcessXI2Events();
+    void RefreshXI2ScrollValuators();
+    void RefreshXI2ButtonMap();
+    void FlushXI2ScrollFrame();
+    Point QueryXI2Pointer();
+
+    // Event reactor helper methods: the handlers run on the reactor thread in place of the
+    // XRecord, XI2 and XFixes thread loops
+    bool WatchOnReactor();
+    void UnwatchOnReactor();
+    static int64_t OnXRecordReadable(void *context);
+    static int64_t OnXI2Readable(void *context);
+    static int64_t OnXFixesReadable(void *context);
+    static int64_t OnClipboardWake(void *context);
+
+    // XI2 input backend helper methods
+    void ProcessXI2Button(const XIRawEvent *raw, bool press);
+    void ProcessXI2Key(const XIRawEvent *raw, bool press);
+    void ProcessXI2Motion(int device, Time time);
+    bool IsXI2XTestDevice(int device) const;
+
     // XFixes helper methods
     bool InitializeXFixes();
     void CleanupXFixes();
     void XFixesMonitoringThreadProc();
+    void ProcessXFixesEvents();
+
+    // Clipboard fallback helper methods
+    bool WaitClipboardOwnerChange(uint64_t serial, int timeoutMs);
+    void RestoreClipboard(bool hasSaved, std::string &savedText);
+    void ProcessClipboardRestoreRequest();
+    void ServeClipboardRequest(const XSelectionRequestEvent &request);
+    size_t ClipboardServeLimit();
+
+    // Fullscreen tracking helper methods (XFixes connection)
+    void InitializeFullscreenTracking();
+    void WatchActiveWindow();
+    void UpdateFullscreenState();
 
   public:
-    X11Protocol()
+    explicit X11Protocol(bool selectionOnly = false)
         : display(nullptr),
           screen(0),
           root(0),
+          selection_only(selectionOnly),
+          primary_cache_valid(false),
+          primary_cache_owner(X11_None),
+          primary_cache_timestamp(0),
+          primary_cache_serial(0),
+          primary_owner_serial(0),
           record_context(X11_None),
           record_range(nullptr),
           record_display(nullptr),
           control_display(nullptr),
           record_initialized(false),
+          xtest_opcode(0),
           input_monitoring_running(false),
           mouse_callback(nullptr),
           keyboard_callback(nullptr),
           callback_context(nullptr),
+          xi2_display(nullptr),
+          xi2_opcode(0),
+          xi2_initialized(false),
+          xi2_monitoring_running(false),
+          input_backend(X11InputBackend::XRecord),
+          xi2_input(false),
           xfixes_display(nullptr),
           xfixes_event_base(0),
           xfixes_error_base(0),
           xfixes_initialized(false),
           xfixes_monitoring_running(false),
-          selection_callback(nullptr)
+          selection_callback(nullptr),
+          xfixes_in_loop(false),
+          xfixes_primary_atom(X11_None),
+          xfixes_clipboard_atom(X11_None),
+          xfixes_targets_atom(X11_None),
+          xfixes_utf8_atom(X11_None),
+          xfixes_text_atom(X11_None),
+          clipboard_owner_window(0),
+          clipboard_owner_serial(0),
+          clipboard_restore_pending(false),
+          clipboard_wake_fds{-1, -1},
+          fullscreen_callback(nullptr),
+          fullscreen_context(nullptr),
+          net_active_window_atom(X11_None),
+          net_wm_state_atom(X11_None),
+          net_wm_state_fullscreen_atom(X11_None),
+          fullscreen_window(0),
+          fullscreen_reported(false),
+          event_reactor(nullptr)
     {
     }
 
@@ -132,7 +333,7 @@ class X11Protocol : public ProtocolBase
     bool Initialize() override
     {
         // Initialize X11 connection
-        display = XOpenDisplay(nullptr);
+        display = OpenDisplay();
         if (!display)
         {
             return false;
@@ -144,6 +345,8 @@ class X11Protocol : public ProtocolBase
         return true;
     }
 
+    void SetDisplayName(const std::string &name) override { display_name = name; }
+
     void Cleanup() override
     {
         if (display)
@@ -151,6 +354,10 @@ class X11Protocol : public ProtocolBase
             XCloseDisplay(display);
             display = nullptr;
         }
+
+        std::lock_guard<std::mutex> lock(primary_cache_mutex);
+        primary_cache_valid = false;
+        primary_cache_text.clear();
     }
 
     // Window management
@@ -208,38 +415,13 @@ class X11Protocol : public ProtocolBase
         if (!display || !window)
             return false;
 
-        Window x11Window = static_cast<Window>(window);
-
-        // Try to get WM_CLASS property first
-        XClassHint classHint;
-        if (XGetClassHint(display, x11Window, &classHint))
-        {
-            if (classHint.res_name)
-            {
-                programName = std::string(classHint.res_name);
-                XFree(classHint.res_name);
-                if (classHint.res_class)
-                    XFree(classHint.res_class);
-                return true;
-            }
-            if (classHint.res_class)
-                XFree(classHint.res_class);
-        }
-
-        // Fallback to window name
-        char *window_name = nullptr;
-        if (XFetchName(display, x11Window, &window_name) && window_name)
-        {
-            programName = std::string(window_name);
-            XFree(window_name);
-            return true;
-        }
-
-        return false;
+        return ReadProgramName(display, static_cast<Window>(window), programName);
     }
 
-    // Shared helper: read a named X11 selection into text
-    bool ReadSelection(const char *selectionName, const char *propertyName, std::string &text)
+    // Shared helper: read a named X11 selection into text. With length set, only the byte
+    // length is read: the owner still converts, but the data is not transferred to us.
+    bool ReadSelection(const char *selectionName, const char *propertyName, std::string &text,
+                       size_t *length = nullptr)
     {
         if (!display)
             return false;
@@ -268,10 +450,16 @@ class X11Protocol : public ProtocolBase
                     unsigned long nitems, bytes_after;
                     unsigned char *data = nullptr;
 
-                    if (XGetWindowProperty(display, window, property, 0, LONG_MAX, False, AnyPropertyType, &actual_type,
-                                           &actual_format, &nitems, &bytes_after, &data) == Success)
+                    if (XGetWindowProperty(display, window, property, 0, length ? 0 : LONG_MAX, False,
+                                           AnyPropertyType, &actual_type, &actual_format, &nitems, &bytes_after,
+                                           &data) == Success)
                     {
-                        if (actual_type == utf8_string && data && nitems > 0)
+                        if (length && actual_type == utf8_string)
+                        {
+                            *length = bytes_after;
+                            success = true;
+                        }
+                        else if (actual_type == utf8_string && data && nitems > 0)
                         {
                             text = std::string(reinterpret_cast<char *>(data), nitems);
                             success = true;
@@ -282,15 +470,190 @@ class X11Protocol : public ProtocolBase
                 }
                 break;
             }
+            if (IsPrimaryReadCancelled())
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        XDestroyWindow(display, window);
+        return success;
+    }
+
+    // Wait for the SelectionNotify answering each of count conversions requested on window, matched by
+    // target. converted[i] is set when targets[i] was converted. Once only the optional target (index,
+    // or -1 for none) is left, it is waited for PRIMARY_TIMESTAMP_GRACE_MS at most. False unless all
+    // were answered, e.g. on timeout or cancellation.
+    bool WaitSelectionNotifies(Window window, const Atom *targets, bool *converted, int count, int optional = -1)
+    {
+        bool answered[2] = {false, false};
+        int pending = count;
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
+        while (pending > 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            XEvent event;
+            if (XCheckTypedWindowEvent(display, window, SelectionNotify, &event))
+            {
+                for (int i = 0; i < count; i++)
+                {
+                    if (!answered[i] && event.xselection.target == targets[i])
+                    {
+                        answered[i] = true;
+                        converted[i] = event.xselection.property != X11_None;
+                        pending--;
+                        if (pending == 1 && optional >= 0 && !answered[optional])
+                            deadline = std::min(deadline, std::chrono::steady_clock::now() +
+                                                              std::chrono::milliseconds(PRIMARY_TIMESTAMP_GRACE_MS));
+                        break;
+                    }
+                }
+                continue;
+            }
+            if (IsPrimaryReadCancelled())
+                break;
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
 
+        return pending == 0;
+    }
+
+    // Read a converted TIMESTAMP target (one 32-bit item); 0 when missing or malformed
+    Time ReadTimestampProperty(Window window, Atom property)
+    {
+        Atom actual_type;
+        int actual_format;
+        unsigned long nitems, bytes_after;
+        unsigned char *data = nullptr;
+        Time timestamp = 0;
+
+        if (XGetWindowProperty(display, window, property, 0, 1, False, AnyPropertyType, &actual_type, &actual_format,
+                               &nitems, &bytes_after, &data) == Success)
+        {
+            // Format 32 items are returned as longs by Xlib
+            if (actual_format == 32 && nitems == 1 && data)
+                timestamp = static_cast<Time>(*reinterpret_cast<unsigned long *>(data));
+            if (data)
+                XFree(data);
+        }
+
+        return timestamp;
+    }
+
+    // Read a converted UTF8_STRING target into text
+    bool ReadTextProperty(Window window, Atom property, Atom utf8_string, std::string &text)
+    {
+        Atom actual_type;
+        int actual_format;
+        unsigned long nitems, bytes_after;
+        unsigned char *data = nullptr;
+        bool success = false;
+
+        if (XGetWindowProperty(display, window, property, 0, LONG_MAX, False, AnyPropertyType, &actual_type,
+                               &actual_format, &nitems, &bytes_after, &data) == Success)
+        {
+            if (actual_type == utf8_string && data && nitems > 0)
+            {
+                text = std::string(reinterpret_cast<char *>(data), nitems);
+                success = true;
+            }
+            if (data)
+                XFree(data);
+        }
+
+        return success;
+    }
+
+    // Text selection. PRIMARY is first converted to the ICCCM TIMESTAMP target, the time its owner
+    // acquired it: with the same owner and timestamp as the cached read, the cached text is returned
+    // and the text is not transferred again. When no cached text can still be valid (none yet, or
+    // XFixes reported an owner change since), the text conversion is requested along with it.
+    // Owners that do not convert TIMESTAMP, or acquired PRIMARY with CurrentTime, are never cached;
+    // their text is returned PRIMARY_TIMESTAMP_GRACE_MS after it arrives at most.
+    // An owner that leaves the revalidation unanswered fails the read instead of a second wait.
+    bool GetTextViaPrimary(std::string &text) override
+    {
+        if (!display)
+            return false;
+
+        Window window = XCreateSimpleWindow(display, root, 0, 0, 1, 1, 0, 0, 0);
+
+        Atom targets[2] = {XInternAtom(display, "TIMESTAMP", False), XInternAtom(display, "UTF8_STRING", False)};
+        Atom properties[2] = {XInternAtom(display, "SELECTION_TIMESTAMP", False),
+                              XInternAtom(display, "SELECTION_DATA", False)};
+        bool converted[2] = {false, false};
+
+        uint64_t serial = primary_owner_serial.load();
+        bool revalidate;
+        {
+            std::lock_guard<std::mutex> lock(primary_cache_mutex);
+            revalidate = primary_cache_valid && primary_cache_serial == serial;
+        }
+
+        XConvertSelection(display, XA_PRIMARY, targets[0], properties[0], window, CurrentTime);
+        if (!revalidate)
+            XConvertSelection(display, XA_PRIMARY, targets[1], properties[1], window, CurrentTime);
+
+        // Flushes the conversions; its round trip overlaps the owner converting them
+        Window owner = XGetSelectionOwner(display, XA_PRIMARY);
+
+        // With the text requested, TIMESTAMP only decides caching and does not hold the text back
+        bool answered = revalidate ? WaitSelectionNotifies(window, targets, converted, 1)
+                                   : WaitSelectionNotifies(window, targets, converted, 2, 0);
+        Time timestamp = converted[0] ? ReadTimestampProperty(window, properties[0]) : 0;
+
+        bool success = false;
+        if (revalidate && timestamp != 0)
+        {
+            std::lock_guard<std::mutex> lock(primary_cache_mutex);
+            if (primary_cache_valid && owner == primary_cache_owner && timestamp == primary_cache_timestamp)
+            {
+                text = primary_cache_text;
+                success = true;
+            }
+        }
+
+        if (!success)
+        {
+            // Cached text is stale: transfer the text now, unless the owner timed out (or the read
+            // was cancelled) already; the cache is dropped, so the next read converts both at once
+            if (revalidate && answered && owner != X11_None)
+            {
+                XConvertSelection(display, XA_PRIMARY, targets[1], properties[1], window, CurrentTime);
+                XFlush(display);
+                WaitSelectionNotifies(window, &targets[1], &converted[1], 1);
+            }
+
+            if (converted[1])
+                success = ReadTextProperty(window, properties[1], targets[1], text);
+
+            std::lock_guard<std::mutex> lock(primary_cache_mutex);
+            primary_cache_valid = success && timestamp != 0 && owner != X11_None;
+            primary_cache_owner = owner;
+            primary_cache_timestamp = timestamp;
+            primary_cache_serial = serial;
+            if (primary_cache_valid)
+                primary_cache_text = text;
+            else
+                primary_cache_text.clear();
+        }
+
         XDestroyWindow(display, window);
         return success;
     }
 
-    // Text selection
-    bool GetTextViaPrimary(std::string &text) override { return ReadSelection("PRIMARY", "SELECTION_DATA", text); }
+    bool HasPrimarySelection() override { return display && XGetSelectionOwner(display, XA_PRIMARY) != X11_None; }
+
+    bool GetPrimarySelectionLength(size_t &length) override
+    {
+        if (!HasPrimarySelection())
+        {
+            length = 0;
+            return true;
+        }
+
+        std::string unused;
+        return ReadSelection("PRIMARY", "SELECTION_DATA", unused, &length);
+    }
 
     // Clipboard operations
     bool WriteClipboard(const std::string &text) override
@@ -329,6 +692,25 @@ class X11Protocol : public ProtocolBase
 
     bool ReadClipboard(std::string &text) override { return ReadSelection("CLIPBOARD", "CLIPBOARD_DATA", text); }
 
+    // Clipboard fallback via XTest Ctrl+C, confirmed by the XFixes CLIPBOARD owner change
+    bool GetTextViaClipboard(std::string &text, bool delayRead) override;
+
+    // Text cursor detection via the XFixes cursor name (set by libXcursor themes)
+    bool IsTextCursor() override
+    {
+        if (!display || !xfixes_initialized)
+            return false;
+
+        XFixesCursorImage *image = XFixesGetCursorImage(display);
+        if (!image)
+            return false;
+
+        bool is_text = image->name && (strcmp(image->name, "xterm") == 0 || strcmp(image->name, "text") == 0 ||
+                                       strcmp(image->name, "ibeam") == 0);
+        XFree(image);
+        return is_text;
+    }
+
     // Input monitoring implementation using XRecord + XFixes
     bool InitializeInputMonitoring(MouseEventCallback mouseCallback, KeyboardEventCallback keyboardCallback,
                                    SelectionEventCallback selectionCb, void *context) override
@@ -342,17 +724,36 @@ class X11Protocol : public ProtocolBase
         selection_callback = selectionCb;
         callback_context = context;
 
-        // Initialize XRecord
-        if (!InitializeXRecord())
-            return false;
+        // The selection bridge has nothing to monitor without XFixes
+        if (selection_only)
+            return InitializeXFixes();
+
+        // XInput2 backend: all input from raw events on the XI2 connection, without XRecord
+        xi2_input = (input_backend == X11InputBackend::XInput2);
+        if (xi2_input && !InitializeXI2())
+        {
+            LogMessage(LogLevel::Warn, "[XI2] XInput 2.1 not available, input from XRecord");
+            xi2_input = false;
+        }
+
+        if (!xi2_input)
+        {
+            // Initialize XRecord
+            if (!InitializeXRecord())
+                return false;
+
+            // Smooth-scroll wheel events need XInput 2.1; without it XRecord reports wheel buttons
+            if (!InitializeXI2())
+                LogMessage(LogLevel::Info, "[XI2] XInput 2.1 not available, wheel events from core buttons");
+        }
 
         // Initialize XFixes for PRIMARY selection monitoring
         // If XFixes fails, print warning but don't block startup
         if (!InitializeXFixes())
         {
-            fprintf(stderr,
-                    "[XFixes] WARNING: Failed to initialize XFixes extension. "
-                    "Selection change detection will not work.\n");
+            LogMessage(LogLevel::Warn,
+                       "[XFixes] Failed to initialize XFixes extension. "
+                       "Selection change detection will not work.");
         }
 
         return true;
@@ -366,6 +767,9 @@ class X11Protocol : public ProtocolBase
         // Cleanup XFixes
         CleanupXFixes();
 
+        // Cleanup XI2
+        CleanupXI2();
+
         // Cleanup XRecord
         CleanupXRecord();
 
@@ -378,25 +782,103 @@ class X11Protocol : public ProtocolBase
 
     bool StartInputMonitoring() override
     {
-        if (!display || !record_initialized || input_monitoring_running)
+        if (!display || input_monitoring_running || xi2_monitoring_running || xfixes_monitoring_running)
             return false;
 
-        // Start XRecord monitoring thread
-        input_monitoring_running = true;
-        input_monitoring_thread = std::thread(&X11Protocol::XRecordMonitoringThreadProc, this);
+        if (selection_only)
+        {
+            if (!xfixes_initialized)
+                return false;
+        }
+        else
+        {
+            if (!record_initialized && !xi2_input)
+                return false;
+
+            // Start XRecord monitoring thread, unless input comes from XI2
+            if (record_initialized)
+            {
+                input_monitoring_running = true;
+                if (!event_reactor)
+                    input_monitoring_thread = std::thread(&X11Protocol::XRecordMonitoringThreadProc, this);
+            }
+
+            // Start XI2 thread (smooth scrolling, or all input with the XI2 backend) if initialized
+            if (xi2_initialized)
+            {
+                xi2_monitoring_running = true;
+                if (!event_reactor)
+                    xi2_monitoring_thread = std::thread(&X11Protocol::XI2MonitoringThreadProc, this);
+            }
+        }
 
-        // Start XFixes monitoring thread if initialized
+        // Start XFixes monitoring thread if initialized. In in-loop mode the host
+        // event loop polls GetSelectionEventFd() and calls DispatchSelectionEvents().
         if (xfixes_initialized)
         {
             xfixes_monitoring_running = true;
-            xfixes_monitoring_thread = std::thread(&X11Protocol::XFixesMonitoringThreadProc, this);
+            if (!xfixes_in_loop && !event_reactor)
+                xfixes_monitoring_thread = std::thread(&X11Protocol::XFixesMonitoringThreadProc, this);
+        }
+
+        // With a reactor, the connections are read by its thread instead
+        if (event_reactor && !WatchOnReactor())
+        {
+            StopInputMonitoring();
+            return false;
         }
 
         return true;
     }
 
+    void SetThreadScheduling(const ThreadSchedulingOptions &options) override { thread_scheduling = options; }
+
+    // Set before InitializeInputMonitoring(): the watch is set up with the XFixes connection
+    bool SetFullscreenCallback(FullscreenEventCallback callback, void *context) override
+    {
+        fullscreen_callback = callback;
+        fullscreen_context = context;
+        return true;
+    }
+
+    // Only excludeXTest applies on X11: the X server, not this process, reads the input devices
+    void SetInputDeviceFilter(const InputDeviceFilter &filter) override { input_device_filter = filter; }
+
+    void SetX11InputBackend(X11InputBackend backend) override { input_backend = backend; }
+
+    void SetEventReactor(EventReactor *reactor) override { event_reactor = reactor; }
+
+    bool SetSelectionEventsInLoop(bool inLoop) override
+    {
+        if (xfixes_monitoring_running)
+            return false;
+
+        xfixes_in_loop = inLoop;
+        return true;
+    }
+
+    int GetSelectionEventFd() override
+    {
+        if (!xfixes_in_loop || !xfixes_display || !xfixes_monitoring_running)
+            return -1;
+
+        return ConnectionNumber(xfixes_display);
+    }
+
+    void DispatchSelectionEvents() override
+    {
+        if (!xfixes_in_loop || !xfixes_display || !xfixes_monitoring_running)
+            return;
+
+        ProcessXFixesEvents();
+    }
+
     void StopInputMonitoring() override
     {
+        // With a reactor: once unwatched, no handler runs for this display anymore
+        if (event_reactor)
+            UnwatchOnReactor();
+
         // Stop XFixes thread first (non-blocking select loop, joins quickly)
         xfixes_monitoring_running = false;
         if (xfixes_monitoring_thread.joinable())
@@ -404,6 +886,16 @@ class X11Protocol : public ProtocolBase
             xfixes_monitoring_thread.join();
         }
 
+        if (selection_only)
+            return;
+
+        // Stop XI2 thread (non-blocking select loop, joins quickly)
+        xi2_monitoring_running = false;
+        if (xi2_monitoring_thread.joinable())
+        {
+            xi2_monitoring_thread.join();
+        }
+
         // Signal the XRecord thread to stop
         input_monitoring_running = false;
 
@@ -418,10 +910,10 @@ class X11Protocol : public ProtocolBase
         if (input_monitoring_thread.joinable())
         {
             input_monitoring_thread.join();
-        }
 
-        // Give XRecord a moment to fully disable the context before cleanup
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            // Give XRecord a moment to fully disable the context before cleanup
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
     }
 
     // X11-specific methods
@@ -448,6 +940,50 @@ class X11Protocol : public ProtocolBase
     }
 };
 
+static uint64_t SteadyMs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// Fullscreen tracking selects events on and reads properties of other clients' windows, which
+// may be destroyed at any time. BadWindow errors on the connections doing so are ignored rather
+// than reaching Xlib's default handler, which exits the process; other errors are passed on.
+static std::mutex fullscreen_error_mutex;
+static std::vector<Display *> fullscreen_error_displays;
+static XErrorHandler previous_error_handler = nullptr;
+
+static int FullscreenErrorHandler(Display *dpy, XErrorEvent *error)
+{
+    {
+        std::lock_guard<std::mutex> lock(fullscreen_error_mutex);
+        if (error->error_code == BadWindow &&
+            std::find(fullscreen_error_displays.begin(), fullscreen_error_displays.end(), dpy) !=
+                fullscreen_error_displays.end())
+            return 0;
+    }
+    return previous_error_handler ? previous_error_handler(dpy, error) : 0;
+}
+
+static void IgnoreBadWindowErrors(Display *dpy, bool ignore)
+{
+    std::lock_guard<std::mutex> lock(fullscreen_error_mutex);
+    if (ignore)
+    {
+        // Installed once and kept: a handler installed later by the host may have chained to it
+        if (!previous_error_handler)
+            previous_error_handler = XSetErrorHandler(FullscreenErrorHandler);
+        fullscreen_error_displays.push_back(dpy);
+    }
+    else
+    {
+        fullscreen_error_displays.erase(
+            std::remove(fullscreen_error_displays.begin(), fullscreen_error_displays.end(), dpy),
+            fullscreen_error_displays.end());
+    }
+}
+
 // XRecord helper methods implementation
 bool X11Protocol::InitializeXRecord()
 {
@@ -462,14 +998,14 @@ bool X11Protocol::InitializeXRecord()
     }
 
     // Create a dedicated display connection for XRecord
-    record_display = XOpenDisplay(nullptr);
+    record_display = OpenDisplay();
     if (!record_display)
     {
         return false;
     }
 
     // Create a separate display connection for control operations
-    control_display = XOpenDisplay(nullptr);
+    control_display = OpenDisplay();
     if (!control_display)
     {
         XCloseDisplay(record_display);
@@ -492,6 +1028,29 @@ bool X11Protocol::InitializeXRecord()
     record_range->device_events.first = KeyPress;
     record_range->device_events.last = MotionNotify;
 
+    // Also record XTestFakeInput requests to recognize the events they generate
+    xtest_opcode = 0;
+    xtest_inputs.Clear();
+    int xtest_event_base, xtest_error_base;
+    if (input_device_filter.excludeXTest &&
+        XQueryExtension(display, "XTEST", &xtest_opcode, &xtest_event_base, &xtest_error_base))
+    {
+        record_range->ext_requests.ext_major.first = xtest_opcode;
+        record_range->ext_requests.ext_major.last = xtest_opcode;
+        record_range->ext_requests.ext_minor.first = XTEST_FAKE_INPUT_MINOR;
+        record_range->ext_requests.ext_minor.last = XTEST_FAKE_INPUT_MINOR;
+
+        // Requests name physical buttons; read once, later remappings are not followed
+        unsigned char map[256];
+        int count = XGetPointerMapping(display, map, sizeof(map));
+        xtest_inputs.SetButtonMap(map, static_cast<size_t>(std::max(count, 0)));
+    }
+    else if (input_device_filter.excludeXTest)
+    {
+        xtest_opcode = 0;
+        LogMessage(LogLevel::Warn, "[XRecord] XTEST not available, synthetic input is not filtered");
+    }
+
     // Create client specification - all clients
     XRecordClientSpec client_spec = XRecordAllClients;
 
@@ -557,6 +1116,8 @@ void X11Protocol::XRecordMonitoringThreadProc()
     if (!record_display || !record_initialized)
         return;
 
+    ApplyThreadScheduling("sh-xrecord", &thread_scheduling);
+
     // Enable XRecord context — blocks until XRecordDisableContext is called from StopInputMonitoring.
     // Per the XRecord spec, re-enabling an already-enabled context produces BadMatch,
     // so this must be a single call, not a retry loop.
@@ -578,101 +1139,50 @@ void X11Protocol::ProcessXRecordData(XRecordInterceptData *data)
     if (!data || !data->data)
         return;
 
-    // Parse the X11 protocol data
-    if (data->category == XRecordFromServer && data->data_len >= 8)
+    // Suspended: drop the event before decoding and forget held modifiers, whose releases may be missed
+    if (IsInputSuspended())
     {
-        // Get the event type from the first byte
-        unsigned char event_type = data->data[0] & 0x7f;  // Remove the send_event bit
+        modifier_state = ModifierState();
+        XRecordFreeData(data);
+        return;
+    }
 
-        // Extract basic event data from the 8-byte protocol data
-        unsigned char *event_data = data->data;
+    // Synthetic input: remember the request, then drop the event it generates
+    if (xtest_opcode && data->category == XRecordFromClient)
+    {
+        XTestFakeInput fakeInput;
+        if (DecodeXTestFakeInput(data->data, static_cast<size_t>(data->data_len) * 4, xtest_opcode, fakeInput))
+        {
+            if (data->client_swapped)
+                fakeInput.delayMs = __builtin_bswap32(fakeInput.delayMs);
+            xtest_inputs.Add(fakeInput, SteadyMs());
+        }
+        XRecordFreeData(data);
+        return;
+    }
 
-        switch (event_type)
+    // Parse the X11 protocol data (data_len is in 4-byte units)
+    XRecordInputEvent inputEvent;
+    if (data->category == XRecordFromServer &&
+        DecodeXRecordInputEvent(data->data, static_cast<size_t>(data->data_len) * 4, inputEvent) &&
+        !(xtest_inputs.Size() > 0 && xtest_inputs.Consume(inputEvent, SteadyMs())))
+    {
+        switch (inputEvent.type)
         {
             case ButtonPress:
             case ButtonRelease:
             {
+                // One wheel event per notch, on press; the XI2 thread reports the wheel while it runs
+                if (IsX11WheelButton(inputEvent.detail) && (inputEvent.type == ButtonRelease || xi2_monitoring_running))
+                    break;
+
                 if (mouse_callback)
                 {
-                    // Get current mouse position for button events
-                    Point current_pos = GetCurrentMousePosition();
-
-                    // For 8-byte data, try a simpler approach
-                    // Just use current mouse position and button from second byte
-                    unsigned char button = event_data[1];
-
                     MouseEventContext *mouseEvent = new MouseEventContext();
-                    mouseEvent->value = (event_type == ButtonPress) ? 1 : 0;
-                    mouseEvent->pos = current_pos;  // Use actual mouse position
+                    MapX11ButtonToMouseEvent(inputEvent.detail, inputEvent.type == ButtonPress, *mouseEvent);
 
-                    // Map X11 button numbers to Linux input event codes
-                    switch (button)
-                    {
-                        case 1:  // Left button
-                            mouseEvent->type = EV_KEY;
-                            mouseEvent->code = BTN_LEFT;
-                            mouseEvent->button = static_cast<int>(MouseButton::Left);
-                            mouseEvent->flag = 0;
-                            break;
-                        case 2:  // Middle button
-                            mouseEvent->type = EV_KEY;
-                            mouseEvent->code = BTN_MIDDLE;
-                            mouseEvent->button = static_cast<int>(MouseButton::Middle);
-                            mouseEvent->flag = 0;
-                            break;
-                        case 3:  // Right button
-                            mouseEvent->type = EV_KEY;
-                            mouseEvent->code = BTN_RIGHT;
-                            mouseEvent->button = static_cast<int>(MouseButton::Right);
-                            mouseEvent->flag = 0;
-                            break;
-                        case 4:  // Wheel up
-                            mouseEvent->type = EV_REL;
-                            mouseEvent->code = REL_WHEEL;
-                            mouseEvent->value = 1;
-                            mouseEvent->button = static_cast<int>(MouseButton::WheelVertical);
-                            mouseEvent->flag = 1;
-                            break;
-                        case 5:  // Wheel down
-                            mouseEvent->type = EV_REL;
-                            mouseEvent->code = REL_WHEEL;
-                            mouseEvent->value = -1;
-                            mouseEvent->button = static_cast<int>(MouseButton::WheelVertical);
-                            mouseEvent->flag = -1;
-                            break;
-                        case 6:  // Wheel left
-                            mouseEvent->type = EV_REL;
-                            mouseEvent->code = REL_HWHEEL;
-                            mouseEvent->value = -1;
-                            mouseEvent->button = static_cast<int>(MouseButton::WheelHorizontal);
-                            mouseEvent->flag = -1;
-                            break;
-                        case 7:  // Wheel right
-                            mouseEvent->type = EV_REL;
-                            mouseEvent->code = REL_HWHEEL;
-                            mouseEvent->value = 1;
-                            mouseEvent->button = static_cast<int>(MouseButton::WheelHorizontal);
-                            mouseEvent->flag = 1;
-                            break;
-                        case 8:  // Back button
-                            mouseEvent->type = EV_KEY;
-                            mouseEvent->code = BTN_BACK;
-                            mouseEvent->button = static_cast<int>(MouseButton::Back);
-                            mouseEvent->flag = 0;
-                            break;
-                        case 9:  // Forward button
-                            mouseEvent->type = EV_KEY;
-                            mouseEvent->code = BTN_FORWARD;
-                            mouseEvent->button = static_cast<int>(MouseButton::Forward);
-                            mouseEvent->flag = 0;
-                            break;
-                        default:
-                            mouseEvent->type = EV_KEY;
-                            mouseEvent->code = button;
-                            mouseEvent->button = static_cast<int>(MouseButton::Unknown);
-                            mouseEvent->flag = 0;
-                            break;
-                    }
+                    // The event's root coordinates are not decoded: use the actual mouse position
+                    mouseEvent->pos = GetCurrentMousePosition();
 
                     mouse_callback(callback_context, mouseEvent);
                 }
@@ -703,10 +1213,9 @@ void X11Protocol::ProcessXRecordData(XRecordInterceptData *data)
             {
                 if (keyboard_callback)
                 {
-                    // Extract X11 keycode from protocol data and convert to Linux keycode
-                    unsigned char x11_keycode = event_data[1];
-                    unsigned int linux_keycode = (x11_keycode >= 8) ? (x11_keycode - 8) : x11_keycode;
-                    bool is_press = (event_type == KeyPress);
+                    // Convert the X11 keycode from the protocol data to a Linux keycode
+                    unsigned int linux_keycode = X11KeycodeToLinux(inputEvent.detail);
+                    bool is_press = (inputEvent.type == KeyPress);
 
                     // Update modifier key state
                     modifier_state.UpdateFromKeyCode(linux_keycode, is_press);
@@ -733,76 +1242,543 @@ void X11Protocol::ProcessXRecordData(XRecordInterceptData *data)
     XRecordFreeData(data);
 }
 
-// XFixes helper methods implementation
-bool X11Protocol::InitializeXFixes()
+// XI2 smooth-scroll helper methods implementation
+bool X11Protocol::InitializeXI2()
 {
-    // Open a dedicated Display connection for XFixes (separate from XRecord)
-    xfixes_display = XOpenDisplay(nullptr);
-    if (!xfixes_display)
-    {
-        fprintf(stderr, "[XFixes] Failed to open dedicated Display connection\n");
+    // Open a dedicated Display connection for XI2 (owned by the XI2 thread)
+    xi2_display = OpenDisplay();
+    if (!xi2_display)
         return false;
-    }
 
-    // Check if XFixes extension is available
-    if (!XFixesQueryExtension(xfixes_display, &xfixes_event_base, &xfixes_error_base))
+    // Smooth scrolling (scroll classes, XIPointerEmulated) needs XInput >= 2.1
+    int event_base = 0, error_base = 0;
+    int major = 2, minor = 1;
+    if (!XQueryExtension(xi2_display, "XInputExtension", &xi2_opcode, &event_base, &error_base) ||
+        XIQueryVersion(xi2_display, &major, &minor) != Success || major < 2 || (major == 2 && minor < 1))
     {
-        fprintf(stderr, "[XFixes] XFixes extension not available\n");
-        XCloseDisplay(xfixes_display);
-        xfixes_display = nullptr;
+        XCloseDisplay(xi2_display);
+        xi2_display = nullptr;
         return false;
     }
 
-    // Query XFixes version (need >= 2.0 for selection events)
-    int major = 0, minor = 0;
-    XFixesQueryVersion(xfixes_display, &major, &minor);
-    if (major < 2)
+    Window xi2_root = DefaultRootWindow(xi2_display);
+
+    // Raw events of the master devices (sourceid names the slave), device changes of all devices
+    unsigned char raw_bits[XIMaskLen(XI_LASTEVENT)] = {};
+    XISetMask(raw_bits, XI_RawMotion);
+    XISetMask(raw_bits, XI_RawButtonPress);
+    if (xi2_input)
     {
-        fprintf(stderr, "[XFixes] XFixes version %d.%d too old (need >= 2.0)\n", major, minor);
-        XCloseDisplay(xfixes_display);
-        xfixes_display = nullptr;
-        return false;
+        XISetMask(raw_bits, XI_RawButtonRelease);
+        XISetMask(raw_bits, XI_RawKeyPress);
+        XISetMask(raw_bits, XI_RawKeyRelease);
     }
 
-    // Subscribe to PRIMARY selection owner changes on root window
-    Window xfixes_root = DefaultRootWindow(xfixes_display);
-    Atom primary = XInternAtom(xfixes_display, "PRIMARY", False);
-    XFixesSelectSelectionInput(xfixes_display, xfixes_root, primary, XFixesSetSelectionOwnerNotifyMask);
-    XFlush(xfixes_display);
+    unsigned char device_bits[XIMaskLen(XI_LASTEVENT)] = {};
+    XISetMask(device_bits, XI_HierarchyChanged);
+    XISetMask(device_bits, XI_DeviceChanged);
 
-    xfixes_initialized = true;
+    XIEventMask masks[2];
+    masks[0].deviceid = XIAllMasterDevices;
+    masks[0].mask_len = sizeof(raw_bits);
+    masks[0].mask = raw_bits;
+    masks[1].deviceid = XIAllDevices;
+    masks[1].mask_len = sizeof(device_bits);
+    masks[1].mask = device_bits;
+    XISelectEvents(xi2_display, xi2_root, masks, 2);
+    XSync(xi2_display, False);
+
+    RefreshXI2ScrollValuators();
+    RefreshXI2ButtonMap();
+
+    xi2_initialized = true;
     return true;
 }
 
-void X11Protocol::CleanupXFixes()
+void X11Protocol::CleanupXI2()
 {
-    if (xfixes_display)
+    if (xi2_display)
     {
-        XCloseDisplay(xfixes_display);
-        xfixes_display = nullptr;
+        XCloseDisplay(xi2_display);
+        xi2_display = nullptr;
     }
-    xfixes_initialized = false;
+
+    xi2_scroll_valuators.clear();
+    xi2_button_map.clear();
+    double vertical, horizontal;
+    xi2_scroll_frame.Take(vertical, horizontal);
+    xi2_initialized = false;
+    xi2_input = false;
 }
 
-void X11Protocol::XFixesMonitoringThreadProc()
+// Rebuild the scroll valuators of all slave pointers and the XTEST slave ids (at startup and on
+// device changes)
+void X11Protocol::RefreshXI2ScrollValuators()
 {
-    if (!xfixes_display || !xfixes_initialized)
-        return;
+    xi2_scroll_valuators.clear();
+    xi2_xtest_devices.clear();
 
-    int x11_fd = ConnectionNumber(xfixes_display);
+    int count = 0;
+    XIDeviceInfo *devices = XIQueryDevice(xi2_display, XIAllDevices, &count);
+    if (!devices)
+        return;
 
-    while (xfixes_monitoring_running)
+    for (int i = 0; i < count; i++)
+    {
+        const XIDeviceInfo &device = devices[i];
+        if (device.use != XISlavePointer && device.use != XISlaveKeyboard && device.use != XIFloatingSlave)
+            continue;
+
+        // "Virtual core XTEST pointer/keyboard" and the XTEST slaves of other masters
+        if (device.name && strstr(device.name, "XTEST"))
+            xi2_xtest_devices.push_back(device.deviceid);
+
+        if (device.use == XISlaveKeyboard)
+            continue;
+
+        std::vector<ScrollValuator> valuators;
+        for (int c = 0; c < device.num_classes; c++)
+        {
+            if (device.classes[c]->type != XIScrollClass)
+                continue;
+
+            const XIScrollClassInfo *scroll = reinterpret_cast<const XIScrollClassInfo *>(device.classes[c]);
+            ScrollValuator valuator;
+            valuator.number = scroll->number;
+            valuator.horizontal = (scroll->scroll_type == XIScrollTypeHorizontal);
+            valuator.increment = scroll->increment;
+
+            // The valuator class of the same number tells whether it reports positions
+            for (int v = 0; v < device.num_classes; v++)
+            {
+                if (device.classes[v]->type != XIValuatorClass)
+                    continue;
+
+                const XIValuatorClassInfo *info = reinterpret_cast<const XIValuatorClassInfo *>(device.classes[v]);
+                if (info->number == scroll->number)
+                    valuator.absolute = (info->mode == XIModeAbsolute);
+            }
+
+            valuators.push_back(valuator);
+        }
+
+        if (!valuators.empty())
+            xi2_scroll_valuators[device.deviceid] = std::move(valuators);
+    }
+
+    XIFreeDeviceInfo(devices);
+}
+
+// Reload the core pointer button mapping (at startup and on MappingNotify)
+void X11Protocol::RefreshXI2ButtonMap()
+{
+    unsigned char map[256];
+    int count = XGetPointerMapping(xi2_display, map, sizeof(map));
+    xi2_button_map.assign(map, map + std::max(count, 0));
+}
+
+bool X11Protocol::IsXI2XTestDevice(int device) const
+{
+    return std::find(xi2_xtest_devices.begin(), xi2_xtest_devices.end(), device) != xi2_xtest_devices.end();
+}
+
+void X11Protocol::XI2MonitoringThreadProc()
+{
+    if (!xi2_display || !xi2_initialized)
+        return;
+
+    ApplyThreadScheduling("sh-xi2", &thread_scheduling);
+
+    int x11_fd = ConnectionNumber(xi2_display);
+
+    while (xi2_monitoring_running)
+    {
+        ProcessXI2Events();
+
+        // Deliver the scroll frame once it is due; otherwise wait for events until it is,
+        // or 200ms for the shutdown check
+        int64_t due_ms = xi2_scroll_frame.MsUntilDue(SteadyMs());
+        if (due_ms == 0)
+        {
+            FlushXI2ScrollFrame();
+            continue;
+        }
+
+        fd_set read_fds;
+        FD_ZERO(&read_fds);
+        FD_SET(x11_fd, &read_fds);
+
+        struct timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = (due_ms > 0 ? due_ms : 200) * 1000;
+
+        int ret = select(x11_fd + 1, &read_fds, nullptr, nullptr, &timeout);
+        if (ret < 0 && errno != EINTR)
+            break;
+    }
+}
+
+/**
+ * Drain the queued XI2 events into the scroll frame, and with the XI2 backend deliver
+ * buttons and keys, and one motion event for all pointer motion read at once.
+ * Runs on the XI2 thread.
+ */
+void X11Protocol::ProcessXI2Events()
+{
+    int motion_device = 0;
+    Time motion_time = 0;
+
+    while (XPending(xi2_display))
+    {
+        XEvent event;
+        XNextEvent(xi2_display, &event);
+
+        // Sent to every client: the raw buttons are mapped with the core pointer mapping
+        if (event.type == MappingNotify)
+        {
+            if (event.xmapping.request == MappingPointer)
+                RefreshXI2ButtonMap();
+            continue;
+        }
+
+        XGenericEventCookie *cookie = &event.xcookie;
+        if (cookie->type != GenericEvent || cookie->extension != xi2_opcode || !XGetEventData(xi2_display, cookie))
+            continue;
+
+        switch (cookie->evtype)
+        {
+            case XI_RawMotion:
+            {
+                const XIRawEvent *raw = static_cast<const XIRawEvent *>(cookie->data);
+
+                // Pointer motion moves valuator 0 (x) or 1 (y); scroll valuators alone do not
+                bool moved = raw->valuators.mask_len > 0 &&
+                             (XIMaskIsSet(raw->valuators.mask, 0) || XIMaskIsSet(raw->valuators.mask, 1));
+                if (xi2_input && moved)
+                {
+                    motion_device = raw->sourceid;
+                    motion_time = raw->time;
+                }
+
+                auto it = xi2_scroll_valuators.find(raw->sourceid);
+                if (it == xi2_scroll_valuators.end())
+                    break;
+
+                // values holds one entry per set mask bit, in valuator order
+                uint64_t now = SteadyMs();
+                const double *value = raw->valuators.values;
+                for (int number = 0; number < raw->valuators.mask_len * 8; number++)
+                {
+                    if (!XIMaskIsSet(raw->valuators.mask, number))
+                        continue;
+
+                    for (ScrollValuator &valuator : it->second)
+                    {
+                        if (valuator.number == number)
+                            xi2_scroll_frame.Add(valuator.horizontal, ScrollValuatorNotches(valuator, *value), now);
+                    }
+                    value++;
+                }
+                break;
+            }
+            case XI_RawButtonPress:
+            case XI_RawButtonRelease:
+            {
+                const XIRawEvent *raw = static_cast<const XIRawEvent *>(cookie->data);
+
+                // Synthetic clicks come from the XTEST slaves
+                if (input_device_filter.excludeXTest && IsXI2XTestDevice(raw->sourceid))
+                    break;
+
+                ProcessXI2Button(raw, cookie->evtype == XI_RawButtonPress);
+                break;
+            }
+            case XI_RawKeyPress:
+            case XI_RawKeyRelease:
+            {
+                const XIRawEvent *raw = static_cast<const XIRawEvent *>(cookie->data);
+                if (input_device_filter.excludeXTest && IsXI2XTestDevice(raw->sourceid))
+                    break;
+
+                ProcessXI2Key(raw, cookie->evtype == XI_RawKeyPress);
+                break;
+            }
+            case XI_HierarchyChanged:
+            case XI_DeviceChanged:
+                RefreshXI2ScrollValuators();
+                break;
+            default:
+                break;
+        }
+
+        XFreeEventData(xi2_display, cookie);
+    }
+
+    if (motion_device && !(input_device_filter.excludeXTest && IsXI2XTestDevice(motion_device)))
+        ProcessXI2Motion(motion_device, motion_time);
+}
+
+// Raw button event: wheel buttons go to the scroll frame, other buttons are delivered with the XI2 backend
+void X11Protocol::ProcessXI2Button(const XIRawEvent *raw, bool press)
+{
+    unsigned char button = static_cast<unsigned char>(raw->detail);
+    if (button >= 1 && static_cast<size_t>(button) <= xi2_button_map.size())
+        button = xi2_button_map[button - 1];
+
+    // Wheel buttons emulated from scroll valuators are already counted from the valuators;
+    // devices without scroll valuators still report real button clicks
+    if (IsX11WheelButton(button))
+    {
+        if (press && !(raw->flags & XIPointerEmulated))
+        {
+            MouseEventContext wheel;
+            MapX11ButtonToMouseEvent(button, true, wheel);
+            xi2_scroll_frame.Add(wheel.code == REL_HWHEEL, wheel.value, SteadyMs());
+        }
+        return;
+    }
+
+    // A button mapped to 0 is disabled
+    if (!xi2_input || button == 0 || !mouse_callback)
+        return;
+
+    // Suspended: drop the event, as the XRecord thread does
+    if (IsInputSuspended())
+    {
+        modifier_state = ModifierState();
+        return;
+    }
+
+    MouseEventContext *mouseEvent = new MouseEventContext();
+    MapX11ButtonToMouseEvent(button, press, *mouseEvent);
+    mouseEvent->pos = QueryXI2Pointer();
+    mouseEvent->device = raw->sourceid;
+    mouseEvent->time = static_cast<uint32_t>(raw->time);
+
+    mouse_callback(callback_context, mouseEvent);
+}
+
+// Raw key event (XI2 backend): the detail is the X11 keycode, as in XRecord's core events
+void X11Protocol::ProcessXI2Key(const XIRawEvent *raw, bool press)
+{
+    if (!xi2_input || !keyboard_callback)
+        return;
+
+    if (IsInputSuspended())
+    {
+        modifier_state = ModifierState();
+        return;
+    }
+
+    unsigned int linux_keycode = X11KeycodeToLinux(static_cast<unsigned char>(raw->detail));
+    modifier_state.UpdateFromKeyCode(linux_keycode, press);
+
+    KeyboardEventContext *keyboardEvent = new KeyboardEventContext();
+    keyboardEvent->type = EV_KEY;
+    keyboardEvent->code = linux_keycode;
+    keyboardEvent->value = press ? 1 : 0;
+    keyboardEvent->flags = modifier_state.GetFlags();
+    keyboardEvent->device = raw->sourceid;
+    keyboardEvent->time = static_cast<uint32_t>(raw->time);
+
+    keyboard_callback(callback_context, keyboardEvent);
+}
+
+// Pointer motion (XI2 backend): raw events carry no position, so the pointer is queried once for
+// all motion read at once rather than once per event
+void X11Protocol::ProcessXI2Motion(int device, Time time)
+{
+    if (!mouse_callback || IsInputSuspended())
+        return;
+
+    MouseEventContext *mouseEvent = new MouseEventContext();
+    mouseEvent->type = EV_REL;
+    mouseEvent->code = REL_X;
+    mouseEvent->value = 0;
+    mouseEvent->pos = QueryXI2Pointer();
+    mouseEvent->button = static_cast<int>(MouseButton::None);
+    mouseEvent->flag = 0;
+    mouseEvent->device = device;
+    mouseEvent->time = static_cast<uint32_t>(time);
+
+    mouse_callback(callback_context, mouseEvent);
+}
+
+// Query the pointer on the XI2 connection, which the XI2 thread owns
+Point X11Protocol::QueryXI2Pointer()
+{
+    Window root_return, child_return;
+    int root_x, root_y, win_x, win_y;
+    unsigned int mask_return;
+    if (XQueryPointer(xi2_display, DefaultRootWindow(xi2_display), &root_return, &child_return, &root_x, &root_y,
+                      &win_x, &win_y, &mask_return))
+    {
+        return Point(root_x, root_y);
+    }
+
+    return Point();
+}
+
+// Deliver the summed notches of the frame as one wheel event per axis
+void X11Protocol::FlushXI2ScrollFrame()
+{
+    double vertical, horizontal;
+    xi2_scroll_frame.Take(vertical, horizontal);
+
+    // While suspended the raw events are still read to keep absolute valuators current, but not delivered
+    if (!mouse_callback || IsInputSuspended())
+        return;
+
+    Point pos = QueryXI2Pointer();
+
+    const struct
+    {
+        double notches;
+        int code;
+        MouseButton button;
+    } axes[] = {{vertical, REL_WHEEL, MouseButton::WheelVertical},
+                {horizontal, REL_HWHEEL, MouseButton::WheelHorizontal}};
+
+    for (const auto &axis : axes)
+    {
+        if (axis.notches == 0)
+            continue;
+
+        int direction = axis.notches > 0 ? 1 : -1;
+
+        MouseEventContext *mouseEvent = new MouseEventContext();
+        mouseEvent->type = EV_REL;
+        mouseEvent->code = axis.code;
+        mouseEvent->value = direction;
+        mouseEvent->pos = pos;
+        mouseEvent->button = static_cast<int>(axis.button);
+        mouseEvent->flag = direction;
+        mouseEvent->delta = axis.notches;
+
+        mouse_callback(callback_context, mouseEvent);
+    }
+}
+
+// XFixes helper methods implementation
+bool X11Protocol::InitializeXFixes()
+{
+    // Open a dedicated Display connection for XFixes (separate from XRecord)
+    xfixes_display = OpenDisplay();
+    if (!xfixes_display)
+    {
+        LogMessage(LogLevel::Error, "[XFixes] Failed to open dedicated Display connection");
+        return false;
+    }
+
+    // Check if XFixes extension is available
+    if (!XFixesQueryExtension(xfixes_display, &xfixes_event_base, &xfixes_error_base))
+    {
+        LogMessage(LogLevel::Error, "[XFixes] XFixes extension not available");
+        XCloseDisplay(xfixes_display);
+        xfixes_display = nullptr;
+        return false;
+    }
+
+    // Query XFixes version (need >= 2.0 for selection events)
+    int major = 0, minor = 0;
+    XFixesQueryVersion(xfixes_display, &major, &minor);
+    if (major < 2)
+    {
+        LogMessage(LogLevel::Error, "[XFixes] XFixes version %d.%d too old (need >= 2.0)", major, minor);
+        XCloseDisplay(xfixes_display);
+        xfixes_display = nullptr;
+        return false;
+    }
+
+    xfixes_primary_atom = XInternAtom(xfixes_display, "PRIMARY", False);
+    xfixes_clipboard_atom = XInternAtom(xfixes_display, "CLIPBOARD", False);
+    xfixes_targets_atom = XInternAtom(xfixes_display, "TARGETS", False);
+    xfixes_utf8_atom = XInternAtom(xfixes_display, "UTF8_STRING", False);
+    xfixes_text_atom = XInternAtom(xfixes_display, "TEXT", False);
+
+    // Subscribe to PRIMARY selection owner changes on root window
+    Window xfixes_root = DefaultRootWindow(xfixes_display);
+    XFixesSelectSelectionInput(xfixes_display, xfixes_root, xfixes_primary_atom, XFixesSetSelectionOwnerNotifyMask);
+
+    // Subscribe to CLIPBOARD owner changes (confirms the clipboard fallback's Ctrl+C)
+    XFixesSelectSelectionInput(xfixes_display, xfixes_root, xfixes_clipboard_atom, XFixesSetSelectionOwnerNotifyMask);
+
+    // Window that owns CLIPBOARD while serving restored content after a fallback
+    clipboard_owner_window = XCreateSimpleWindow(xfixes_display, xfixes_root, 0, 0, 1, 1, 0, 0, 0);
+
+    if (fullscreen_callback)
+        InitializeFullscreenTracking();
+    XFlush(xfixes_display);
+
+    // Wake pipe for restore requests from the main thread
+    if (pipe2(clipboard_wake_fds, O_CLOEXEC | O_NONBLOCK) < 0)
+    {
+        clipboard_wake_fds[0] = -1;
+        clipboard_wake_fds[1] = -1;
+    }
+
+    xfixes_initialized = true;
+    return true;
+}
+
+void X11Protocol::CleanupXFixes()
+{
+    if (xfixes_display)
+    {
+        // Closing the connection also destroys clipboard_owner_window (and drops ownership)
+        if (net_active_window_atom != X11_None)
+            IgnoreBadWindowErrors(xfixes_display, false);
+        XCloseDisplay(xfixes_display);
+        xfixes_display = nullptr;
+    }
+    clipboard_owner_window = 0;
+    net_active_window_atom = X11_None;
+    fullscreen_window = 0;
+    fullscreen_reported = false;
+    fullscreen_program.clear();
+
+    for (int &fd : clipboard_wake_fds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(clipboard_mutex);
+        clipboard_restore_text.clear();
+        clipboard_restore_pending = false;
+    }
+
+    xfixes_initialized = false;
+}
+
+void X11Protocol::XFixesMonitoringThreadProc()
+{
+    if (!xfixes_display || !xfixes_initialized)
+        return;
+
+    ApplyThreadScheduling("sh-xfixes", &thread_scheduling);
+
+    int x11_fd = ConnectionNumber(xfixes_display);
+    int wake_fd = clipboard_wake_fds[0];
+
+    while (xfixes_monitoring_running)
     {
         // Use select() with 200ms timeout for shutdown check
         fd_set read_fds;
         FD_ZERO(&read_fds);
         FD_SET(x11_fd, &read_fds);
+        if (wake_fd >= 0)
+            FD_SET(wake_fd, &read_fds);
 
         struct timeval timeout;
         timeout.tv_sec = 0;
         timeout.tv_usec = 200000;  // 200ms
 
-        int ret = select(x11_fd + 1, &read_fds, nullptr, nullptr, &timeout);
+        int ret = select(std::max(x11_fd, wake_fd) + 1, &read_fds, nullptr, nullptr, &timeout);
         if (ret < 0)
         {
             // Error
@@ -814,52 +1790,549 @@ void X11Protocol::XFixesMonitoringThreadProc()
         if (ret == 0)
             continue;  // Timeout, check running flag
 
-        // Process all pending X events
-        while (XPending(xfixes_display))
+        // Clipboard restore request from the main thread (clipboard fallback)
+        if (wake_fd >= 0 && FD_ISSET(wake_fd, &read_fds))
         {
-            XEvent event;
-            XNextEvent(xfixes_display, &event);
-
-            // Check if this is an XFixes SelectionNotify event
-            if (event.type == xfixes_event_base + XFixesSelectionNotify)
+            char drain[16];
+            while (read(wake_fd, drain, sizeof(drain)) > 0)
             {
-                XFixesSelectionNotifyEvent *sel_event = (XFixesSelectionNotifyEvent *)&event;
+            }
+            ProcessClipboardRestoreRequest();
+        }
 
-                // Only handle SetSelectionOwner notifications
-                if (sel_event->subtype == XFixesSetSelectionOwnerNotify)
-                {
-                    // Skip deselection events (owner released PRIMARY selection).
-                    // These carry no useful text data and can cause false matches
-                    // in Path A correlation when an app clears its selection
-                    // before setting a new one (e.g., double-click in konsole).
-                    if (sel_event->owner == X11_None)
-                        continue;
+        // Process all pending X events
+        ProcessXFixesEvents();
+    }
 
-                    // Get current time in milliseconds
-                    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                   std::chrono::system_clock::now().time_since_epoch())
-                                   .count();
+    // Thread is exiting — unblock a clipboard fallback waiting for an owner change
+    clipboard_cv.notify_all();
+}
 
-                    // Create selection change context and dispatch via callback
-                    SelectionChangeContext *ctx = new SelectionChangeContext();
-                    ctx->timestamp_ms = static_cast<uint64_t>(now);
+/**
+ * Read the connections on the event reactor instead of the XRecord, XI2 and XFixes threads.
+ * Called by StartInputMonitoring() once the running flags are set.
+ */
+bool X11Protocol::WatchOnReactor()
+{
+    // Asynchronous: the data is read by XRecordProcessReplies() when the connection is readable
+    if (input_monitoring_running &&
+        (!XRecordEnableContextAsync(record_display, record_context, XRecordDataCallback, (XPointer)this) ||
+         !event_reactor->Add(ConnectionNumber(record_display), &X11Protocol::OnXRecordReadable, this)))
+    {
+        LogMessage(LogLevel::Error, "[XRecord] Failed to enable the context on the event reactor");
+        return false;
+    }
 
-                    if (selection_callback && callback_context)
-                    {
-                        selection_callback(callback_context, ctx);
-                    }
-                    else
+    if (xi2_monitoring_running &&
+        !event_reactor->Add(ConnectionNumber(xi2_display), &X11Protocol::OnXI2Readable, this))
+        return false;
+
+    if (xfixes_monitoring_running && !xfixes_in_loop)
+    {
+        if (!event_reactor->Add(ConnectionNumber(xfixes_display), &X11Protocol::OnXFixesReadable, this))
+            return false;
+        if (clipboard_wake_fds[0] >= 0 &&
+            !event_reactor->Add(clipboard_wake_fds[0], &X11Protocol::OnClipboardWake, this))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Stop reading the connections on the event reactor; waits for a running handler
+ */
+void X11Protocol::UnwatchOnReactor()
+{
+    if (xfixes_display)
+        event_reactor->Remove(ConnectionNumber(xfixes_display));
+    if (clipboard_wake_fds[0] >= 0)
+        event_reactor->Remove(clipboard_wake_fds[0]);
+    if (xi2_display)
+        event_reactor->Remove(ConnectionNumber(xi2_display));
+    if (record_display)
+        event_reactor->Remove(ConnectionNumber(record_display));
+
+    // In place of the exiting XFixes thread: unblock a clipboard fallback waiting for an owner change
+    clipboard_cv.notify_all();
+}
+
+int64_t X11Protocol::OnXRecordReadable(void *context)
+{
+    X11Protocol *self = static_cast<X11Protocol *>(context);
+    XRecordProcessReplies(self->record_display);
+    return -1;
+}
+
+int64_t X11Protocol::OnXI2Readable(void *context)
+{
+    X11Protocol *self = static_cast<X11Protocol *>(context);
+    self->ProcessXI2Events();
+
+    // Deliver the scroll frame once it is due; otherwise be invoked again when it is
+    int64_t due_ms = self->xi2_scroll_frame.MsUntilDue(SteadyMs());
+    if (due_ms != 0)
+        return due_ms;
+
+    self->FlushXI2ScrollFrame();
+    return -1;
+}
+
+int64_t X11Protocol::OnXFixesReadable(void *context)
+{
+    static_cast<X11Protocol *>(context)->ProcessXFixesEvents();
+    return -1;
+}
+
+// Clipboard restore request from the main thread (clipboard fallback)
+int64_t X11Protocol::OnClipboardWake(void *context)
+{
+    X11Protocol *self = static_cast<X11Protocol *>(context);
+
+    char drain[16];
+    while (read(self->clipboard_wake_fds[0], drain, sizeof(drain)) > 0)
+    {
+    }
+    self->ProcessClipboardRestoreRequest();
+
+    // Events read into the queue by the restore's round trips don't make the connection readable
+    self->ProcessXFixesEvents();
+    return -1;
+}
+
+/**
+ * Drain and handle all queued XFixes connection events.
+ * Runs on the XFixes thread, or on the host event loop in in-loop mode.
+ */
+void X11Protocol::ProcessXFixesEvents()
+{
+    while (XPending(xfixes_display))
+    {
+        XEvent event;
+        XNextEvent(xfixes_display, &event);
+
+        // Fullscreen tracking: focus moved to another window, or the active window's state changed
+        if (event.type == PropertyNotify)
+        {
+            if (event.xproperty.atom == net_active_window_atom &&
+                event.xproperty.window == DefaultRootWindow(xfixes_display))
+                WatchActiveWindow();
+            else if (event.xproperty.atom == net_wm_state_atom && event.xproperty.window == fullscreen_window)
+                UpdateFullscreenState();
+            continue;
+        }
+
+        // Requests for the restored clipboard content
+        if (event.type == SelectionRequest)
+        {
+            ServeClipboardRequest(event.xselectionrequest);
+            continue;
+        }
+
+        // Lost CLIPBOARD ownership — the restored content is no longer needed
+        if (event.type == SelectionClear)
+        {
+            if (event.xselectionclear.window == clipboard_owner_window)
+            {
+                std::lock_guard<std::mutex> lock(clipboard_mutex);
+                clipboard_restore_text.clear();
+            }
+            continue;
+        }
+
+        // Check if this is an XFixes SelectionNotify event
+        if (event.type == xfixes_event_base + XFixesSelectionNotify)
+        {
+            XFixesSelectionNotifyEvent *sel_event = (XFixesSelectionNotifyEvent *)&event;
+
+            // CLIPBOARD owner changes only confirm the clipboard fallback's Ctrl+C.
+            // Our own ownership (restoring content) and clears are not copies.
+            if (sel_event->selection == xfixes_clipboard_atom)
+            {
+                if (sel_event->subtype == XFixesSetSelectionOwnerNotify && sel_event->owner != X11_None &&
+                    sel_event->owner != clipboard_owner_window)
+                {
                     {
-                        delete ctx;
+                        std::lock_guard<std::mutex> lock(clipboard_mutex);
+                        clipboard_owner_serial++;
                     }
+                    clipboard_cv.notify_all();
+                }
+                continue;
+            }
+
+            // Only handle SetSelectionOwner notifications
+            if (sel_event->subtype == XFixesSetSelectionOwnerNotify)
+            {
+                // Any PRIMARY owner change, deselection included, stales the cached text
+                primary_owner_serial++;
+
+                // Skip deselection events (owner released PRIMARY selection).
+                // These carry no useful text data and can cause false matches
+                // in Path A correlation when an app clears its selection
+                // before setting a new one (e.g., double-click in konsole).
+                if (sel_event->owner == X11_None)
+                    continue;
+
+                // Get current time in milliseconds
+                auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+
+                // Create selection change context and dispatch via callback
+                SelectionChangeContext *ctx = new SelectionChangeContext();
+                ctx->timestamp_ms = static_cast<uint64_t>(now);
+                ctx->owner = static_cast<uint64_t>(sel_event->owner);
+
+                if (selection_callback && callback_context)
+                {
+                    selection_callback(callback_context, ctx);
+                }
+                else
+                {
+                    delete ctx;
                 }
             }
         }
     }
 }
 
+/**
+ * Start watching the active window's fullscreen state on the XFixes connection and
+ * report the initial state (host thread, before the XFixes thread starts).
+ */
+void X11Protocol::InitializeFullscreenTracking()
+{
+    net_active_window_atom = XInternAtom(xfixes_display, "_NET_ACTIVE_WINDOW", False);
+    net_wm_state_atom = XInternAtom(xfixes_display, "_NET_WM_STATE", False);
+    net_wm_state_fullscreen_atom = XInternAtom(xfixes_display, "_NET_WM_STATE_FULLSCREEN", False);
+    IgnoreBadWindowErrors(xfixes_display, true);
+
+    XSelectInput(xfixes_display, DefaultRootWindow(xfixes_display), PropertyChangeMask);
+    WatchActiveWindow();
+}
+
+/**
+ * Follow _NET_ACTIVE_WINDOW: watch the new active window's _NET_WM_STATE.
+ * The previous window keeps its event mask, its PropertyNotify events are ignored; deselecting
+ * could fail on a destroyed window and is not worth the round trip.
+ */
+void X11Protocol::WatchActiveWindow()
+{
+    Window active = 0;
+    Atom type;
+    int format;
+    unsigned long nitems, bytes_after;
+    unsigned char *data = nullptr;
+    if (XGetWindowProperty(xfixes_display, DefaultRootWindow(xfixes_display), net_active_window_atom, 0, 1, False,
+                           XA_WINDOW, &type, &format, &nitems, &bytes_after, &data) == Success &&
+        data)
+    {
+        if (nitems == 1)
+            active = *reinterpret_cast<Window *>(data);
+        XFree(data);
+    }
+
+    fullscreen_window = active;
+    if (active)
+        XSelectInput(xfixes_display, active, PropertyChangeMask);
+    UpdateFullscreenState();
+}
+
+/**
+ * Read _NET_WM_STATE of the active window and report a change of its fullscreen state,
+ * or of the program while fullscreen
+ */
+void X11Protocol::UpdateFullscreenState()
+{
+    bool fullscreen = false;
+    if (fullscreen_window)
+    {
+        Atom type;
+        int format;
+        unsigned long nitems, bytes_after;
+        unsigned char *data = nullptr;
+        if (XGetWindowProperty(xfixes_display, fullscreen_window, net_wm_state_atom, 0, 64, False, XA_ATOM, &type,
+                               &format, &nitems, &bytes_after, &data) == Success &&
+            data)
+        {
+            const Atom *states = reinterpret_cast<const Atom *>(data);
+            for (unsigned long i = 0; i < nitems && !fullscreen; i++)
+                fullscreen = (states[i] == net_wm_state_fullscreen_atom);
+            XFree(data);
+        }
+    }
+
+    // The program matters for the keep-running list only while fullscreen
+    std::string program;
+    if (fullscreen)
+        ReadProgramName(xfixes_display, fullscreen_window, program);
+
+    if (fullscreen == fullscreen_reported && program == fullscreen_program)
+        return;
+
+    fullscreen_reported = fullscreen;
+    fullscreen_program = program;
+    if (fullscreen_callback)
+        fullscreen_callback(fullscreen_context, fullscreen, program);
+}
+
+/**
+ * Get selected text via the clipboard (X11 clipboard fallback).
+ *
+ * Flow:
+ * 1. Save the current CLIPBOARD text (no round trip if we already own it)
+ * 2. Synthesize Ctrl+C with XTest
+ * 3. Wait for the XFixes thread (or in-loop dispatch) to observe a CLIPBOARD owner
+ *    change, so latency is bounded by how fast the app copies rather than by a fixed sleep
+ * 4. Read the copied text
+ * 5. Restore the saved text (served by the XFixes thread) or clear CLIPBOARD again
+ *
+ * Only text content is saved and restored. A clipboard that cannot be restored (no text
+ * target, an INCR transfer, or text larger than one request) skips the fallback entirely.
+ */
+bool X11Protocol::GetTextViaClipboard(std::string &text, bool delayRead)
+{
+    if (!display || !xfixes_initialized || !xfixes_monitoring_running)
+        return false;
+
+    // A held Shift/Alt/Super would turn the synthesized chord into a different shortcut
+    if (modifier_state.GetFlags() & (MODIFIER_SHIFT | MODIFIER_ALT | MODIFIER_META))
+        return false;
+
+    KeyCode ctrl_keycode = XKeysymToKeycode(display, XK_Control_L);
+    KeyCode c_keycode = XKeysymToKeycode(display, XK_c);
+    if (!ctrl_keycode || !c_keycode)
+        return false;
+
+    // Step 1: Save the current clipboard text
+    Window previous_owner = XGetSelectionOwner(display, xfixes_clipboard_atom);
+    std::string saved_text;
+    bool has_saved = false;
+    if (previous_owner == clipboard_owner_window)
+    {
+        std::lock_guard<std::mutex> lock(clipboard_mutex);
+        saved_text = clipboard_restore_text;
+        has_saved = !saved_text.empty();
+    }
+    else if (previous_owner != X11_None)
+    {
+        has_saved = ReadSelection("CLIPBOARD", "CLIPBOARD_DATA", saved_text);
+    }
+
+    // Never send Ctrl+C over content that could not be restored afterwards
+    if (previous_owner != X11_None && (!has_saved || saved_text.size() > ClipboardServeLimit()))
+        return false;
+
+    uint64_t serial_before;
+    {
+        std::lock_guard<std::mutex> lock(clipboard_mutex);
+        serial_before = clipboard_owner_serial;
+    }
+
+    // Step 2: Synthesize Ctrl+C (keep a physically held Ctrl untouched)
+    bool ctrl_held = modifier_state.ctrl;
+    if (!ctrl_held)
+        XTestFakeKeyEvent(display, ctrl_keycode, True, CurrentTime);
+    XTestFakeKeyEvent(display, c_keycode, True, CurrentTime);
+    XTestFakeKeyEvent(display, c_keycode, False, CurrentTime);
+    if (!ctrl_held)
+        XTestFakeKeyEvent(display, ctrl_keycode, False, CurrentTime);
+    XFlush(display);
+
+    // Step 3: Wait for the app to take CLIPBOARD ownership
+    bool copied = WaitClipboardOwnerChange(serial_before, CLIPBOARD_COPY_TIMEOUT_MS);
+
+    // Some apps replace the clipboard content several times — wait until it settles
+    if (copied && delayRead)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CLIPBOARD_SETTLE_MAX_MS);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            uint64_t last_serial;
+            {
+                std::lock_guard<std::mutex> lock(clipboard_mutex);
+                last_serial = clipboard_owner_serial;
+            }
+            if (!WaitClipboardOwnerChange(last_serial, CLIPBOARD_SETTLE_QUIET_MS))
+                break;
+        }
+    }
+
+    // Nothing was copied — the clipboard is untouched, nothing to restore
+    if (!copied)
+        return false;
+
+    // Step 4: Read the copied text
+    bool success = ReadSelection("CLIPBOARD", "CLIPBOARD_DATA", text) && !text.empty();
+
+    // Step 5: Restore the previous clipboard
+    RestoreClipboard(has_saved, saved_text);
+
+    return success;
+}
+
+/**
+ * Wait until the CLIPBOARD owner serial moves past `serial` (main thread).
+ * In in-loop mode there is no XFixes thread to observe the owner change, so the
+ * XFixes connection is pumped here until the change arrives or the timeout expires.
+ */
+bool X11Protocol::WaitClipboardOwnerChange(uint64_t serial, int timeoutMs)
+{
+    if (xfixes_in_loop)
+    {
+        int x11_fd = ConnectionNumber(xfixes_display);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+        while (true)
+        {
+            ProcessXFixesEvents();
+            if (clipboard_owner_serial != serial)
+                return true;
+
+            auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                                 deadline - std::chrono::steady_clock::now())
+                                 .count();
+            if (remaining <= 0)
+                return false;
+
+            fd_set read_fds;
+            FD_ZERO(&read_fds);
+            FD_SET(x11_fd, &read_fds);
+
+            struct timeval timeout;
+            timeout.tv_sec = remaining / 1000000;
+            timeout.tv_usec = remaining % 1000000;
+
+            if (select(x11_fd + 1, &read_fds, nullptr, nullptr, &timeout) < 0 && errno != EINTR)
+                return false;
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(clipboard_mutex);
+    return clipboard_cv.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                 [&]
+                                 { return clipboard_owner_serial != serial || !xfixes_monitoring_running.load(); }) &&
+           clipboard_owner_serial != serial;
+}
+
+/**
+ * Restore the clipboard saved by GetTextViaClipboard (main thread).
+ * Saved text is handed to the XFixes thread, which takes CLIPBOARD ownership and
+ * serves it. An empty clipboard is restored by clearing the ownership again.
+ * In in-loop mode the main thread owns the XFixes connection and takes ownership itself.
+ */
+void X11Protocol::RestoreClipboard(bool hasSaved, std::string &savedText)
+{
+    if (!hasSaved || (!xfixes_in_loop && clipboard_wake_fds[1] < 0))
+    {
+        XSetSelectionOwner(display, xfixes_clipboard_atom, X11_None, CurrentTime);
+        XFlush(display);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(clipboard_mutex);
+        clipboard_restore_text = std::move(savedText);
+        clipboard_restore_pending = true;
+    }
+
+    if (xfixes_in_loop)
+    {
+        ProcessClipboardRestoreRequest();
+        return;
+    }
+
+    char wake = 1;
+    if (write(clipboard_wake_fds[1], &wake, 1) < 0)
+    {
+        // Pipe full — a wakeup is already pending
+    }
+}
+
+/**
+ * Take CLIPBOARD ownership for the restored text (XFixes thread).
+ */
+void X11Protocol::ProcessClipboardRestoreRequest()
+{
+    {
+        std::lock_guard<std::mutex> lock(clipboard_mutex);
+        if (!clipboard_restore_pending)
+            return;
+        clipboard_restore_pending = false;
+    }
+
+    XSetSelectionOwner(xfixes_display, xfixes_clipboard_atom, clipboard_owner_window, CurrentTime);
+    XFlush(xfixes_display);
+}
+
+/**
+ * Largest text ServeClipboardRequest can hand out in a single property change.
+ * INCR transfers are not implemented, so GetTextViaClipboard does not fire over larger content.
+ */
+size_t X11Protocol::ClipboardServeLimit()
+{
+    long max_request = XExtendedMaxRequestSize(display);
+    if (max_request == 0)
+        max_request = XMaxRequestSize(display);
+    return static_cast<size_t>(max_request) * 4 - 256;
+}
+
+/**
+ * Answer a SelectionRequest for the restored clipboard text (XFixes thread).
+ * Supports TARGETS, UTF8_STRING, STRING and TEXT. The text fits into a single request:
+ * GetTextViaClipboard only saves content within ClipboardServeLimit().
+ */
+void X11Protocol::ServeClipboardRequest(const XSelectionRequestEvent &request)
+{
+    // Obsolete clients may pass None as the property, meaning "use the target atom"
+    Atom property = (request.property != X11_None) ? request.property : request.target;
+
+    XEvent reply;
+    memset(&reply, 0, sizeof(reply));
+    reply.xselection.type = SelectionNotify;
+    reply.xselection.display = request.display;
+    reply.xselection.requestor = request.requestor;
+    reply.xselection.selection = request.selection;
+    reply.xselection.target = request.target;
+    reply.xselection.time = request.time;
+    reply.xselection.property = X11_None;
+
+    if (request.selection == xfixes_clipboard_atom && request.owner == clipboard_owner_window)
+    {
+        std::lock_guard<std::mutex> lock(clipboard_mutex);
+
+        if (request.target == xfixes_targets_atom)
+        {
+            Atom supported[] = {xfixes_targets_atom, xfixes_utf8_atom, XA_STRING, xfixes_text_atom};
+            XChangeProperty(xfixes_display, request.requestor, property, XA_ATOM, 32, PropModeReplace,
+                            reinterpret_cast<unsigned char *>(supported), 4);
+            reply.xselection.property = property;
+        }
+        else if ((request.target == xfixes_utf8_atom || request.target == XA_STRING ||
+                  request.target == xfixes_text_atom) &&
+                 !clipboard_restore_text.empty())
+        {
+            Atom type = (request.target == XA_STRING) ? XA_STRING : xfixes_utf8_atom;
+            XChangeProperty(xfixes_display, request.requestor, property, type, 8, PropModeReplace,
+                            reinterpret_cast<const unsigned char *>(clipboard_restore_text.data()),
+                            static_cast<int>(clipboard_restore_text.size()));
+            reply.xselection.property = property;
+        }
+    }
+
+    XSendEvent(xfixes_display, request.requestor, False, NoEventMask, &reply);
+    XFlush(xfixes_display);
+}
+
 // Factory function to create X11Protocol instance
 std::unique_ptr<ProtocolBase> CreateX11Protocol()
 {
     return std::make_unique<X11Protocol>();
 }
+
+// Factory function to create the selection-only X11Protocol used by the Wayland hybrid mode
+std::unique_ptr<ProtocolBase> CreateX11SelectionBridge()
+{
+    return std::make_unique<X11Protocol>(true);
+}
@@ -5,10 +5,12 @@
  * on Linux using X11/Wayland libraries.
  *
  * Main components:
- * - TextSelectionHook class: Core implementation of the module
- * - Text selection detection: Primary Selection (X11)
- * - Event monitoring: XRecord (X11), libevdev (Wayland) for input monitoring
- * - Thread management: Background threads for hooks with thread-safe callbacks
+ * - TextSelectionHook class: N-API wrapper around the selection-hook-core engine
+ * - SelectionCore (core/selection_core.h): protocols, gesture detection, correlation
+ * - Event delivery: the core's pollable fd is watched by uv_poll on the Node event
+ *   loop; Dispatch() runs there and callbacks build JS objects directly
+ * - Multiple X11 displays: one core per display, their fds multiplexed through one
+ *   epoll fd and one uv_poll; events are tagged with the display
  *
  * Features:
  * - Detect text selections via mouse drag, double-click, or keyboard
@@ -27,200 +29,33 @@
  */
 
 #include <napi.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <uv.h>
 
 #include <algorithm>
-#include <atomic>
-#include <chrono>
-#include <cmath>
-#include <stdexcept>
+#include <memory>
 #include <string>
-#include <thread>
 #include <vector>
 
 // Standard C headers
 #include <cstdlib>
 #include <cstring>
 
-// Linux system headers
-#include <dirent.h>
-#include <fcntl.h>
-#include <grp.h>
-#include <sys/types.h>
-#include <unistd.h>
-
-// Threading primitives for Path C debounce
-#include <condition_variable>
-#include <mutex>
-
 // Include common definitions
 #include "common.h"
 
-// Keyboard utility for Linux key code conversion
-#include "lib/keyboard.h"
-
-// Utility functions
-#include "lib/utils.h"
-
-/**
- * Factory function to create protocol instances
- */
-std::unique_ptr<ProtocolBase> CreateProtocol(DisplayProtocol protocol)
-{
-    switch (protocol)
-    {
-        case DisplayProtocol::X11:
-            return CreateX11Protocol();
-        case DisplayProtocol::Wayland:
-            return CreateWaylandProtocol();
-        default:
-            return nullptr;
-    }
-}
-
-/**
- * Detect the current display protocol (X11 or Wayland)
- */
-DisplayProtocol DetectDisplayProtocol()
-{
-    // Check for Wayland by looking for WAYLAND_DISPLAY environment variable
-    const char *wayland_display = std::getenv("WAYLAND_DISPLAY");
-    if (wayland_display && strlen(wayland_display) > 0)
-    {
-        return DisplayProtocol::Wayland;
-    }
-
-    // Check for X11 by looking for DISPLAY environment variable
-    const char *x11_display = std::getenv("DISPLAY");
-    if (x11_display && strlen(x11_display) > 0)
-    {
-        return DisplayProtocol::X11;
-    }
-
-    // Default to X11 if neither is clearly set
-    return DisplayProtocol::X11;
-}
-
-/**
- * Detect the running Wayland compositor type.
- *
- * Standalone compositors (Hyprland, sway) set their own environment variables,
- * so we check those first. DE-bundled compositors (KWin, mutter, cosmic-comp)
- * are inferred from XDG_CURRENT_DESKTOP because each DE uses exactly one
- * compositor: KDE→KWin, GNOME→mutter, COSMIC→cosmic-comp.
- */
-CompositorType DetectCompositorType()
-{
-    // 1. Standalone compositors — detected via compositor-specific env vars
-    if (std::getenv("HYPRLAND_INSTANCE_SIGNATURE"))
-        return CompositorType::Hyprland;
-    if (std::getenv("SWAYSOCK"))
-        return CompositorType::Sway;
-
-    // 2. DE-bundled compositors — inferred from XDG_CURRENT_DESKTOP
-    //    (each DE has a 1:1 relationship with its compositor)
-    const char *desktop = std::getenv("XDG_CURRENT_DESKTOP");
-    if (desktop)
-    {
-        std::string desktop_str(desktop);
-        std::transform(desktop_str.begin(), desktop_str.end(), desktop_str.begin(),
-                       [](unsigned char c) { return std::tolower(c); });
-
-        if (desktop_str.find("kde") != std::string::npos)
-            return CompositorType::KWin;  // KDE Plasma → KWin
-        if (desktop_str.find("gnome") != std::string::npos)
-            return CompositorType::Mutter;  // GNOME → mutter
-        if (desktop_str.find("cosmic") != std::string::npos)
-            return CompositorType::CosmicComp;  // COSMIC → cosmic-comp
-        if (desktop_str.find("wlroots") != std::string::npos)
-            return CompositorType::Wlroots;  // Generic wlroots-based
-    }
-
-    return CompositorType::Unknown;
-}
-
-/**
- * Check if the current user can access input devices.
- * X11 uses XRecord (always available). Wayland uses libevdev (/dev/input).
- * For Wayland: checks root > input group > actual device open (covers ACL, capabilities, etc.)
- */
-bool CheckInputDeviceAccess(DisplayProtocol protocol)
-{
-    // X11 uses XRecord for input monitoring — always available
-    if (protocol == DisplayProtocol::X11)
-        return true;
-
-    // Root always has access
-    if (geteuid() == 0)
-        return true;
-
-    // Check input group membership (fast path, no I/O)
-    struct group *grp = getgrnam("input");
-    if (grp)
-    {
-        gid_t input_gid = grp->gr_gid;
-        if (getegid() == input_gid)
-            return true;
-
-        int ngroups = getgroups(0, nullptr);
-        if (ngroups > 0)
-        {
-            std::vector<gid_t> groups(ngroups);
-            if (getgroups(ngroups, groups.data()) >= 0)
-            {
-                for (int i = 0; i < ngroups; i++)
-                {
-                    if (groups[i] == input_gid)
-                        return true;
-                }
-            }
-        }
-    }
-
-    // Fallback: try opening any input device (covers ACL, capabilities, etc.)
-    DIR *dir = opendir("/dev/input");
-    if (dir)
-    {
-        struct dirent *entry;
-        while ((entry = readdir(dir)))
-        {
-            if (strncmp(entry->d_name, "event", 5) == 0)
-            {
-                std::string path = std::string("/dev/input/") + entry->d_name;
-                int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK);
-                if (fd >= 0)
-                {
-                    close(fd);
-                    closedir(dir);
-                    return true;
-                }
-            }
-        }
-        closedir(dir);
-    }
+// Selection engine
+#include "core/selection_core.h"
 
-    return false;
-}
-
-// Mouse&Keyboard hook constants
-constexpr int DEFAULT_MOUSE_EVENT_QUEUE_SIZE = 512;
-constexpr int DEFAULT_KEYBOARD_EVENT_QUEUE_SIZE = 128;
+// Shared X11 input thread of several displays
+#include "lib/event_reactor.h"
 
-// Mouse interaction constants
-constexpr int MIN_DRAG_DISTANCE = 8;
-constexpr uint64_t MAX_DRAG_TIME_MS = 8000;
-constexpr int DOUBLE_CLICK_MAX_DISTANCE = 3;
-static uint64_t DOUBLE_CLICK_TIME_MS = 500;
+// Diagnostic log
+#include "lib/log_ring.h"
 
-// Path A/B correlation window (ms): maximum elapsed time between a mouse gesture
-// and a selection change event for them to be considered related.
-// Total latency includes TSFN dispatch, app processing, and XFixes notification.
-// Some apps (e.g., Konsole) take ~300ms from gesture to XFixes event, so 500ms
-// provides sufficient margin.  On Wayland, data-control events typically arrive
-// within ~50ms after drag end.
-constexpr uint64_t CORRELATION_WINDOW_MS = 500;
-
-// No-input fallback (Path C): debounce quiet period before firing selection event
-constexpr uint64_t NO_INPUT_DEBOUNCE_MS = 200;
+// Selection tag names
+#include "lib/text_classifier.h"
 
 //=============================================================================
 // TextSelectionHook Class Declaration
@@ -240,6 +75,8 @@ class SelectionHook : public Napi::ObjectWrap<SelectionHook>
     void Stop(const Napi::CallbackInfo &info);
     void EnableMouseMoveEvent(const Napi::CallbackInfo &info);
     void DisableMouseMoveEvent(const Napi::CallbackInfo &info);
+    void EnableSelectionChangeEvent(const Napi::CallbackInfo &info);
+    void DisableSelectionChangeEvent(const Napi::CallbackInfo &info);
     void EnableClipboard(const Napi::CallbackInfo &info);
     void DisableClipboard(const Napi::CallbackInfo &info);
     void SetClipboardMode(const Napi::CallbackInfo &info);
@@ -247,163 +84,158 @@ class SelectionHook : public Napi::ObjectWrap<SelectionHook>
     void SetFineTunedList(const Napi::CallbackInfo &info);
     void SetSelectionPassiveMode(const Napi::CallbackInfo &info);
     Napi::Value GetCurrentSelection(const Napi::CallbackInfo &info);
+    Napi::Value GetSelectionSnapshot(const Napi::CallbackInfo &info);
+    void SetSelectionHistory(const Napi::CallbackInfo &info);
+    Napi::Value GetSelectionHistory(const Napi::CallbackInfo &info);
     Napi::Value WriteToClipboard(const Napi::CallbackInfo &info);
     Napi::Value ReadFromClipboard(const Napi::CallbackInfo &info);
     Napi::Value LinuxGetEnvInfo(const Napi::CallbackInfo &info);
-
-    // Core functionality methods
-    bool GetSelectedText(uint64_t window, TextSelectionInfo &selectionInfo);
-    bool GetTextViaPrimary(uint64_t window, TextSelectionInfo &selectionInfo);
-    Napi::Object CreateSelectionResultObject(Napi::Env env, const TextSelectionInfo &selectionInfo);
+    Napi::Value LinuxGetStats(const Napi::CallbackInfo &info);
+    void LinuxSetSelectionInLoop(const Napi::CallbackInfo &info);
+    void LinuxSetTextClassification(const Napi::CallbackInfo &info);
+    void LinuxSetAtspi(const Napi::CallbackInfo &info);
+    void LinuxSetAutoSuspend(const Napi::CallbackInfo &info);
+    void LinuxSetFullscreenSuspend(const Napi::CallbackInfo &info);
+    void LinuxSetThreadScheduling(const Napi::CallbackInfo &info);
+    void LinuxSetInputDeviceFilter(const Napi::CallbackInfo &info);
+    void LinuxSetX11InputBackend(const Napi::CallbackInfo &info);
+    Napi::Value LinuxDrainLog(const Napi::CallbackInfo &info);
+    void LinuxSetLogEvents(const Napi::CallbackInfo &info);
+    Napi::Value InjectTestEvents(const Napi::CallbackInfo &info);
+    Napi::Value IsInjectingTestEvents(const Napi::CallbackInfo &info);
+
+    // Selection engine of one display, the context of its core callbacks
+    struct DisplayCore
+    {
+        SelectionHook *hook = nullptr;
+        std::string name;  // X11 display, empty for the display of the environment
+        std::unique_ptr<SelectionCore> core;
+        // JS strings of the interned program names, indexed by program id; created on first use
+        std::vector<Napi::Reference<Napi::String>> program_name_strings;
+    };
 
     // Helper methods
-    bool IsInFilterList(const std::string &programName, const std::vector<std::string> &filterList);
+    Napi::Object CreateSelectionResultObject(Napi::Env env, DisplayCore &display,
+                                             const TextSelectionInfo &selectionInfo);
+    static Napi::Object CreateLogEntryObject(Napi::Env env, const LogEntry &entry);
+    static Napi::String ProgramNameString(Napi::Env env, DisplayCore &display, uint32_t programId,
+                                          const char *programName);
+    static void SetDisplayTag(Napi::Env env, const DisplayCore &display, Napi::Object resultObj);
+    bool AddDisplayCore(Napi::Env env, const std::string &name);
+    template <typename Fn> void ForEachCore(Fn fn)
+    {
+        for (auto &display : displays)
+            fn(*display->core);
+    }
+    bool IsAnyCoreRunning() const
+    {
+        for (const auto &display : displays)
+        {
+            if (display->core->IsRunning())
+                return true;
+        }
+        return false;
+    }
     void ProcessStringArrayToList(const Napi::Array &array, std::vector<std::string> &targetList);
-
-    // Mouse and keyboard event handling methods
-    static void ProcessMouseEvent(Napi::Env env, Napi::Function function, MouseEventContext *mouseEvent);
-    static void ProcessKeyboardEvent(Napi::Env env, Napi::Function function, KeyboardEventContext *keyboardEvent);
-    static void ProcessSelectionEvent(Napi::Env env, Napi::Function function, SelectionChangeContext *pEvent);
-
-    // Input monitoring callback methods
-    static void OnMouseEventCallback(void *context, MouseEventContext *mouseEvent);
-    static void OnKeyboardEventCallback(void *context, KeyboardEventContext *keyboardEvent);
-    static void OnSelectionEventCallback(void *context, SelectionChangeContext *selectionEvent);
-
-    // Emit text selection event (shared by Path A, Path B, and Path C).
-    // Returns true if the event was successfully emitted, false otherwise.
-    bool EmitSelectionEvent(SelectionDetectType type, Point start, Point end);
-
-    // Protocol interface for X11/Wayland abstraction
-    std::unique_ptr<ProtocolBase> protocol;
-
-    // Cached Linux environment information
-    LinuxEnvInfo env_info;
-
-    // Mouse position tracking
-    Point current_mouse_pos;
-
-    // Mouse state tracking (for selection gesture detection)
-    Point last_mouse_down_pos;
-    // Accurate screen position at mouse-down, obtained by querying the display
-    // server (compositor IPC or XWayland). Unlike last_mouse_down_pos which comes
-    // from the input event (unreliable on Wayland), this provides real screen
-    // coordinates for reporting to consumers. Also used to detect XWayland
-    // position freezing by comparing with the emission-time query.
-    Point queried_mouse_down_pos;
-    uint64_t last_mouse_down_time = 0;
-    Point last_mouse_up_pos;
-    uint64_t last_mouse_up_time = 0;
-    Point prev_mouse_up_pos;  // Previous mouse-up (for shift+click)
-    uint64_t prev_mouse_up_time = 0;
-    uint64_t last_window_handler = 0;
-    WindowRect last_window_rect;
-    bool is_last_valid_click = false;
-    int last_mouse_up_modifier_flags = 0;
-
-    // Atomic timestamp of the last selection change event, written by
-    // OnSelectionEventCallback in the protocol thread, read by
-    // ProcessMouseEvent on the main thread (Path A).
-    std::atomic<uint64_t> last_selection_event_time{0};
-
-    // Gesture button state — written by OnMouseEventCallback (input thread),
-    // read by OnSelectionEventCallback (protocol selection thread).
-    // Tracks BTN_LEFT and BTN_RIGHT (Wayland left-handed support) to suppress
-    // intermediate selection change events during mouse drag.
-    std::atomic<bool> is_gesture_button_down{false};
-
-    // Set when a selection change event arrives while the mouse button is held
-    // (during a drag). Cleared at mouse-down and after consumption at mouse-up.
-    // Allows drag gestures to bypass the 500ms correlation window, since apps
-    // may fire XFixes at drag start rather than at mouse-up.
-    std::atomic<bool> had_selection_during_drag{false};
-
-    // Pending gesture for Path B (selection change event arrives after mouse-up)
-    struct
-    {
-        bool active = false;
-        SelectionDetectType type = SelectionDetectType::None;
-        Point mousePosStart;
-        Point mousePosEnd;
-        uint64_t timestamp = 0;
-    } pending_gesture;
-
-    // No-input fallback (Path C): debounce for Wayland without libevdev
-    bool is_no_input_fallback = false;
-    std::mutex debounce_mutex;
-    std::condition_variable debounce_cv;
-    std::thread debounce_thread;
-    std::atomic<bool> debounce_running{false};
-    std::atomic<uint64_t> debounce_last_event_time{0};
-
-    void DebounceThreadProc();
-
-    // Thread communication
-    Napi::ThreadSafeFunction tsfn;
-    Napi::ThreadSafeFunction mouse_tsfn;
-    Napi::ThreadSafeFunction keyboard_tsfn;
-    Napi::ThreadSafeFunction selection_tsfn;  // For selection change events (Path A/B)
-
-    std::atomic<bool> running{false};
-    std::atomic<bool> mouse_keyboard_running{false};
-
-    // the text selection is processing, we should ignore some events
-    std::atomic<bool> is_processing{false};
-    // user use GetCurrentSelection
-    bool is_triggered_by_user = false;
-
-    bool is_enabled_mouse_move_event = false;
-
-    // passive mode: only trigger when user call GetSelectionText
-    bool is_selection_passive_mode = false;
-
-    // global filter mode
-    FilterMode global_filter_mode = FilterMode::Default;
-    std::vector<std::string> global_filter_list;
+    void CallJsCallback(Napi::Object resultObj);
+
+    // Core callbacks (main thread, inside Dispatch)
+    static void OnSelection(void *context, const TextSelectionInfo &selectionInfo);
+    static void OnMouseEvent(void *context, const CoreMouseEvent &mouseEvent);
+    static void OnKeyboardEvent(void *context, const CoreKeyboardEvent &keyboardEvent);
+    static void OnSelectionChange(void *context, const CoreSelectionChangeEvent &changeEvent);
+    static void OnSuspend(void *context, int reasons);
+    void DeliverLogEntries();
+
+    // Core fd polled on the Node event loop
+    bool StartCorePoll(Napi::Env env);
+    void StopCorePoll();
+    static void OnCorePoll(uv_poll_t *handle, int status, int events);
+
+    // Selection engines (protocols, gesture detection, correlation), one per display. Setters
+    // apply to all; core is the first one, which holds the running state and the shared settings.
+    std::vector<std::unique_ptr<DisplayCore>> displays;
+    SelectionCore *core = nullptr;
+    // Display of the latest input event, read by getCurrentSelection() and the clipboard methods
+    DisplayCore *active_display = nullptr;
+    // epoll set of the core fds with several displays (polled instead of a core fd), else -1
+    int reactor_fd = -1;
+    // With several displays: one thread reading the X11 input and selection connections of all
+    // of them, running while the hook is; else null and each protocol has its own threads
+    std::unique_ptr<EventReactor> input_reactor;
+
+    // JS callback passed to start(); invoked with MakeCallback from the poll callback
+    Napi::FunctionReference callback;
+    Napi::AsyncContext async_context;
+
+    uv_poll_t *core_poll = nullptr;  // non-null while running
+
+    // Deliver diagnostic log entries as "debug" events after each Dispatch()
+    bool log_events = false;
 };
 
 // Static member initialization
 Napi::FunctionReference SelectionHook::constructor;
-// Static pointer for callbacks
-static SelectionHook *currentInstance = nullptr;
 
 /**
  * Constructor - initializes display protocol
+ * Optional argument: X11 display names to monitor instead of the display of the environment
  */
-SelectionHook::SelectionHook(const Napi::CallbackInfo &info) : Napi::ObjectWrap<SelectionHook>(info)
+SelectionHook::SelectionHook(const Napi::CallbackInfo &info)
+    : Napi::ObjectWrap<SelectionHook>(info), async_context(info.Env(), "SelectionHook")
 {
     Napi::Env env = info.Env();
     Napi::HandleScope scope(env);
 
-    currentInstance = this;
+    std::vector<std::string> names;
+    if (info.Length() > 0 && !info[0u].IsUndefined() && !info[0u].IsNull())
+    {
+        if (!info[0u].IsArray())
+        {
+            Napi::TypeError::New(env, "Array of display names expected as first argument")
+                .ThrowAsJavaScriptException();
+            return;
+        }
 
-    // Detect all environment information once at construction time
-    env_info.displayProtocol = DetectDisplayProtocol();
-    env_info.compositorType = DetectCompositorType();
-    env_info.hasInputDeviceAccess = CheckInputDeviceAccess(env_info.displayProtocol);
-    env_info.isRoot = (geteuid() == 0);
+        Napi::Array array = info[0u].As<Napi::Array>();
+        for (uint32_t i = 0; i < array.Length(); i++)
+        {
+            Napi::Value name = array.Get(i);
+            if (!name.IsString() || name.As<Napi::String>().Utf8Value().empty())
+            {
+                Napi::TypeError::New(env, "Display names must be non-empty strings").ThrowAsJavaScriptException();
+                return;
+            }
+            names.push_back(name.As<Napi::String>().Utf8Value());
+        }
+    }
+    if (names.empty())
+        names.emplace_back();
 
-    protocol = CreateProtocol(env_info.displayProtocol);
-    if (!protocol)
+    if (names.size() > 1)
     {
-        Napi::Error::New(env, "Failed to create protocol interface").ThrowAsJavaScriptException();
-        return;
+        reactor_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (reactor_fd < 0)
+        {
+            Napi::Error::New(env, "Failed to create event notification fd").ThrowAsJavaScriptException();
+            return;
+        }
     }
 
-    // Pass environment info to protocol layer
-    protocol->SetEnvInfo(env_info);
-
-    if (!protocol->Initialize())
+    for (const auto &name : names)
     {
-        Napi::Error::New(env, "Failed to initialize display protocol").ThrowAsJavaScriptException();
-        return;
+        if (!AddDisplayCore(env, name))
+            return;
     }
 
-    // Get system double-click time (placeholder - Linux specific implementation needed)
-    DOUBLE_CLICK_TIME_MS = 500;  // Default value
+    if (names.size() > 1)
+    {
+        input_reactor = std::make_unique<EventReactor>();
+        ForEachCore([&](SelectionCore &c) { c.SetEventReactor(input_reactor.get()); });
+    }
 
-    // Initialize current mouse position
-    current_mouse_pos = Point();
+    core = displays.front()->core.get();
+    active_display = displays.front().get();
 }
 
 /**
@@ -411,54 +243,56 @@ SelectionHook::SelectionHook(const Napi::CallbackInfo &info) : Napi::ObjectWrap<
  */
 SelectionHook::~SelectionHook()
 {
-    // Stop debounce thread (Path C)
-    debounce_running = false;
-    debounce_cv.notify_one();
-    if (debounce_thread.joinable())
-        debounce_thread.join();
-
-    // Stop worker thread
-    bool was_running = running.exchange(false);
-    if (was_running && tsfn)
-    {
-        tsfn.Release();
-    }
+    // Stop polling the core fds before the cores close them
+    StopCorePoll();
+
+    // Stops input monitoring and timer threads, cleans up the protocols; then the input reactor
+    displays.clear();
+    input_reactor.reset();
+    if (reactor_fd >= 0)
+        close(reactor_fd);
+}
 
-    // Stop input monitoring via protocol
-    if (protocol)
-    {
-        protocol->StopInputMonitoring();
-        protocol->CleanupInputMonitoring();
+/**
+ * Create and connect the core of a display (empty name: the display of the environment).
+ * Throws and returns false on failure.
+ */
+bool SelectionHook::AddDisplayCore(Napi::Env env, const std::string &name)
+{
+    auto display = std::make_unique<DisplayCore>();
+    display->hook = this;
+    display->name = name;
+    display->core = std::make_unique<SelectionCore>();
+    display->core->SetDisplayName(name);
+
+    std::string error;
+    if (!display->core->Initialize(error))
+    {
+        if (!name.empty())
+            error += " (display " + name + ")";
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return false;
     }
 
-    // Ensure mouse_keyboard_running is set to false
-    mouse_keyboard_running = false;
-
-    // Release thread-safe functions
-    if (mouse_tsfn)
-    {
-        mouse_tsfn.Release();
-    }
-    if (keyboard_tsfn)
-    {
-        keyboard_tsfn.Release();
-    }
-    if (selection_tsfn)
+    if (reactor_fd >= 0)
     {
-        selection_tsfn.Release();
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.ptr = display.get();
+        if (epoll_ctl(reactor_fd, EPOLL_CTL_ADD, display->core->GetFd(), &ev) != 0)
+        {
+            Napi::Error::New(env, "Failed to poll display " + name).ThrowAsJavaScriptException();
+            return false;
+        }
     }
 
-    // Clear current instance if it's us
-    if (currentInstance == this)
-    {
-        currentInstance = nullptr;
-    }
+    display->core->SetCallbacks(&SelectionHook::OnSelection, &SelectionHook::OnMouseEvent,
+                                &SelectionHook::OnKeyboardEvent, display.get());
+    display->core->SetSelectionChangeCallback(&SelectionHook::OnSelectionChange);
+    display->core->SetSuspendCallback(&SelectionHook::OnSuspend);
 
-    // Cleanup protocol
-    if (protocol)
-    {
-        protocol->Cleanup();
-    }
+    displays.push_back(std::move(display));
+    return true;
 }
 
 /**
@@ -474,6 +308,8 @@ Napi::Object SelectionHook::Init(Napi::Env env, Napi::Object exports)
                     {InstanceMethod("start", &SelectionHook::Start), InstanceMethod("stop", &SelectionHook::Stop),
                      InstanceMethod("enableMouseMoveEvent", &SelectionHook::EnableMouseMoveEvent),
                      InstanceMethod("disableMouseMoveEvent", &SelectionHook::DisableMouseMoveEvent),
+                     InstanceMethod("enableSelectionChangeEvent", &SelectionHook::EnableSelectionChangeEvent),
+                     InstanceMethod("disableSelectionChangeEvent", &SelectionHook::DisableSelectionChangeEvent),
                      InstanceMethod("enableClipboard", &SelectionHook::EnableClipboard),
                      InstanceMethod("disableClipboard", &SelectionHook::DisableClipboard),
                      InstanceMethod("setClipboardMode", &SelectionHook::SetClipboardMode),
@@ -481,9 +317,25 @@ Napi::Object SelectionHook::Init(Napi::Env env, Napi::Object exports)
                      InstanceMethod("setFineTunedList", &SelectionHook::SetFineTunedList),
                      InstanceMethod("setSelectionPassiveMode", &SelectionHook::SetSelectionPassiveMode),
                      InstanceMethod("getCurrentSelection", &SelectionHook::GetCurrentSelection),
+                     InstanceMethod("getSelectionSnapshot", &SelectionHook::GetSelectionSnapshot),
+                     InstanceMethod("setSelectionHistory", &SelectionHook::SetSelectionHistory),
+                     InstanceMethod("getSelectionHistory", &SelectionHook::GetSelectionHistory),
                      InstanceMethod("writeToClipboard", &SelectionHook::WriteToClipboard),
                      InstanceMethod("readFromClipboard", &SelectionHook::ReadFromClipboard),
-                     InstanceMethod("linuxGetEnvInfo", &SelectionHook::LinuxGetEnvInfo)});
+                     InstanceMethod("linuxGetEnvInfo", &SelectionHook::LinuxGetEnvInfo),
+                     InstanceMethod("linuxGetStats", &SelectionHook::LinuxGetStats),
+                     InstanceMethod("linuxSetSelectionInLoop", &SelectionHook::LinuxSetSelectionInLoop),
+                     InstanceMethod("linuxSetTextClassification", &SelectionHook::LinuxSetTextClassification),
+                     InstanceMethod("linuxSetAtspi", &SelectionHook::LinuxSetAtspi),
+                     InstanceMethod("linuxSetAutoSuspend", &SelectionHook::LinuxSetAutoSuspend),
+                     InstanceMethod("linuxSetFullscreenSuspend", &SelectionHook::LinuxSetFullscreenSuspend),
+                     InstanceMethod("linuxSetThreadScheduling", &SelectionHook::LinuxSetThreadScheduling),
+                     InstanceMethod("linuxSetInputDeviceFilter", &SelectionHook::LinuxSetInputDeviceFilter),
+                     InstanceMethod("linuxSetX11InputBackend", &SelectionHook::LinuxSetX11InputBackend),
+                     InstanceMethod("linuxDrainLog", &SelectionHook::LinuxDrainLog),
+                     InstanceMethod("linuxSetLogEvents", &SelectionHook::LinuxSetLogEvents),
+                     InstanceMethod("injectTestEvents", &SelectionHook::InjectTestEvents),
+                     InstanceMethod("isInjectingTestEvents", &SelectionHook::IsInjectingTestEvents)});
 
     constructor = Napi::Persistent(func);
     constructor.SuppressDestruct();
@@ -507,91 +359,45 @@ void SelectionHook::Start(const Napi::CallbackInfo &info)
     }
 
     // Don't start if already running
-    if (running)
+    if (core->IsRunning())
     {
         Napi::Error::New(env, "Text selection hook is already running").ThrowAsJavaScriptException();
         return;
     }
 
-    // Don't start if mouse/keyboard monitoring is already running
-    if (mouse_keyboard_running)
-    {
-        Napi::Error::New(env, "Input monitoring is already running").ThrowAsJavaScriptException();
-        return;
-    }
-
-    // Ensure ThreadSafeFunction objects are clean
-    if (tsfn || mouse_tsfn || keyboard_tsfn || selection_tsfn)
-    {
-        Napi::Error::New(env, "ThreadSafeFunction objects are not clean").ThrowAsJavaScriptException();
-        return;
-    }
-
-    // Create thread-safe function from JavaScript callback
-    Napi::Function callback = info[0u].As<Napi::Function>();
-
-    tsfn = Napi::ThreadSafeFunction::New(env, callback, "TextSelectionCallback", 0, 1,
-                                         [this](Napi::Env) { running = false; });
-
-    // Create thread-safe function for mouse events
-    mouse_tsfn = Napi::ThreadSafeFunction::New(env, callback, "MouseEventCallback", DEFAULT_MOUSE_EVENT_QUEUE_SIZE, 1,
-                                               [this](Napi::Env) { mouse_keyboard_running = false; });
-
-    // Create thread-safe function for keyboard events
-    keyboard_tsfn =
-        Napi::ThreadSafeFunction::New(env, callback, "KeyboardEventCallback", DEFAULT_KEYBOARD_EVENT_QUEUE_SIZE, 1,
-                                      [this](Napi::Env) { mouse_keyboard_running = false; });
-
-    // Create thread-safe function for selection change events (Path A/B)
-    selection_tsfn = Napi::ThreadSafeFunction::New(env, callback, "SelectionEventCallback", 64, 1);
-
-    // Initialize input monitoring via protocol
-    if (!protocol->InitializeInputMonitoring(&SelectionHook::OnMouseEventCallback,
-                                             &SelectionHook::OnKeyboardEventCallback,
-                                             &SelectionHook::OnSelectionEventCallback, this))
+    // The cores' protocols watch their connections on the input reactor as they start
+    if (input_reactor && !input_reactor->Start(core->GetThreadScheduling()))
     {
-        selection_tsfn.Release();
-        mouse_tsfn.Release();
-        keyboard_tsfn.Release();
-        tsfn.Release();
-        Napi::Error::New(env, "Failed to initialize input monitoring").ThrowAsJavaScriptException();
+        Napi::Error::New(env, "Failed to start the input thread").ThrowAsJavaScriptException();
         return;
     }
 
-    // Start input monitoring
-    try
+    std::string error;
+    for (size_t i = 0; i < displays.size(); i++)
     {
-        if (!protocol->StartInputMonitoring())
-        {
-            throw std::runtime_error("Failed to start input monitoring");
-        }
-
-        // Set running flags only after successful start
-        running = true;
-        mouse_keyboard_running = true;
-
-        // Start debounce thread for no-input fallback (Wayland without libevdev)
-        // Note: !isRoot is redundant (CheckInputDeviceAccess already returns true for root)
-        // but kept as defensive guard
-        is_no_input_fallback = (env_info.displayProtocol == DisplayProtocol::Wayland &&
-                                !env_info.hasInputDeviceAccess && !env_info.isRoot);
-        if (is_no_input_fallback)
+        if (!displays[i]->core->Start(error))
         {
-            fprintf(stderr, "[Wayland] No input devices available, using data-control debounce fallback (Path C)\n");
-            debounce_running = true;
-            debounce_thread = std::thread(&SelectionHook::DebounceThreadProc, this);
+            for (size_t j = 0; j < i; j++)
+                displays[j]->core->Stop();
+            if (input_reactor)
+                input_reactor->Stop();
+            if (!displays[i]->name.empty())
+                error += " (display " + displays[i]->name + ")";
+            Napi::Error::New(env, error).ThrowAsJavaScriptException();
+            return;
         }
     }
-    catch (const std::exception &e)
+
+    if (!StartCorePoll(env))
     {
-        protocol->CleanupInputMonitoring();
-        selection_tsfn.Release();
-        mouse_tsfn.Release();
-        keyboard_tsfn.Release();
-        tsfn.Release();
-        Napi::Error::New(env, "Failed to start input monitoring").ThrowAsJavaScriptException();
+        ForEachCore([](SelectionCore &c) { c.Stop(); });
+        if (input_reactor)
+            input_reactor->Stop();
+        Napi::Error::New(env, "Failed to poll selection hook events on the event loop").ThrowAsJavaScriptException();
         return;
     }
+
+    callback = Napi::Persistent(info[0u].As<Napi::Function>());
 }
 
 /**
@@ -600,63 +406,18 @@ void SelectionHook::Start(const Napi::CallbackInfo &info)
 void SelectionHook::Stop(const Napi::CallbackInfo &info)
 {
     // Do nothing if not running
-    if (!running)
+    if (!core->IsRunning())
     {
         return;
     }
 
-    // Set running flags to false first
-    running = false;
-    mouse_keyboard_running = false;
-
-    // Stop and cleanup input monitoring via protocol (this will wait for threads to finish)
-    if (protocol)
-    {
-        protocol->CleanupInputMonitoring();
-    }
-
-    // Give a small delay to ensure any pending callbacks complete
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-
-    // Stop debounce thread (Path C)
-    debounce_running = false;
-    debounce_cv.notify_one();
-    if (debounce_thread.joinable())
-        debounce_thread.join();
-    debounce_last_event_time.store(0);
-    is_gesture_button_down.store(false);
-    had_selection_during_drag.store(false);
-    is_no_input_fallback = false;
+    // Stop polling the core fds, then stop the engines (this will wait for threads to finish)
+    StopCorePoll();
+    ForEachCore([](SelectionCore &c) { c.Stop(); });
+    if (input_reactor)
+        input_reactor->Stop();
 
-    // Release thread-safe functions after threads have stopped
-    try
-    {
-        if (tsfn)
-        {
-            tsfn.Release();
-            tsfn = nullptr;
-        }
-        if (mouse_tsfn)
-        {
-            mouse_tsfn.Release();
-            mouse_tsfn = nullptr;
-        }
-        if (keyboard_tsfn)
-        {
-            keyboard_tsfn.Release();
-            keyboard_tsfn = nullptr;
-        }
-        if (selection_tsfn)
-        {
-            selection_tsfn.Release();
-            selection_tsfn = nullptr;
-        }
-    }
-    catch (const std::exception &e)
-    {
-        // Log error but don't throw to prevent further issues
-        fprintf(stderr, "Error releasing ThreadSafeFunction: %s\n", e.what());
-    }
+    callback.Reset();
 }
 
 /**
@@ -664,7 +425,7 @@ void SelectionHook::Stop(const Napi::CallbackInfo &info)
  */
 void SelectionHook::EnableMouseMoveEvent(const Napi::CallbackInfo &info)
 {
-    is_enabled_mouse_move_event = true;
+    ForEachCore([&](SelectionCore &c) { c.SetMouseMoveEventEnabled(true); });
 }
 
 /**
@@ -672,31 +433,61 @@ void SelectionHook::EnableMouseMoveEvent(const Napi::CallbackInfo &info)
  */
 void SelectionHook::DisableMouseMoveEvent(const Napi::CallbackInfo &info)
 {
-    is_enabled_mouse_move_event = false;
+    ForEachCore([&](SelectionCore &c) { c.SetMouseMoveEventEnabled(false); });
+}
+
+/**
+ * NAPI: Enable selection change events (owner changes, no text read)
+ */
+void SelectionHook::EnableSelectionChangeEvent(const Napi::CallbackInfo &info)
+{
+    ForEachCore([&](SelectionCore &c) { c.SetSelectionChangeEventEnabled(true); });
+}
+
+/**
+ * NAPI: Disable selection change events
+ */
+void SelectionHook::DisableSelectionChangeEvent(const Napi::CallbackInfo &info)
+{
+    ForEachCore([&](SelectionCore &c) { c.SetSelectionChangeEventEnabled(false); });
 }
 
 /**
- * NAPI: Enable clipboard fallback (no-op on Linux)
+ * NAPI: Enable clipboard fallback (X11 only)
  */
 void SelectionHook::EnableClipboard(const Napi::CallbackInfo &info)
 {
-    return;
+    ForEachCore([&](SelectionCore &c) { c.SetClipboardEnabled(true); });
 }
 
 /**
- * NAPI: Disable clipboard fallback (no-op on Linux)
+ * NAPI: Disable clipboard fallback
  */
 void SelectionHook::DisableClipboard(const Napi::CallbackInfo &info)
 {
-    return;
+    ForEachCore([&](SelectionCore &c) { c.SetClipboardEnabled(false); });
 }
 
 /**
- * NAPI: Set the clipboard filter mode & list (no-op on Linux)
+ * NAPI: Set the clipboard filter mode & list
  */
 void SelectionHook::SetClipboardMode(const Napi::CallbackInfo &info)
 {
-    return;
+    Napi::Env env = info.Env();
+    // Validate arguments
+    if (info.Length() < 2 || !info[0u].IsNumber() || !info[1u].IsArray())
+    {
+        Napi::TypeError::New(env, "Number and Array expected as arguments").ThrowAsJavaScriptException();
+        return;
+    }
+
+    // Get clipboard mode from first argument
+    int mode = info[0u].As<Napi::Number>().Int32Value();
+
+    std::vector<std::string> list;
+    ProcessStringArrayToList(info[1u].As<Napi::Array>(), list);
+
+    ForEachCore([&](SelectionCore &c) { c.SetClipboardMode(static_cast<FilterMode>(mode), list); });
 }
 
 /**
@@ -714,21 +505,38 @@ void SelectionHook::SetGlobalFilterMode(const Napi::CallbackInfo &info)
 
     // Get global mode from first argument
     int mode = info[0u].As<Napi::Number>().Int32Value();
-    global_filter_mode = static_cast<FilterMode>(mode);
 
-    Napi::Array listArray = info[1u].As<Napi::Array>();
+    std::vector<std::string> list;
+    ProcessStringArrayToList(info[1u].As<Napi::Array>(), list);
 
-    // Use helper method to process the array
-    ProcessStringArrayToList(listArray, global_filter_list);
+    ForEachCore([&](SelectionCore &c) { c.SetGlobalFilterMode(static_cast<FilterMode>(mode), list); });
 }
 
 /**
  * NAPI: Set fine-tuned list based on type
- * only for Windows now
  */
 void SelectionHook::SetFineTunedList(const Napi::CallbackInfo &info)
 {
-    return;
+    Napi::Env env = info.Env();
+    // Validate arguments
+    if (info.Length() < 2 || !info[0u].IsNumber() || !info[1u].IsArray())
+    {
+        Napi::TypeError::New(env, "Number and Array expected as arguments").ThrowAsJavaScriptException();
+        return;
+    }
+
+    // Get fine-tuned list type from first argument
+    int listType = info[0u].As<Napi::Number>().Int32Value();
+
+    std::vector<std::string> list;
+    ProcessStringArrayToList(info[1u].As<Napi::Array>(), list);
+
+    bool valid = true;
+    ForEachCore([&](SelectionCore &c) { valid = c.SetFineTunedList(static_cast<FineTunedListType>(listType), list); });
+    if (!valid)
+    {
+        Napi::TypeError::New(env, "Invalid FineTunedListType").ThrowAsJavaScriptException();
+    }
 }
 
 /**
@@ -744,11 +552,12 @@ void SelectionHook::SetSelectionPassiveMode(const Napi::CallbackInfo &info)
         return;
     }
 
-    is_selection_passive_mode = info[0u].As<Napi::Boolean>().Value();
+    ForEachCore([&](SelectionCore &c) { c.SetSelectionPassiveMode(info[0u].As<Napi::Boolean>().Value()); });
 }
 
 /**
  * NAPI: Get the currently selected text from the active window
+ * (with several displays: of the display of the latest input event)
  */
 Napi::Value SelectionHook::GetCurrentSelection(const Napi::CallbackInfo &info)
 {
@@ -756,36 +565,158 @@ Napi::Value SelectionHook::GetCurrentSelection(const Napi::CallbackInfo &info)
 
     try
     {
-        // Get the currently active window
-        uint64_t activeWindow = protocol->GetActiveWindow();
-        if (!activeWindow)
+        TextSelectionInfo selectionInfo;
+        if (!active_display->core->GetCurrentSelection(selectionInfo))
         {
             return env.Null();
         }
 
-        // Get selected text
-        TextSelectionInfo selectionInfo;
-        is_triggered_by_user = true;
-        if (!GetSelectedText(activeWindow, selectionInfo) || IsTrimmedEmpty(selectionInfo.text))
+        return CreateSelectionResultObject(env, *active_display, selectionInfo);
+    }
+    catch (const std::exception &e)
+    {
+        Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+/**
+ * NAPI: Get only the requested fields of the current selection
+ * Argument: SNAPSHOT_* bitmask. The result has a property for each requested field only.
+ */
+Napi::Value SelectionHook::GetSelectionSnapshot(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0u].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected as argument").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    try
+    {
+        SelectionSnapshot snapshot;
+        DisplayCore &display = *active_display;
+        if (!display.core->GetSelectionSnapshot(info[0u].As<Napi::Number>().Int32Value(), snapshot))
         {
-            is_triggered_by_user = false;
             return env.Null();
         }
 
-        is_triggered_by_user = false;
+        Napi::Object resultObj = Napi::Object::New(env);
+
+        if (snapshot.fields & SNAPSHOT_TEXT)
+            resultObj.Set("text", Napi::String::New(env, snapshot.text));
+        if (snapshot.fields & SNAPSHOT_PROGRAM_NAME)
+            resultObj.Set("programName",
+                          ProgramNameString(env, display, snapshot.programId, snapshot.programName.c_str()));
+        if (snapshot.fields & SNAPSHOT_CURSOR)
+        {
+            Napi::Object cursor = Napi::Object::New(env);
+            cursor.Set("x", Napi::Number::New(env, snapshot.cursor.valid ? snapshot.cursor.x : INVALID_COORDINATE));
+            cursor.Set("y", Napi::Number::New(env, snapshot.cursor.valid ? snapshot.cursor.y : INVALID_COORDINATE));
+            resultObj.Set("cursor", cursor);
+        }
+        if (snapshot.fields & SNAPSHOT_HAS_SELECTION)
+            resultObj.Set("hasSelection", Napi::Boolean::New(env, snapshot.hasSelection));
+        if (snapshot.fields & SNAPSHOT_BYTE_LENGTH)
+            resultObj.Set("byteLength", Napi::Number::New(env, static_cast<double>(snapshot.byteLength)));
+        SetDisplayTag(env, display, resultObj);
 
-        return CreateSelectionResultObject(env, selectionInfo);
+        return resultObj;
     }
     catch (const std::exception &e)
     {
         Napi::Error::New(env, e.what()).ThrowAsJavaScriptException();
-        is_triggered_by_user = false;
         return env.Null();
     }
 }
 
 /**
- * NAPI: Write string to clipboard
+ * NAPI: Set the selection history limits
+ * Arguments: maxEntries (0 disables and frees the history), maxBytes of stored text
+ */
+void SelectionHook::SetSelectionHistory(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0u].IsNumber() || !info[1u].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected as arguments").ThrowAsJavaScriptException();
+        return;
+    }
+
+    int64_t maxEntries = info[0u].As<Napi::Number>().Int64Value();
+    int64_t maxBytes = info[1u].As<Napi::Number>().Int64Value();
+    if (maxEntries < 0 || maxBytes < 0)
+    {
+        Napi::TypeError::New(env, "Limits must not be negative").ThrowAsJavaScriptException();
+        return;
+    }
+
+    ForEachCore([&](SelectionCore &c)
+                { c.SetSelectionHistory(static_cast<size_t>(maxEntries), static_cast<size_t>(maxBytes)); });
+}
+
+/**
+ * NAPI: Get history entries last seen after since (ms), newest first
+ * Arguments: since, limit (0 = all). The histories of several displays are merged.
+ */
+Napi::Value SelectionHook::GetSelectionHistory(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0u].IsNumber() || !info[1u].IsNumber())
+    {
+        Napi::TypeError::New(env, "Number expected as arguments").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    int64_t since = info[0u].As<Napi::Number>().Int64Value();
+    int64_t limit = info[1u].As<Napi::Number>().Int64Value();
+
+    size_t maxViews = limit > 0 ? static_cast<size_t>(limit) : 0;
+
+    // Entry views with the display they belong to
+    std::vector<std::pair<SelectionHistory::View, DisplayCore *>> views;
+    for (auto &display : displays)
+    {
+        std::vector<SelectionHistory::View> displayViews;
+        display->core->GetSelectionHistory(since, maxViews, displayViews);
+        for (const auto &view : displayViews)
+            views.emplace_back(view, display.get());
+    }
+
+    if (displays.size() > 1)
+    {
+        std::stable_sort(views.begin(), views.end(),
+                         [](const auto &a, const auto &b) { return a.first.lastTime > b.first.lastTime; });
+        if (maxViews > 0 && views.size() > maxViews)
+            views.resize(maxViews);
+    }
+
+    Napi::Array result = Napi::Array::New(env, views.size());
+    for (size_t i = 0; i < views.size(); i++)
+    {
+        const SelectionHistory::View &view = views[i].first;
+        DisplayCore &display = *views[i].second;
+
+        Napi::Object entry = Napi::Object::New(env);
+        entry.Set("id", Napi::Number::New(env, static_cast<double>(view.id)));
+        entry.Set("text", Napi::String::New(env, view.text, view.textLength));
+        entry.Set("programName", ProgramNameString(env, display, view.programId, view.programName));
+        entry.Set("timestamp", Napi::Number::New(env, static_cast<double>(view.lastTime)));
+        entry.Set("firstTimestamp", Napi::Number::New(env, static_cast<double>(view.firstTime)));
+        entry.Set("count", Napi::Number::New(env, view.count));
+        SetDisplayTag(env, display, entry);
+        result.Set(static_cast<uint32_t>(i), entry);
+    }
+
+    return result;
+}
+
+/**
+ * NAPI: Write string to clipboard (with several displays: of the display of the latest input event)
  *
  * Linux WriteClipboard has limited reliability due to X11's lazy clipboard model:
  * The clipboard owner must keep a window alive and respond to SelectionRequest events
@@ -811,7 +742,7 @@ Napi::Value SelectionHook::WriteToClipboard(const Napi::CallbackInfo &info)
         std::string text = info[0].As<Napi::String>().Utf8Value();
 
         // Write to clipboard using protocol interface
-        bool result = protocol->WriteClipboard(text);
+        bool result = active_display->core->WriteClipboard(text);
         return Napi::Boolean::New(env, result);
     }
     catch (const std::exception &e)
@@ -822,7 +753,7 @@ Napi::Value SelectionHook::WriteToClipboard(const Napi::CallbackInfo &info)
 }
 
 /**
- * NAPI: Read string from clipboard
+ * NAPI: Read string from clipboard (with several displays: of the display of the latest input event)
  */
 Napi::Value SelectionHook::ReadFromClipboard(const Napi::CallbackInfo &info)
 {
@@ -832,7 +763,7 @@ Napi::Value SelectionHook::ReadFromClipboard(const Napi::CallbackInfo &info)
     {
         // Read from clipboard
         std::string clipboardContent;
-        bool result = protocol->ReadClipboard(clipboardContent);
+        bool result = active_display->core->ReadClipboard(clipboardContent);
 
         if (!result)
         {
@@ -858,6 +789,8 @@ Napi::Value SelectionHook::LinuxGetEnvInfo(const Napi::CallbackInfo &info)
 
     try
     {
+        const LinuxEnvInfo &env_info = core->GetEnvInfo();
+
         Napi::Object obj = Napi::Object::New(env);
         obj.Set("displayProtocol", Napi::Number::New(env, static_cast<int>(env_info.displayProtocol)));
         obj.Set("compositorType", Napi::Number::New(env, static_cast<int>(env_info.compositorType)));
@@ -873,840 +806,800 @@ Napi::Value SelectionHook::LinuxGetEnvInfo(const Napi::CallbackInfo &info)
 }
 
 /**
- * Get selected text from the active window using multiple methods
+ * NAPI: Get the core's cumulative event counters (summed over the displays)
  */
-bool SelectionHook::GetSelectedText(uint64_t window, TextSelectionInfo &selectionInfo)
+Napi::Value SelectionHook::LinuxGetStats(const Napi::CallbackInfo &info)
 {
-    if (!window)
-        return false;
+    Napi::Env env = info.Env();
 
-    if (is_processing.load())
-        return false;
-    else
-        is_processing.store(true);
+    CoreStats stats;
+    for (auto &display : displays)
+    {
+        CoreStats displayStats = display->core->GetStats();
+        stats.starts = std::max(stats.starts, displayStats.starts);
+        stats.mouseEvents += displayStats.mouseEvents;
+        stats.keyboardEvents += displayStats.keyboardEvents;
+        stats.selectionChanges += displayStats.selectionChanges;
+        stats.droppedEvents += displayStats.droppedEvents;
+        stats.dispatchedEvents += displayStats.dispatchedEvents;
+        stats.selectionsEmitted += displayStats.selectionsEmitted;
+        stats.hedgedReads += displayStats.hedgedReads;
+        stats.hedgeSecondaryWins += displayStats.hedgeSecondaryWins;
+        stats.queueLength += displayStats.queueLength;
+        stats.queueHighWater = std::max(stats.queueHighWater, displayStats.queueHighWater);
+    }
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("starts", Napi::Number::New(env, static_cast<double>(stats.starts)));
+    obj.Set("mouseEvents", Napi::Number::New(env, static_cast<double>(stats.mouseEvents)));
+    obj.Set("keyboardEvents", Napi::Number::New(env, static_cast<double>(stats.keyboardEvents)));
+    obj.Set("selectionChanges", Napi::Number::New(env, static_cast<double>(stats.selectionChanges)));
+    obj.Set("droppedEvents", Napi::Number::New(env, static_cast<double>(stats.droppedEvents)));
+    obj.Set("dispatchedEvents", Napi::Number::New(env, static_cast<double>(stats.dispatchedEvents)));
+    obj.Set("selectionsEmitted", Napi::Number::New(env, static_cast<double>(stats.selectionsEmitted)));
+    obj.Set("hedgedReads", Napi::Number::New(env, static_cast<double>(stats.hedgedReads)));
+    obj.Set("hedgeSecondaryWins", Napi::Number::New(env, static_cast<double>(stats.hedgeSecondaryWins)));
+    obj.Set("queueLength", Napi::Number::New(env, static_cast<double>(stats.queueLength)));
+    obj.Set("queueHighWater", Napi::Number::New(env, static_cast<double>(stats.queueHighWater)));
+    return obj;
+}
 
-    // Initialize structure
-    selectionInfo.clear();
+/**
+ * NAPI: Enable/disable in-loop selection events (X11 only, applied at next start)
+ */
+void SelectionHook::LinuxSetSelectionInLoop(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
 
-    // Get program name and store it in selectionInfo
-    if (!protocol->GetProgramNameFromWindow(window, selectionInfo.programName))
+    if (info.Length() < 1 || !info[0u].IsBoolean())
     {
-        selectionInfo.programName = "";
-
-        // if no programName found, and global filter mode is include list, return false
-        if (global_filter_mode == FilterMode::IncludeList)
-        {
-            is_processing.store(false);
-            return false;
-        }
+        Napi::TypeError::New(env, "Boolean expected as first argument").ThrowAsJavaScriptException();
+        return;
     }
-    // should filter by global filter list
-    else if (global_filter_mode != FilterMode::Default)
-    {
-        bool isIn = IsInFilterList(selectionInfo.programName, global_filter_list);
 
-        if ((global_filter_mode == FilterMode::IncludeList && !isIn) ||
-            (global_filter_mode == FilterMode::ExcludeList && isIn))
-        {
-            is_processing.store(false);
-            return false;
-        }
-    }
+    ForEachCore([&](SelectionCore &c) { c.SetSelectionInLoop(info[0u].As<Napi::Boolean>().Value()); });
+}
+
+/**
+ * NAPI: Enable/disable text classification tags on selection results
+ */
+void SelectionHook::LinuxSetTextClassification(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
 
-    // Primary Selection (covers both X11 and Wayland)
-    if (GetTextViaPrimary(window, selectionInfo))
+    if (info.Length() < 1 || !info[0u].IsBoolean())
     {
-        selectionInfo.method = SelectionMethod::Primary;
-        is_processing.store(false);
-        return true;
+        Napi::TypeError::New(env, "Boolean expected as first argument").ThrowAsJavaScriptException();
+        return;
     }
 
-    // Clipboard fallback is intentionally not implemented for now.
-
-    is_processing.store(false);
-    return false;
+    ForEachCore([&](SelectionCore &c) { c.SetTextClassification(info[0u].As<Napi::Boolean>().Value()); });
 }
 
 /**
- * Get text selection via protocol selection APIs
+ * NAPI: Enable/disable the AT-SPI2 selection source (applied at next start)
  */
-bool SelectionHook::GetTextViaPrimary(uint64_t window, TextSelectionInfo &selectionInfo)
+void SelectionHook::LinuxSetAtspi(const Napi::CallbackInfo &info)
 {
-    if (!window)
-        return false;
+    Napi::Env env = info.Env();
 
-    // Try to get text from primary selection
-    std::string selectedText;
-    if (protocol->GetTextViaPrimary(selectedText) && !IsTrimmedEmpty(selectedText))
+    if (info.Length() < 1 || !info[0u].IsBoolean())
     {
-        selectionInfo.text = selectedText;
-        return true;
+        Napi::TypeError::New(env, "Boolean expected as first argument").ThrowAsJavaScriptException();
+        return;
     }
 
-    return false;
+    ForEachCore([&](SelectionCore &c) { c.SetAtspiEnabled(info[0u].As<Napi::Boolean>().Value()); });
 }
 
 /**
- * Check if program name is in the filter list
+ * NAPI: Enable/disable suspension while the session is locked or idle (applied at next start)
  */
-bool SelectionHook::IsInFilterList(const std::string &programName, const std::vector<std::string> &filterList)
+void SelectionHook::LinuxSetAutoSuspend(const Napi::CallbackInfo &info)
 {
-    // If filter list is empty, allow all
-    if (filterList.empty())
-    {
-        return false;
-    }
-
-    // Convert program name to lowercase for case-insensitive comparison
-    std::string lowerProgramName = programName;
-    std::transform(lowerProgramName.begin(), lowerProgramName.end(), lowerProgramName.begin(), ::tolower);
+    Napi::Env env = info.Env();
 
-    // Check if program name is in the filter list
-    for (const auto &filterItem : filterList)
+    if (info.Length() < 1 || !info[0u].IsBoolean())
     {
-        if (lowerProgramName.find(filterItem) != std::string::npos)
-        {
-            return true;
-        }
+        Napi::TypeError::New(env, "Boolean expected as first argument").ThrowAsJavaScriptException();
+        return;
     }
 
-    return false;
+    ForEachCore([&](SelectionCore &c) { c.SetAutoSuspend(info[0u].As<Napi::Boolean>().Value()); });
 }
 
 /**
- * Helper method to process string array and populate target list
+ * NAPI: Enable/disable suspension while a fullscreen window is focused, with the programs
+ * that keep the hook running (applied at next start)
  */
-void SelectionHook::ProcessStringArrayToList(const Napi::Array &array, std::vector<std::string> &targetList)
+void SelectionHook::LinuxSetFullscreenSuspend(const Napi::CallbackInfo &info)
 {
-    uint32_t length = array.Length();
-
-    // Clear existing list
-    targetList.clear();
+    Napi::Env env = info.Env();
 
-    // Process each string in the array
-    for (uint32_t i = 0; i < length; i++)
+    if (info.Length() < 2 || !info[0u].IsBoolean() || !info[1u].IsArray())
     {
-        Napi::Value value = array.Get(i);
-        if (value.IsString())
-        {
-            // Get the UTF-8 string
-            std::string programName = value.As<Napi::String>().Utf8Value();
+        Napi::TypeError::New(env, "Boolean and Array expected as arguments").ThrowAsJavaScriptException();
+        return;
+    }
 
-            // Convert to lowercase
-            std::transform(programName.begin(), programName.end(), programName.begin(), ::tolower);
+    std::vector<std::string> list;
+    ProcessStringArrayToList(info[1u].As<Napi::Array>(), list);
 
-            // Add to the target list
-            targetList.push_back(programName);
-        }
-    }
+    ForEachCore([&](SelectionCore &c) { c.SetFullscreenSuspend(info[0u].As<Napi::Boolean>().Value(), list); });
 }
 
 /**
- * Create JavaScript object with selection result
+ * NAPI: Take the diagnostic log entries written since the last drain, oldest first
  */
-Napi::Object SelectionHook::CreateSelectionResultObject(Napi::Env env, const TextSelectionInfo &selectionInfo)
+Napi::Value SelectionHook::LinuxDrainLog(const Napi::CallbackInfo &info)
 {
-    Napi::Object resultObj = Napi::Object::New(env);
+    Napi::Env env = info.Env();
 
-    resultObj.Set(Napi::String::New(env, "type"), Napi::String::New(env, "text-selection"));
-    resultObj.Set(Napi::String::New(env, "text"), Napi::String::New(env, selectionInfo.text));
-    resultObj.Set(Napi::String::New(env, "programName"), Napi::String::New(env, selectionInfo.programName));
+    std::vector<LogEntry> entries;
+    LogDrain(entries);
 
-    // Add method and position level information
-    resultObj.Set(Napi::String::New(env, "method"), Napi::Number::New(env, static_cast<int>(selectionInfo.method)));
-    resultObj.Set(Napi::String::New(env, "posLevel"), Napi::Number::New(env, static_cast<int>(selectionInfo.posLevel)));
+    Napi::Array result = Napi::Array::New(env, entries.size());
+    for (size_t i = 0; i < entries.size(); i++)
+        result.Set(static_cast<uint32_t>(i), CreateLogEntryObject(env, entries[i]));
+    return result;
+}
 
-    // Helper: output real coordinate when valid, INVALID_COORDINATE otherwise
-    auto setCoord = [&](const char *xKey, const char *yKey, const Point &p)
-    {
-        resultObj.Set(xKey, Napi::Number::New(env, p.valid ? p.x : INVALID_COORDINATE));
-        resultObj.Set(yKey, Napi::Number::New(env, p.valid ? p.y : INVALID_COORDINATE));
-    };
+/**
+ * NAPI: Enable/disable "debug" events for diagnostic log entries
+ */
+void SelectionHook::LinuxSetLogEvents(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
 
-    setCoord("startTopX", "startTopY", selectionInfo.startTop);
-    setCoord("startBottomX", "startBottomY", selectionInfo.startBottom);
-    setCoord("endTopX", "endTopY", selectionInfo.endTop);
-    setCoord("endBottomX", "endBottomY", selectionInfo.endBottom);
-    setCoord("mouseStartX", "mouseStartY", selectionInfo.mousePosStart);
-    setCoord("mouseEndX", "mouseEndY", selectionInfo.mousePosEnd);
+    if (info.Length() < 1 || !info[0u].IsBoolean())
+    {
+        Napi::TypeError::New(env, "Boolean expected as first argument").ThrowAsJavaScriptException();
+        return;
+    }
 
-    return resultObj;
+    log_events = info[0u].As<Napi::Boolean>().Value();
+    ForEachCore([&](SelectionCore &c) { c.SetLogNotify(log_events); });
 }
 
 /**
- * Input monitoring callback methods
+ * NAPI: Set input thread scheduling { nice?, realtime?, cpus? } (applied at next start)
  */
-void SelectionHook::OnMouseEventCallback(void *context, MouseEventContext *mouseEvent)
+void SelectionHook::LinuxSetThreadScheduling(const Napi::CallbackInfo &info)
 {
-    SelectionHook *instance = static_cast<SelectionHook *>(context);
-    if (!instance || !mouseEvent || !instance->mouse_keyboard_running.load() || !instance->mouse_tsfn)
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0u].IsObject())
     {
-        delete mouseEvent;
+        Napi::TypeError::New(env, "Object expected as first argument").ThrowAsJavaScriptException();
         return;
     }
 
-    // Update current mouse position
-    instance->current_mouse_pos = mouseEvent->pos;
+    Napi::Object options = info[0u].As<Napi::Object>();
+    ThreadSchedulingOptions scheduling;
 
-    // Track gesture button state for selection event suppression during drag.
-    // On X11, XRecord reports post-swap logical codes, so only BTN_LEFT matters.
-    // On Wayland, libevdev reports raw physical codes, so BTN_RIGHT must also
-    // be tracked for left-handed users (mirrors the guard at ProcessMouseEvent).
-    if (mouseEvent->code == BTN_LEFT ||
-        (mouseEvent->code == BTN_RIGHT && instance->env_info.displayProtocol == DisplayProtocol::Wayland))
+    Napi::Value nice = options.Get("nice");
+    if (nice.IsNumber())
     {
-        instance->is_gesture_button_down.store(mouseEvent->value == 1);
+        scheduling.setNice = true;
+        scheduling.niceValue = nice.As<Napi::Number>().Int32Value();
     }
-
-    if (instance->mouse_tsfn.NonBlockingCall(mouseEvent, ProcessMouseEvent) != napi_ok)
+    else if (!nice.IsUndefined() && !nice.IsNull())
     {
-        delete mouseEvent;  // Queue full or closing — callback won't fire, prevent leak
+        Napi::TypeError::New(env, "nice must be a number").ThrowAsJavaScriptException();
+        return;
     }
-}
 
-void SelectionHook::OnKeyboardEventCallback(void *context, KeyboardEventContext *keyboardEvent)
-{
-    SelectionHook *instance = static_cast<SelectionHook *>(context);
-    if (!instance || !keyboardEvent || !instance->mouse_keyboard_running.load() || !instance->keyboard_tsfn)
+    Napi::Value realtime = options.Get("realtime");
+    if (realtime.IsBoolean())
     {
-        delete keyboardEvent;
+        scheduling.realtime = realtime.As<Napi::Boolean>().Value();
+    }
+    else if (!realtime.IsUndefined() && !realtime.IsNull())
+    {
+        Napi::TypeError::New(env, "realtime must be a boolean").ThrowAsJavaScriptException();
         return;
     }
 
-    if (instance->keyboard_tsfn.NonBlockingCall(keyboardEvent, ProcessKeyboardEvent) != napi_ok)
+    Napi::Value cpus = options.Get("cpus");
+    if (cpus.IsArray())
     {
-        delete keyboardEvent;  // Queue full or closing — callback won't fire, prevent leak
+        Napi::Array cpuArray = cpus.As<Napi::Array>();
+        for (uint32_t i = 0; i < cpuArray.Length(); i++)
+        {
+            Napi::Value cpu = cpuArray.Get(i);
+            if (!cpu.IsNumber())
+            {
+                Napi::TypeError::New(env, "cpus must be an array of numbers").ThrowAsJavaScriptException();
+                return;
+            }
+            scheduling.cpus.push_back(cpu.As<Napi::Number>().Int32Value());
+        }
     }
+    else if (!cpus.IsUndefined() && !cpus.IsNull())
+    {
+        Napi::TypeError::New(env, "cpus must be an array of numbers").ThrowAsJavaScriptException();
+        return;
+    }
+
+    ForEachCore([&](SelectionCore &c) { c.SetThreadScheduling(scheduling); });
 }
 
 /**
- * Process mouse event on main thread and detect text selection gestures.
- * Correlates recognized gestures with selection change events via Path A or Path B.
+ * Parse an array of input device rules { name?, bus?, vendor?, product?, classes? }.
+ * Throws a TypeError and returns false on an invalid rule.
  */
-void SelectionHook::ProcessMouseEvent(Napi::Env env, Napi::Function function, MouseEventContext *pMouseEvent)
+static bool ParseInputDeviceRules(Napi::Env env, Napi::Value value, const char *key,
+                                  std::vector<InputDeviceRule> &rules)
 {
-    // During TSFN drain at shutdown, env is null — just free the data
-    if (!env || !pMouseEvent || !currentInstance)
+    if (value.IsUndefined() || value.IsNull())
+        return true;
+
+    std::string message = std::string(key) + " must be an array of device rules";
+    if (!value.IsArray())
     {
-        delete pMouseEvent;
-        return;
+        Napi::TypeError::New(env, message).ThrowAsJavaScriptException();
+        return false;
     }
 
-    // Get current time in milliseconds
-    auto currentTime =
-        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
-            .count();
-
-    Point currentPos = pMouseEvent->pos;
-    auto mouseCode = pMouseEvent->code;
-    auto mouseValue = pMouseEvent->value;
-    MouseButton mouseButton = static_cast<MouseButton>(pMouseEvent->button);
-
-    std::string mouseTypeStr = "";
-    int mouseFlagValue = 0;
-
-    // Process different mouse events based on libevdev codes
-    switch (mouseCode)
-    {
-        case BTN_LEFT:
-        case BTN_RIGHT:
-            // Monitor both buttons for gesture detection so that left-handed users
-            // (who swap buttons) can trigger selections with their primary button.
-            // On Wayland, libevdev reads raw physical button codes from /dev/input,
-            // bypassing libinput's left-handed swap. The gesture-selection correlation
-            // mechanism (requiring both a gesture AND a selection-change event within
-            // 500ms) naturally filters out right-click actions that don't produce
-            // text selections.
-
-            // On X11, XRecord captures post-swap logical events, so left-handed
-            // users already report BTN_LEFT as their primary button. Skip gesture
-            // tracking for BTN_RIGHT on X11 — only Wayland (libevdev) needs it.
-            if (mouseCode == BTN_RIGHT && currentInstance->env_info.displayProtocol != DisplayProtocol::Wayland)
-            {
-                mouseTypeStr = (mouseValue == 1) ? "mouse-down" : "mouse-up";
-                mouseButton = MouseButton::Right;
-                break;
-            }
-
-            if (mouseValue == 1)  // Press
-            {
-                mouseTypeStr = "mouse-down";
-                mouseButton = (mouseCode == BTN_LEFT) ? MouseButton::Left : MouseButton::Right;
-
-                // Update mouse-down state
-                currentInstance->last_mouse_down_time = currentTime;
-                currentInstance->last_mouse_down_pos = currentPos;
+    Napi::Array array = value.As<Napi::Array>();
+    for (uint32_t i = 0; i < array.Length(); i++)
+    {
+        Napi::Value item = array.Get(i);
+        if (!item.IsObject())
+        {
+            Napi::TypeError::New(env, message).ThrowAsJavaScriptException();
+            return false;
+        }
 
-                // Query display server for accurate screen coordinates at gesture start.
-                // On X11 this duplicates last_mouse_down_pos; on Wayland it provides the
-                // first reliable coordinate for drag gesture reporting (MouseDual).
-                if (currentInstance->env_info.displayProtocol == DisplayProtocol::Wayland)
-                {
-                    currentInstance->queried_mouse_down_pos = currentInstance->protocol->GetCurrentMousePosition();
-                }
+        Napi::Object object = item.As<Napi::Object>();
+        InputDeviceRule rule;
 
-                // Clear pending gesture (prevent old pending from being triggered by new action)
-                currentInstance->pending_gesture.active = false;
-                currentInstance->had_selection_during_drag.store(false);
+        Napi::Value name = object.Get("name");
+        if (name.IsString())
+            rule.name = name.As<Napi::String>().Utf8Value();
+        else if (!name.IsUndefined() && !name.IsNull())
+        {
+            Napi::TypeError::New(env, "Device rule name must be a string").ThrowAsJavaScriptException();
+            return false;
+        }
 
-                // Record window handle and position at mouse-down for movement detection
-                currentInstance->last_window_handler = currentInstance->protocol->GetActiveWindow();
-                if (currentInstance->last_window_handler)
-                {
-                    currentInstance->protocol->GetWindowRect(currentInstance->last_window_handler,
-                                                             currentInstance->last_window_rect);
-                }
-            }
-            else if (mouseValue == 0)  // Release
+        const char *idKeys[] = {"bus", "vendor", "product"};
+        int *idFields[] = {&rule.bus, &rule.vendor, &rule.product};
+        for (int k = 0; k < 3; k++)
+        {
+            Napi::Value id = object.Get(idKeys[k]);
+            if (id.IsNumber())
+                *idFields[k] = id.As<Napi::Number>().Int32Value();
+            else if (!id.IsUndefined() && !id.IsNull())
             {
-                mouseTypeStr = "mouse-up";
-                mouseButton = (mouseCode == BTN_LEFT) ? MouseButton::Left : MouseButton::Right;
-
-                // Update mouse-up state (save previous values first)
-                Point prevUp = currentInstance->last_mouse_up_pos;
-                uint64_t prevUpTime = currentInstance->last_mouse_up_time;
-                currentInstance->last_mouse_up_time = currentTime;
-                currentInstance->last_mouse_up_pos = currentPos;
-                currentInstance->last_mouse_up_modifier_flags = currentInstance->protocol->GetModifierFlags();
+                Napi::TypeError::New(env, std::string("Device rule ") + idKeys[k] + " must be a number")
+                    .ThrowAsJavaScriptException();
+                return false;
+            }
+        }
 
-                if (!currentInstance->is_selection_passive_mode)
+        Napi::Value classes = object.Get("classes");
+        if (classes.IsArray())
+        {
+            Napi::Array classArray = classes.As<Napi::Array>();
+            for (uint32_t c = 0; c < classArray.Length(); c++)
+            {
+                Napi::Value cls = classArray.Get(c);
+                std::string clsName = cls.IsString() ? cls.As<Napi::String>().Utf8Value() : "";
+                if (clsName == "mouse")
+                    rule.classes |= INPUT_DEVICE_MOUSE;
+                else if (clsName == "keyboard")
+                    rule.classes |= INPUT_DEVICE_KEYBOARD;
+                else if (clsName == "touchpad")
+                    rule.classes |= INPUT_DEVICE_TOUCHPAD;
+                else if (clsName == "tablet")
+                    rule.classes |= INPUT_DEVICE_TABLET;
+                else if (clsName == "gamepad")
+                    rule.classes |= INPUT_DEVICE_GAMEPAD;
+                else
                 {
-                    // Gesture detection
-                    auto detectionType = SelectionDetectType::None;
-
-                    double dx = currentPos.x - currentInstance->last_mouse_down_pos.x;
-                    double dy = currentPos.y - currentInstance->last_mouse_down_pos.y;
-                    double distance = sqrt(dx * dx + dy * dy);
-
-                    bool isCurrentValidClick =
-                        (currentTime - currentInstance->last_mouse_down_time) <= DOUBLE_CLICK_TIME_MS;
-
-                    if ((currentTime - currentInstance->last_mouse_down_time) > MAX_DRAG_TIME_MS)
-                    {
-                        // Too long drag, skip
-                    }
-                    // Check for drag selection
-                    else if (distance >= MIN_DRAG_DISTANCE)
-                    {
-                        uint64_t upWindow = currentInstance->protocol->GetActiveWindow();
-                        if (upWindow && upWindow == currentInstance->last_window_handler)
-                        {
-                            // Same window at mouse-down and mouse-up: verify window wasn't
-                            // dragged (moved) to distinguish text selection from window drag.
-                            WindowRect currentWindowRect;
-                            currentInstance->protocol->GetWindowRect(upWindow, currentWindowRect);
-                            if (!HasWindowMoved(currentWindowRect, currentInstance->last_window_rect))
-                            {
-                                detectionType = SelectionDetectType::Drag;
-                            }
-                        }
-                        else if (upWindow && upWindow != currentInstance->last_window_handler)
-                        {
-                            // Active window changed between mouse-down and mouse-up.
-                            // This happens when the user drags to select text in an unfocused
-                            // window — the click causes focus to shift.  Allow the drag gesture;
-                            // XFixes correlation will validate whether a real selection occurred.
-                            detectionType = SelectionDetectType::Drag;
-                        }
-                    }
-                    // Check for double-click selection
-                    else if (currentInstance->is_last_valid_click && isCurrentValidClick &&
-                             distance <= DOUBLE_CLICK_MAX_DISTANCE)
-                    {
-                        double dx2 = currentPos.x - prevUp.x;
-                        double dy2 = currentPos.y - prevUp.y;
-                        double distance2 = sqrt(dx2 * dx2 + dy2 * dy2);
-
-                        if (distance2 <= DOUBLE_CLICK_MAX_DISTANCE &&
-                            (currentInstance->last_mouse_down_time - prevUpTime) <= DOUBLE_CLICK_TIME_MS)
-                        {
-                            uint64_t upWindow = currentInstance->protocol->GetActiveWindow();
-                            if (upWindow && upWindow == currentInstance->last_window_handler)
-                            {
-                                WindowRect currentWindowRect;
-                                currentInstance->protocol->GetWindowRect(upWindow, currentWindowRect);
-                                if (!HasWindowMoved(currentWindowRect, currentInstance->last_window_rect))
-                                {
-                                    detectionType = SelectionDetectType::DoubleClick;
-                                }
-                            }
-                        }
-                    }
-
-                    // Check shift+click selection
-                    if (detectionType == SelectionDetectType::None)
-                    {
-                        int modFlags = currentInstance->last_mouse_up_modifier_flags;
-                        bool isShiftPressed = (modFlags & MODIFIER_SHIFT) != 0;
-                        bool isCtrlPressed = (modFlags & MODIFIER_CTRL) != 0;
-                        bool isAltPressed = (modFlags & MODIFIER_ALT) != 0;
-                        if (isShiftPressed && !isCtrlPressed && !isAltPressed)
-                        {
-                            detectionType = SelectionDetectType::ShiftClick;
-                        }
-                    }
-
-                    // Correlate recognized gesture with selection change event
-                    if (detectionType != SelectionDetectType::None)
-                    {
-                        uint64_t lastSelectionEvent = currentInstance->last_selection_event_time.load();
-
-                        // Determine mouse coordinates for the event
-                        Point gestureStart, gestureEnd;
-                        switch (detectionType)
-                        {
-                            case SelectionDetectType::Drag:
-                                gestureStart = currentInstance->last_mouse_down_pos;
-                                gestureEnd = currentPos;
-                                break;
-                            case SelectionDetectType::DoubleClick:
-                                gestureStart = currentPos;
-                                gestureEnd = currentPos;
-                                break;
-                            case SelectionDetectType::ShiftClick:
-                                gestureStart = currentInstance->prev_mouse_up_pos;
-                                gestureEnd = currentPos;
-                                break;
-                            default:
-                                gestureStart = currentPos;
-                                gestureEnd = currentPos;
-                                break;
-                        }
-
-                        bool emitted = false;
-
-                        // Drag correlation: selection event arrived during drag — directly
-                        // correlated regardless of how long ago (bypasses 500ms window).
-                        if (detectionType == SelectionDetectType::Drag &&
-                            currentInstance->had_selection_during_drag.load())
-                        {
-                            currentInstance->had_selection_during_drag.store(false);
-                            emitted = currentInstance->EmitSelectionEvent(detectionType, gestureStart, gestureEnd);
-                            if (emitted)
-                            {
-                                // Consume timestamps only on success to allow Path A retry on failure
-                                currentInstance->last_selection_event_time.store(0);
-                                lastSelectionEvent = 0;
-                            }
-                        }
-
-                        // Path A: selection change event already arrived within correlation window.
-                        // If EmitSelectionEvent fails (e.g., selection data not yet available),
-                        // fall through to Path B to wait for the actual selection event.
-                        if (!emitted && lastSelectionEvent > 0 &&
-                            (static_cast<uint64_t>(currentTime) - lastSelectionEvent) < CORRELATION_WINDOW_MS)
-                        {
-                            currentInstance->last_selection_event_time.store(0);  // Consume
-                            emitted = currentInstance->EmitSelectionEvent(detectionType, gestureStart, gestureEnd);
-                        }
-
-                        if (!emitted)
-                        {
-                            // Path B: store pending gesture, wait for selection change event
-                            currentInstance->pending_gesture.active = true;
-                            currentInstance->pending_gesture.type = detectionType;
-                            currentInstance->pending_gesture.mousePosStart = gestureStart;
-                            currentInstance->pending_gesture.mousePosEnd = gestureEnd;
-                            currentInstance->pending_gesture.timestamp = currentTime;
-                        }
-                    }
-
-                    currentInstance->is_last_valid_click = isCurrentValidClick;
+                    Napi::TypeError::New(env,
+                                         "Device rule classes must be mouse, keyboard, touchpad, tablet or gamepad")
+                        .ThrowAsJavaScriptException();
+                    return false;
                 }
-
-                currentInstance->prev_mouse_up_pos = prevUp;
-                currentInstance->prev_mouse_up_time = prevUpTime;
             }
-            break;
-
-        case BTN_MIDDLE:
-            mouseTypeStr = (mouseValue == 1) ? "mouse-down" : "mouse-up";
-            mouseButton = MouseButton::Middle;
-            break;
+        }
+        else if (!classes.IsUndefined() && !classes.IsNull())
+        {
+            Napi::TypeError::New(env, "Device rule classes must be an array of strings").ThrowAsJavaScriptException();
+            return false;
+        }
 
-        case REL_WHEEL:
-            mouseTypeStr = "mouse-wheel";
-            mouseButton = MouseButton::WheelVertical;
-            mouseFlagValue = mouseValue > 0 ? 1 : -1;
-            break;
+        rules.push_back(rule);
+    }
+    return true;
+}
 
-        case REL_HWHEEL:
-            mouseTypeStr = "mouse-wheel";
-            mouseButton = MouseButton::WheelHorizontal;
-            mouseFlagValue = mouseValue > 0 ? 1 : -1;
-            break;
+/**
+ * NAPI: Set the input devices to monitor { allow?, deny?, excludeVirtual?, excludeXTest? }
+ * (applied at next start)
+ */
+void SelectionHook::LinuxSetInputDeviceFilter(const Napi::CallbackInfo &info)
+{
+    Napi::Env env = info.Env();
 
-        default:
-            if (mouseCode == REL_X || mouseCode == REL_Y)
-            {
-                mouseTypeStr = "mouse-move";
-                mouseButton = MouseButton::None;
-            }
-            else
-            {
-                mouseTypeStr = "unknown";
-                mouseButton = MouseButton::Unknown;
-            }
-            break;
+    if (info.Length() < 1 || !info[0u].IsObject())
+    {
+        Napi::TypeError::New(env, "Object expected as first argument").ThrowAsJavaScriptException();
+        return;
     }
 
-    // Create and emit mouse event object
-    if (!mouseTypeStr.empty())
+    Napi::Object options = info[0u].As<Napi::Object>();
+    InputDeviceFilter filter;
+
+    if (!ParseInputDeviceRules(env, options.Get("allow"), "allow", filter.allow) ||
+        !ParseInputDeviceRules(env, options.Get("deny"), "deny", filter.deny))
+        return;
+
+    const char *flagKeys[] = {"excludeVirtual", "excludeXTest"};
+    bool *flagFields[] = {&filter.excludeVirtual, &filter.excludeXTest};
+    for (int k = 0; k < 2; k++)
     {
-        // Filter mouse move events based on the flag
-        if (mouseTypeStr == "mouse-move" && !currentInstance->is_enabled_mouse_move_event)
+        Napi::Value flag = options.Get(flagKeys[k]);
+        if (flag.IsBoolean())
+            *flagFields[k] = flag.As<Napi::Boolean>().Value();
+        else if (!flag.IsUndefined() && !flag.IsNull())
         {
-            delete pMouseEvent;
+            Napi::TypeError::New(env, std::string(flagKeys[k]) + " must be a boolean").ThrowAsJavaScriptException();
             return;
         }
-
-        // Output INVALID_COORDINATE when position source is unreliable (e.g. libevdev on Wayland)
-        int outX = currentPos.valid ? currentPos.x : INVALID_COORDINATE;
-        int outY = currentPos.valid ? currentPos.y : INVALID_COORDINATE;
-
-        Napi::Object resultObj = Napi::Object::New(env);
-        resultObj.Set(Napi::String::New(env, "type"), Napi::String::New(env, "mouse-event"));
-        resultObj.Set(Napi::String::New(env, "action"), Napi::String::New(env, mouseTypeStr));
-        resultObj.Set(Napi::String::New(env, "x"), Napi::Number::New(env, outX));
-        resultObj.Set(Napi::String::New(env, "y"), Napi::Number::New(env, outY));
-        resultObj.Set(Napi::String::New(env, "button"), Napi::Number::New(env, static_cast<int>(mouseButton)));
-        resultObj.Set(Napi::String::New(env, "flag"), Napi::Number::New(env, mouseFlagValue));
-        function.Call({resultObj});
     }
 
-    delete pMouseEvent;
+    ForEachCore([&](SelectionCore &c) { c.SetInputDeviceFilter(filter); });
 }
 
 /**
- * Selection change event callback (XFixes on X11, data-control on Wayland).
- * Called from the protocol's selection monitoring thread.
+ * NAPI: Set the source of X11 input events (X11InputBackend: 0 = XRecord, 1 = XInput2)
+ * (applied at next start)
  */
-void SelectionHook::OnSelectionEventCallback(void *context, SelectionChangeContext *event)
+void SelectionHook::LinuxSetX11InputBackend(const Napi::CallbackInfo &info)
 {
-    SelectionHook *instance = static_cast<SelectionHook *>(context);
-    if (!instance || !event)
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0u].IsNumber())
     {
-        delete event;
+        Napi::TypeError::New(env, "Number expected as first argument").ThrowAsJavaScriptException();
         return;
     }
 
-    // Atomic write — executed in protocol selection thread, read by Path A in main thread
-    instance->last_selection_event_time.store(event->timestamp_ms);
-
-    // During mouse drag: skip ThreadSafeFunction dispatch.  Path A will pick up
-    // last_selection_event_time when ButtonRelease is processed.  Only dispatch when:
-    //   - Path B: mouse is up (pending_gesture may be awaiting confirmation)
-    //   - Path C: no-input fallback mode (always needs dispatch for debounce)
-    if (instance->is_gesture_button_down.load())
+    int backend = info[0u].As<Napi::Number>().Int32Value();
+    if (backend != static_cast<int>(X11InputBackend::XRecord) && backend != static_cast<int>(X11InputBackend::XInput2))
     {
-        // Mouse button held — record that a selection event arrived during drag,
-        // so drag gestures can bypass the 500ms correlation window at mouse-up.
-        instance->had_selection_during_drag.store(true);
-        delete event;
+        Napi::TypeError::New(env, "Unknown X11 input backend").ThrowAsJavaScriptException();
         return;
     }
 
-    // Dispatch to main thread for Path B / Path C processing
-    if (instance->running.load() && instance->selection_tsfn)
-    {
-        if (instance->selection_tsfn.NonBlockingCall(event, ProcessSelectionEvent) != napi_ok)
-        {
-            delete event;  // Queue full or closing — callback won't fire, prevent leak
-        }
-    }
-    else
-    {
-        delete event;
-    }
+    ForEachCore([&](SelectionCore &c) { c.SetX11InputBackend(static_cast<X11InputBackend>(backend)); });
 }
 
 /**
- * Process selection event on main thread.
- *
- * Three paths for selection detection:
- *   Path A: Mouse gesture detected, selection change event already arrived (fast path)
- *   Path B: Mouse gesture detected, waiting for selection change event confirmation
- *   Path C: No-input fallback — selection change event + debounce (no libevdev)
+ * NAPI: Inject synthetic events into the delivery pipeline (test-only).
+ * Arguments: kind (InjectEventKind), count, rate per second (0 = unpaced).
+ * Only available when SELECTION_HOOK_TEST_INJECTION=1 is set in the environment.
  */
-void SelectionHook::ProcessSelectionEvent(Napi::Env env, Napi::Function function, SelectionChangeContext *pEvent)
+Napi::Value SelectionHook::InjectTestEvents(const Napi::CallbackInfo &info)
 {
-    // During TSFN drain at shutdown, env is null — just free the data
-    if (!env || !pEvent || !currentInstance)
+    Napi::Env env = info.Env();
+
+    const char *enabled = getenv("SELECTION_HOOK_TEST_INJECTION");
+    if (!enabled || strcmp(enabled, "1") != 0)
     {
-        delete pEvent;
-        return;
+        Napi::Error::New(env, "Event injection requires SELECTION_HOOK_TEST_INJECTION=1").ThrowAsJavaScriptException();
+        return env.Undefined();
     }
 
-    if (currentInstance->pending_gesture.active)
+    if (info.Length() < 3 || !info[0u].IsNumber() || !info[1u].IsNumber() || !info[2u].IsNumber())
     {
-        // Use selection event timestamp (not wall clock "now") to avoid false expiry
-        // under main-thread load when ThreadSafeFunction callback is delayed.
-        // Note: pEvent->timestamp_ms is captured in the protocol thread (at XFixes/data-control
-        // event time), while pending_gesture.timestamp is captured later in the main thread
-        // (at ProcessMouseEvent time).  The selection event timestamp is often slightly earlier,
-        // so we use signed arithmetic to handle either ordering correctly.
-        int64_t delta = (int64_t)pEvent->timestamp_ms - (int64_t)currentInstance->pending_gesture.timestamp;
-        if (std::abs(delta) < (int64_t)CORRELATION_WINDOW_MS)
-        {
-            // Path B: pending gesture confirmed by selection change event
-            currentInstance->last_selection_event_time.store(0);  // Consume
-            bool path_b_emitted = currentInstance->EmitSelectionEvent(currentInstance->pending_gesture.type,
-                                                                      currentInstance->pending_gesture.mousePosStart,
-                                                                      currentInstance->pending_gesture.mousePosEnd);
-            // Always clear pending gesture regardless of success — keeping it active risks
-            // misattributing a future unrelated selection event to this stale gesture.
-            currentInstance->pending_gesture.active = false;
-            (void)path_b_emitted;  // return value captured for observability; drop is accepted
-        }
-        else
-        {
-            // Pending expired, clear it
-            currentInstance->pending_gesture.active = false;
-        }
+        Napi::TypeError::New(env, "Number expected for kind, count and rate").ThrowAsJavaScriptException();
+        return env.Undefined();
     }
-    else if (currentInstance->is_no_input_fallback && !currentInstance->is_selection_passive_mode)
+
+    int kind = info[0u].As<Napi::Number>().Int32Value();
+    if (kind < static_cast<int>(InjectEventKind::MouseMove) || kind > static_cast<int>(InjectEventKind::Selection))
     {
-        // Path C: No-input fallback - reset debounce timer
-        currentInstance->debounce_last_event_time.store(pEvent->timestamp_ms);
-        currentInstance->debounce_cv.notify_one();
+        Napi::TypeError::New(env, "Invalid event kind").ThrowAsJavaScriptException();
+        return env.Undefined();
     }
-    // else: no pending gesture and no fallback, skip
 
-    delete pEvent;
+    bool injected = core->InjectEvents(static_cast<InjectEventKind>(kind), info[1u].As<Napi::Number>().Uint32Value(),
+                                       info[2u].As<Napi::Number>().Uint32Value());
+    return Napi::Boolean::New(env, injected);
 }
 
 /**
- * Debounce thread for no-input fallback (Path C).
- * When libevdev is unavailable, data-control events alone trigger selection
- * detection after a quiet period (no new events for NO_INPUT_DEBOUNCE_MS).
+ * NAPI: Whether an injection started by injectTestEvents() is still producing events
  */
-void SelectionHook::DebounceThreadProc()
+Napi::Value SelectionHook::IsInjectingTestEvents(const Napi::CallbackInfo &info)
 {
-    while (debounce_running.load())
+    return Napi::Boolean::New(info.Env(), core->IsInjecting());
+}
+
+/**
+ * Helper method to process string array into a list (lowercased by the core)
+ */
+void SelectionHook::ProcessStringArrayToList(const Napi::Array &array, std::vector<std::string> &targetList)
+{
+    uint32_t length = array.Length();
+
+    // Clear existing list
+    targetList.clear();
+
+    // Process each string in the array
+    for (uint32_t i = 0; i < length; i++)
     {
-        // Phase 1: Idle wait — block until a data-control event arrives or shutdown
+        Napi::Value value = array.Get(i);
+        if (value.IsString())
         {
-            std::unique_lock<std::mutex> lock(debounce_mutex);
-            debounce_cv.wait(lock, [this] { return debounce_last_event_time.load() != 0 || !debounce_running.load(); });
+            targetList.push_back(value.As<Napi::String>().Utf8Value());
         }
+    }
+}
 
-        if (!debounce_running.load())
-            break;
+/**
+ * JS string of a program name. Interned names are converted once and then reused from
+ * program_name_strings of the display; its core's ids are stable for the lifetime of this instance.
+ */
+Napi::String SelectionHook::ProgramNameString(Napi::Env env, DisplayCore &display, uint32_t programId,
+                                              const char *programName)
+{
+    if (programId == ProgramNameTable::UNKNOWN || programId > ProgramNameTable::MAX_NAMES)
+        return Napi::String::New(env, programName);
 
-        // Phase 2: Active debounce — wait for quiet period
-        while (debounce_running.load())
-        {
-            uint64_t last = debounce_last_event_time.load();
-            if (last == 0)
-                break;  // Consumed elsewhere, go back to idle wait
+    if (programId >= display.program_name_strings.size())
+        display.program_name_strings.resize(programId + 1);
 
-            auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
-                           std::chrono::system_clock::now().time_since_epoch())
-                           .count();
+    Napi::Reference<Napi::String> &cached = display.program_name_strings[programId];
+    if (cached.IsEmpty())
+        cached = Napi::Persistent(Napi::String::New(env, programName));
+    return cached.Value();
+}
 
-            uint64_t elapsed = static_cast<uint64_t>(now) - last;
-            if (elapsed >= NO_INPUT_DEBOUNCE_MS)
-            {
-                // Quiet period elapsed — fire selection event
-                debounce_last_event_time.store(0);
+/**
+ * Tag an event or result with its X11 display, when the display was given explicitly
+ */
+void SelectionHook::SetDisplayTag(Napi::Env env, const DisplayCore &display, Napi::Object resultObj)
+{
+    if (!display.name.empty())
+        resultObj.Set(Napi::String::New(env, "display"), Napi::String::New(env, display.name));
+}
 
-                if (!running.load() || !tsfn)
-                    break;
+/**
+ * Create JavaScript object with selection result
+ */
+Napi::Object SelectionHook::CreateSelectionResultObject(Napi::Env env, DisplayCore &display,
+                                                        const TextSelectionInfo &selectionInfo)
+{
+    Napi::Object resultObj = Napi::Object::New(env);
 
-                auto callback = [](Napi::Env env, Napi::Function jsCallback)
-                {
-                    if (!currentInstance || !currentInstance->running.load())
-                        return;
-                    Point cursorPos = currentInstance->protocol->GetCurrentMousePosition();
-                    currentInstance->EmitSelectionEvent(SelectionDetectType::Drag, cursorPos, cursorPos);
-                };
-                tsfn.NonBlockingCall(callback);
-                break;
-            }
-            else
-            {
-                // Wait for remaining debounce time (or new event / shutdown)
-                auto remaining = std::chrono::milliseconds(NO_INPUT_DEBOUNCE_MS - elapsed);
-                std::unique_lock<std::mutex> lock(debounce_mutex);
-                debounce_cv.wait_for(lock, remaining);
-            }
+    resultObj.Set(Napi::String::New(env, "type"), Napi::String::New(env, "text-selection"));
+    resultObj.Set(Napi::String::New(env, "text"), Napi::String::New(env, selectionInfo.text));
+    resultObj.Set(Napi::String::New(env, "programName"),
+                  ProgramNameString(env, display, selectionInfo.programId, selectionInfo.programName.c_str()));
+
+    // Add method and position level information
+    resultObj.Set(Napi::String::New(env, "method"), Napi::Number::New(env, static_cast<int>(selectionInfo.method)));
+    resultObj.Set(Napi::String::New(env, "posLevel"), Napi::Number::New(env, static_cast<int>(selectionInfo.posLevel)));
+
+    // Helper: output real coordinate when valid, INVALID_COORDINATE otherwise
+    auto setCoord = [&](const char *xKey, const char *yKey, const Point &p)
+    {
+        resultObj.Set(xKey, Napi::Number::New(env, p.valid ? p.x : INVALID_COORDINATE));
+        resultObj.Set(yKey, Napi::Number::New(env, p.valid ? p.y : INVALID_COORDINATE));
+    };
+
+    setCoord("startTopX", "startTopY", selectionInfo.startTop);
+    setCoord("startBottomX", "startBottomY", selectionInfo.startBottom);
+    setCoord("endTopX", "endTopY", selectionInfo.endTop);
+    setCoord("endBottomX", "endBottomY", selectionInfo.endBottom);
+    setCoord("mouseStartX", "mouseStartY", selectionInfo.mousePosStart);
+    setCoord("mouseEndX", "mouseEndY", selectionInfo.mousePosEnd);
+
+    // Tag names, only when classification is enabled (an empty array then means "no tags")
+    if (display.core->IsTextClassificationEnabled())
+    {
+        Napi::Array tags = Napi::Array::New(env);
+        uint32_t index = 0;
+        for (uint32_t bits = selectionInfo.tags; bits; bits &= bits - 1)
+        {
+            const char *name = GetTextTagName(bits & (~bits + 1));
+            if (name)
+                tags.Set(index++, Napi::String::New(env, name));
         }
+        resultObj.Set("tags", tags);
     }
+
+    SetDisplayTag(env, display, resultObj);
+    return resultObj;
 }
 
 /**
- * Emit text selection event (shared by Path A, Path B, and Path C).
- * Returns true if the event was successfully emitted, false otherwise.
+ * Convert a diagnostic log entry; timestamp is CLOCK_MONOTONIC in ms
  */
-bool SelectionHook::EmitSelectionEvent(SelectionDetectType type, Point start, Point end)
+Napi::Object SelectionHook::CreateLogEntryObject(Napi::Env env, const LogEntry &entry)
 {
-    if (is_selection_passive_mode || is_processing.load())
-        return false;
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("seq", Napi::Number::New(env, static_cast<double>(entry.seq)));
+    obj.Set("level", Napi::String::New(env, GetLogLevelName(entry.level)));
+    obj.Set("timestamp", Napi::Number::New(env, static_cast<double>(entry.timeNs) / 1e6));
+    obj.Set("message", Napi::String::New(env, entry.message));
+    return obj;
+}
 
-    uint64_t activeWindow = protocol->GetActiveWindow();
-    if (!activeWindow)
-        return false;
+/**
+ * Invoke the JS callback from the poll callback.
+ * MakeCallback runs the microtask queue; a thrown exception has no JS caller to
+ * propagate to, so it is reported as uncaught (as ThreadSafeFunction does).
+ */
+void SelectionHook::CallJsCallback(Napi::Object resultObj)
+{
+    if (callback.IsEmpty())
+        return;
 
-    TextSelectionInfo selectionInfo;
-    if (!GetSelectedText(activeWindow, selectionInfo) || IsTrimmedEmpty(selectionInfo.text))
-        return false;
+    Napi::Env env = Env();
+    callback.MakeCallback(env.Global(), {resultObj}, async_context);
+
+    if (env.IsExceptionPending())
+    {
+        Napi::Error error = env.GetAndClearPendingException();
+        napi_fatal_exception(env, error.Value());
+    }
+}
+
+/**
+ * Core callback: text selection detected
+ */
+void SelectionHook::OnSelection(void *context, const TextSelectionInfo &selectionInfo)
+{
+    DisplayCore *display = static_cast<DisplayCore *>(context);
+    SelectionHook *instance = display->hook;
+    Napi::Env env = instance->Env();
+
+    instance->CallJsCallback(instance->CreateSelectionResultObject(env, *display, selectionInfo));
+}
+
+/**
+ * Core callback: mouse event
+ */
+void SelectionHook::OnMouseEvent(void *context, const CoreMouseEvent &mouseEvent)
+{
+    DisplayCore *display = static_cast<DisplayCore *>(context);
+    SelectionHook *instance = display->hook;
+    Napi::Env env = instance->Env();
 
-    // Set coordinates and posLevel based on detection type
-    switch (type)
+    // Moves don't make a display the active one: an idle session may still report them
+    if (mouseEvent.action != MouseAction::Move)
+        instance->active_display = display;
+
+    const char *action;
+    switch (mouseEvent.action)
     {
-        case SelectionDetectType::Drag:
-            selectionInfo.mousePosStart = start;
-            selectionInfo.mousePosEnd = end;
-            if (selectionInfo.posLevel == SelectionPositionLevel::None)
-                selectionInfo.posLevel = SelectionPositionLevel::MouseDual;
+        case MouseAction::Move:
+            action = "mouse-move";
+            break;
+        case MouseAction::Down:
+            action = "mouse-down";
             break;
-        case SelectionDetectType::DoubleClick:
-            selectionInfo.mousePosStart = start;
-            selectionInfo.mousePosEnd = end;
-            if (selectionInfo.posLevel == SelectionPositionLevel::None)
-                selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
+        case MouseAction::Up:
+            action = "mouse-up";
             break;
-        case SelectionDetectType::ShiftClick:
-            selectionInfo.mousePosStart = start;
-            selectionInfo.mousePosEnd = end;
-            if (selectionInfo.posLevel == SelectionPositionLevel::None)
-                selectionInfo.posLevel = SelectionPositionLevel::MouseDual;
+        case MouseAction::Wheel:
+            action = "mouse-wheel";
             break;
         default:
+            action = "unknown";
             break;
     }
 
-    // Wayland: refine coordinates using display server query.
-    // Replaces unreliable libevdev positions with compositor/XWayland coordinates.
-    if (env_info.displayProtocol == DisplayProtocol::Wayland)
-    {
-        Point accuratePos = protocol->GetCurrentMousePosition();
+    // Output INVALID_COORDINATE when position source is unreliable (e.g. libevdev on Wayland)
+    int outX = mouseEvent.pos.valid ? mouseEvent.pos.x : INVALID_COORDINATE;
+    int outY = mouseEvent.pos.valid ? mouseEvent.pos.y : INVALID_COORDINATE;
 
-        switch (type)
-        {
-            case SelectionDetectType::Drag:
-            {
-                if (queried_mouse_down_pos.valid && accuratePos.valid)
-                {
-                    // XWayland frozen: position unchanged despite physical drag → stale coordinates
-                    if (accuratePos.x == queried_mouse_down_pos.x && accuratePos.y == queried_mouse_down_pos.y)
-                    {
-                        selectionInfo.mousePosStart.valid = false;
-                        selectionInfo.mousePosEnd.valid = false;
-                        selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
-                    }
-                    else
-                    {
-                        // Both start (mouse-down) and end (emission) are accurate
-                        selectionInfo.mousePosStart = queried_mouse_down_pos;
-                        selectionInfo.mousePosEnd = accuratePos;
-                        selectionInfo.posLevel = SelectionPositionLevel::MouseDual;
-                    }
-                }
-                else if (accuratePos.valid)
-                {
-                    // Only emission-time position is accurate
-                    selectionInfo.mousePosEnd = accuratePos;
-                    selectionInfo.mousePosStart = accuratePos;  // start = end
-                    selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
-                }
-                else
-                {
-                    // Both invalid (no compositor IPC, no XWayland)
-                    selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
-                }
-                break;
-            }
-            case SelectionDetectType::DoubleClick:
-                if (accuratePos.valid)
-                {
-                    selectionInfo.mousePosStart = accuratePos;
-                    selectionInfo.mousePosEnd = accuratePos;
-                }
-                // posLevel stays MouseSingle (double-click is always single point)
-                break;
-            case SelectionDetectType::ShiftClick:
-                if (accuratePos.valid)
-                {
-                    selectionInfo.mousePosEnd = accuratePos;
-                    selectionInfo.mousePosStart = accuratePos;  // start = end
-                }
-                selectionInfo.posLevel = SelectionPositionLevel::MouseSingle;
-                break;
-            default:
-                break;
-        }
+    Napi::Object resultObj = Napi::Object::New(env);
+    resultObj.Set(Napi::String::New(env, "type"), Napi::String::New(env, "mouse-event"));
+    resultObj.Set(Napi::String::New(env, "action"), Napi::String::New(env, action));
+    resultObj.Set(Napi::String::New(env, "x"), Napi::Number::New(env, outX));
+    resultObj.Set(Napi::String::New(env, "y"), Napi::Number::New(env, outY));
+    resultObj.Set(Napi::String::New(env, "button"), Napi::Number::New(env, static_cast<int>(mouseEvent.button)));
+    resultObj.Set(Napi::String::New(env, "flag"), Napi::Number::New(env, mouseEvent.flag));
+    if (mouseEvent.action == MouseAction::Wheel)
+        resultObj.Set(Napi::String::New(env, "delta"), Napi::Number::New(env, mouseEvent.delta));
+    if (mouseEvent.device)
+    {
+        resultObj.Set(Napi::String::New(env, "deviceId"), Napi::Number::New(env, mouseEvent.device));
+        resultObj.Set(Napi::String::New(env, "time"), Napi::Number::New(env, mouseEvent.time));
+    }
+    SetDisplayTag(env, *display, resultObj);
+    instance->CallJsCallback(resultObj);
+}
+
+/**
+ * Core callback: keyboard event
+ */
+void SelectionHook::OnKeyboardEvent(void *context, const CoreKeyboardEvent &keyboardEvent)
+{
+    DisplayCore *display = static_cast<DisplayCore *>(context);
+    SelectionHook *instance = display->hook;
+    Napi::Env env = instance->Env();
+
+    instance->active_display = display;
+
+    const char *action;
+    switch (keyboardEvent.action)
+    {
+        case KeyboardAction::Down:
+            action = "key-down";
+            break;
+        case KeyboardAction::Up:
+            action = "key-up";
+            break;
+        default:
+            action = "unknown";
+            break;
     }
 
-    auto callback = [selectionInfo](Napi::Env env, Napi::Function jsCallback)
+    Napi::Object resultObj = Napi::Object::New(env);
+    resultObj.Set(Napi::String::New(env, "type"), Napi::String::New(env, "keyboard-event"));
+    resultObj.Set(Napi::String::New(env, "action"), Napi::String::New(env, action));
+    resultObj.Set(Napi::String::New(env, "uniKey"), Napi::String::New(env, keyboardEvent.uniKey));
+    resultObj.Set(Napi::String::New(env, "vkCode"), Napi::Number::New(env, keyboardEvent.code));
+    resultObj.Set(Napi::String::New(env, "sys"), Napi::Boolean::New(env, keyboardEvent.sys));
+    resultObj.Set(Napi::String::New(env, "flags"), Napi::Number::New(env, keyboardEvent.flags));
+    if (keyboardEvent.device)
+    {
+        resultObj.Set(Napi::String::New(env, "deviceId"), Napi::Number::New(env, keyboardEvent.device));
+        resultObj.Set(Napi::String::New(env, "time"), Napi::Number::New(env, keyboardEvent.time));
+    }
+    SetDisplayTag(env, *display, resultObj);
+    instance->CallJsCallback(resultObj);
+}
+
+/**
+ * Core callback: selection owner changed
+ */
+void SelectionHook::OnSelectionChange(void *context, const CoreSelectionChangeEvent &changeEvent)
+{
+    DisplayCore *display = static_cast<DisplayCore *>(context);
+    SelectionHook *instance = display->hook;
+    Napi::Env env = instance->Env();
+
+    Napi::Object resultObj = Napi::Object::New(env);
+    resultObj.Set(Napi::String::New(env, "type"), Napi::String::New(env, "selection-change"));
+    resultObj.Set(Napi::String::New(env, "timestamp"),
+                  Napi::Number::New(env, static_cast<double>(changeEvent.timestamp)));
+    resultObj.Set(Napi::String::New(env, "owner"), Napi::Number::New(env, static_cast<double>(changeEvent.owner)));
+    resultObj.Set(Napi::String::New(env, "programName"),
+                  ProgramNameString(env, *display, changeEvent.programId, changeEvent.programName.c_str()));
+    resultObj.Set(Napi::String::New(env, "isDragging"), Napi::Boolean::New(env, changeEvent.isDragging));
+    SetDisplayTag(env, *display, resultObj);
+    instance->CallJsCallback(resultObj);
+}
+
+/**
+ * Core callback: input dispatch suspended (session locked/idle) or resumed
+ */
+void SelectionHook::OnSuspend(void *context, int reasons)
+{
+    DisplayCore *display = static_cast<DisplayCore *>(context);
+    SelectionHook *instance = display->hook;
+    Napi::Env env = instance->Env();
+
+    Napi::Object resultObj = Napi::Object::New(env);
+    resultObj.Set(Napi::String::New(env, "type"), Napi::String::New(env, "status"));
+    resultObj.Set(Napi::String::New(env, "status"), Napi::String::New(env, reasons ? "suspended" : "resumed"));
+    SetDisplayTag(env, *display, resultObj);
+    instance->CallJsCallback(resultObj);
+}
+
+/**
+ * Start polling the core fd (with several displays: the epoll set of the core fds) on the
+ * Node event loop. The active poll handle keeps the loop alive while the hook is running.
+ */
+bool SelectionHook::StartCorePoll(Napi::Env env)
+{
+    int fd = reactor_fd >= 0 ? reactor_fd : core->GetFd();
+    if (fd < 0)
+        return false;
+
+    uv_loop_t *loop = nullptr;
+    if (napi_get_uv_event_loop(env, &loop) != napi_ok || !loop)
+        return false;
+
+    uv_poll_t *poll = new uv_poll_t;
+    if (uv_poll_init(loop, poll, fd) != 0)
     {
-        Napi::Object resultObj = currentInstance->CreateSelectionResultObject(env, selectionInfo);
-        jsCallback.Call({resultObj});
-    };
+        delete poll;
+        return false;
+    }
 
-    if (running.load() && tsfn)
+    poll->data = this;
+    if (uv_poll_start(poll, UV_READABLE, &SelectionHook::OnCorePoll) != 0)
     {
-        tsfn.NonBlockingCall(callback);
+        uv_close(reinterpret_cast<uv_handle_t *>(poll),
+                 [](uv_handle_t *handle) { delete reinterpret_cast<uv_poll_t *>(handle); });
+        return false;
     }
 
+    core_poll = poll;
     return true;
 }
 
 /**
- * Process keyboard event on main thread
+ * Stop polling the core fd. The handle is freed by libuv's close callback on a
+ * later loop iteration.
  */
-void SelectionHook::ProcessKeyboardEvent(Napi::Env env, Napi::Function function, KeyboardEventContext *pKeyboardEvent)
+void SelectionHook::StopCorePoll()
 {
-    // During TSFN drain at shutdown, env is null — just free the data
-    if (!env || !pKeyboardEvent)
-    {
-        delete pKeyboardEvent;
+    if (!core_poll)
         return;
-    }
 
-    auto keyCode = pKeyboardEvent->code;
-    auto keyValue = pKeyboardEvent->value;
-    auto keyFlags = pKeyboardEvent->flags;
+    uv_poll_stop(core_poll);
+    core_poll->data = nullptr;
+    uv_close(reinterpret_cast<uv_handle_t *>(core_poll),
+             [](uv_handle_t *handle) { delete reinterpret_cast<uv_poll_t *>(handle); });
+    core_poll = nullptr;
+}
 
-    std::string eventTypeStr;
+/**
+ * uv_poll callback (main thread): the core has queued events. With several displays, every
+ * core with queued events is dispatched in turn.
+ * Callbacks are delivered synchronously through OnSelection/OnMouseEvent/OnKeyboardEvent.
+ */
+void SelectionHook::OnCorePoll(uv_poll_t *handle, int status, int events)
+{
+    SelectionHook *instance = static_cast<SelectionHook *>(handle->data);
+    if (!instance || !instance->IsAnyCoreRunning())
+        return;
 
-    // Determine event type
-    switch (keyValue)
+    if (status < 0)
     {
-        case 0:  // Key release
-            eventTypeStr = "key-up";
-            break;
-        case 1:  // Key press
-            eventTypeStr = "key-down";
-            break;
-        case 2:  // Key repeat
-            eventTypeStr = "key-down";
-            break;
-        default:
-            eventTypeStr = "unknown";
-            break;
+        LogMessage(LogLevel::Error, "[SelectionHook] Event poll failed: %s", uv_strerror(status));
+        instance->StopCorePoll();
+        return;
     }
 
-    // Check if any system key (Ctrl, Alt, Super) is being pressed
-    bool isSysKey = (keyFlags & MODIFIER_CTRL) || (keyFlags & MODIFIER_ALT) || (keyFlags & MODIFIER_META);
+    Napi::HandleScope scope(instance->Env());
+    if (instance->reactor_fd < 0)
+    {
+        instance->core->Dispatch();
+    }
+    else
+    {
+        struct epoll_event ready[16];
+        int count = epoll_wait(instance->reactor_fd, ready, 16, 0);
+        for (int i = 0; i < count; i++)
+        {
+            // A callback may have stopped the hook
+            SelectionCore *displayCore = static_cast<DisplayCore *>(ready[i].data.ptr)->core.get();
+            if (displayCore->IsRunning())
+                displayCore->Dispatch();
+        }
+    }
+
+    // A callback may have stopped the hook; the entries then stay for linuxDrainLog()
+    if (instance->log_events && instance->IsAnyCoreRunning())
+        instance->DeliverLogEntries();
+}
 
-    // Convert Linux key code to universal key string (MDN KeyboardEvent.key)
-    std::string uniKey = convertKeyCodeToUniKey(keyCode, keyFlags);
+/**
+ * Emit the pending diagnostic log entries as "debug" events (main thread)
+ */
+void SelectionHook::DeliverLogEntries()
+{
+    std::vector<LogEntry> entries;
+    LogDrain(entries);
 
-    // Create and emit keyboard event object
-    if (!eventTypeStr.empty())
+    for (const auto &entry : entries)
     {
-        Napi::Object resultObj = Napi::Object::New(env);
-        resultObj.Set(Napi::String::New(env, "type"), Napi::String::New(env, "keyboard-event"));
-        resultObj.Set(Napi::String::New(env, "action"), Napi::String::New(env, eventTypeStr));
-        resultObj.Set(Napi::String::New(env, "uniKey"), Napi::String::New(env, uniKey));
-        resultObj.Set(Napi::String::New(env, "vkCode"), Napi::Number::New(env, keyCode));
-        resultObj.Set(Napi::String::New(env, "sys"), Napi::Boolean::New(env, isSysKey));
-        resultObj.Set(Napi::String::New(env, "flags"), Napi::Number::New(env, keyFlags));
-        function.Call({resultObj});
+        Napi::Object obj = CreateLogEntryObject(Env(), entry);
+        obj.Set("type", Napi::String::New(Env(), "debug"));
+        CallJsCallback(obj);
     }
-
-    delete pKeyboardEvent;
 }
 
 //=============================================================================